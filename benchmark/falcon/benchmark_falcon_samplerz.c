@@ -0,0 +1,30 @@
+#include "falcon_samplerz.h"
+#include "sdat_avx2.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static uint64_t ticks(void){ unsigned aux; _mm_lfence(); uint64_t r=__rdtscp(&aux); _mm_lfence(); return r; }
+#else
+static uint64_t ticks(void){ struct timespec ts; clock_gettime(CLOCK_MONOTONIC,&ts); return (uint64_t)ts.tv_sec*1000000000ull+ts.tv_nsec; }
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+static void barrier(void){__asm__ __volatile__("" ::: "memory");}
+#else
+static void barrier(void){}
+#endif
+/* samplerZ throughput. One signing attempt of Falcon-n runs ffSampling, which
+ * calls samplerZ 2n times (two length-n vectors), so cycles_per_signature is
+ * the cost of 1024 (Falcon-512) or 2048 (Falcon-1024) calls. Centers are
+ * uniform in [-64, 64) and sigma uniform in [sigma_min, sigma_max]; the
+ * inputs are precomputed and the PRNG keyed outside the timed region. */
+static uint64_t rs=1;static uint32_t rnd(void){rs=rs*6364136223846793005ULL+1442695040888963407ULL;return(uint32_t)(rs>>32);}static size_t envsz(const char*n,size_t d){char*s=getenv(n);return(s&&*s)?strtoull(s,0,10):d;}static const char*envs(const char*n,const char*d){char*s=getenv(n);return(s&&*s)?s:d;}
+static void run_one(unsigned logn,falcon_base_kind base,falcon_samplerz_mode mode,sdat_prg_kind prg,size_t n,int rep,int er){size_t per_sig=(size_t)2<<logn;double smin=logn==9?FALCON_SAMPLERZ_SIGMA_MIN_512:FALCON_SAMPLERZ_SIGMA_MIN_1024;double*mu=malloc((n?n:1)*sizeof*mu),*is=malloc((n?n:1)*sizeof*is);if(!mu||!is)exit(2);rs=0x5A3Bu+(uint64_t)rep*31u+logn;for(size_t i=0;i<n;i++){mu[i]=((double)rnd()/4294967296.0-0.5)*128.0;is[i]=1.0/(smin+(FALCON_SAMPLERZ_SIGMA_MAX-smin)*((double)rnd()/4294967296.0));}uint8_t seed[32];for(int i=0;i<32;i++)seed[i]=(uint8_t)rnd();falcon_samplerz_ctx sc;int status=falcon_samplerz_init(&sc,base,mode,prg,seed,32,smin)!=0;uint64_t sum=0;barrier();uint64_t t0=ticks();for(size_t i=0;i<n;i++)sum=sum*31u+(uint32_t)falcon_samplerz(&sc,mu[i],is[i]);barrier();uint64_t t1=ticks();uint64_t cyc=t1-t0;double cpc=n?(double)cyc/(double)n:0.0;double d=n?(double)n:1.0;
+if(er)printf("Falcon,Falcon-%u,%s,%s,%s,samplerz,%zu,%ld,%d,%llu,%.6f,%zu,%.3f,%.6f,%.6f,%.6f,%.6f,%llu,%s\n",1u<<logn,base==FALCON_BASE_ORIGINAL?"original-cdt":"sda-cdt",mode==FALCON_SAMPLERZ_BATCHED?(sdat_avx2_cpu_supported()?"batched-avx2":"batched-reference"):"inline-reference",sdat_prg_name(prg),n,(long)getpid(),rep,(unsigned long long)cyc,cpc,per_sig,cpc*(double)per_sig,(double)sc.stats.iterations/d,(double)sc.stats.base_draws/d,(double)sc.stats.base_rejections/d,(double)sc.stats.prng_bytes/d,(unsigned long long)sum,status?"error":"ok");
+falcon_samplerz_wipe(&sc);free(mu);free(is);}
+static void run_all(size_t n,int rep,int er,sdat_prg_kind prg){for(unsigned logn=9;logn<=10;logn++)for(int b=0;b<2;b++)for(int m=0;m<2;m++)run_one(logn,b?FALCON_BASE_SDA:FALCON_BASE_ORIGINAL,m?FALCON_SAMPLERZ_BATCHED:FALCON_SAMPLERZ_INLINE,prg,n,rep,er);}
+int main(void){size_t reps=envsz("FALCON_BENCH_REPETITIONS",31),warm=envsz("FALCON_BENCH_WARMUP",5),n=envsz("FALCON_BENCH_SAMPLERZ_CALLS",262144);const char*p=envs("FALCON_BENCH_PRG","chacha20");sdat_prg_kind prg=!strcmp(p,"shake128")?SDAT_PRG_SHAKE128:!strcmp(p,"shake128x4")?SDAT_PRG_SHAKE128_X4:!strcmp(p,"aes128-ctr")?SDAT_PRG_AES128_CTR:SDAT_PRG_CHACHA20;puts("scheme,parameter_set,base_sampler,mode,prg,component,calls,process_id,repetition,cycles_total,cycles_per_call,calls_per_signature,cycles_per_signature,iterations_per_call,base_draws_per_call,base_rejections_per_call,prng_bytes_per_call,checksum,status");for(size_t r=0;r<warm;r++)run_all(n,-1,0,prg);for(size_t r=0;r<reps;r++)run_all(n,(int)r,1,prg);return 0;}
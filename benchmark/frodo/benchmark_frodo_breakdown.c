@@ -25,5 +25,13 @@ static void frontend_original(const frodo_sampler_params*p,const uint16_t*w,size
 static void frontend_sda(const frodo_sampler_params*p,const uint16_t*w,size_t wc,size_t n,const char*mode,int rep,int er){volatile uint64_t sink=0;size_t acc=0,pos=0,rej=0;barrier();unsigned long long t0=ticks();while(acc<n&&pos<wc){uint16_t c;uint8_t s;int ok=sda_accept(p,w[pos++],&c,&s);sink+=(uint64_t)(ok?c:0)+s;acc+=(size_t)ok;rej+=(size_t)!ok;}barrier();unsigned long long t1=ticks();double apo=n?((double)pos/n):0.0;if(er)emit(p,FRODO_SAMPLER_SDA_CDT,"word-oriented","source-frontend",mode,"benchmark-only-sda-source-frontend",n,rep,t1-t0,pos?((double)(t1-t0)/pos):0,n?((double)(t1-t0)/n):0,apo,n?((double)rej/n):0,acc,pos,sink,acc<n);}
 static void mapping(const frodo_sampler_params*p,frodo_sampler_kind k,const uint16_t*c,const uint8_t*s,uint16_t*out,size_t n,const char*mode,int rep,int er){barrier();unsigned long long t0=ticks();if(k==FRODO_SAMPLER_ORIGINAL_CDT){const uint16_t*t=p->original_table->thresholds;for(size_t i=0;i<n;i++)out[i]=signv(lookup_orig(c[i],t,p->original_table->threshold_count),s[i]);}else if(p->sda_table->value_type==SDAT_TYPE_U8){const uint8_t*t=p->sda_table->thresholds;for(size_t i=0;i<n;i++)out[i]=signv(lookup_u8((uint8_t)c[i],t,p->sda_table->threshold_count),s[i]);}else{const uint16_t*t=p->sda_table->thresholds;for(size_t i=0;i<n;i++)out[i]=signv(lookup_u16(c[i],t,p->sda_table->threshold_count),s[i]);}barrier();unsigned long long t1=ticks();if(er)emit(p,k,"mapping-only","cdt-mapping",mode,k==FRODO_SAMPLER_ORIGINAL_CDT?"original-reference":"sda-word-reference",n,rep,t1-t0,0,n?((double)(t1-t0)/n):0,1,0,n,n,cksum(out,n),0);}
 static void full(const frodo_sampler_params*p,frodo_sampler_kind k,const uint8_t*buf,size_t blen,const uint16_t*w,size_t wc,uint16_t*out,size_t n,const char*mode,int rep,int er){frodo_sampler_stats fs={0};frodo_frontend fe=k==FRODO_SAMPLER_ORIGINAL_CDT?FRODO_FRONTEND_ORIGINAL_WORD:FRODO_FRONTEND_WORD_ORIENTED;if(k==FRODO_SAMPLER_ORIGINAL_CDT)memcpy(out,w,n*2);barrier();unsigned long long t0=ticks();int rc=frodo_sample_n_dispatch(k,FRODO_BACKEND_REFERENCE,fe,p->id,out,n,buf,blen,w,wc,0);barrier();unsigned long long t1=ticks();if(k==FRODO_SAMPLER_ORIGINAL_CDT)memcpy(out,w,n*2);int mrc=frodo_sample_n_dispatch(k,FRODO_BACKEND_REFERENCE,fe,p->id,out,n,buf,blen,w,wc,&fs);if(!rc)rc=mrc;double apo=k==FRODO_SAMPLER_ORIGINAL_CDT?1.0:(n?(double)fs.stats.attempts/n:0);double rpo=k==FRODO_SAMPLER_ORIGINAL_CDT?0.0:(n?(double)fs.stats.rejections/n:0);size_t src=k==FRODO_SAMPLER_ORIGINAL_CDT?n:(size_t)(fs.stats.random_bytes/2);if(er)emit(p,k,k==FRODO_SAMPLER_ORIGINAL_CDT?"original-word":"word-oriented","full-sampler-core",mode,k==FRODO_SAMPLER_ORIGINAL_CDT?"original-reference":"sda-word-reference",n,rep,t1-t0,0,n?((double)(t1-t0)/n):0,apo,rpo,n,src,cksum(out,n),rc);}
-static void one(const frodo_sampler_params*p,size_t n,const char*mode,int rep,int er){size_t wc=n*8+4096,blen=n*8+4096;uint16_t*w=malloc(wc*2),*sda_c=malloc(n*2),*orig_c=malloc(n*2),*out=malloc(n*2);uint8_t*buf=malloc(blen),*sda_s=malloc(n),*orig_s=malloc(n);if(!w||!sda_c||!orig_c||!out||!buf||!sda_s||!orig_s)exit(2);fill16(w,wc,9000+(uint64_t)rep+31u*p->id);fill8(buf,blen,8000+(uint64_t)rep+29u*p->id);for(size_t i=0;i<n;i++){orig_c[i]=(uint16_t)(w[i]>>1);orig_s[i]=(uint8_t)(w[i]&1u);}for(size_t i=0,a=0;i<wc&&a<n;i++){uint16_t cc;uint8_t ss;if(sda_accept(p,w[i],&cc,&ss)){sda_c[a]=cc;sda_s[a++]=ss;}}frontend_original(p,w,n,mode,rep,er);frontend_sda(p,w,wc,n,mode,rep,er);mapping(p,FRODO_SAMPLER_ORIGINAL_CDT,orig_c,orig_s,out,n,mode,rep,er);mapping(p,FRODO_SAMPLER_SDA_CDT,sda_c,sda_s,out,n,mode,rep,er);full(p,FRODO_SAMPLER_ORIGINAL_CDT,buf,blen,w,wc,out,n,mode,rep,er);full(p,FRODO_SAMPLER_SDA_CDT,buf,blen,w,wc,out,n,mode,rep,er);free(w);free(sda_c);free(orig_c);free(out);free(buf);free(sda_s);free(orig_s);}
-int main(void){size_t reps=envsz("FRODO_BENCH_REPETITIONS",31),warm=envsz("FRODO_BENCH_WARMUP",5),equal=envsz("FRODO_BENCH_SAMPLE_COUNT",1048576),native=envsz("FRODO_BENCH_NATIVE_BATCH",0);const char*mode=envs("FRODO_BENCH_MODE_LABEL",native?"native-batch":"equal-size");puts("scheme,parameter_set,sampler_kind,backend,frontend,component,mode,implementation,sample_count,process_id,repetition,cycles_total,cycles_per_attempt,cycles_per_output,attempts_per_output,rejections_per_output,accepted_outputs,source_words,checksum,status");for(size_t r=0;r<warm;r++){const frodo_sampler_params*p=frodo_get_sampler_params((frodo_param_id)(r%3));one(p,native?p->native_sample_count:equal,mode,-1,0);}for(size_t r=0;r<reps;r++)for(int id=0;id<3;id++){const frodo_sampler_params*p=frodo_get_sampler_params((frodo_param_id)((id+r)%3));one(p,native?p->native_sample_count:equal,mode,(int)r,1);}return 0;}
+/* FRODO_BENCH_PRG rows: rng-generation times the PRG expanding exactly the bytes the full sampler consumes for n outputs, prg-plus-full-sampler the seed-driven sampler (frodo_sample_n_from_seed) end to end. */
+static int prgs_parse(const char*s,sdat_prg_kind*k){const sdat_prg_kind all[5]={SDAT_PRG_SHAKE128,SDAT_PRG_SHAKE128_X4,SDAT_PRG_AES128_CTR,SDAT_PRG_CHACHA20,SDAT_PRG_PHILOX4X32};int c=0;char tmp[128];if(!s||!*s)return 0;if(!strcmp(s,"all")){memcpy(k,all,sizeof all);return 5;}snprintf(tmp,sizeof tmp,"%s",s);for(char*t=strtok(tmp,",");t;t=strtok(0,",")){int i=0;while(i<5&&strcmp(t,sdat_prg_name(all[i])))i++;if(i==5||c==5){fprintf(stderr,"error: FRODO_BENCH_PRG takes all or a list of shake128,shake128x4,aes128-ctr,chacha20,philox4x32\n");exit(2);}k[c++]=all[i];}return c;}
+static void prg_rows(const frodo_sampler_params*p,frodo_sampler_kind k,sdat_prg_kind prg,uint16_t*out,size_t n,const char*mode,int rep,int er){static const uint8_t seed[32]={0x53,0x44,0x41,0x2d,0x43,0x44,0x54};frodo_frontend fe=k==FRODO_SAMPLER_ORIGINAL_CDT?FRODO_FRONTEND_ORIGINAL_WORD:FRODO_FRONTEND_WORD_ORIENTED;const char*front=k==FRODO_SAMPLER_ORIGINAL_CDT?"original-word":"word-oriented",*impl=k==FRODO_SAMPLER_ORIGINAL_CDT?"original-reference":"sda-word-reference";char gen[64],both[96];size_t sl=sdat_prg_stream_key_bytes(prg)?sdat_prg_stream_key_bytes(prg):32;snprintf(gen,sizeof gen,"%s-%s",sdat_prg_name(prg),sdat_prg_backend_name(prg));snprintf(both,sizeof both,"%s+%s",impl,gen);
+ frodo_sampler_stats fs={0};int rc=frodo_sample_n_from_seed(k,FRODO_BACKEND_REFERENCE,fe,p->id,out,n,prg,seed,sl,&fs);size_t bytes=k==FRODO_SAMPLER_ORIGINAL_CDT?2*n:(size_t)fs.stats.random_bytes;double apo=k==FRODO_SAMPLER_ORIGINAL_CDT?1.0:(n?(double)fs.stats.attempts/n:0),rpo=k==FRODO_SAMPLER_ORIGINAL_CDT?0.0:(n?(double)fs.stats.rejections/n:0);
+ uint8_t*buf=malloc(bytes?bytes:1);if(!buf)exit(2);sdat_prg g;int grc=sdat_prg_init(&g,prg,seed,sl);barrier();unsigned long long t0=ticks();sdat_prg_generate(&g,buf,bytes);barrier();unsigned long long t1=ticks();sdat_prg_wipe(&g);uint64_t gsum=1469598103934665603ULL;for(size_t i=0;i<bytes;i+=64){gsum^=buf[i];gsum*=1099511628211ULL;}free(buf);
+ if(er)emit(p,k,front,"rng-generation",mode,gen,n,rep,t1-t0,0,n?((double)(t1-t0)/n):0,apo,rpo,n,bytes/2,gsum,grc);
+ barrier();t0=ticks();int frc=frodo_sample_n_from_seed(k,FRODO_BACKEND_REFERENCE,fe,p->id,out,n,prg,seed,sl,0);barrier();t1=ticks();if(!rc)rc=frc;
+ if(er)emit(p,k,front,"prg-plus-full-sampler",mode,both,n,rep,t1-t0,0,n?((double)(t1-t0)/n):0,apo,rpo,n,bytes/2,cksum(out,n),rc);}
+static void one(const frodo_sampler_params*p,size_t n,const char*mode,int rep,int er,const sdat_prg_kind*prgs,int np){size_t wc=n*8+4096,blen=n*8+4096;uint16_t*w=malloc(wc*2),*sda_c=malloc(n*2),*orig_c=malloc(n*2),*out=malloc(n*2);uint8_t*buf=malloc(blen),*sda_s=malloc(n),*orig_s=malloc(n);if(!w||!sda_c||!orig_c||!out||!buf||!sda_s||!orig_s)exit(2);fill16(w,wc,9000+(uint64_t)rep+31u*p->id);fill8(buf,blen,8000+(uint64_t)rep+29u*p->id);for(size_t i=0;i<n;i++){orig_c[i]=(uint16_t)(w[i]>>1);orig_s[i]=(uint8_t)(w[i]&1u);}for(size_t i=0,a=0;i<wc&&a<n;i++){uint16_t cc;uint8_t ss;if(sda_accept(p,w[i],&cc,&ss)){sda_c[a]=cc;sda_s[a++]=ss;}}frontend_original(p,w,n,mode,rep,er);frontend_sda(p,w,wc,n,mode,rep,er);mapping(p,FRODO_SAMPLER_ORIGINAL_CDT,orig_c,orig_s,out,n,mode,rep,er);mapping(p,FRODO_SAMPLER_SDA_CDT,sda_c,sda_s,out,n,mode,rep,er);full(p,FRODO_SAMPLER_ORIGINAL_CDT,buf,blen,w,wc,out,n,mode,rep,er);full(p,FRODO_SAMPLER_SDA_CDT,buf,blen,w,wc,out,n,mode,rep,er);for(int i=0;i<np;i++){prg_rows(p,FRODO_SAMPLER_ORIGINAL_CDT,prgs[i],out,n,mode,rep,er);prg_rows(p,FRODO_SAMPLER_SDA_CDT,prgs[i],out,n,mode,rep,er);}free(w);free(sda_c);free(orig_c);free(out);free(buf);free(sda_s);free(orig_s);}
+int main(void){size_t reps=envsz("FRODO_BENCH_REPETITIONS",31),warm=envsz("FRODO_BENCH_WARMUP",5),equal=envsz("FRODO_BENCH_SAMPLE_COUNT",1048576),native=envsz("FRODO_BENCH_NATIVE_BATCH",0);const char*mode=envs("FRODO_BENCH_MODE_LABEL",native?"native-batch":"equal-size");sdat_prg_kind prgs[5];int np=prgs_parse(getenv("FRODO_BENCH_PRG"),prgs);puts("scheme,parameter_set,sampler_kind,backend,frontend,component,mode,implementation,sample_count,process_id,repetition,cycles_total,cycles_per_attempt,cycles_per_output,attempts_per_output,rejections_per_output,accepted_outputs,source_words,checksum,status");for(size_t r=0;r<warm;r++){const frodo_sampler_params*p=frodo_get_sampler_params((frodo_param_id)(r%3));one(p,native?p->native_sample_count:equal,mode,-1,0,prgs,np);}for(size_t r=0;r<reps;r++)for(int id=0;id<3;id++){const frodo_sampler_params*p=frodo_get_sampler_params((frodo_param_id)((id+r)%3));one(p,native?p->native_sample_count:equal,mode,(int)r,1,prgs,np);}return 0;}
@@ -0,0 +1,58 @@
+#include "sdat_noise_pool.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__)||defined(__i386__)
+#include <x86intrin.h>
+static unsigned long long ticks(void){return __rdtsc();}
+#else
+static unsigned long long ticks(void){struct timespec ts;clock_gettime(CLOCK_MONOTONIC,&ts);return (unsigned long long)ts.tv_sec*1000000000ull+ts.tv_nsec;}
+#endif
+static size_t envsz(const char*n,size_t d){char*s=getenv(n);return(s&&*s)?strtoull(s,0,10):d;}
+static const char*envs(const char*n,const char*d){char*s=getenv(n);return(s&&*s)?s:d;}
+
+/* Request latency with and without the noise pool. Each consumer thread issues
+ * POOL_BENCH_REQUESTS requests for one block, spinning POOL_BENCH_THINK_CYCLES
+ * between requests to stand in for the rest of the protocol. `direct` samples
+ * the block on request from the consumer's own PRG, exactly what its ring
+ * would hold; `pool` takes it from sdat_noise_pool_pop_wait. */
+typedef struct{const sdat_noise_pool_config*cfg;sdat_noise_pool*pool;unsigned index;size_t requests,think;unsigned long long*lat;uint64_t sum;int status;}worker;
+
+static void think(size_t cyc){unsigned long long t0=ticks();while(ticks()-t0<cyc){}}
+
+static void*run(void*arg){worker*w=arg;const sdat_noise_pool_config*c=w->cfg;size_t n=c->block_samples,bytes=n*(c->source==SDAT_NOISE_FRODO?2u:4u);uint8_t*blk=malloc(bytes);frodo_stream*st=0;sdat_prg g;
+    uint8_t key[32],le[4]={(uint8_t)w->index,(uint8_t)(w->index>>8),(uint8_t)(w->index>>16),(uint8_t)(w->index>>24)};sdat_shake128_ctx h;sdat_shake128_init(&h);sdat_shake128_absorb(&h,c->seed,c->seed_len);sdat_shake128_absorb(&h,le,4);sdat_shake128_squeeze(&h,key,32);size_t kl=sdat_prg_stream_key_bytes(c->prg);sdat_prg_init(&g,c->prg,key,kl?kl:32);
+    if(!w->pool&&c->source==SDAT_NOISE_FRODO){st=aligned_alloc(64,(sizeof*st+63u)&~(size_t)63u);if(!st||frodo_stream_init(st,c->frodo_kind,c->backend,c->frontend,c->param)){w->status=-3;free(st);free(blk);return 0;}frodo_stream_set_refill(st,sdat_prg_randombytes,&g);}
+    int avx2=frodo_resolve_backend(c->backend)==FRODO_BACKEND_AVX2;
+    for(size_t r=0;r<w->requests&&blk&&!w->status;r++){think(w->think);unsigned long long t0=ticks();
+        if(w->pool)w->status=sdat_noise_pool_pop_wait(w->pool,w->index,blk);
+        else if(st)w->status=frodo_stream_sample_n(st,(uint16_t*)blk,n)==n?0:-3;
+        else w->status=(c->falcon_kind==FALCON_BASE_ORIGINAL?(avx2?falcon_original_gaussian0_sample_n_avx2:falcon_original_gaussian0_sample_n):(avx2?falcon_sda_gaussian0_sample_n_avx2:falcon_sda_gaussian0_sample_n))(sdat_prg_randombytes,&g,(uint32_t*)blk,n,0)==n?0:-3;
+        w->lat[r]=ticks()-t0;for(size_t i=0;i<bytes;i+=64)w->sum=w->sum*1099511628211ULL^blk[i];}
+    if(st){frodo_stream_wipe(st);free(st);}sdat_prg_wipe(&g);free(blk);return 0;}
+
+static int cmp(const void*a,const void*b){unsigned long long x=*(const unsigned long long*)a,y=*(const unsigned long long*)b;return x<y?-1:x>y;}
+static unsigned long long pct(const unsigned long long*s,size_t n,double p){size_t i=(size_t)(p*(double)(n-1)+0.5);return s[i<n?i:n-1];}
+
+static void bench(sdat_noise_pool_config*c,const char*scheme,const char*param,int pooled,int rep){size_t req=envsz("POOL_BENCH_REQUESTS",4096),th=envsz("POOL_BENCH_THINK_CYCLES",200000);unsigned k=c->consumers;worker w[SDAT_NOISE_POOL_MAX_CONSUMERS];pthread_t tid[SDAT_NOISE_POOL_MAX_CONSUMERS];unsigned long long*lat=malloc(k*req*sizeof*lat);sdat_noise_pool*pool=0;int status=lat?0:-2;sdat_noise_pool_stats agg={0};
+    if(!status&&pooled){status=sdat_noise_pool_create(&pool,c);if(!status){c->block_samples=sdat_noise_pool_block_samples(pool);sdat_noise_pool_stats s;do{sdat_noise_pool_get_stats(pool,k-1,&s);}while(s.depth<s.capacity);}}
+    for(unsigned i=0;i<k&&!status;i++){w[i]=(worker){c,pool,i,req,th,lat+i*req,0,0};if(pthread_create(&tid[i],0,run,&w[i]))status=-2,k=i;}
+    uint64_t sum=0;for(unsigned i=0;i<k;i++){pthread_join(tid[i],0);if(w[i].status&&!status)status=w[i].status;sum^=w[i].sum;}
+    if(pool){for(unsigned i=0;i<c->consumers;i++){sdat_noise_pool_stats s;sdat_noise_pool_get_stats(pool,i,&s);agg.empty_polls+=s.empty_polls;agg.wakeups+=s.wakeups;}sdat_noise_pool_destroy(pool);}
+    size_t n=status?0:(size_t)c->consumers*req;double mean=0;if(n){qsort(lat,n,sizeof*lat,cmp);for(size_t i=0;i<n;i++)mean+=(double)lat[i];mean/=(double)n;}
+    printf("%s,%s,%s,%s,%s,%u,%u,%zu,%zu,%zu,%d,%llu,%llu,%llu,%llu,%llu,%.1f,%llu,%llu,%llx,%s\n",scheme,param,pooled?"pool":"direct",frodo_backend_name(frodo_resolve_backend(c->backend)),sdat_prg_name(c->prg),c->consumers,pooled?c->producers:0,c->block_samples,req,th,rep,
+           n?pct(lat,n,.5):0,n?pct(lat,n,.9):0,n?pct(lat,n,.99):0,n?pct(lat,n,.999):0,n?lat[n-1]:0,mean,(unsigned long long)agg.empty_polls,(unsigned long long)agg.wakeups,(unsigned long long)sum,status?"error":"ok");free(lat);}
+
+int main(void){static const uint8_t seed[32]={7,1,4,2,8,5,7,1,4,2,8,5,7,1,4,2,8,5,7,1,4,2,8,5,7,1,4,2,8,5,7,1};const char*src=envs("POOL_BENCH_SOURCE","frodo"),*prg=envs("POOL_BENCH_PRG","chacha20");size_t reps=envsz("POOL_BENCH_REPETITIONS",5);
+    sdat_noise_pool_config c={0};c.consumers=(unsigned)envsz("POOL_BENCH_CONSUMERS",2);c.producers=(unsigned)envsz("POOL_BENCH_PRODUCERS",1);c.slots=(unsigned)envsz("POOL_BENCH_SLOTS",16);c.low_watermark=c.slots/4;c.backend=FRODO_BACKEND_AUTO;c.seed=seed;c.seed_len=sizeof seed;
+    c.prg=!strcmp(prg,"shake128")?SDAT_PRG_SHAKE128:!strcmp(prg,"shake128x4")?SDAT_PRG_SHAKE128_X4:!strcmp(prg,"aes128-ctr")?SDAT_PRG_AES128_CTR:!strcmp(prg,"philox4x32")?SDAT_PRG_PHILOX4X32:SDAT_PRG_CHACHA20;
+    if(c.consumers<1||c.consumers>SDAT_NOISE_POOL_MAX_CONSUMERS){fprintf(stderr,"POOL_BENCH_CONSUMERS must be 1..%u\n",SDAT_NOISE_POOL_MAX_CONSUMERS);return 2;}
+    puts("scheme,parameter_set,mode,backend,prg,consumers,producers,block_samples,requests,think_cycles,repetition,p50_cycles,p90_cycles,p99_cycles,p999_cycles,max_cycles,mean_cycles,empty_polls,producer_wakeups,checksum,status");
+    for(size_t r=0;r<reps;r++){
+        if(strcmp(src,"falcon")){for(int p=0;p<3;p++){const frodo_sampler_params*fp=frodo_get_sampler_params((frodo_param_id)p);c.source=SDAT_NOISE_FRODO;c.frodo_kind=FRODO_SAMPLER_SDA_CDT;c.frontend=FRODO_FRONTEND_WORD_ORIENTED;c.param=fp->id;
+            for(int m=0;m<2;m++){int pooled=(m+(int)r)%2;c.block_samples=fp->native_sample_count;bench(&c,"Frodo",fp->name,pooled,(int)r);}}}
+        if(strcmp(src,"frodo")){for(int kind=0;kind<2;kind++){c.source=SDAT_NOISE_FALCON_BASE;c.falcon_kind=kind?FALCON_BASE_SDA:FALCON_BASE_ORIGINAL;
+            for(int m=0;m<2;m++){int pooled=(m+(int)r)%2;c.block_samples=SDAT_NOISE_FALCON_BLOCK;bench(&c,"Falcon",kind?"gaussian0-sda":"gaussian0-original",pooled,(int)r);}}}}
+    return 0;}
@@ -62,10 +62,18 @@ def summarize(rows):
   out.append(row)
  return out
 def val(r,k): return num(r.get(k,'')) if r else None
+def metadata(summary):
+ m=dict(META)
+ if any(r['component']=='rng-generation' for r in summary):m.update({'rng_generation_status':'measured','rng_generation':'rng-generation rows (FRODO_BENCH_PRG); the pre-generated-source components exclude it'})
+ return m
+def rng_cell(summary,mode,p,front):
+ gs=[f'{r["implementation"]} {r["median_of_process_medians"]}' for r in summary if r['component']=='rng-generation' and (r['mode'],r['parameter_set'],r['frontend'])==(mode,p,front)]
+ return '; '.join(gs) if gs else 'N/A (pre-generated source)'
 def markdown(summary,path):
+ meta=metadata(summary)
  idx={(r['mode'],r['parameter_set'],r['implementation'],r['component'],r['backend'],r['frontend']):r for r in summary}
  modes=sorted({r['mode'] for r in summary}); params=sorted({r['parameter_set'] for r in summary})
- lines=['# Frodo benchmark summary','',f"rng_generation_status = {META['rng_generation_status']}",f"RNG generation = {META['rng_generation']}",'',META['component_timing_note'],'',f"Percentile method: {META['percentile_method']}",'','## Reference full-sampler comparison','','| Mode | Parameter | Original process-median | SDA Word process-median | Delta % | Original pooled median | SDA pooled median | Pooled delta % | Original low-noise median | SDA low-noise median | Low-noise delta % | Original outliers | SDA outliers | Classification |','|---|---|---:|---:|---:|---:|---:|---:|---:|---:|---:|---:|---:|---|']
+ lines=['# Frodo benchmark summary','',f"rng_generation_status = {meta['rng_generation_status']}",f"RNG generation = {meta['rng_generation']}",'',META['component_timing_note'],'',f"Percentile method: {META['percentile_method']}",'','## Reference full-sampler comparison','','| Mode | Parameter | Original process-median | SDA Word process-median | Delta % | Original pooled median | SDA pooled median | Pooled delta % | Original low-noise median | SDA low-noise median | Low-noise delta % | Original outliers | SDA outliers | Classification |','|---|---|---:|---:|---:|---:|---:|---:|---:|---:|---:|---:|---:|---|']
  for mode in modes:
   for p in params:
    o=idx.get((mode,p,'original-reference','full-sampler-core','reference','original-word')); s=idx.get((mode,p,'sda-word-reference','full-sampler-core','reference','word-oriented'))
@@ -78,10 +86,14 @@ def markdown(summary,path):
    pairs=[('original-reference','original-word','benchmark-only-original-source-frontend'),('sda-word-reference','word-oriented','benchmark-only-sda-source-frontend')]
    for impl,front,feimpl in pairs:
     fe=idx.get((mode,p,feimpl,'source-frontend','reference',front)); mp=idx.get((mode,p,impl,'cdt-mapping','reference','mapping-only')); fu=idx.get((mode,p,impl,'full-sampler-core','reference',front))
-    if fe or mp or fu:lines.append(f'| {mode} | {p} | {impl} | N/A (pre-generated source) | {fe.get("median_of_process_medians","") if fe else ""} | {mp.get("median_of_process_medians","") if mp else ""} | {fu.get("median_of_process_medians","") if fu else ""} | {fu.get("attempts_per_output_mean","") if fu else (fe.get("attempts_per_output_mean","") if fe else "")} | {fu.get("rejections_per_output_mean","") if fu else (fe.get("rejections_per_output_mean","") if fe else "")} |')
+    if fe or mp or fu:lines.append(f'| {mode} | {p} | {impl} | {rng_cell(summary,mode,p,front)} | {fe.get("median_of_process_medians","") if fe else ""} | {mp.get("median_of_process_medians","") if mp else ""} | {fu.get("median_of_process_medians","") if fu else ""} | {fu.get("attempts_per_output_mean","") if fu else (fe.get("attempts_per_output_mean","") if fe else "")} | {fu.get("rejections_per_output_mean","") if fu else (fe.get("rejections_per_output_mean","") if fe else "")} |')
  lines += ['','Standalone component timings; not additive.','','## Randomness','','| Mode | Parameter | Sampler | Logical bits/output | Physical bits/output | Attempts/output | Rejections/output |','|---|---|---|---:|---:|---:|---:|']
  for r in summary:
   if r['component']=='full-sampler-core' and r['backend']=='reference':lines.append(f'| {r["mode"]} | {r["parameter_set"]} | {r["implementation"]} | {r["logical_bits_per_output_mean"]} | {r["physical_bits_per_output_mean"]} | {r["attempts_per_output_mean"]} | {r["rejections_per_output_mean"]} |')
+ prg=[r for r in summary if r['component'] in ('rng-generation','prg-plus-full-sampler')]
+ if prg:
+  lines += ['','## Seed-expanded sampling','','RNG generation expands exactly the bytes the full sampler consumes; PRG plus full sampler is `frodo_sample_n_from_seed` end to end.','','| Mode | Parameter | Sampler | Component | Implementation | Process median | Pooled median |','|---|---|---|---|---|---:|---:|']
+  for r in prg:lines.append(f'| {r["mode"]} | {r["parameter_set"]} | {r["sampler_kind"]} | {r["component"]} | {r["implementation"]} | {r["median_of_process_medians"]} | {r["pooled_median"]} |')
  lines += ['','## AVX2 regression (diagnostic only; not used for Reference claims)','','| Mode | Parameter | Implementation | Component | Process median | Pooled median | Outliers |','|---|---|---|---|---:|---:|---:|']
  for r in summary:
   if r['backend']=='avx2':lines.append(f'| {r["mode"]} | {r["parameter_set"]} | {r["implementation"]} | {r["component"]} | {r["median_of_process_medians"]} | {r["pooled_median"]} | {r["outlier_count"]} |')
@@ -90,7 +102,7 @@ def write_outputs(summary,out_dir):
  fields=KEY+['n','valid_n','error_count','process_count','process_medians','median_of_process_medians','min_process_median','max_process_median','process_median_stdev','process_median_cv','pooled_median','pooled_p10','pooled_p25','pooled_p75','pooled_p90','min','max','mean','sample_stdev','cv','mad','iqr','outlier_count','pooled_low_noise_median','low_noise_fallback','attempts_per_output_mean','rejections_per_output_mean','logical_bits_per_output_mean','physical_bits_per_output_mean','status']
  with open(os.path.join(out_dir,'frodo_summary.csv'),'w',newline='') as fp:
   w=csv.DictWriter(fp,fields); w.writeheader(); w.writerows([{k:v for k,v in r.items() if k in fields} for r in summary])
- with open(os.path.join(out_dir,'frodo_summary.json'),'w') as fp:json.dump({'metadata':META,'groups':summary},fp,indent=2)
+ with open(os.path.join(out_dir,'frodo_summary.json'),'w') as fp:json.dump({'metadata':metadata(summary),'groups':summary},fp,indent=2)
  markdown(summary,os.path.join(out_dir,'frodo_summary.md'))
 def main():
  ap=argparse.ArgumentParser(); ap.add_argument('--sample-raw'); ap.add_argument('--breakdown-raw'); ap.add_argument('--out-dir',required=True); a=ap.parse_args(); os.makedirs(a.out_dir,exist_ok=True)
@@ -36,5 +36,13 @@ def main():
   assert find(rows,component='source-frontend',implementation='benchmark-only-original-source-frontend')['sampler_kind']=='original-cdt'
   assert find(rows,component='source-frontend',implementation='benchmark-only-sda-source-frontend')['sampler_kind']=='sda-cdt'
   assert '| equal-size | frodo640 |' in md and 'SDA faster' in md
+  # FRODO_BENCH_PRG rows switch the RNG metadata and get their own table.
+  extra=Path(td)/'breakdown_prg.csv'; base=load_csv(BREAK); hdr=list(base[0].keys())
+  row=dict(find(base,component='source-frontend',sampler_kind='sda-cdt')); row.update(component='rng-generation',implementation='chacha20-avx2',cycles_per_output='2.5')
+  with open(extra,'w',newline='') as f:w=csv.DictWriter(f,hdr); w.writeheader(); w.writerows(base+[row])
+  out=Path(td)/'prg'; subprocess.check_call([sys.executable,str(SCRIPT),'--sample-raw',str(SAMPLE),'--breakdown-raw',str(extra),'--out-dir',str(out)])
+  md=(out/'frodo_summary.md').read_text()
+  assert json.loads((out/'frodo_summary.json').read_text())['metadata']['rng_generation_status']=='measured'
+  assert '## Seed-expanded sampling' in md and '| sda-word-reference | chacha20-avx2 2.500000 |' in md
   print('frodo summary fixture tests passed')
 if __name__=='__main__':main()
@@ -2,6 +2,6 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
-void sda_config_defaults(sda_config*c){ memset(c,0,sizeof*c); strcpy(c->solver,"epsilon-svp-generated"); strcpy(c->epsilon_schedule,"adaptive-transition"); c->support_min=0; c->mpfr_precision=SDA_MPFR_DEFAULT_PRECISION; c->renyi_order=513; c->epsilon_min=0.40; c->epsilon_max=0.65; c->epsilon_initial_trials=9; c->epsilon_refinement_rounds=1; c->epsilon_refinement_factor=2; c->epsilon_min_interval_width=1e-6; c->epsilon_max_total_instances=32; c->epsilon_initial_precision=SDA_MPFR_DEFAULT_PRECISION; c->epsilon_max_precision=SDA_MPFR_DEFAULT_PRECISION*2; c->epsilon_deduplicate_q=1; }
+void sda_config_defaults(sda_config*c){ memset(c,0,sizeof*c); strcpy(c->solver,"epsilon-svp-generated"); strcpy(c->epsilon_schedule,"adaptive-transition"); c->support_min=0; c->mpfr_precision=SDA_MPFR_DEFAULT_PRECISION; c->renyi_order=513; c->epsilon_min=0.40; c->epsilon_max=0.65; c->epsilon_initial_trials=9; c->epsilon_refinement_rounds=1; c->epsilon_refinement_factor=2; c->epsilon_min_interval_width=1e-6; c->epsilon_max_total_instances=32; c->epsilon_initial_precision=SDA_MPFR_DEFAULT_PRECISION; c->epsilon_max_precision=SDA_MPFR_DEFAULT_PRECISION*2; c->epsilon_deduplicate_q=1; c->bkz_block_size=20; c->bkz_max_tours=8; }
 int sda_config_builtin(const char*n,sda_config*c){ sda_config_defaults(c); strcpy(c->scheme,(!strncmp(n,"falcon",6))?"Falcon":"Frodo"); strcpy(c->parameter_set,n); if(!strcmp(n,"frodo640")){c->sigma=2.8;c->support_max=12;c->precision_k=15; sda_parse_u128("14534",&c->manuscript_q);} else if(!strcmp(n,"frodo976")){c->sigma=2.3;c->support_max=10;c->precision_k=15;c->renyi_order=500; sda_parse_u128("7442",&c->manuscript_q);} else if(!strcmp(n,"frodo1344")){c->sigma=1.4;c->support_max=6;c->precision_k=15;c->renyi_order=1000; sda_parse_u128("102",&c->manuscript_q);} else if(!strcmp(n,"falcon")){c->sigma=1.8205;c->support_max=18;c->precision_k=72; sda_parse_u128("4696835740265763827900",&c->manuscript_q);} else return -1; return 0; }
-int sda_config_load(const char*path,sda_config*c){ FILE*f=fopen(path,"r"); if(!f)return-1; sda_config_defaults(c); char k[64],v[128]; while(fscanf(f," %63[^=]=%127s",k,v)==2){ if(!strcmp(k,"name"))strncpy(c->parameter_set,v,31); else if(!strcmp(k,"scheme"))strncpy(c->scheme,v,31); else if(!strcmp(k,"sigma"))c->sigma=strtod(v,0); else if(!strcmp(k,"support_min"))c->support_min=atoi(v); else if(!strcmp(k,"support_max"))c->support_max=atoi(v); else if(!strcmp(k,"precision_k"))c->precision_k=atoi(v); else if(!strcmp(k,"renyi_order"))c->renyi_order=atol(v); else if(!strcmp(k,"epsilon_min"))c->epsilon_min=strtod(v,0); else if(!strcmp(k,"epsilon_max"))c->epsilon_max=strtod(v,0); else if(!strcmp(k,"epsilon_initial_trials"))c->epsilon_initial_trials=atoi(v); else if(!strcmp(k,"epsilon_schedule"))strncpy(c->epsilon_schedule,v,31); else if(!strcmp(k,"epsilon_refinement_rounds"))c->epsilon_refinement_rounds=atoi(v); else if(!strcmp(k,"epsilon_refinement_factor"))c->epsilon_refinement_factor=atoi(v); else if(!strcmp(k,"epsilon_min_interval_width"))c->epsilon_min_interval_width=strtod(v,0); else if(!strcmp(k,"epsilon_max_total_instances"))c->epsilon_max_total_instances=atoi(v); else if(!strcmp(k,"epsilon_initial_precision"))c->epsilon_initial_precision=strtoul(v,0,10); else if(!strcmp(k,"epsilon_max_precision"))c->epsilon_max_precision=strtoul(v,0,10); else if(!strcmp(k,"epsilon_deduplicate_q"))c->epsilon_deduplicate_q=atoi(v); int ch; while((ch=fgetc(f))!='\n'&&ch!=EOF){} } fclose(f); return 0; }
+int sda_config_load(const char*path,sda_config*c){ FILE*f=fopen(path,"r"); if(!f)return-1; sda_config_defaults(c); char k[64],v[128]; while(fscanf(f," %63[^=]=%127s",k,v)==2){ if(!strcmp(k,"name"))strncpy(c->parameter_set,v,31); else if(!strcmp(k,"scheme"))strncpy(c->scheme,v,31); else if(!strcmp(k,"sigma"))c->sigma=strtod(v,0); else if(!strcmp(k,"support_min"))c->support_min=atoi(v); else if(!strcmp(k,"support_max"))c->support_max=atoi(v); else if(!strcmp(k,"precision_k"))c->precision_k=atoi(v); else if(!strcmp(k,"renyi_order"))c->renyi_order=atol(v); else if(!strcmp(k,"epsilon_min"))c->epsilon_min=strtod(v,0); else if(!strcmp(k,"epsilon_max"))c->epsilon_max=strtod(v,0); else if(!strcmp(k,"epsilon_initial_trials"))c->epsilon_initial_trials=atoi(v); else if(!strcmp(k,"epsilon_schedule"))strncpy(c->epsilon_schedule,v,31); else if(!strcmp(k,"epsilon_refinement_rounds"))c->epsilon_refinement_rounds=atoi(v); else if(!strcmp(k,"epsilon_refinement_factor"))c->epsilon_refinement_factor=atoi(v); else if(!strcmp(k,"epsilon_min_interval_width"))c->epsilon_min_interval_width=strtod(v,0); else if(!strcmp(k,"epsilon_max_total_instances"))c->epsilon_max_total_instances=atoi(v); else if(!strcmp(k,"epsilon_initial_precision"))c->epsilon_initial_precision=strtoul(v,0,10); else if(!strcmp(k,"epsilon_max_precision"))c->epsilon_max_precision=strtoul(v,0,10); else if(!strcmp(k,"epsilon_deduplicate_q"))c->epsilon_deduplicate_q=atoi(v); else if(!strcmp(k,"max_log2_renyi_minus_one"))c->max_log2_renyi_minus_one=strtod(v,0); else if(!strcmp(k,"bkz_block_size"))c->bkz_block_size=atoi(v); else if(!strcmp(k,"bkz_max_tours"))c->bkz_max_tours=atoi(v); int ch; while((ch=fgetc(f))!='\n'&&ch!=EOF){} } fclose(f); return 0; }
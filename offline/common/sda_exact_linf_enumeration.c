@@ -1,12 +1,78 @@
 #include "sda_exact_linf_enumeration.h"
+#include "sda_workspace.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
-static int is_zero_vec(mpz_t*x,size_t d){ for(size_t i=0;i<d;i++) if(mpz_sgn(x[i])) return 0; return 1; }
-static void compute_vec(mpfr_t*B,size_t d,mpz_t*x,mpfr_t*v,mpfr_t norm){ mpfr_set_ui(norm,0,MPFR_RNDU); mpfr_t t,a; mpfr_inits2(mpfr_get_prec(norm),t,a,(mpfr_ptr)0); for(size_t i=0;i<d;i++){ mpfr_set_ui(v[i],0,MPFR_RNDN); for(size_t j=i;j<d;j++){ mpfr_mul_z(t,B[i*d+j],x[j],MPFR_RNDN); mpfr_add(v[i],v[i],t,MPFR_RNDN);} mpfr_abs(a,v[i],MPFR_RNDU); if(mpfr_cmp(a,norm)>0) mpfr_set(norm,a,MPFR_RNDU);} mpfr_clears(t,a,(mpfr_ptr)0); }
-static int lex_better(mpz_t*a,mpz_t*b,size_t d){ for(size_t i=0;i<d;i++){ int c=mpz_cmp(a[i],b[i]); if(c) return c<0; } return 0; }
-static void rec(mpfr_t*B,size_t d,int l,mpz_t*x,sda_exact_linf_enum_result*r){ r->nodes_visited++; if(l<0){ if(is_zero_vec(x,d))return; r->leaves_visited++; mpfr_t nm; mpfr_init2(nm,r->precision_used); mpfr_t *v=calloc(d,sizeof(mpfr_t)); for(size_t i=0;i<d;i++) mpfr_init2(v[i],r->precision_used); compute_vec(B,d,x,v,nm); if(mpfr_cmp(nm,r->norm_upper)<0 || (mpfr_cmp(nm,r->norm_upper)==0 && lex_better(x,r->coefficients,d))){ for(size_t i=0;i<d;i++){ mpz_set(r->coefficients[i],x[i]); mpfr_set(r->shortest_vector[i],v[i],MPFR_RNDN);} mpfr_set(r->norm_lower,nm,MPFR_RNDD); mpfr_set(r->norm_upper,nm,MPFR_RNDU); mpfr_set(r->final_radius,nm,MPFR_RNDU);} for(size_t i=0;i<d;i++) mpfr_clear(v[i]); free(v); mpfr_clear(nm); return; }
- mpfr_t high,R,lo,hi,tmp; mpz_t zlo,zhi; mpfr_inits2(r->precision_used,high,R,lo,hi,tmp,(mpfr_ptr)0); mpz_inits(zlo,zhi,(mpz_ptr)0); mpfr_set(R,r->norm_upper,MPFR_RNDU); mpfr_set_ui(high,0,MPFR_RNDN); for(size_t j=(size_t)l+1;j<d;j++){ mpfr_mul_z(tmp,B[l*d+j],x[j],MPFR_RNDN); mpfr_add(high,high,tmp,MPFR_RNDN);} mpfr_neg(high,high,MPFR_RNDN); mpfr_sub(lo,high,R,MPFR_RNDD); mpfr_div(lo,lo,B[l*d+l],MPFR_RNDD); mpfr_get_z(zlo,lo,MPFR_RNDD); if(!mpfr_integer_p(lo)) mpz_add_ui(zlo,zlo,1); mpfr_add(hi,high,R,MPFR_RNDU); mpfr_div(hi,hi,B[l*d+l],MPFR_RNDU); mpfr_get_z(zhi,hi,MPFR_RNDD); for(mpz_t z; mpz_init_set(z,zlo), mpz_cmp(z,zhi)<=0; mpz_add_ui(z,z,1)){ mpz_set(x[l],z); rec(B,d,l-1,x,r); } mpz_set_ui(x[l],0); mpfr_clears(high,R,lo,hi,tmp,(mpfr_ptr)0); mpz_clears(zlo,zhi,(mpz_ptr)0); }
+
+/* Centers are kept below 2^61 and steps below 2^60, so coefficients fit a long. */
+#define CENTER_BITS 61
+#define STEP_BITS 60
+
+/* Zig-zag (Schnorr-Euchner) search state. sig[l*(d+1)+j] = sum_{k>=j} B[l][k]*x[k]
+ * is valid for j > dirty[l]; changing x[k] marks row k-1, and the mark follows
+ * the path down, so each row only re-adds the terms whose x changed. v[l] is the
+ * current coordinate B[l][l]*x[l] + sig[l][l+1] and pmax[l] the L-inf norm of
+ * v[l..d-1]. While every x above a level is zero (sym) the level only walks
+ * x >= 0: v and -v have the same norm. */
+typedef struct { mpfr_t *B; size_t d; mpfr_ptr *sig,*v,*pmax,R,c,a,lim; long x[SDA_EXACT_LINF_ENUM_MAX_DIM],dx[SDA_EXACT_LINF_ENUM_MAX_DIM],ddx[SDA_EXACT_LINF_ENUM_MAX_DIM],best[SDA_EXACT_LINF_ENUM_MAX_DIM]; size_t dirty[SDA_EXACT_LINF_ENUM_MAX_DIM]; unsigned char sym[SDA_EXACT_LINF_ENUM_MAX_DIM]; } enum_state;
+
+static void touch(enum_state *s,size_t l){ if(l&&s->dirty[l-1]<l) s->dirty[l-1]=l; }
+
+static int enter(enum_state *s,size_t l){
+  size_t d=s->d; mpfr_ptr *row=s->sig+l*(d+1);
+  if(l&&s->dirty[l-1]<s->dirty[l]) s->dirty[l-1]=s->dirty[l];
+  for(size_t j=s->dirty[l];j>l;j--){ mpfr_mul_si(s->a,s->B[l*d+j],s->x[j],MPFR_RNDN); mpfr_add(row[j],row[j+1],s->a,MPFR_RNDN); }
+  s->dirty[l]=l;
+  if(s->sym[l]){ s->x[l]=0; s->dx[l]=s->ddx[l]=1; touch(s,l); return 0; }
+  mpfr_div(s->c,row[l+1],s->B[l*d+l],MPFR_RNDN); mpfr_neg(s->c,s->c,MPFR_RNDN);
+  if(mpfr_cmpabs(s->c,s->lim)>=0) return -1;
+  s->x[l]=mpfr_get_si(s->c,MPFR_RNDN); s->dx[l]=s->ddx[l]=mpfr_cmp_si(s->c,s->x[l])>=0?1:-1; touch(s,l); return 0;
+}
+
+static void step(enum_state *s,size_t l){
+  if(s->sym[l]) s->x[l]++; else { s->x[l]+=s->dx[l]; s->ddx[l]=-s->ddx[l]; s->dx[l]=s->ddx[l]-s->dx[l]; }
+  touch(s,l);
+}
+
+/* Candidates are compared by norm, then by the lexicographically smaller of
+ * x and -x, which is the one whose first nonzero coefficient is negative. */
+static void leaf(enum_state *s,sda_exact_linf_enum_result *r){
+  size_t d=s->d,f=0; while(!s->x[f]) f++; long sg=s->x[f]<0?1:-1; int c=mpfr_cmp(s->pmax[0],s->R);
+  if(c==0){ size_t i=0; while(i<d&&sg*s->x[i]==s->best[i]) i++; if(i==d||sg*s->x[i]>s->best[i]) return; }
+  for(size_t i=0;i<d;i++){ s->best[i]=sg*s->x[i]; if(sg>0) mpfr_set(r->shortest_vector[i],s->v[i],MPFR_RNDN); else mpfr_neg(r->shortest_vector[i],s->v[i],MPFR_RNDN); }
+  mpfr_set(s->R,s->pmax[0],MPFR_RNDN);
+}
+
 void sda_exact_linf_enum_result_init(sda_exact_linf_enum_result*r,size_t d,mpfr_prec_t p){ memset(r,0,sizeof*r); strcpy(r->solver,"exact-linf-enumeration"); r->dimension=d; r->precision_used=p; r->coefficients=calloc(d,sizeof(mpz_t)); r->shortest_vector=calloc(d,sizeof(mpfr_t)); for(size_t i=0;i<d;i++){mpz_init(r->coefficients[i]); mpfr_init2(r->shortest_vector[i],p);} mpfr_inits2(p,r->norm_lower,r->norm_upper,r->initial_radius,r->final_radius,(mpfr_ptr)0); mpfr_set_inf(r->norm_lower,1); mpfr_set_inf(r->norm_upper,1); }
 void sda_exact_linf_enum_result_clear(sda_exact_linf_enum_result*r){ for(size_t i=0;i<r->dimension;i++){mpz_clear(r->coefficients[i]); mpfr_clear(r->shortest_vector[i]);} free(r->coefficients); free(r->shortest_vector); mpfr_clears(r->norm_lower,r->norm_upper,r->initial_radius,r->final_radius,(mpfr_ptr)0); }
-int sda_exact_linf_enumerate(mpfr_t*B,size_t d,mpfr_prec_t p,sda_exact_linf_enum_result*r){ if(!B||!r||!d||d>16){snprintf(r->failure_reason,sizeof r->failure_reason,"invalid input");return -1;} for(size_t i=0;i<d;i++){ for(size_t j=0;j<i;j++) if(mpfr_sgn(B[i*d+j])) return -2; if(mpfr_sgn(B[i*d+i])<=0) return -3; } mpfr_set_ui(r->norm_upper,64,MPFR_RNDU); mpfr_set(r->initial_radius,r->norm_upper,MPFR_RNDU); mpz_t*x=calloc(d,sizeof(mpz_t)); for(size_t i=0;i<d;i++) mpz_init(x[i]); rec(B,d,(int)d-1,x,r); for(size_t i=0;i<d;i++) mpz_clear(x[i]); free(x); r->search_space_exhausted=1; r->nearest_integer_certified=1; r->norm_comparisons_certified=1; r->interval_certified=1; r->global_svp_certified=1; snprintf(r->failure_reason,sizeof r->failure_reason,"interval-certified"); return 0; }
+
+int sda_exact_linf_enumerate(mpfr_t*B,size_t d,mpfr_prec_t p,sda_exact_linf_enum_result*r){
+  (void)p; if(!r) return -1;
+  if(!B||!d||d>SDA_EXACT_LINF_ENUM_MAX_DIM||r->dimension!=d){ snprintf(r->failure_reason,sizeof r->failure_reason,"invalid input"); return -1; }
+  for(size_t i=0;i<d;i++){ for(size_t j=0;j<i;j++) if(mpfr_sgn(B[i*d+j])){ snprintf(r->failure_reason,sizeof r->failure_reason,"basis not upper triangular"); return -2; } if(mpfr_sgn(B[i*d+i])<=0){ snprintf(r->failure_reason,sizeof r->failure_reason,"non-positive diagonal"); return -3; } }
+  mpfr_prec_t pr=r->precision_used; enum_state *s=calloc(1,sizeof *s); mpfr_ptr *slots=s?malloc((d*(d+1)+2*d+1)*sizeof *slots):0;
+  if(!slots){ free(s); snprintf(r->failure_reason,sizeof r->failure_reason,"allocation failed"); return -5; }
+  sda_workspace *ws=sda_ws_local(); size_t mk=sda_ws_mark(ws); s->B=B; s->d=d; s->sig=slots; s->v=slots+d*(d+1); s->pmax=s->v+d;
+  for(size_t i=0;i<d*(d+1)+2*d+1;i++){ slots[i]=sda_ws_mpfr(ws,pr); mpfr_set_zero(slots[i],0); }
+  s->R=sda_ws_mpfr(ws,pr); s->c=sda_ws_mpfr(ws,pr); s->a=sda_ws_mpfr(ws,pr); s->lim=sda_ws_mpfr(ws,pr);
+  /* Seed with the shortest basis column (lowest index on ties, as -e_i). */
+  size_t seed=0; for(size_t i=0;i<d;i++){ mpfr_set_zero(s->c,0); for(size_t k=0;k<=i;k++){ mpfr_abs(s->a,B[k*d+i],MPFR_RNDN); mpfr_max(s->c,s->c,s->a,MPFR_RNDN); } if(!i||mpfr_cmp(s->c,s->R)<0){ mpfr_set(s->R,s->c,MPFR_RNDN); seed=i; } }
+  s->best[seed]=-1; for(size_t i=0;i<d;i++) if(i<=seed) mpfr_neg(r->shortest_vector[i],B[i*d+seed],MPFR_RNDN); else mpfr_set_zero(r->shortest_vector[i],0);
+  mpfr_set(r->initial_radius,s->R,MPFR_RNDU);
+  int rc=0; mpfr_set_ui_2exp(s->lim,1,STEP_BITS,MPFR_RNDN); for(size_t l=0;l<d&&!rc;l++){ mpfr_div(s->a,s->R,B[l*d+l],MPFR_RNDU); if(mpfr_cmp(s->a,s->lim)>=0) rc=-4; }
+  mpfr_set_ui_2exp(s->lim,1,CENTER_BITS,MPFR_RNDN); for(size_t l=0;l<d;l++) s->dirty[l]=l;
+  size_t l=d-1; s->sym[l]=1; if(!rc) rc=enter(s,l);
+  while(!rc){
+    mpfr_mul_si(s->v[l],B[l*d+l],s->x[l],MPFR_RNDN); mpfr_add(s->v[l],s->v[l],s->sig[l*(d+1)+l+1],MPFR_RNDN); mpfr_abs(s->a,s->v[l],MPFR_RNDN);
+    if(mpfr_cmp(s->a,s->R)>0){ r->branches_pruned++; if(++l==d) break; step(s,l); continue; }
+    r->nodes_visited++; mpfr_max(s->pmax[l],s->pmax[l+1],s->a,MPFR_RNDN);
+    if(l){ s->sym[l-1]=s->sym[l]&&!s->x[l]; rc=enter(s,--l); continue; }
+    if(!s->sym[0]||s->x[0]){ r->leaves_visited++; leaf(s,r); }
+    step(s,0);
+  }
+  for(size_t i=0;i<d;i++) mpz_set_si(r->coefficients[i],s->best[i]);
+  mpfr_set(r->norm_lower,s->R,MPFR_RNDD); mpfr_set(r->norm_upper,s->R,MPFR_RNDU); mpfr_set(r->final_radius,s->R,MPFR_RNDU);
+  sda_ws_release(ws,mk); free(slots); free(s);
+  if(rc){ snprintf(r->failure_reason,sizeof r->failure_reason,"coefficient range exceeds %d bits",CENTER_BITS); return -4; }
+  r->search_space_exhausted=1; r->nearest_integer_certified=1; r->norm_comparisons_certified=1; r->interval_certified=1; r->global_svp_certified=1; snprintf(r->failure_reason,sizeof r->failure_reason,"interval-certified"); return 0;
+}
@@ -3,14 +3,23 @@
 #include <stddef.h>
 #include <mpfr.h>
 #include <gmp.h>
+#define SDA_EXACT_LINF_ENUM_MAX_DIM 64
 typedef struct {
   char solver[40]; size_t dimension; mpfr_prec_t precision_used; unsigned precision_escalations;
   mpz_t *coefficients; mpfr_t *shortest_vector; mpfr_t norm_lower,norm_upper,initial_radius,final_radius;
-  unsigned long long nodes_visited,leaves_visited,branches_pruned;
+  unsigned long long nodes_visited,leaves_visited,branches_pruned; /* partial assignments within the radius, nonzero full vectors evaluated, assignments cut by the radius */
   int search_space_exhausted,nearest_integer_certified,norm_comparisons_certified,interval_certified,global_svp_certified;
   char failure_reason[160];
 } sda_exact_linf_enum_result;
 void sda_exact_linf_enum_result_init(sda_exact_linf_enum_result*r,size_t d,mpfr_prec_t p);
 void sda_exact_linf_enum_result_clear(sda_exact_linf_enum_result*r);
+/* Shortest nonzero vector in L-inf of the lattice spanned by the columns of the
+ * upper-triangular d x d basis B (row-major, positive diagonal), 1 <= d <=
+ * SDA_EXACT_LINF_ENUM_MAX_DIM, r initialised for dimension d. Iterative
+ * Schnorr-Euchner enumeration at r->precision_used, seeded with the shortest
+ * basis column; the radius shrinks to each improvement. Among vectors of equal
+ * norm the lexicographically smallest coefficient vector wins. Returns 0, -1
+ * invalid input, -2 not upper triangular, -3 non-positive diagonal, -4 a center
+ * or search range too wide for long coefficients, -5 allocation failure. */
 int sda_exact_linf_enumerate(mpfr_t *B,size_t d,mpfr_prec_t p,sda_exact_linf_enum_result*r);
 #endif
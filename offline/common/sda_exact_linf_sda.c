@@ -1,36 +1,45 @@
 #include "sda_exact_linf_sda.h"
 #include "sda_interval.h"
+#include "sda_workspace.h"
 #include <string.h>
 #include <stdio.h>
 #include <gmp.h>
+#include <math.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 static void set_u128(mpfr_t r, sda_u128 v){ mpfr_set_ui_2exp(r,(unsigned long)(v>>64),64,MPFR_RNDN); mpfr_add_ui(r,r,(unsigned long)v,MPFR_RNDN); }
+static void mpz_set_u128_local(mpz_t z, sda_u128 v){ unsigned char buf[16]; for(size_t i=0;i<16;i++) buf[i]=(unsigned char)(v>>(8*i)); mpz_import(z,16,-1,1,0,0,buf); }
 static sda_u128 mpz_get_u128_local(const mpz_t z){ unsigned char buf[16]={0}; size_t n=0; mpz_export(buf,&n,-1,1,0,0,z); sda_u128 v=0; for(size_t i=0;i<n&&i<16;i++) v|=((sda_u128)buf[i])<<(8*i); return v; }
 
 void sda_exact_linf_sda_init(sda_exact_linf_sda_result *r, size_t n, mpfr_prec_t prec){ memset(r,0,sizeof *r); r->n=n; r->precision=prec; mpfr_inits2(prec,r->epsilon,r->C,r->norm_lower,r->norm_upper,(mpfr_ptr)0); }
 void sda_exact_linf_sda_clear(sda_exact_linf_sda_result *r){ mpfr_clears(r->epsilon,r->C,r->norm_lower,r->norm_upper,(mpfr_ptr)0); }
 
 static int certified_nearest(mpfr_t alpha, sda_u128 q, sda_u128 *out, int *tie){
-  mpfr_prec_t pr=mpfr_get_prec(alpha); mpfr_t qq,lo,hi,mid,fl,half,lowb,highb; mpz_t z;
-  mpfr_inits2(pr,qq,lo,hi,mid,fl,half,lowb,highb,(mpfr_ptr)0); mpz_init(z); *tie=0;
+  mpfr_prec_t pr=mpfr_get_prec(alpha); sda_workspace *ws=sda_ws_local(); size_t mk=sda_ws_mark(ws);
+  mpfr_ptr qq=sda_ws_mpfr(ws,pr),lo=sda_ws_mpfr(ws,pr),hi=sda_ws_mpfr(ws,pr),mid=sda_ws_mpfr(ws,pr),fl=sda_ws_mpfr(ws,pr),half=sda_ws_mpfr(ws,pr),lowb=sda_ws_mpfr(ws,pr),highb=sda_ws_mpfr(ws,pr); mpz_ptr z=sda_ws_mpz(ws); *tie=0;
   set_u128(qq,q); mpfr_mul(lo,qq,alpha,MPFR_RNDD); mpfr_mul(hi,qq,alpha,MPFR_RNDU); mpfr_add(mid,lo,hi,MPFR_RNDN); mpfr_div_ui(mid,mid,2,MPFR_RNDN);
   mpfr_floor(fl,mid); mpfr_sub(lowb,mid,fl,MPFR_RNDN); mpfr_set_d(half,0.5,MPFR_RNDN); if(mpfr_cmp(lowb,half)>=0) mpfr_add_ui(fl,fl,1,MPFR_RNDN);
   mpfr_get_z(z,fl,MPFR_RNDN); *out=mpz_get_u128_local(z);
   mpfr_sub_d(lowb,fl,0.5,MPFR_RNDD); mpfr_add_d(highb,fl,0.5,MPFR_RNDU);
   int cert=(mpfr_cmp(lo,lowb)>0 && mpfr_cmp(hi,highb)<0);
   if(!cert){ *tie=1; cert=1; }
-  mpz_clear(z); mpfr_clears(qq,lo,hi,mid,fl,half,lowb,highb,(mpfr_ptr)0); return cert;
+  sda_ws_release(ws,mk); return cert;
 }
 
 static void norm_interval(mpfr_t *alpha,size_t n,sda_u128 q,const sda_u128*p,const mpfr_t C,mpfr_t lo_out,mpfr_t hi_out,int *cert){
-  mpfr_prec_t pr=mpfr_get_prec(lo_out); sda_mpfr_interval ai,y,pp,d,ad,maxd,ci,prod,qi,fn; mpz_t z;
-  sda_interval_init(&ai,pr); sda_interval_init(&y,pr); sda_interval_init(&pp,pr); sda_interval_init(&d,pr); sda_interval_init(&ad,pr); sda_interval_init(&maxd,pr); sda_interval_init(&ci,pr); sda_interval_init(&prod,pr); sda_interval_init(&qi,pr); sda_interval_init(&fn,pr); mpz_init(z);
-  sda_interval_set(&ci,C); sda_interval_set_ui(&maxd,0);
+  mpfr_prec_t pr=mpfr_get_prec(lo_out); sda_workspace *ws=sda_ws_local(); size_t mk=sda_ws_mark(ws);
+  sda_mpfr_interval *ai=sda_ws_interval(ws,pr),*y=sda_ws_interval(ws,pr),*pp=sda_ws_interval(ws,pr),*d=sda_ws_interval(ws,pr),*ad=sda_ws_interval(ws,pr),*maxd=sda_ws_interval(ws,pr),*ci=sda_ws_interval(ws,pr),*prod=sda_ws_interval(ws,pr),*qi=sda_ws_interval(ws,pr),*fn=sda_ws_interval(ws,pr); mpz_ptr z=sda_ws_mpz(ws),zp=sda_ws_mpz(ws);
+  sda_interval_set(ci,C); sda_interval_set_ui(maxd,0); mpz_set_u128_local(z,q); mpfr_set_z(qi->lo,z,MPFR_RNDD); mpfr_set_z(qi->hi,z,MPFR_RNDU);
   for(size_t i=0;i<n;i++){
-    sda_interval_set(&ai,alpha[i]); mpz_set_ui(z,(unsigned long)q); sda_interval_mul_z(&y,&ai,z); sda_interval_set_ui(&pp,(unsigned long)p[i]); sda_interval_sub(&d,&pp,&y); sda_interval_abs(&ad,&d); sda_interval_max(&maxd,&maxd,&ad);
+    sda_interval_set(ai,alpha[i]); sda_interval_mul_z(y,ai,z); mpz_set_u128_local(zp,p[i]); mpfr_set_z(pp->lo,zp,MPFR_RNDD); mpfr_set_z(pp->hi,zp,MPFR_RNDU); sda_interval_sub(d,pp,y); sda_interval_abs(ad,d); sda_interval_max(maxd,maxd,ad);
   }
-  sda_interval_mul(&prod,&ci,&maxd); sda_interval_set_ui(&qi,(unsigned long)q); sda_interval_max(&fn,&prod,&qi); mpfr_set(lo_out,fn.lo,MPFR_RNDD); mpfr_set(hi_out,fn.hi,MPFR_RNDU); if(mpfr_cmp(lo_out,hi_out)>0)*cert=0;
-  mpz_clear(z); sda_interval_clear(&ai); sda_interval_clear(&y); sda_interval_clear(&pp); sda_interval_clear(&d); sda_interval_clear(&ad); sda_interval_clear(&maxd); sda_interval_clear(&ci); sda_interval_clear(&prod); sda_interval_clear(&qi); sda_interval_clear(&fn);
+  sda_interval_mul(prod,ci,maxd); sda_interval_max(fn,prod,qi); mpfr_set(lo_out,fn->lo,MPFR_RNDD); mpfr_set(hi_out,fn->hi,MPFR_RNDU); if(mpfr_cmp(lo_out,hi_out)>0)*cert=0;
+  sda_ws_release(ws,mk);
 }
 
 static int nearest_vector_interval(mpfr_t *alpha,size_t n,sda_u128 q,mpfr_t C,sda_u128 *p,mpfr_t norm_lo,mpfr_t norm_hi,unsigned long long *ties){
@@ -38,6 +47,81 @@ static int nearest_vector_interval(mpfr_t *alpha,size_t n,sda_u128 q,mpfr_t C,sd
   norm_interval(alpha,n,q,p,C,norm_lo,norm_hi,&dummy); return all&&dummy;
 }
 
+/* Fixed-point tier: a[i] = floor(alpha_i * 2^PF_BITS), so q*alpha_i lies in
+ * [q*a[i], q*a[i] + q) units of 2^-PF_BITS for q < 2^24. When that interval sits
+ * strictly between two half-integers for every coordinate, certified_nearest
+ * would return the same integer and no tie, and max(C * max_i dist_i, q) has a
+ * rigorous lower bound; if the bound already reaches norm_lower, the MPFR
+ * upper bound cannot fall below it and q is rejected here. Anything closer to
+ * a half-integer, or a bound that does not reject, goes to the MPFR path. The
+ * MPFR precision must leave rounding well below 2^-PF_BITS. */
+#define PF_BITS 100
+typedef struct { int on; double c_lo; sda_u128 a[32]; } prefilter;
+
+static void prefilter_init(prefilter *f, mpfr_t *alpha, size_t n, const mpfr_t C){
+  f->on=1; f->c_lo=mpfr_get_d(C,MPFR_RNDD); mpfr_t t; mpz_t z; mpfr_init2(t,mpfr_get_prec(alpha[0])); mpz_init(z);
+  for(size_t i=0;i<n&&f->on;i++){ if(mpfr_get_prec(alpha[i])<160||!mpfr_number_p(alpha[i])||mpfr_sgn(alpha[i])<0||mpfr_cmp_ui(alpha[i],1)>=0){ f->on=0; break; } mpfr_set_prec(t,mpfr_get_prec(alpha[i])); mpfr_mul_2ui(t,alpha[i],PF_BITS,MPFR_RNDN); mpfr_get_z(z,t,MPFR_RNDD); f->a[i]=mpz_get_u128_local(z); }
+  mpz_clear(z); mpfr_clear(t);
+}
+
+static int prefilter_reject(const prefilter *f, size_t n, unsigned long q, double norm_lower_up){
+  const sda_u128 half=(sda_u128)1<<(PF_BITS-1); sda_u128 dmax=0;
+  for(size_t i=0;i<n;i++){
+    sda_u128 lo=(sda_u128)q*f->a[i], hi=lo+q, k=(lo+half)>>PF_BITS<<PF_BITS;
+    if(lo+half==k||hi>=k+half) return 0;
+    sda_u128 d=lo>=k?lo-k:(hi<=k?k-hi:0); if(d>dmax) dmax=d;
+  }
+  if((double)q>=norm_lower_up) return 1;
+  return f->c_lo*ldexp((double)dmax,-PF_BITS)*(1.0-0x1p-50)>=norm_lower_up;
+}
+
+/* Parallel enumeration. Workers claim ascending blocks of LINF_BLOCK values of
+ * q from a shared counter and keep only the q that might be accepted: q is
+ * dropped when hi(q) >= lo of the starting bound, or >= hi(q') for some
+ * evaluated q' < q, because the sequential best at q is then already at least
+ * as good. q' is the worker's own last survivor or the globally published
+ * one, packed as (float bits of hi rounded up) << 32 | q' and lowered with a
+ * CAS. Each survivor also caps the range, since no limit the sequential loop
+ * reaches exceeds floor(hi(q')) + 2. Replaying the survivors in q order with
+ * the sequential rule then gives the same q, p[] and limit for any number of
+ * workers, and q_enumerated, half_integer_ties and the certification flags
+ * follow from the per-q records up to the last q the sequential loop visits. */
+#define LINF_BLOCK 1024ul
+#define LINF_MAX_THREADS 256u
+typedef struct { unsigned long q; sda_u128 p[32]; mpfr_t lo, hi; } linf_survivor;
+typedef struct {
+  mpfr_t *alpha; size_t n; sda_exact_linf_sda_result *r; const prefilter *pf;
+  atomic_ulong *next, *stop; _Atomic uint64_t *published; unsigned char *ties;
+  linf_survivor *surv; size_t count, cap; unsigned long first_uncertified; unsigned long long rejections; int failed;
+} linf_worker;
+
+static void publish_bound(linf_worker *w, const mpfr_t hi, unsigned long q){
+  double d=mpfr_get_d(hi,MPFR_RNDU); float f=(float)d; if((double)f<d) f=nextafterf(f,INFINITY); if(!isfinite(f)) return;
+  uint32_t bits; memcpy(&bits,&f,sizeof bits); uint64_t key=(uint64_t)bits<<32|q, cur=atomic_load(w->published);
+  while(key<cur && !atomic_compare_exchange_weak(w->published,&cur,key)) {}
+  unsigned long cap=(unsigned long)floor(d)+2, st=atomic_load(w->stop);
+  while(cap<st && !atomic_compare_exchange_weak(w->stop,&st,cap)) {}
+}
+
+static void *linf_run(void *arg){
+  linf_worker *w=arg; sda_exact_linf_sda_result *r=w->r; size_t n=w->n; mpfr_t lo,hi,local; sda_u128 pp[32];
+  mpfr_inits2(r->precision,lo,hi,local,(mpfr_ptr)0); mpfr_set(local,r->norm_lower,MPFR_RNDD); double local_up=mpfr_get_d(local,MPFR_RNDU);
+  for(unsigned long s; !w->failed && (s=atomic_fetch_add(w->next,LINF_BLOCK))<atomic_load(w->stop); )
+    for(unsigned long q=s; q<s+LINF_BLOCK && q<atomic_load(w->stop); q++){
+      uint64_t g=atomic_load(w->published); double bound=local_up; float gf=INFINITY;
+      if((unsigned long)(g&0xffffffffu)<q){ uint32_t bits=(uint32_t)(g>>32); memcpy(&gf,&bits,sizeof gf); if(gf<bound) bound=gf; }
+      if(w->pf->on && prefilter_reject(w->pf,n,q,bound)){ w->rejections++; continue; }
+      unsigned long long t=0; if(!nearest_vector_interval(w->alpha,n,(sda_u128)q,r->C,pp,lo,hi,&t) && q<w->first_uncertified) w->first_uncertified=q; w->ties[q]=(unsigned char)t;
+      if(mpfr_cmp(hi,local)>=0 || mpfr_cmp_d(hi,(double)gf)>=0) continue;
+      if(w->count==w->cap){ size_t cap=w->cap?2*w->cap:16; linf_survivor *v=realloc(w->surv,cap*sizeof *v); if(!v){ w->failed=1; break; } w->surv=v; w->cap=cap; }
+      linf_survivor *sv=&w->surv[w->count++]; sv->q=q; memcpy(sv->p,pp,sizeof pp); mpfr_inits2(r->precision,sv->lo,sv->hi,(mpfr_ptr)0); mpfr_set(sv->lo,lo,MPFR_RNDD); mpfr_set(sv->hi,hi,MPFR_RNDU);
+      mpfr_set(local,hi,MPFR_RNDU); local_up=mpfr_get_d(local,MPFR_RNDU); publish_bound(w,hi,q);
+    }
+  mpfr_clears(lo,hi,local,(mpfr_ptr)0); return 0;
+}
+static void *linf_thread(void *arg){ linf_run(arg); mpfr_free_cache(); return 0; }
+static int survivor_cmp(const void *a, const void *b){ unsigned long x=(*(linf_survivor *const *)a)->q, y=(*(linf_survivor *const *)b)->q; return x<y?-1:x>y; }
+
 int sda_exact_linf_sda_solve(mpfr_t *alpha, size_t n, mpfr_t epsilon, sda_u128 initial_q, sda_exact_linf_sda_result *r){
   if(!alpha||!r||!n||n>32||mpfr_sgn(epsilon)<=0||mpfr_cmp_ui(epsilon,1)>=0){ if(r) snprintf(r->failure_reason,sizeof r->failure_reason,"invalid input"); return -1; }
   mpfr_set(r->epsilon,epsilon,MPFR_RNDD); mpfr_ui_div(r->C,1,epsilon,MPFR_RNDU); mpfr_pow_ui(r->C,r->C,(unsigned long)(n+1),MPFR_RNDU);
@@ -46,12 +130,31 @@ int sda_exact_linf_sda_solve(mpfr_t *alpha, size_t n, mpfr_t epsilon, sda_u128 i
   if(initial_q>0){ nearest_all&=nearest_vector_interval(alpha,n,initial_q,r->C,r->p,cand_lo,cand_hi,&r->half_integer_ties); mpfr_set(r->norm_lower,cand_lo,MPFR_RNDD); mpfr_set(r->norm_upper,cand_hi,MPFR_RNDU); r->q=initial_q; }
   unsigned long limit=mpfr_get_ui(r->norm_upper,MPFR_RNDU); if(!mpfr_integer_p(r->norm_upper)) limit++; if(limit<2) limit=2; if(limit>10000000UL){ snprintf(r->failure_reason,sizeof r->failure_reason,"enumeration bound too large"); mpfr_clears(cand_lo,cand_hi,(mpfr_ptr)0); return -2; }
   r->q_search_lower=1; r->q_search_upper=limit-1;
-  for(unsigned long q=1;q<limit;q++){
-    sda_u128 pp[32]; int cert=nearest_vector_interval(alpha,n,(sda_u128)q,r->C,pp,cand_lo,cand_hi,&r->half_integer_ties); nearest_all&=cert; r->q_enumerated++; r->candidates_evaluated++;
-    if(mpfr_cmp(cand_hi,r->norm_lower)<0){ r->q=(sda_u128)q; for(size_t i=0;i<n;i++) r->p[i]=pp[i]; mpfr_set(r->norm_lower,cand_lo,MPFR_RNDD); mpfr_set(r->norm_upper,cand_hi,MPFR_RNDU); unsigned long nl=mpfr_get_ui(r->norm_upper,MPFR_RNDU); if(!mpfr_integer_p(r->norm_upper)) nl++; if(nl<limit){ limit=nl; r->q_search_upper=limit-1; } }
+  prefilter pf; prefilter_init(&pf,alpha,n,r->C); if(r->mpfr_only||limit>(1UL<<24)) pf.on=0;
+  unsigned k=r->threads; if(!k){ long c=sysconf(_SC_NPROCESSORS_ONLN); k=c>0?(unsigned)c:1u; } if(k>LINF_MAX_THREADS) k=LINF_MAX_THREADS; if(k>(limit+LINF_BLOCK-1)/LINF_BLOCK) k=(unsigned)((limit+LINF_BLOCK-1)/LINF_BLOCK);
+  unsigned char *ties=calloc(limit,1); atomic_ulong next=1, stop=limit; _Atomic uint64_t published=UINT64_MAX; linf_worker w[LINF_MAX_THREADS]; pthread_t tid[LINF_MAX_THREADS]; unsigned started=1;
+  if(!ties){ snprintf(r->failure_reason,sizeof r->failure_reason,"allocation failed"); mpfr_clears(cand_lo,cand_hi,(mpfr_ptr)0); return -3; }
+  for(unsigned i=0;i<k;i++) w[i]=(linf_worker){.alpha=alpha,.n=n,.r=r,.pf=&pf,.next=&next,.stop=&stop,.published=&published,.ties=ties,.first_uncertified=ULONG_MAX};
+  for(unsigned i=1;i<k;i++){ if(pthread_create(&tid[i],0,linf_thread,&w[i])) break; started++; }
+  linf_run(&w[0]); for(unsigned i=1;i<started;i++) pthread_join(tid[i],0);
+  size_t total=0; int failed=0; unsigned long first_uncertified=ULONG_MAX; for(unsigned i=0;i<started;i++){ total+=w[i].count; failed|=w[i].failed; r->prefilter_rejections+=w[i].rejections; if(w[i].first_uncertified<first_uncertified) first_uncertified=w[i].first_uncertified; }
+  linf_survivor **order=malloc((total?total:1)*sizeof *order); size_t m=0; if(order) for(unsigned i=0;i<started;i++) for(size_t j=0;j<w[i].count;j++) order[m++]=&w[i].surv[j];
+  if(!order||failed){ snprintf(r->failure_reason,sizeof r->failure_reason,"allocation failed"); norm_cert=0; }
+  else {
+    qsort(order,m,sizeof *order,survivor_cmp); unsigned long q_final=0;
+    for(size_t j=0;j<m&&order[j]->q<limit;j++) if(mpfr_cmp(order[j]->hi,r->norm_lower)<0){ linf_survivor *sv=order[j]; q_final=sv->q; r->q=(sda_u128)sv->q; for(size_t i=0;i<n;i++) r->p[i]=sv->p[i]; mpfr_set(r->norm_lower,sv->lo,MPFR_RNDD); mpfr_set(r->norm_upper,sv->hi,MPFR_RNDU); unsigned long nl=mpfr_get_ui(r->norm_upper,MPFR_RNDU); if(!mpfr_integer_p(r->norm_upper)) nl++; if(nl<limit){ limit=nl; r->q_search_upper=limit-1; } }
+    unsigned long last=q_final>limit-1?q_final:limit-1; r->q_enumerated+=last; r->candidates_evaluated+=last; for(unsigned long q=1;q<=last;q++) r->half_integer_ties+=ties[q]; if(first_uncertified<=last) nearest_all=0;
   }
-  r->search_space_exhausted=1; r->nearest_integer_certified=nearest_all; r->norm_comparisons_certified=norm_cert; r->interval_certified=nearest_all&&norm_cert; r->exact_linf_svp=r->interval_certified; r->global_svp_certified=r->search_space_exhausted&&r->interval_certified; r->high_precision_verified=1; r->formal_certificate_valid=r->global_svp_certified;
-  snprintf(r->failure_reason,sizeof r->failure_reason,"%s q_range=[%lu,%lu] ties=%llu", r->global_svp_certified?"interval-certified":"certification-unresolved", r->q_search_lower,r->q_search_upper,r->half_integer_ties);
+  for(unsigned i=0;i<started;i++){ for(size_t j=0;j<w[i].count;j++) mpfr_clears(w[i].surv[j].lo,w[i].surv[j].hi,(mpfr_ptr)0); free(w[i].surv); } free(order); free(ties);
+  r->search_space_exhausted=norm_cert; r->nearest_integer_certified=nearest_all; r->norm_comparisons_certified=norm_cert; r->interval_certified=nearest_all&&norm_cert; r->exact_linf_svp=r->interval_certified; r->global_svp_certified=r->search_space_exhausted&&r->interval_certified; r->high_precision_verified=1; r->formal_certificate_valid=r->global_svp_certified;
+  if(norm_cert) snprintf(r->failure_reason,sizeof r->failure_reason,"%s q_range=[%lu,%lu] ties=%llu", r->global_svp_certified?"interval-certified":"certification-unresolved", r->q_search_lower,r->q_search_upper,r->half_integer_ties);
   mpfr_clears(cand_lo,cand_hi,(mpfr_ptr)0); return r->global_svp_certified?0:-5;
 }
+int sda_exact_linf_sda_evaluate(mpfr_t *alpha, size_t n, mpfr_t epsilon, sda_u128 q, sda_exact_linf_sda_result *r){
+  if(!alpha||!r||!n||n>32||!q||mpfr_sgn(epsilon)<=0||mpfr_cmp_ui(epsilon,1)>=0){ if(r) snprintf(r->failure_reason,sizeof r->failure_reason,"invalid input"); return -1; }
+  mpfr_set(r->epsilon,epsilon,MPFR_RNDD); mpfr_ui_div(r->C,1,epsilon,MPFR_RNDU); mpfr_pow_ui(r->C,r->C,(unsigned long)(n+1),MPFR_RNDU); r->q=q;
+  int ok=nearest_vector_interval(alpha,n,q,r->C,r->p,r->norm_lower,r->norm_upper,&r->half_integer_ties); r->candidates_evaluated++;
+  r->search_space_exhausted=0; r->nearest_integer_certified=ok; r->norm_comparisons_certified=ok; r->interval_certified=ok; r->exact_linf_svp=0; r->global_svp_certified=0; r->high_precision_verified=1; r->formal_certificate_valid=0;
+  snprintf(r->failure_reason,sizeof r->failure_reason,"%s single-q ties=%llu",ok?"interval-evaluated":"certification-unresolved",r->half_integer_ties); return ok?0:-5;
+}
 int sda_exact_linf_sda_verify(mpfr_t *alpha, size_t n, const sda_exact_linf_sda_result *r){ (void)alpha; return (!r||n!=r->n||!r->global_svp_certified||!r->interval_certified)?-1:0; }
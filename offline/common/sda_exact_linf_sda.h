@@ -16,6 +16,7 @@ typedef struct {
   unsigned long long q_enumerated;
   unsigned long long candidates_evaluated;
   unsigned long long half_integer_ties;
+  unsigned long long prefilter_rejections;
   unsigned precision_escalations;
   unsigned long q_search_lower;
   unsigned long q_search_upper;
@@ -28,11 +29,24 @@ typedef struct {
   int global_svp_certified;
   int high_precision_verified;
   int formal_certificate_valid;
+  int mpfr_only;
+  unsigned threads;
   char failure_reason[160];
 } sda_exact_linf_sda_result;
+/* sda_exact_linf_sda_solve screens each q with a fixed-point bound first and
+ * runs the MPFR interval path only when that bound cannot reject q; the result
+ * is the same either way. Set mpfr_only after init to evaluate every q with
+ * MPFR; prefilter_rejections counts the q rejected by the fixed-point tier.
+ * The q range is enumerated on `threads` workers (0: one per online CPU); the
+ * result, q_enumerated and half_integer_ties do not depend on that number,
+ * prefilter_rejections does. */
 
 void sda_exact_linf_sda_init(sda_exact_linf_sda_result *r, size_t n, mpfr_prec_t prec);
 void sda_exact_linf_sda_clear(sda_exact_linf_sda_result *r);
 int sda_exact_linf_sda_solve(mpfr_t *alpha, size_t n, mpfr_t epsilon, sda_u128 initial_q, sda_exact_linf_sda_result *r);
+/* Interval evaluation of one given q, e.g. a denominator proposed by lattice
+ * reduction: certified nearest p, norm bounds and the interval flags. Nothing is
+ * claimed about other q, so exact_linf_svp and global_svp_certified stay 0. */
+int sda_exact_linf_sda_evaluate(mpfr_t *alpha, size_t n, mpfr_t epsilon, sda_u128 q, sda_exact_linf_sda_result *r);
 int sda_exact_linf_sda_verify(mpfr_t *alpha, size_t n, const sda_exact_linf_sda_result *r);
 #endif
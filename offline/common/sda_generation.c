@@ -1,24 +1,29 @@
 #include <stdio.h>
 #include "sda_generation.h"
+#include "sda_workspace.h"
 #include "sda_metrics.h"
 #include "sda_lll.h"
 #include "sda_exact_linf_sda.h"
 #include "sda_baseline.h"
+#include "sda_trace.h"
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
 #include <math.h>
 #include <gmp.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
 static void set_u128(mpfr_t r,sda_u128 v){ mpfr_set_ui_2exp(r,(unsigned long)(v>>64),64,MPFR_RNDN); mpfr_add_ui(r,r,(unsigned long)v,MPFR_RNDN); }
-static sda_u128 mpfr_floor_u128(mpfr_t x){ mpz_t z; mpz_init(z); mpfr_get_z(z,x,MPFR_RNDD); unsigned char buf[16]={0}; size_t n=0; mpz_export(buf,&n,-1,1,0,0,z); sda_u128 v=0; for(size_t i=0;i<n && i<16;i++) v|=((sda_u128)buf[i])<<(8*i); mpz_clear(z); return v; }
+static sda_u128 mpfr_floor_u128(mpfr_t x){ sda_workspace *ws=sda_ws_local(); size_t mk=sda_ws_mark(ws); mpz_ptr z=sda_ws_mpz(ws); mpfr_get_z(z,x,MPFR_RNDD); unsigned char buf[16]={0}; size_t n=0; mpz_export(buf,&n,-1,1,0,0,z); sda_u128 v=0; for(size_t i=0;i<n && i<16;i++) v|=((sda_u128)buf[i])<<(8*i); sda_ws_release(ws,mk); return v; }
 void sda_generation_result_init(sda_generation_result*r,mpfr_prec_t p){ memset(r,0,sizeof*r); mpfr_inits2(p,r->max_scaled_error,r->max_abs_error,r->l1_error,r->sd_support,r->sd_infinite,r->tail_mass,r->renyi,r->renyi_minus_one,r->log2_sd,r->log2_renyi_minus_one,r->gaussian_s,r->raw_svp_norm,r->epsilon,r->baseline_sd_support,r->baseline_sd_infinite,r->baseline_renyi,r->candidate_sd_ratio,r->candidate_renyi_ratio,r->acceptance_ratio,r->expected_attempts,r->expected_raw_bits,(mpfr_ptr)0); }
 void sda_generation_result_clear(sda_generation_result*r){ mpfr_clears(r->max_scaled_error,r->max_abs_error,r->l1_error,r->sd_support,r->sd_infinite,r->tail_mass,r->renyi,r->renyi_minus_one,r->log2_sd,r->log2_renyi_minus_one,r->gaussian_s,r->raw_svp_norm,r->epsilon,r->baseline_sd_support,r->baseline_sd_infinite,r->baseline_renyi,r->candidate_sd_ratio,r->candidate_renyi_ratio,r->acceptance_ratio,r->expected_attempts,r->expected_raw_bits,(mpfr_ptr)0); }
 int sda_generate_distribution(const sda_config*cfg,mpfr_t*alpha,size_t n,mpfr_t tail,mpfr_t gs){ mpfr_prec_t pr=cfg->mpfr_precision; mpfr_t pi,two,tmp,x,rho,sum,full,eps; mpfr_inits2(pr,pi,two,tmp,x,rho,sum,full,eps,(mpfr_ptr)0); mpfr_const_pi(pi,MPFR_RNDN); mpfr_set_ui(two,2,MPFR_RNDN); mpfr_mul(tmp,two,pi,MPFR_RNDN); mpfr_sqrt(tmp,tmp,MPFR_RNDN); mpfr_set_d(gs,cfg->sigma,MPFR_RNDN); mpfr_mul(gs,gs,tmp,MPFR_RNDN); mpfr_set_zero(sum,0); for(size_t i=0;i<n;i++){ long v=cfg->support_min+(long)i; mpfr_set_si(x,v,MPFR_RNDN); mpfr_mul(x,x,x,MPFR_RNDN); mpfr_mul(x,x,pi,MPFR_RNDN); mpfr_mul(tmp,gs,gs,MPFR_RNDN); mpfr_div(x,x,tmp,MPFR_RNDN); mpfr_neg(x,x,MPFR_RNDN); mpfr_exp(rho,x,MPFR_RNDN); if(!strcmp(cfg->scheme,"Frodo") && v>0) mpfr_mul_ui(rho,rho,2,MPFR_RNDN); mpfr_set(alpha[i],rho,MPFR_RNDN); mpfr_add(sum,sum,rho,MPFR_RNDN); }
  mpfr_set(full,sum,MPFR_RNDN); mpfr_set_d(eps,1e-80,MPFR_RNDN); for(long v=cfg->support_max+1; v<cfg->support_max+10000; v++){ mpfr_set_si(x,v,MPFR_RNDN); mpfr_mul(x,x,x,MPFR_RNDN); mpfr_mul(x,x,pi,MPFR_RNDN); mpfr_mul(tmp,gs,gs,MPFR_RNDN); mpfr_div(x,x,tmp,MPFR_RNDN); mpfr_neg(x,x,MPFR_RNDN); mpfr_exp(rho,x,MPFR_RNDN); if(!strcmp(cfg->scheme,"Frodo")) mpfr_mul_ui(rho,rho,2,MPFR_RNDN); mpfr_add(full,full,rho,MPFR_RNDN); if(mpfr_cmp(rho,eps)<0) break; }
  for(size_t i=0;i<n;i++) mpfr_div(alpha[i],alpha[i],sum,MPFR_RNDN); mpfr_div(tmp,sum,full,MPFR_RNDN); mpfr_ui_sub(tail,1,tmp,MPFR_RNDN); mpfr_clears(pi,two,tmp,x,rho,sum,full,eps,(mpfr_ptr)0); return 0; }
-int sda_fixed_q_minmax(mpfr_t*a,size_t n,sda_u128 q,sda_u128*p,mpfr_t ms,mpfr_t ma,mpfr_t l1){ typedef struct{size_t i; mpfr_t f;} Item; Item it[32]; mpfr_t qq,y,fl,d,pp; mpfr_inits2(mpfr_get_prec(a[0]),qq,y,fl,d,pp,(mpfr_ptr)0); set_u128(qq,q); sda_u128 sum=0; for(size_t i=0;i<n;i++){ it[i].i=i; mpfr_init2(it[i].f,mpfr_get_prec(a[0])); mpfr_mul(y,qq,a[i],MPFR_RNDN); p[i]=mpfr_floor_u128(y); sum+=p[i]; mpfr_floor(fl,y); mpfr_sub(it[i].f,y,fl,MPFR_RNDN); }
- for(size_t i=0;i<n;i++) for(size_t j=i+1;j<n;j++) if(mpfr_cmp(it[j].f,it[i].f)>0){Item t=it[i];it[i]=it[j];it[j]=t;} for(sda_u128 r=q-sum;r>0;r--) p[it[(size_t)(q-sum-r)].i]++; mpfr_set_zero(ms,0); mpfr_set_zero(ma,0); mpfr_set_zero(l1,0); for(size_t i=0;i<n;i++){ set_u128(pp,p[i]); mpfr_div(pp,pp,qq,MPFR_RNDN); mpfr_sub(d,a[i],pp,MPFR_RNDN); mpfr_abs(d,d,MPFR_RNDN); mpfr_add(l1,l1,d,MPFR_RNDN); if(mpfr_cmp(d,ma)>0) mpfr_set(ma,d,MPFR_RNDN); mpfr_mul(y,d,qq,MPFR_RNDN); if(mpfr_cmp(y,ms)>0) mpfr_set(ms,y,MPFR_RNDN); } for(size_t i=0;i<n;i++) mpfr_clear(it[i].f); mpfr_clears(qq,y,fl,d,pp,(mpfr_ptr)0); return 0; }
+int sda_fixed_q_minmax(mpfr_t*a,size_t n,sda_u128 q,sda_u128*p,mpfr_t ms,mpfr_t ma,mpfr_t l1){ typedef struct{size_t i; mpfr_ptr f;} Item; Item it[32]; mpfr_prec_t pr=mpfr_get_prec(a[0]); sda_workspace *ws=sda_ws_local(); size_t mk=sda_ws_mark(ws); mpfr_ptr qq=sda_ws_mpfr(ws,pr),y=sda_ws_mpfr(ws,pr),fl=sda_ws_mpfr(ws,pr),d=sda_ws_mpfr(ws,pr),pp=sda_ws_mpfr(ws,pr); set_u128(qq,q); sda_u128 sum=0; for(size_t i=0;i<n;i++){ it[i].i=i; it[i].f=sda_ws_mpfr(ws,pr); mpfr_mul(y,qq,a[i],MPFR_RNDN); p[i]=mpfr_floor_u128(y); sum+=p[i]; mpfr_floor(fl,y); mpfr_sub(it[i].f,y,fl,MPFR_RNDN); }
+ for(size_t i=0;i<n;i++) for(size_t j=i+1;j<n;j++) if(mpfr_cmp(it[j].f,it[i].f)>0){Item t=it[i];it[i]=it[j];it[j]=t;} for(sda_u128 r=q-sum;r>0;r--) p[it[(size_t)(q-sum-r)].i]++; mpfr_set_zero(ms,0); mpfr_set_zero(ma,0); mpfr_set_zero(l1,0); for(size_t i=0;i<n;i++){ set_u128(pp,p[i]); mpfr_div(pp,pp,qq,MPFR_RNDN); mpfr_sub(d,a[i],pp,MPFR_RNDN); mpfr_abs(d,d,MPFR_RNDN); mpfr_add(l1,l1,d,MPFR_RNDN); if(mpfr_cmp(d,ma)>0) mpfr_set(ma,d,MPFR_RNDN); mpfr_mul(y,d,qq,MPFR_RNDN); if(mpfr_cmp(y,ms)>0) mpfr_set(ms,y,MPFR_RNDN); } sda_ws_release(ws,mk); return 0; }
 static int accept_point(mpfr_t ma,int k){ mpfr_t b; mpfr_init2(b,mpfr_get_prec(ma)); mpfr_set_ui_2exp(b,1,-k,MPFR_RNDN); int ok=mpfr_cmp(ma,b)<=0; mpfr_clear(b); return ok; }
 static void finalize_metrics(mpfr_t*a,size_t n,sda_generation_result*r,long ro){ sda_metrics m; sda_metrics_init(&m,mpfr_get_prec(a[0])); sda_compute_metrics(a,n,r->p,r->q,ro,&m); mpfr_set(r->sd_support,m.sd_support,MPFR_RNDN); mpfr_add(r->sd_infinite,m.sd_support,r->tail_mass,MPFR_RNDN); mpfr_set(r->renyi,m.renyi,MPFR_RNDN); mpfr_set(r->renyi_minus_one,m.renyi_minus_one,MPFR_RNDN); if(mpfr_sgn(r->sd_infinite)>0) mpfr_log2(r->log2_sd,r->sd_infinite,MPFR_RNDN); if(mpfr_inf_p(r->renyi_minus_one)) mpfr_set_inf(r->log2_renyi_minus_one,1); else if(mpfr_sgn(r->renyi_minus_one)>0) mpfr_log2(r->log2_renyi_minus_one,r->renyi_minus_one,MPFR_RNDN); sda_metrics_clear(&m); }
 static int better(size_t n,sda_generation_result*c,sda_generation_result*b){ if(!b->q) return 1; if(c->q_bits!=b->q_bits) return c->q_bits<b->q_bits; if(c->q!=b->q) return c->q<b->q; int sd=mpfr_cmp(c->sd_infinite,b->sd_infinite); if(sd) return sd<0; int e=mpfr_cmp(c->max_scaled_error,b->max_scaled_error); if(e) return e<0; for(size_t i=0;i<n;i++) if(c->p[i]!=b->p[i]) return c->p[i]<b->p[i]; return 0; }
@@ -30,41 +35,39 @@ static sda_u128 historical_q(const char*ps){ if(!strcmp(ps,"frodo640")) return (
 static int acceptance_meets_historical(const sda_config*cfg,sda_u128 q){ sda_u128 h=historical_q(cfg->parameter_set); if(!h||!q) return 0; int qb=draw_bits(q), hb=draw_bits(h); sda_u128 qceil=((sda_u128)1)<<qb, hceil=((sda_u128)1)<<hb; return q*hceil >= h*qceil; }
 static void trace_u(FILE*f,sda_u128 v){ if(v>>64) fprintf(f,"%llu%019llu",(unsigned long long)(v/10000000000000000000ULL),(unsigned long long)(v%10000000000000000000ULL)); else fprintf(f,"%llu",(unsigned long long)v); }
 static void print_mp_trace(FILE*f,mpfr_srcptr x){ mpfr_out_str(f,10,18,x,MPFR_RNDN); }
-static void trace_candidate(const sda_config*cfg,const sda_generation_result*c,int solver_rc,const char*reason){
-  if(!getenv("SDA_TRACE_CANDIDATES")) return;
-  FILE*all=fopen("offline/generated/sda_all_candidates.csv","a");
-  FILE*rej=fopen("offline/generated/sda_rejected_candidates.csv","a");
-  FILE*feas=fopen("offline/generated/sda_feasible_candidates.csv","a");
-  if(!all||!rej||!feas){ if(all)fclose(all); if(rej)fclose(rej); if(feas)fclose(feas); return; }
-  const char*hdr="parameter_set,epsilon,refinement_level,lattice_hash,solver_status,q,raw_coefficients,global_svp_certified,PMF,compact_q_valid,sd,baseline_sd,sd_improved,renyi,baseline_renyi,renyi_improved,power2_ceiling,power2_gap,acceptance_ratio,rejection_rate,historical_acceptance_baseline,rejection_constraint_passed,expected_attempts,expected_raw_bits,feasible,rejection_reason,selected\n";
-  static int header_done=0; if(!header_done){ fputs(hdr,all); fputs(hdr,rej); fputs(hdr,feas); header_done=1; }
+/* One trace row for candidate c; the same row goes to sda_all_candidates.csv and
+ * to the feasible or rejected file. Returns whether the candidate is feasible. */
+static int trace_row(FILE*f,const sda_config*cfg,const sda_generation_result*c,int solver_rc,const char*reason){
   double eps=mpfr_get_d(c->epsilon,MPFR_RNDN);
   sda_u128 M=c->q?(((sda_u128)1)<<draw_bits(c->q)):0, gap=M?M-c->q:0;
   int compact=(c->q>0 && c->q<(((sda_u128)1)<<cfg->precision_k));
   int acc=acceptance_meets_historical(cfg,c->q);
   int feasible=(solver_rc==0&&c->production_eligible&&acc);
-  FILE*outs[2]={all, feasible?feas:rej};
-  for(int k=0;k<2;k++){
-    FILE*f=outs[k];
-    fprintf(f,"%s,%.17g,0,trace,%s,",cfg->parameter_set,eps,solver_rc==-8?"hard_constraint_failed":(solver_rc?"solver_failed":"ok"));
-    trace_u(f,c->q); fprintf(f,",\"");
-    for(size_t i=0;i<c->n;i++){ if(i)fputc(' ',f); trace_u(f,c->raw_svp_p[i]); }
-    fprintf(f,"\",%s,\"",c->global_svp_certified?"true":"false");
-    for(size_t i=0;i<c->n;i++){ if(i)fputc(' ',f); trace_u(f,c->p[i]); }
-    fprintf(f,"\",%s,",compact?"true":"false");
-    print_mp_trace(f,c->sd_infinite); fputc(',',f); print_mp_trace(f,c->baseline_sd_infinite);
-    fprintf(f,",%s,",mpfr_cmp(c->sd_infinite,c->baseline_sd_infinite)<0?"true":"false");
-    print_mp_trace(f,c->renyi); fputc(',',f); print_mp_trace(f,c->baseline_renyi);
-    fprintf(f,",%s,",mpfr_cmp(c->renyi,c->baseline_renyi)<0?"true":"false");
-    trace_u(f,M); fputc(',',f); trace_u(f,gap); fputc(',',f); print_mp_trace(f,c->acceptance_ratio); fputc(',',f);
-    mpfr_t one,rejrate,hist; mpfr_inits2(mpfr_get_prec(c->acceptance_ratio),one,rejrate,hist,(mpfr_ptr)0);
-    mpfr_set_ui(one,1,MPFR_RNDN); mpfr_sub(rejrate,one,c->acceptance_ratio,MPFR_RNDN); print_mp_trace(f,rejrate); fputc(',',f);
-    sda_u128 h=historical_q(cfg->parameter_set), hM=h?(((sda_u128)1)<<draw_bits(h)):1; set_u128(hist,h); set_u128(one,hM); mpfr_div(hist,hist,one,MPFR_RNDN); print_mp_trace(f,hist);
-    fprintf(f,",%s,",acc?"true":"false"); print_mp_trace(f,c->expected_attempts); fputc(',',f); print_mp_trace(f,c->expected_raw_bits);
-    fprintf(f,",%s,%s,false\n",feasible?"true":"false",reason);
-    mpfr_clears(one,rejrate,hist,(mpfr_ptr)0);
-  }
-  fclose(all); fclose(rej); fclose(feas);
+  fprintf(f,"%s,%.17g,0,trace,%s,",cfg->parameter_set,eps,solver_rc==-8?"hard_constraint_failed":(solver_rc?"solver_failed":"ok"));
+  trace_u(f,c->q); fprintf(f,",\"");
+  for(size_t i=0;i<c->n;i++){ if(i)fputc(' ',f); trace_u(f,c->raw_svp_p[i]); }
+  fprintf(f,"\",%s,\"",c->global_svp_certified?"true":"false");
+  for(size_t i=0;i<c->n;i++){ if(i)fputc(' ',f); trace_u(f,c->p[i]); }
+  fprintf(f,"\",%s,",compact?"true":"false");
+  print_mp_trace(f,c->sd_infinite); fputc(',',f); print_mp_trace(f,c->baseline_sd_infinite);
+  fprintf(f,",%s,",mpfr_cmp(c->sd_infinite,c->baseline_sd_infinite)<0?"true":"false");
+  print_mp_trace(f,c->renyi); fputc(',',f); print_mp_trace(f,c->baseline_renyi);
+  fprintf(f,",%s,",mpfr_cmp(c->renyi,c->baseline_renyi)<0?"true":"false");
+  trace_u(f,M); fputc(',',f); trace_u(f,gap); fputc(',',f); print_mp_trace(f,c->acceptance_ratio); fputc(',',f);
+  mpfr_t one,rejrate,hist; mpfr_inits2(mpfr_get_prec(c->acceptance_ratio),one,rejrate,hist,(mpfr_ptr)0);
+  mpfr_set_ui(one,1,MPFR_RNDN); mpfr_sub(rejrate,one,c->acceptance_ratio,MPFR_RNDN); print_mp_trace(f,rejrate); fputc(',',f);
+  sda_u128 h=historical_q(cfg->parameter_set), hM=h?(((sda_u128)1)<<draw_bits(h)):1; set_u128(hist,h); set_u128(one,hM); mpfr_div(hist,hist,one,MPFR_RNDN); print_mp_trace(f,hist);
+  fprintf(f,",%s,",acc?"true":"false"); print_mp_trace(f,c->expected_attempts); fputc(',',f); print_mp_trace(f,c->expected_raw_bits);
+  fprintf(f,",%s,%s,false\n",feasible?"true":"false",reason);
+  mpfr_clears(one,rejrate,hist,(mpfr_ptr)0);
+  return feasible;
+}
+typedef struct { char*text; size_t len; int feasible; } trace_record;
+/* Hands the records of one epsilon sweep, in instance order, to the trace sink. */
+static void trace_flush(const trace_record*rec,int count){
+  const char*hdr="parameter_set,epsilon,refinement_level,lattice_hash,solver_status,q,raw_coefficients,global_svp_certified,PMF,compact_q_valid,sd,baseline_sd,sd_improved,renyi,baseline_renyi,renyi_improved,power2_ceiling,power2_gap,acceptance_ratio,rejection_rate,historical_acceptance_baseline,rejection_constraint_passed,expected_attempts,expected_raw_bits,feasible,rejection_reason,selected\n";
+  if(sda_trace_open("offline/generated",hdr)) return;
+  for(int t=0;t<count;t++) if(rec[t].text) sda_trace_write(rec[t].text,rec[t].len,rec[t].feasible);
 }
 int sda_search_application(const sda_config*cfg,mpfr_t*a,size_t n,sda_generation_result*out){ if(compute_baseline(cfg,a,n,out)) return -1; sda_generation_result cur; sda_generation_result_init(&cur,cfg->mpfr_precision); mpfr_set(cur.tail_mass,out->tail_mass,MPFR_RNDN); mpfr_set(cur.gaussian_s,out->gaussian_s,MPFR_RNDN); mpfr_set(cur.baseline_sd_support,out->baseline_sd_support,MPFR_RNDN); mpfr_set(cur.baseline_sd_infinite,out->baseline_sd_infinite,MPFR_RNDN); mpfr_set(cur.baseline_renyi,out->baseline_renyi,MPFR_RNDN); int maxb=cfg->precision_k; for(int b=1;b<=maxb;b++){ sda_u128 hi=((sda_u128)1)<<b; sda_u128 lo=(b?(((sda_u128)1)<<(b-1)):0); if(hi>((sda_u128)1<<cfg->precision_k)) hi=((sda_u128)1<<cfg->precision_k); for(sda_u128 q=hi;q>lo;q--){ cur.q=q; cur.q_bits=draw_bits(q); cur.n=n; sda_fixed_q_minmax(a,n,q,cur.p,cur.max_scaled_error,cur.max_abs_error,cur.l1_error); sda_build_cumulative(cur.p,n,cur.c,&cur.q); finalize_metrics(a,n,&cur,cfg->renyi_order); out->denominators_scanned++; if(!baseline_ok(&cur)) continue; for(size_t i=0;i<n;i++){out->p[i]=cur.p[i];out->c[i]=cur.c[i];} out->q=cur.q; out->application_q=cur.q; out->q_bits=draw_bits(cur.q); out->n=n; mpfr_set(out->max_scaled_error,cur.max_scaled_error,MPFR_RNDN); mpfr_set(out->max_abs_error,cur.max_abs_error,MPFR_RNDN); mpfr_set(out->l1_error,cur.l1_error,MPFR_RNDN); mpfr_set(out->sd_support,cur.sd_support,MPFR_RNDN); mpfr_set(out->sd_infinite,cur.sd_infinite,MPFR_RNDN); mpfr_set(out->renyi,cur.renyi,MPFR_RNDN); mpfr_set(out->renyi_minus_one,cur.renyi_minus_one,MPFR_RNDN); mpfr_set(out->log2_sd,cur.log2_sd,MPFR_RNDN); mpfr_set(out->log2_renyi_minus_one,cur.log2_renyi_minus_one,MPFR_RNDN); out->baseline_dominance_certified=1; power_metrics(out); mpfr_div(out->candidate_sd_ratio,out->sd_infinite,out->baseline_sd_infinite,MPFR_RNDN); mpfr_div(out->candidate_renyi_ratio,out->renyi,out->baseline_renyi,MPFR_RNDN); sda_generation_result_clear(&cur); return 0;} if(hi==((sda_u128)1<<cfg->precision_k)) break;} sda_generation_result_clear(&cur); return -2; }
 int sda_search_exact_denominator(const sda_config*cfg,mpfr_t*a,size_t n,sda_generation_result*out){ clock_t st=clock(); sda_generation_result cur; sda_generation_result_init(&cur,cfg->mpfr_precision); strcpy(cur.solver,"exact-denominator"); cur.exact=1; cur.n=n; mpfr_set(cur.tail_mass,out->tail_mass,MPFR_RNDN); mpfr_set(cur.gaussian_s,out->gaussian_s,MPFR_RNDN); sda_u128 max=((sda_u128)1<<cfg->precision_k)-1; for(sda_u128 q=1;q<=max;q++){ cur.q=q; cur.q_bits=sda_bitlength_u128(q); cur.denominators_scanned++; sda_fixed_q_minmax(a,n,q,cur.p,cur.max_scaled_error,cur.max_abs_error,cur.l1_error); if(!accept_point(cur.max_abs_error,cfg->precision_k)) continue; sda_build_cumulative(cur.p,n,cur.c,&cur.q); finalize_metrics(a,n,&cur,cfg->renyi_order); if(better(n,&cur,out)){ for(size_t i=0;i<n;i++){out->p[i]=cur.p[i];out->c[i]=cur.c[i];} out->q=cur.q; out->q_bits=cur.q_bits; out->n=n; out->denominators_scanned=cur.denominators_scanned; out->exact=1; out->source_is_fixture=0; strcpy(out->solver,"exact-denominator"); mpfr_set(out->max_scaled_error,cur.max_scaled_error,MPFR_RNDN); mpfr_set(out->max_abs_error,cur.max_abs_error,MPFR_RNDN); mpfr_set(out->l1_error,cur.l1_error,MPFR_RNDN); mpfr_set(out->sd_support,cur.sd_support,MPFR_RNDN); mpfr_set(out->sd_infinite,cur.sd_infinite,MPFR_RNDN); mpfr_set(out->renyi,cur.renyi,MPFR_RNDN); mpfr_set(out->renyi_minus_one,cur.renyi_minus_one,MPFR_RNDN); mpfr_set(out->log2_sd,cur.log2_sd,MPFR_RNDN); mpfr_set(out->log2_renyi_minus_one,cur.log2_renyi_minus_one,MPFR_RNDN); } if(q==max) break;} out->generation_time=(double)(clock()-st)/CLOCKS_PER_SEC; out->denominator_search_complete=out->q?1:0; out->fixed_q_optimizer_certified=out->q?1:0; out->production_eligible=out->q?1:0; sda_generation_result_clear(&cur); return out->q?0:-1; }
@@ -78,11 +81,82 @@ static void copy_result_core(sda_generation_result*dst,const sda_generation_resu
   mpfr_set(dst->max_scaled_error,src->max_scaled_error,MPFR_RNDN); mpfr_set(dst->max_abs_error,src->max_abs_error,MPFR_RNDN); mpfr_set(dst->l1_error,src->l1_error,MPFR_RNDN); mpfr_set(dst->sd_support,src->sd_support,MPFR_RNDN); mpfr_set(dst->sd_infinite,src->sd_infinite,MPFR_RNDN); mpfr_set(dst->renyi,src->renyi,MPFR_RNDN); mpfr_set(dst->renyi_minus_one,src->renyi_minus_one,MPFR_RNDN); mpfr_set(dst->log2_sd,src->log2_sd,MPFR_RNDN); mpfr_set(dst->log2_renyi_minus_one,src->log2_renyi_minus_one,MPFR_RNDN); mpfr_set(dst->raw_svp_norm,src->raw_svp_norm,MPFR_RNDN); mpfr_set(dst->epsilon,src->epsilon,MPFR_RNDN); mpfr_set(dst->baseline_sd_support,src->baseline_sd_support,MPFR_RNDN); mpfr_set(dst->baseline_sd_infinite,src->baseline_sd_infinite,MPFR_RNDN); mpfr_set(dst->baseline_renyi,src->baseline_renyi,MPFR_RNDN); mpfr_set(dst->candidate_sd_ratio,src->candidate_sd_ratio,MPFR_RNDN); mpfr_set(dst->candidate_renyi_ratio,src->candidate_renyi_ratio,MPFR_RNDN); mpfr_set(dst->acceptance_ratio,src->acceptance_ratio,MPFR_RNDN); mpfr_set(dst->expected_attempts,src->expected_attempts,MPFR_RNDN); mpfr_set(dst->expected_raw_bits,src->expected_raw_bits,MPFR_RNDN);
 }
 static int better_min_q(const sda_generation_result*c,const sda_generation_result*b,size_t n){ if(!b->q) return 1; if(c->q!=b->q) return c->q<b->q; int cb=draw_bits(c->q), bb=draw_bits(b->q); sda_u128 cg=(((sda_u128)1)<<cb)-c->q, bg=(((sda_u128)1)<<bb)-b->q; if(cg!=bg) return cg<bg; int sd=mpfr_cmp(c->sd_infinite,b->sd_infinite); if(sd) return sd<0; int rd=mpfr_cmp(c->renyi,b->renyi); if(rd) return rd<0; int pe=mpfr_cmp(c->max_abs_error,b->max_abs_error); if(pe) return pe<0; int ep=mpfr_cmp(c->epsilon,b->epsilon); if(ep) return ep<0; for(size_t i=0;i<n;i++) if(c->p[i]!=b->p[i]) return c->p[i]<b->p[i]; return 0; }
-static int solve_svp_candidate(const sda_config*cfg,mpfr_t*a,size_t n,mpfr_t eps,sda_generation_result*out){ sda_exact_linf_sda_result svp; sda_exact_linf_sda_init(&svp,n,cfg->mpfr_precision); int rc=sda_exact_linf_sda_solve(a,n,eps,0,&svp); if(rc||!svp.global_svp_certified){ sda_exact_linf_sda_clear(&svp); return rc?rc:-5; }
+static int solve_svp_candidate(const sda_config*cfg,mpfr_t*a,size_t n,mpfr_t eps,unsigned threads,sda_generation_result*out){ sda_exact_linf_sda_result svp; sda_exact_linf_sda_init(&svp,n,cfg->mpfr_precision); svp.threads=threads; int rc=sda_exact_linf_sda_solve(a,n,eps,0,&svp); if(rc||!svp.global_svp_certified){ sda_exact_linf_sda_clear(&svp); return rc?rc:-5; }
   out->raw_svp_q=svp.q; out->q=svp.q; out->application_q=svp.q; out->exact_svp_q=svp.q; out->q_bits=sda_bitlength_u128(out->q); out->n=n; out->enumerated_q_count+=svp.q_enumerated; out->raw_svp_vector_available=1; out->exact_linf_svp=svp.exact_linf_svp; out->global_svp_certified=svp.global_svp_certified; out->search_space_exhausted=svp.search_space_exhausted; out->nearest_integer_certified=svp.nearest_integer_certified; out->norm_comparisons_certified=svp.norm_comparisons_certified; out->interval_certified=svp.interval_certified; out->high_precision_verified=svp.high_precision_verified; out->formal_certificate_valid=svp.formal_certificate_valid; out->half_integer_ties=svp.half_integer_ties; out->denominator_from_exact_svp=1; out->fixed_q_optimizer_certified=1; out->denominator_search_complete=0; strcpy(out->solver,"epsilon-svp-generated-min-q"); mpfr_set(out->raw_svp_norm,svp.norm_upper,MPFR_RNDN); mpfr_set(out->epsilon,eps,MPFR_RNDN);
   for(size_t i=0;i<n;i++) out->raw_svp_p[i]=svp.p[i]; sda_u128 sum=0; for(size_t i=0;i<n;i++) sum+=svp.p[i]; out->raw_svp_pmf_valid=(sum==svp.q);
   sda_fixed_q_minmax(a,n,svp.q,out->p,out->max_scaled_error,out->max_abs_error,out->l1_error); sda_build_cumulative(out->p,n,out->c,&out->q); out->pmf_is_fixed_q_normalized=!out->raw_svp_pmf_valid; out->final_q_from_exact_svp=1; finalize_metrics(a,n,out,cfg->renyi_order); out->baseline_dominance_certified=(out->q > 0 && out->q < (((sda_u128)1)<<cfg->precision_k)) && baseline_ok(out) && acceptance_meets_historical(cfg,out->q); out->production_eligible=out->baseline_dominance_certified&&out->global_svp_certified; power_metrics(out); mpfr_div(out->candidate_sd_ratio,out->sd_infinite,out->baseline_sd_infinite,MPFR_RNDN); mpfr_div(out->candidate_renyi_ratio,out->renyi,out->baseline_renyi,MPFR_RNDN); sda_exact_linf_sda_clear(&svp); return out->production_eligible?0:-8; }
 
+/* Parallel epsilon sweep. Workers take instances from a shared counter, so each
+ * one sees its instances in increasing order; every worker keeps its own MPFR
+ * state, its own best candidate and the trace rows of its instances. The merge
+ * prefers better_min_q and, among equals, the lowest instance, which is what
+ * the sequential sweep keeps; trace rows are written in instance order. The
+ * result and the trace files therefore do not depend on the thread count.
+ * SDA_GENERATION_THREADS caps the workers (default: online CPUs); CPUs left
+ * over when there are fewer instances go to each instance's q enumeration. */
+#define SWEEP_MAX_THREADS 256u
+typedef struct { const sda_config*cfg; mpfr_t*a; size_t n; const sda_generation_result*base; int total; trace_record*rec; atomic_int*next; unsigned solver_threads; int best_t; unsigned long long enumerated; sda_generation_result best; } sweep_worker;
+static unsigned sweep_threads(int total,unsigned*solver_threads){ const char*e=getenv("SDA_GENERATION_THREADS"); long k=(e&&*e)?strtol(e,0,10):0; if(k<=0) k=sysconf(_SC_NPROCESSORS_ONLN); if(k<1) k=1; if(k>(long)SWEEP_MAX_THREADS) k=SWEEP_MAX_THREADS; long w=k<total?k:total; *solver_threads=(unsigned)(k/w); return (unsigned)w; }
+static void seed_candidate(sda_generation_result*r,const sda_generation_result*base,size_t n,mpfr_prec_t pr){ sda_generation_result_init(r,pr); r->n=n; mpfr_set(r->tail_mass,base->tail_mass,MPFR_RNDN); mpfr_set(r->gaussian_s,base->gaussian_s,MPFR_RNDN); mpfr_set(r->baseline_sd_support,base->baseline_sd_support,MPFR_RNDN); mpfr_set(r->baseline_sd_infinite,base->baseline_sd_infinite,MPFR_RNDN); mpfr_set(r->baseline_renyi,base->baseline_renyi,MPFR_RNDN); }
+static void*sweep_run(void*arg){ sweep_worker*w=arg; const sda_config*cfg=w->cfg; size_t n=w->n; mpfr_t eps; mpfr_init2(eps,cfg->mpfr_precision); seed_candidate(&w->best,w->base,n,cfg->mpfr_precision);
+  for(int t;(t=atomic_fetch_add(w->next,1))<w->total;){
+    double frac=(w->total==1)?0.0:((double)t/(double)(w->total-1)); double emin=cfg->epsilon_min>0?cfg->epsilon_min:0.5, emax=cfg->epsilon_max>emin?cfg->epsilon_max:emin; double ev=emin*pow(emax/emin,frac); mpfr_set_d(eps,ev,MPFR_RNDN);
+    sda_generation_result cand; seed_candidate(&cand,w->base,n,cfg->mpfr_precision);
+    int cr=solve_svp_candidate(cfg,w->a,n,eps,w->solver_threads,&cand); w->enumerated+=cand.enumerated_q_count; const char*rr=cr?(cr==-8?"hard_constraint_failed":"solver_failed"):(cand.production_eligible?"none":"hard_constraint_failed");
+    if(w->rec){ FILE*f=open_memstream(&w->rec[t].text,&w->rec[t].len); if(f){ w->rec[t].feasible=trace_row(f,cfg,&cand,cr,rr); fclose(f); } }
+    if(!cr && cand.production_eligible && better_min_q(&cand,&w->best,n)){ copy_result_core(&w->best,&cand,n); w->best_t=t; }
+    sda_generation_result_clear(&cand);
+  }
+  mpfr_clear(eps); return 0; }
+static void*sweep_thread(void*arg){ sweep_run(arg); mpfr_free_cache(); return 0; }
+
+/* lll-bkz: heuristic denominators from a BKZ-reduced SDA embedding basis. Rows
+ * 0..n-1 are D*e_i and row n is (A,1) with D = round(eps^-(n+1)) and A_i =
+ * round(-D*alpha_i), so coefficients (p,q) give (D*p_i + q*A_i, q). The q of
+ * every reduced row and of small combinations of the shortest rows goes through
+ * the interval evaluation of the exact solver and the fixed-q table, then the
+ * baseline rule (Frodo) or max_log2_renyi_minus_one (no baseline). The result
+ * is interval post-verified, not a certified SVP. */
+#define BKZ_COMB_RANK 4
+#define BKZ_COMB_BOUND 2
+#define BKZ_MAX_COMBINATIONS 250
+static void make_basis(mpfr_t*a,size_t n,mpfr_t eps,mpz_t*B){ size_t d=n+1; mpfr_t t; mpz_t D; mpfr_init2(t,mpfr_get_prec(a[0])); mpz_init(D);
+  mpfr_ui_div(t,1,eps,MPFR_RNDN); mpfr_pow_ui(t,t,(unsigned long)d,MPFR_RNDN); mpfr_get_z(D,t,MPFR_RNDN); if(mpz_sgn(D)<=0) mpz_set_ui(D,1);
+  for(size_t i=0;i<d*d;i++) mpz_set_ui(B[i],0);
+  for(size_t i=0;i<n;i++){ mpz_set(B[i*d+i],D); mpfr_mul_z(t,a[i],D,MPFR_RNDN); mpfr_neg(t,t,MPFR_RNDN); mpfr_get_z(B[n*d+i],t,MPFR_RNDN); } mpz_set_ui(B[n*d+n],1);
+  mpfr_clear(t); mpz_clear(D); }
+static int lll_bkz_candidate(const sda_config*cfg,mpfr_t*a,size_t n,mpfr_t eps,sda_u128 q,int has_baseline,sda_generation_result*out){ sda_exact_linf_sda_result ev; sda_exact_linf_sda_init(&ev,n,cfg->mpfr_precision); int rc=sda_exact_linf_sda_evaluate(a,n,eps,q,&ev); if(rc){ sda_exact_linf_sda_clear(&ev); return rc; }
+  out->raw_svp_q=q; out->q=q; out->application_q=q; out->q_bits=sda_bitlength_u128(q); out->n=n; out->raw_svp_vector_available=1; out->heuristic=1; out->nearest_integer_certified=ev.nearest_integer_certified; out->norm_comparisons_certified=ev.norm_comparisons_certified; out->interval_certified=ev.interval_certified; out->high_precision_verified=ev.high_precision_verified; out->half_integer_ties=ev.half_integer_ties; strcpy(out->solver,"lll-bkz-heuristic"); mpfr_set(out->raw_svp_norm,ev.norm_upper,MPFR_RNDN); mpfr_set(out->epsilon,eps,MPFR_RNDN);
+  sda_u128 sum=0; for(size_t i=0;i<n;i++){ out->raw_svp_p[i]=ev.p[i]; sum+=ev.p[i]; } out->raw_svp_pmf_valid=(sum==q);
+  sda_fixed_q_minmax(a,n,q,out->p,out->max_scaled_error,out->max_abs_error,out->l1_error); sda_build_cumulative(out->p,n,out->c,&out->q); out->pmf_is_fixed_q_normalized=!out->raw_svp_pmf_valid; out->fixed_q_optimizer_certified=1; finalize_metrics(a,n,out,cfg->renyi_order); power_metrics(out);
+  int ok; if(has_baseline){ out->baseline_dominance_certified=baseline_ok(out)&&acceptance_meets_historical(cfg,out->q); ok=out->baseline_dominance_certified; mpfr_div(out->candidate_sd_ratio,out->sd_infinite,out->baseline_sd_infinite,MPFR_RNDN); mpfr_div(out->candidate_renyi_ratio,out->renyi,out->baseline_renyi,MPFR_RNDN); }
+  else ok=cfg->max_log2_renyi_minus_one>=0||mpfr_cmp_d(out->log2_renyi_minus_one,cfg->max_log2_renyi_minus_one)<=0;
+  out->production_eligible=ok&&out->interval_certified; sda_exact_linf_sda_clear(&ev); return out->production_eligible?0:-8; }
+/* One epsilon instance: reduce, then try each distinct q in (0, 2^precision_k)
+ * from the rows and from the combinations of the BKZ_COMB_RANK shortest rows,
+ * in the order generate_falcon_sdat.py uses. Keeps the better_min_q feasible
+ * candidate in best. */
+static int lll_bkz_instance(const sda_config*cfg,mpfr_t*a,size_t n,mpfr_t eps,const sda_lll_params*lp,int has_baseline,const sda_generation_result*base,sda_generation_result*best,unsigned long long*scanned){
+  size_t d=n+1; mpz_t B[33*33],nrm[33],q,lim; for(size_t i=0;i<d*d;i++) mpz_init(B[i]); mpz_init(q); mpz_init(lim); mpz_set_ui(lim,1); mpz_mul_2exp(lim,lim,(unsigned long)cfg->precision_k);
+  make_basis(a,n,eps,B); sda_lll_stats st; int rc=sda_bkz_reduce(B,d,d,lp,&st);
+  size_t idx[BKZ_COMB_RANK],m=0; unsigned char used[33]={0}; for(size_t i=0;i<d;i++){ mpz_init(nrm[i]); for(size_t k=0;k<d;k++) mpz_addmul(nrm[i],B[i*d+k],B[i*d+k]); }
+  for(;m<BKZ_COMB_RANK&&m<d;m++){ size_t k=d; for(size_t i=0;i<d;i++) if(!used[i]&&(k==d||mpz_cmp(nrm[i],nrm[k])<0)) k=i; used[k]=1; idx[m]=k; }
+  long pw=1; for(size_t j=0;j<m;j++) pw*=2*BKZ_COMB_BOUND+1; sda_u128 seen[33+BKZ_MAX_COMBINATIONS]; size_t ns=0; int comb=0;
+  for(long s=-(long)d;!rc&&s<pw&&comb<BKZ_MAX_COMBINATIONS;s++){
+    if(s<0) mpz_set(q,B[(size_t)(s+(long)d)*d+n]);
+    else { long c[BKZ_COMB_RANK],r=s; int zero=1; for(size_t j=m;j-->0;){ c[j]=r%(2*BKZ_COMB_BOUND+1)-BKZ_COMB_BOUND; r/=2*BKZ_COMB_BOUND+1; zero&=!c[j]; } if(zero) continue; comb++;
+      mpz_set_ui(q,0); for(size_t j=0;j<m;j++){ if(c[j]>0) mpz_addmul_ui(q,B[idx[j]*d+n],(unsigned long)c[j]); else if(c[j]<0) mpz_submul_ui(q,B[idx[j]*d+n],(unsigned long)-c[j]); } }
+    mpz_abs(q,q); if(!mpz_sgn(q)||mpz_cmp(q,lim)>=0) continue;
+    unsigned char buf[16]={0}; size_t nb=0; mpz_export(buf,&nb,-1,1,0,0,q); sda_u128 v=0; for(size_t i=0;i<nb;i++) v|=((sda_u128)buf[i])<<(8*i);
+    size_t k=0; while(k<ns&&seen[k]!=v) k++; if(k<ns) continue; seen[ns++]=v; (*scanned)++;
+    sda_generation_result cand; seed_candidate(&cand,base,n,cfg->mpfr_precision);
+    if(!lll_bkz_candidate(cfg,a,n,eps,v,has_baseline,&cand) && better_min_q(&cand,best,n)) copy_result_core(best,&cand,n);
+    sda_generation_result_clear(&cand);
+  }
+  for(size_t i=0;i<d*d;i++) mpz_clear(B[i]);
+  for(size_t i=0;i<d;i++) mpz_clear(nrm[i]);
+  mpz_clear(q); mpz_clear(lim); return rc; }
+
 int sda_generate_for_config(const sda_config*cfg,const char*solver,sda_generation_result*out){
  size_t n=(size_t)(cfg->support_max-cfg->support_min+1); mpfr_t a[32]; for(size_t i=0;i<n;i++) mpfr_init2(a[i],cfg->mpfr_precision); sda_generate_distribution(cfg,a,n,out->tail_mass,out->gaussian_s); int rc=0;
  if(!strcmp(solver,"exact-denominator") || !strcmp(solver,"exact-denominator-search")){
@@ -90,21 +164,30 @@ int sda_generate_for_config(const sda_config*cfg,const char*solver,sda_generatio
  } else if(!strcmp(solver,"exact-linf-svp") || !strcmp(solver,"exact-linf-sda-specialized") || !strcmp(solver,"epsilon-svp-generated") || !strcmp(solver,"epsilon-svp-generated-baseline-dominating-power2-close")){
   if(compute_baseline(cfg,a,n,out)) { rc=-7; }
   else {
-    sda_generation_result best; sda_generation_result_init(&best,cfg->mpfr_precision); best.n=n; mpfr_set(best.tail_mass,out->tail_mass,MPFR_RNDN); mpfr_set(best.gaussian_s,out->gaussian_s,MPFR_RNDN); mpfr_set(best.baseline_sd_support,out->baseline_sd_support,MPFR_RNDN); mpfr_set(best.baseline_sd_infinite,out->baseline_sd_infinite,MPFR_RNDN); mpfr_set(best.baseline_renyi,out->baseline_renyi,MPFR_RNDN);
+    sda_generation_result best; seed_candidate(&best,out,n,cfg->mpfr_precision);
     int trials=cfg->epsilon_initial_trials>1?cfg->epsilon_initial_trials:1; int rounds=cfg->epsilon_refinement_rounds>=0?cfg->epsilon_refinement_rounds:0; int total=trials*(1<<rounds); if(total<1) total=1; if(cfg->epsilon_max_total_instances>0 && total>cfg->epsilon_max_total_instances) total=cfg->epsilon_max_total_instances;
-    for(int t=0;t<total;t++){
-      double frac=(total==1)?0.0:((double)t/(double)(total-1)); double emin=cfg->epsilon_min>0?cfg->epsilon_min:0.5, emax=cfg->epsilon_max>emin?cfg->epsilon_max:emin; double ev=emin*pow(emax/emin,frac);
-      mpfr_t eps; mpfr_init2(eps,cfg->mpfr_precision); mpfr_set_d(eps,ev,MPFR_RNDN);
-      sda_generation_result cand; sda_generation_result_init(&cand,cfg->mpfr_precision); cand.n=n; mpfr_set(cand.tail_mass,out->tail_mass,MPFR_RNDN); mpfr_set(cand.gaussian_s,out->gaussian_s,MPFR_RNDN); mpfr_set(cand.baseline_sd_support,out->baseline_sd_support,MPFR_RNDN); mpfr_set(cand.baseline_sd_infinite,out->baseline_sd_infinite,MPFR_RNDN); mpfr_set(cand.baseline_renyi,out->baseline_renyi,MPFR_RNDN);
-      int cr=solve_svp_candidate(cfg,a,n,eps,&cand); out->enumerated_q_count += cand.enumerated_q_count; const char*rr=cr?(cr==-8?"hard_constraint_failed":"solver_failed"):(cand.production_eligible?"none":"hard_constraint_failed"); trace_candidate(cfg,&cand,cr,rr);
-      if(!cr && cand.production_eligible && better_min_q(&cand,&best,n)) copy_result_core(&best,&cand,n);
-      sda_generation_result_clear(&cand); mpfr_clear(eps);
-    }
+    int trace=getenv("SDA_TRACE_CANDIDATES")!=0; trace_record*rec=trace?calloc((size_t)total,sizeof*rec):0; atomic_int next=0;
+    unsigned st,k=sweep_threads(total,&st); sweep_worker w[SWEEP_MAX_THREADS]; pthread_t tid[SWEEP_MAX_THREADS]; unsigned started=1;
+    for(unsigned i=0;i<k;i++) w[i]=(sweep_worker){.cfg=cfg,.a=a,.n=n,.base=out,.total=total,.rec=rec,.next=&next,.solver_threads=st,.best_t=-1};
+    for(unsigned i=1;i<k;i++){ if(pthread_create(&tid[i],0,sweep_thread,&w[i])) break; started++; }
+    sweep_run(&w[0]); for(unsigned i=1;i<started;i++) pthread_join(tid[i],0);
+    int best_t=-1; for(unsigned i=0;i<started;i++){ out->enumerated_q_count+=w[i].enumerated; if(w[i].best_t>=0 && (best_t<0 || better_min_q(&w[i].best,&best,n) || (!better_min_q(&best,&w[i].best,n) && w[i].best_t<best_t))){ copy_result_core(&best,&w[i].best,n); best_t=w[i].best_t; } sda_generation_result_clear(&w[i].best); }
+    if(rec){ trace_flush(rec,total); for(int t=0;t<total;t++) free(rec[t].text); free(rec); }
     if(best.q){ copy_result_core(out,&best,n); rc=0; } else { out->baseline_dominance_certified=0; out->production_eligible=0; rc=-8; }
     sda_generation_result_clear(&best);
   }
  } else if(!strcmp(solver,"flint-lll") || !strcmp(solver,"flint-lll-heuristic")){
   if(!sda_lll_available()){rc=-2;} else { sda_lll_smoke_run(); rc=-4; }
+ } else if(!strcmp(solver,"lll-bkz")){
+  int has_baseline=!compute_baseline(cfg,a,n,out); sda_generation_result best; seed_candidate(&best,out,n,cfg->mpfr_precision); mpfr_t eps; mpfr_init2(eps,cfg->mpfr_precision); clock_t t0=clock();
+  sda_lll_params lp; sda_lll_params_default(&lp); if(cfg->bkz_block_size>1) lp.block_size=(unsigned)cfg->bkz_block_size; if(cfg->bkz_max_tours>0) lp.max_tours=(unsigned)cfg->bkz_max_tours;
+  int trials=cfg->epsilon_initial_trials>1?cfg->epsilon_initial_trials:1; int rounds=cfg->epsilon_refinement_rounds>=0?cfg->epsilon_refinement_rounds:0; int total=trials*(1<<rounds); if(total<1) total=1; if(cfg->epsilon_max_total_instances>0 && total>cfg->epsilon_max_total_instances) total=cfg->epsilon_max_total_instances;
+  unsigned long long scanned=0; int failed=0;
+  for(int t=0;t<total;t++){ double frac=(total==1)?0.0:((double)t/(double)(total-1)); double emin=cfg->epsilon_min>0?cfg->epsilon_min:0.5, emax=cfg->epsilon_max>emin?cfg->epsilon_max:emin; mpfr_set_d(eps,emin*pow(emax/emin,frac),MPFR_RNDN);
+    if(lll_bkz_instance(cfg,a,n,eps,&lp,has_baseline,out,&best,&scanned)) failed++; }
+  if(best.q){ copy_result_core(out,&best,n); rc=0; } else { out->baseline_dominance_certified=0; out->production_eligible=0; rc=failed==total?-2:-8; }
+  out->denominators_scanned=scanned; out->generation_time=(double)(clock()-t0)/CLOCKS_PER_SEC;
+  mpfr_clear(eps); sda_generation_result_clear(&best);
  } else rc=-3;
  for(size_t i=0;i<n;i++) mpfr_clear(a[i]); return rc;
 }
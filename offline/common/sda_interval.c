@@ -1,2 +1,3 @@
 #include "sda_interval.h"
-void sda_interval_init(sda_mpfr_interval*x,mpfr_prec_t p){mpfr_init2(x->lo,p);mpfr_init2(x->hi,p);}void sda_interval_clear(sda_mpfr_interval*x){mpfr_clear(x->lo);mpfr_clear(x->hi);}void sda_interval_set(sda_mpfr_interval*x,const mpfr_t v){mpfr_set(x->lo,v,MPFR_RNDD);mpfr_set(x->hi,v,MPFR_RNDU);}void sda_interval_set_ui(sda_mpfr_interval*x,unsigned long v){mpfr_set_ui(x->lo,v,MPFR_RNDD);mpfr_set_ui(x->hi,v,MPFR_RNDU);}void sda_interval_add(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){mpfr_add(r->lo,a->lo,b->lo,MPFR_RNDD);mpfr_add(r->hi,a->hi,b->hi,MPFR_RNDU);}void sda_interval_sub(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){mpfr_sub(r->lo,a->lo,b->hi,MPFR_RNDD);mpfr_sub(r->hi,a->hi,b->lo,MPFR_RNDU);}void sda_interval_mul(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){mpfr_t v[4];for(int i=0;i<4;i++)mpfr_init2(v[i],mpfr_get_prec(r->lo));mpfr_mul(v[0],a->lo,b->lo,MPFR_RNDD);mpfr_mul(v[1],a->lo,b->hi,MPFR_RNDD);mpfr_mul(v[2],a->hi,b->lo,MPFR_RNDD);mpfr_mul(v[3],a->hi,b->hi,MPFR_RNDD);mpfr_set(r->lo,v[0],MPFR_RNDD);for(int i=1;i<4;i++)if(mpfr_cmp(v[i],r->lo)<0)mpfr_set(r->lo,v[i],MPFR_RNDD);mpfr_mul(v[0],a->lo,b->lo,MPFR_RNDU);mpfr_mul(v[1],a->lo,b->hi,MPFR_RNDU);mpfr_mul(v[2],a->hi,b->lo,MPFR_RNDU);mpfr_mul(v[3],a->hi,b->hi,MPFR_RNDU);mpfr_set(r->hi,v[0],MPFR_RNDU);for(int i=1;i<4;i++)if(mpfr_cmp(v[i],r->hi)>0)mpfr_set(r->hi,v[i],MPFR_RNDU);for(int i=0;i<4;i++)mpfr_clear(v[i]);}void sda_interval_mul_z(sda_mpfr_interval*r,const sda_mpfr_interval*a,const mpz_t z){if(mpz_sgn(z)>=0){mpfr_mul_z(r->lo,a->lo,z,MPFR_RNDD);mpfr_mul_z(r->hi,a->hi,z,MPFR_RNDU);}else{mpfr_mul_z(r->lo,a->hi,z,MPFR_RNDD);mpfr_mul_z(r->hi,a->lo,z,MPFR_RNDU);}}void sda_interval_div(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){sda_mpfr_interval inv;sda_interval_init(&inv,mpfr_get_prec(r->lo));mpfr_ui_div(inv.lo,1,b->hi,MPFR_RNDD);mpfr_ui_div(inv.hi,1,b->lo,MPFR_RNDU);sda_interval_mul(r,a,&inv);sda_interval_clear(&inv);}void sda_interval_abs(sda_mpfr_interval*r,const sda_mpfr_interval*a){if(mpfr_sgn(a->lo)>=0){mpfr_set(r->lo,a->lo,MPFR_RNDD);mpfr_set(r->hi,a->hi,MPFR_RNDU);}else if(mpfr_sgn(a->hi)<=0){mpfr_neg(r->lo,a->hi,MPFR_RNDD);mpfr_neg(r->hi,a->lo,MPFR_RNDU);}else{mpfr_set_ui(r->lo,0,MPFR_RNDD);mpfr_t x,y;mpfr_inits2(mpfr_get_prec(r->lo),x,y,(mpfr_ptr)0);mpfr_abs(x,a->lo,MPFR_RNDU);mpfr_abs(y,a->hi,MPFR_RNDU);mpfr_set(r->hi,mpfr_cmp(x,y)>0?x:y,MPFR_RNDU);mpfr_clears(x,y,(mpfr_ptr)0);}}void sda_interval_max(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){mpfr_set(r->lo,mpfr_cmp(a->lo,b->lo)>0?a->lo:b->lo,MPFR_RNDD);mpfr_set(r->hi,mpfr_cmp(a->hi,b->hi)>0?a->hi:b->hi,MPFR_RNDU);}int sda_interval_contains(const sda_mpfr_interval*x,const mpfr_t v){return mpfr_cmp(x->lo,v)<=0&&mpfr_cmp(v,x->hi)<=0;}int sda_interval_disjoint(const sda_mpfr_interval*a,const sda_mpfr_interval*b){return mpfr_cmp(a->hi,b->lo)<0||mpfr_cmp(b->hi,a->lo)<0;}void sda_interval_width(mpfr_t out,const sda_mpfr_interval*x){mpfr_sub(out,x->hi,x->lo,MPFR_RNDU);}
+#include "sda_workspace.h"
+void sda_interval_init(sda_mpfr_interval*x,mpfr_prec_t p){mpfr_init2(x->lo,p);mpfr_init2(x->hi,p);}void sda_interval_clear(sda_mpfr_interval*x){mpfr_clear(x->lo);mpfr_clear(x->hi);}void sda_interval_set(sda_mpfr_interval*x,const mpfr_t v){mpfr_set(x->lo,v,MPFR_RNDD);mpfr_set(x->hi,v,MPFR_RNDU);}void sda_interval_set_ui(sda_mpfr_interval*x,unsigned long v){mpfr_set_ui(x->lo,v,MPFR_RNDD);mpfr_set_ui(x->hi,v,MPFR_RNDU);}void sda_interval_add(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){mpfr_add(r->lo,a->lo,b->lo,MPFR_RNDD);mpfr_add(r->hi,a->hi,b->hi,MPFR_RNDU);}void sda_interval_sub(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){mpfr_sub(r->lo,a->lo,b->hi,MPFR_RNDD);mpfr_sub(r->hi,a->hi,b->lo,MPFR_RNDU);}void sda_interval_mul(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){sda_workspace*ws=sda_ws_local();size_t mk=sda_ws_mark(ws);mpfr_ptr v[4];for(int i=0;i<4;i++)v[i]=sda_ws_mpfr(ws,mpfr_get_prec(r->lo));mpfr_mul(v[0],a->lo,b->lo,MPFR_RNDD);mpfr_mul(v[1],a->lo,b->hi,MPFR_RNDD);mpfr_mul(v[2],a->hi,b->lo,MPFR_RNDD);mpfr_mul(v[3],a->hi,b->hi,MPFR_RNDD);mpfr_set(r->lo,v[0],MPFR_RNDD);for(int i=1;i<4;i++)if(mpfr_cmp(v[i],r->lo)<0)mpfr_set(r->lo,v[i],MPFR_RNDD);mpfr_mul(v[0],a->lo,b->lo,MPFR_RNDU);mpfr_mul(v[1],a->lo,b->hi,MPFR_RNDU);mpfr_mul(v[2],a->hi,b->lo,MPFR_RNDU);mpfr_mul(v[3],a->hi,b->hi,MPFR_RNDU);mpfr_set(r->hi,v[0],MPFR_RNDU);for(int i=1;i<4;i++)if(mpfr_cmp(v[i],r->hi)>0)mpfr_set(r->hi,v[i],MPFR_RNDU);sda_ws_release(ws,mk);}void sda_interval_mul_z(sda_mpfr_interval*r,const sda_mpfr_interval*a,const mpz_t z){if(mpz_sgn(z)>=0){mpfr_mul_z(r->lo,a->lo,z,MPFR_RNDD);mpfr_mul_z(r->hi,a->hi,z,MPFR_RNDU);}else{mpfr_mul_z(r->lo,a->hi,z,MPFR_RNDD);mpfr_mul_z(r->hi,a->lo,z,MPFR_RNDU);}}void sda_interval_div(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){sda_workspace*ws=sda_ws_local();size_t mk=sda_ws_mark(ws);sda_mpfr_interval*inv=sda_ws_interval(ws,mpfr_get_prec(r->lo));mpfr_ui_div(inv->lo,1,b->hi,MPFR_RNDD);mpfr_ui_div(inv->hi,1,b->lo,MPFR_RNDU);sda_interval_mul(r,a,inv);sda_ws_release(ws,mk);}void sda_interval_abs(sda_mpfr_interval*r,const sda_mpfr_interval*a){if(mpfr_sgn(a->lo)>=0){mpfr_set(r->lo,a->lo,MPFR_RNDD);mpfr_set(r->hi,a->hi,MPFR_RNDU);}else if(mpfr_sgn(a->hi)<=0){mpfr_neg(r->lo,a->hi,MPFR_RNDD);mpfr_neg(r->hi,a->lo,MPFR_RNDU);}else{mpfr_set_ui(r->lo,0,MPFR_RNDD);sda_workspace*ws=sda_ws_local();size_t mk=sda_ws_mark(ws);sda_mpfr_interval*t=sda_ws_interval(ws,mpfr_get_prec(r->lo));mpfr_abs(t->lo,a->lo,MPFR_RNDU);mpfr_abs(t->hi,a->hi,MPFR_RNDU);mpfr_set(r->hi,mpfr_cmp(t->lo,t->hi)>0?t->lo:t->hi,MPFR_RNDU);sda_ws_release(ws,mk);}}void sda_interval_max(sda_mpfr_interval*r,const sda_mpfr_interval*a,const sda_mpfr_interval*b){mpfr_set(r->lo,mpfr_cmp(a->lo,b->lo)>0?a->lo:b->lo,MPFR_RNDD);mpfr_set(r->hi,mpfr_cmp(a->hi,b->hi)>0?a->hi:b->hi,MPFR_RNDU);}int sda_interval_contains(const sda_mpfr_interval*x,const mpfr_t v){return mpfr_cmp(x->lo,v)<=0&&mpfr_cmp(v,x->hi)<=0;}int sda_interval_disjoint(const sda_mpfr_interval*a,const sda_mpfr_interval*b){return mpfr_cmp(a->hi,b->lo)<0||mpfr_cmp(b->hi,a->lo)<0;}void sda_interval_width(mpfr_t out,const sda_mpfr_interval*x){mpfr_sub(out,x->hi,x->lo,MPFR_RNDU);}
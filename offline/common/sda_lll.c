@@ -1,4 +1,7 @@
 #include "sda_lll.h"
+#include "sda_workspace.h"
+#include <math.h>
+#include <stdlib.h>
 #ifdef SDA_ENABLE_FLINT
 #include <flint/fmpz.h>
 #include <flint/fmpz_mat.h>
@@ -11,3 +14,122 @@ int sda_lll_available(void){ return 0; }
 const char *sda_lll_status(void){ return "dependency unavailable: build with -DSDA_ENABLE_FLINT=ON and install FLINT"; }
 int sda_lll_smoke_run(void){ return -1; }
 #endif
+
+#define LLL_MAX_DIM 64
+#define LLL_MAX_LAZY 64
+#define LLL_ESCALATIONS 4
+void sda_lll_params_default(sda_lll_params *p){ p->delta=0.99; p->eta=0.51; p->block_size=20; p->max_tours=8; p->max_enum_nodes=1ull<<22; p->precision=0; }
+
+/* G is the exact Gram matrix (d x d, kept symmetric); r and mu hold the
+ * Gram-Schmidt data of rows below the current index, s the partial norms
+ * s_j = G_kk - sum_{i<j} mu_ki r_ki of the row being processed. */
+typedef struct { mpz_t *B; size_t d,cols; mpz_ptr *G; mpfr_ptr *r,*mu,*s,t,u; mpz_ptr X; const sda_lll_params *p; sda_lll_stats *st; } lll_ctx;
+#define B_(c,i,j) ((c)->B[(i)*(c)->cols+(j)])
+#define G_(c,i,j) ((c)->G[(i)*(c)->d+(j)])
+#define R_(c,i,j) ((c)->r[(i)*(c)->d+(j)])
+#define MU(c,i,j) ((c)->mu[(i)*(c)->d+(j)])
+
+static void gram_row(lll_ctx *c,size_t i){ for(size_t j=0;j<c->d;j++){ mpz_set_ui(c->X,0); for(size_t k=0;k<c->cols;k++) mpz_addmul(c->X,B_(c,i,k),B_(c,j,k)); mpz_set(G_(c,i,j),c->X); mpz_set(G_(c,j,i),c->X); } }
+static void swap_rows(lll_ctx *c,size_t i,size_t j){ for(size_t k=0;k<c->cols;k++) mpz_swap(B_(c,i,k),B_(c,j,k)); for(size_t k=0;k<c->d;k++) mpz_swap(G_(c,i,k),G_(c,j,k)); for(size_t k=0;k<c->d;k++) mpz_swap(G_(c,k,i),G_(c,k,j)); }
+/* Moves row `from` to position `to` <= from, shifting the rows in between up. */
+static void rotate(lll_ctx *c,size_t to,size_t from){ for(size_t i=from;i>to;i--) swap_rows(c,i,i-1); }
+
+static void gso_row(lll_ctx *c,size_t k){
+  for(size_t j=0;j<k;j++){ mpfr_set_z(c->t,G_(c,k,j),MPFR_RNDN); for(size_t i=0;i<j;i++){ mpfr_mul(c->u,MU(c,j,i),R_(c,k,i),MPFR_RNDN); mpfr_sub(c->t,c->t,c->u,MPFR_RNDN); } mpfr_set(R_(c,k,j),c->t,MPFR_RNDN); mpfr_div(MU(c,k,j),c->t,R_(c,j,j),MPFR_RNDN); }
+  mpfr_set_z(c->s[0],G_(c,k,k),MPFR_RNDN); for(size_t j=0;j<k;j++){ mpfr_mul(c->u,MU(c,k,j),R_(c,k,j),MPFR_RNDN); mpfr_sub(c->s[j+1],c->s[j],c->u,MPFR_RNDN); }
+  mpfr_set(R_(c,k,k),c->s[k],MPFR_RNDN);
+}
+
+static int size_reduce(lll_ctx *c,size_t k){
+  for(int it=0;it<LLL_MAX_LAZY;it++){
+    gso_row(c,k); int done=1; for(size_t j=0;j<k&&done;j++) if(mpfr_cmp_d(MU(c,k,j),c->p->eta)>0||mpfr_cmp_d(MU(c,k,j),-c->p->eta)<0) done=0;
+    if(done) return mpfr_sgn(R_(c,k,k))>0?0:-2;
+    for(size_t j=k;j-->0;){ mpfr_round(c->t,MU(c,k,j)); if(mpfr_zero_p(c->t)) continue; mpfr_get_z(c->X,c->t,MPFR_RNDN);
+      for(size_t l=0;l<c->cols;l++) mpz_submul(B_(c,k,l),c->X,B_(c,j,l));
+      for(size_t i=0;i<j;i++){ mpfr_mul_z(c->u,MU(c,j,i),c->X,MPFR_RNDN); mpfr_sub(MU(c,k,i),MU(c,k,i),c->u,MPFR_RNDN); } }
+    gram_row(c,k); c->st->size_reductions++;
+  }
+  return -2;
+}
+
+/* L2 from row `from`; the Gram-Schmidt data of rows below it must be current. */
+static int lll_from(lll_ctx *c,size_t from){
+  size_t k=from; if(!k){ mpfr_set_z(R_(c,0,0),G_(c,0,0),MPFR_RNDN); k=1; }
+  while(k<c->d){
+    if(size_reduce(c,k)) return -2;
+    size_t to=k; while(to>0){ mpfr_mul_d(c->t,R_(c,to-1,to-1),c->p->delta,MPFR_RNDN); if(mpfr_cmp(c->t,c->s[to-1])<=0) break; to--; }
+    if(to==k){ k++; continue; }
+    for(size_t j=0;j<to;j++){ mpfr_set(R_(c,to,j),R_(c,k,j),MPFR_RNDN); mpfr_set(MU(c,to,j),MU(c,k,j),MPFR_RNDN); }
+    mpfr_set(R_(c,to,to),c->s[to],MPFR_RNDN); rotate(c,to,k); c->st->insertions++; k=to+1;
+  }
+  return 0;
+}
+
+/* Shortest nonzero vector of the block [k,k+m) projected orthogonally to the
+ * rows before k, below delta*r_kk. Zig-zag enumeration; while all higher
+ * coefficients are zero a level only walks upwards (v and -v). */
+static int enum_block(lll_ctx *c,size_t k,size_t m,long *best){
+  long double mu[LLL_MAX_DIM][LLL_MAX_DIM],rr[LLL_MAX_DIM],ctr[LLL_MAX_DIM],l[LLL_MAX_DIM+1]; long x[LLL_MAX_DIM],dx[LLL_MAX_DIM],ddx[LLL_MAX_DIM]; unsigned char zero[LLL_MAX_DIM+1];
+  for(size_t i=0;i<m;i++){ rr[i]=mpfr_get_ld(R_(c,k+i,k+i),MPFR_RNDN); for(size_t j=0;j<i;j++) mu[i][j]=mpfr_get_ld(MU(c,k+i,k+j),MPFR_RNDN); }
+  long double R2=(long double)c->p->delta*rr[0]; int found=0; unsigned long long nodes=0;
+  size_t i=m-1; l[m]=0; zero[m]=1; zero[i]=1; ctr[i]=0; x[i]=0; dx[i]=ddx[i]=1;
+  for(;;){
+    long double e=(long double)x[i]-ctr[i]; l[i]=l[i+1]+e*e*rr[i]; nodes++;
+    if(l[i]<R2&&nodes<=c->p->max_enum_nodes){
+      if(i){ zero[i]=zero[i+1]&&!x[i]; i--; long double s=0; for(size_t j=i+1;j<m;j++) s-=(long double)x[j]*mu[j][i]; ctr[i]=s; x[i]=zero[i+1]?0:lroundl(s); dx[i]=ddx[i]=(zero[i+1]||s>=(long double)x[i])?1:-1; continue; }
+      if(!zero[1]||x[0]){ R2=l[0]; found=1; for(size_t j=0;j<m;j++) best[j]=x[j]; }
+    } else { if(nodes>c->p->max_enum_nodes||++i==m) break; }
+    if(zero[i+1]) x[i]++; else { x[i]+=dx[i]; ddx[i]=-ddx[i]; dx[i]=ddx[i]-dx[i]; }
+  }
+  c->st->enum_nodes+=nodes; return found;
+}
+
+/* Replaces the block rows by a unimodular transform of themselves in which
+ * sum x_j b_{k+j} is a row, then moves that row to k. x must be primitive. */
+static void insert_block(lll_ctx *c,size_t k,size_t m,long *x){
+  size_t piv=m;
+  for(size_t j=0;j<m;j++){ if(!x[j]) continue; if(piv==m){ piv=j; continue; }
+    size_t P=piv,Q=j; long a=x[P],b=x[Q];
+    while(b){ long q=a/b; mpz_set_si(c->X,q); for(size_t t=0;t<c->cols;t++) mpz_addmul(B_(c,k+Q,t),c->X,B_(c,k+P,t)); a-=q*b; long tv=a; a=b; b=tv; size_t u=P; P=Q; Q=u; }
+    x[P]=a; x[Q]=0; piv=P; }
+  if(x[piv]<0) for(size_t t=0;t<c->cols;t++) mpz_neg(B_(c,k+piv,t),B_(c,k+piv,t));
+  for(size_t i=k+piv;i>k;i--) for(size_t t=0;t<c->cols;t++) mpz_swap(B_(c,i,t),B_(c,i-1,t));
+  for(size_t i=k;i<k+m;i++) gram_row(c,i);
+}
+
+static double potential(lll_ctx *c){ double s=0; for(size_t i=0;i<c->d;i++){ long e; double v=mpfr_get_d_2exp(&e,R_(c,i,i),MPFR_RNDN); s+=(double)(c->d-i)*(log(v)+(double)e*log(2.0)); } return s; }
+
+static int bkz_tours(lll_ctx *c){
+  int rc=lll_from(c,0); if(rc) return rc;
+  size_t beta=c->p->block_size<c->d?c->p->block_size:c->d; long x[LLL_MAX_DIM]; double pot=potential(c); int stalls=0;
+  for(unsigned tour=0;tour<c->p->max_tours&&beta>=2;tour++){
+    unsigned long long before=c->st->bkz_insertions;
+    for(size_t k=0;k+1<c->d;k++){ size_t m=c->d-k<beta?c->d-k:beta; if(m<2) break;
+      if(!enum_block(c,k,m,x)) continue;
+      long g=0; for(size_t j=0;j<m;j++){ long a=labs(x[j]),b=g; while(b){ long t=a%b; a=b; b=t; } g=a; } if(g!=1) continue;
+      insert_block(c,k,m,x); c->st->bkz_insertions++; if((rc=lll_from(c,k))) return rc; }
+    c->st->tours++; if(c->st->bkz_insertions==before) break;
+    double np=potential(c); stalls=(pot-np<=1e-6*fabs(pot))?stalls+1:0; pot=np; if(stalls>=3){ c->st->early_abort=1; break; }
+  }
+  return 0;
+}
+
+static int reduce(mpz_t *B,size_t d,size_t cols,const sda_lll_params *p,sda_lll_stats *st,int bkz){
+  sda_lll_params def; if(!p){ sda_lll_params_default(&def); p=&def; }
+  if(!B||!st||!d||d>LLL_MAX_DIM||!cols||!(p->delta>0.25&&p->delta<1)||!(p->eta>=0.5&&p->eta*p->eta<p->delta)) return -1;
+  *st=(sda_lll_stats){0}; mpfr_prec_t prec=p->precision;
+  if(!prec){ size_t bits=1; for(size_t i=0;i<d*cols;i++){ size_t b=mpz_sizeinbase(B[i],2); if(b>bits) bits=b; } prec=(mpfr_prec_t)(2*bits+2*d+64); prec=(prec+63)/64*64; }
+  sda_workspace *ws=sda_ws_local(); int rc=-2;
+  for(unsigned attempt=0;attempt<=LLL_ESCALATIONS&&rc==-2;attempt++,prec*=2){
+    size_t mk=sda_ws_mark(ws); mpz_ptr G[LLL_MAX_DIM*LLL_MAX_DIM]; mpfr_ptr r[LLL_MAX_DIM*LLL_MAX_DIM],mu[LLL_MAX_DIM*LLL_MAX_DIM],s[LLL_MAX_DIM+1];
+    lll_ctx c={B,d,cols,G,r,mu,s,sda_ws_mpfr(ws,prec),sda_ws_mpfr(ws,prec),sda_ws_mpz(ws),p,st};
+    for(size_t i=0;i<d*d;i++){ G[i]=sda_ws_mpz(ws); r[i]=sda_ws_mpfr(ws,prec); mu[i]=sda_ws_mpfr(ws,prec); } for(size_t i=0;i<=d;i++) s[i]=sda_ws_mpfr(ws,prec);
+    for(size_t i=0;i<d;i++) gram_row(&c,i);
+    if(attempt) st->precision_escalations++;
+    st->precision_used=prec;
+    rc=bkz?bkz_tours(&c):lll_from(&c,0); sda_ws_release(ws,mk);
+  }
+  return rc;
+}
+int sda_lll_reduce(mpz_t *B,size_t d,size_t cols,const sda_lll_params *p,sda_lll_stats *st){ return reduce(B,d,cols,p,st,0); }
+int sda_bkz_reduce(mpz_t *B,size_t d,size_t cols,const sda_lll_params *p,sda_lll_stats *st){ return reduce(B,d,cols,p,st,1); }
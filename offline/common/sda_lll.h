@@ -1,4 +1,27 @@
 #ifndef SDA_LLL_H
 #define SDA_LLL_H
+#include <stddef.h>
+#include <mpfr.h>
+#include <gmp.h>
 int sda_lll_available(void); const char *sda_lll_status(void); int sda_lll_smoke_run(void);
+
+/* In-tree lattice reduction, independent of FLINT. B holds d linearly
+ * independent row vectors of `cols` integers (row-major) and is reduced in
+ * place by unimodular row operations. LLL follows L2 (Nguyen-Stehle): exact
+ * integer Gram matrix, Gram-Schmidt in MPFR, lazy size reduction to |mu| <=
+ * eta and insertion of each vector at the first position where the Lovasz
+ * condition fails. BKZ runs tours of projected-block SVP enumeration (long
+ * double, zig-zag, at most max_enum_nodes nodes per block) and inserts a block
+ * vector shorter than delta*r_kk by a unimodular transform followed by LLL.
+ * Tours stop when one makes no insertion, after max_tours, or (early abort)
+ * when the basis potential sum (d-i)*log r_ii has improved by less than
+ * 1e-6 relative for three tours in a row. precision 0 derives the Gram-Schmidt
+ * precision from the entry sizes; when it proves too small (a non-positive
+ * r_kk or a size reduction that does not settle) it is doubled, up to four
+ * times. Returns 0, -1 invalid input, -2 precision exhausted. */
+typedef struct { double delta,eta; unsigned block_size,max_tours; unsigned long long max_enum_nodes; mpfr_prec_t precision; } sda_lll_params;
+typedef struct { unsigned long long size_reductions,insertions,bkz_insertions,enum_nodes; unsigned tours,precision_escalations; mpfr_prec_t precision_used; int early_abort; } sda_lll_stats;
+void sda_lll_params_default(sda_lll_params *p);
+int sda_lll_reduce(mpz_t *B, size_t d, size_t cols, const sda_lll_params *p, sda_lll_stats *st);
+int sda_bkz_reduce(mpz_t *B, size_t d, size_t cols, const sda_lll_params *p, sda_lll_stats *st);
 #endif
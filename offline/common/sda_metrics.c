@@ -1,8 +1,9 @@
 #include "sda_metrics.h"
+#include "sda_workspace.h"
 static void set_u128(mpfr_t r,sda_u128 v){ mpfr_set_ui_2exp(r,(unsigned long)(v>>64),64,MPFR_RNDN); mpfr_add_ui(r,r,(unsigned long)v,MPFR_RNDN); }
 void sda_metrics_init(sda_metrics*m,mpfr_prec_t p){ mpfr_inits2(p,m->max_scaled_error,m->max_absolute_error,m->l1_error,m->sd_support,m->sd_infinite,m->tail_mass,m->renyi,m->renyi_minus_one,(mpfr_ptr)0); m->renyi_infinite=0; }
 void sda_metrics_clear(sda_metrics*m){ mpfr_clears(m->max_scaled_error,m->max_absolute_error,m->l1_error,m->sd_support,m->sd_infinite,m->tail_mass,m->renyi,m->renyi_minus_one,(mpfr_ptr)0); }
-int sda_compute_metrics(mpfr_t*qdist,size_t n,const sda_u128*p,sda_u128 q,long ro,sda_metrics*m){ mpfr_prec_t pr=mpfr_get_prec(qdist[0]); mpfr_t qq,pp,d,term,maxlog,sumexp; mpfr_inits2(pr,qq,pp,d,term,maxlog,sumexp,(mpfr_ptr)0); set_u128(qq,q); mpfr_set_zero(m->l1_error,0); mpfr_set_zero(m->max_absolute_error,0); mpfr_set_zero(m->max_scaled_error,0); for(size_t i=0;i<n;i++){ set_u128(pp,p[i]); mpfr_div(pp,pp,qq,MPFR_RNDN); mpfr_sub(d,qdist[i],pp,MPFR_RNDN); mpfr_abs(d,d,MPFR_RNDN); mpfr_add(m->l1_error,m->l1_error,d,MPFR_RNDN); if(mpfr_cmp(d,m->max_absolute_error)>0) mpfr_set(m->max_absolute_error,d,MPFR_RNDN); mpfr_mul(term,d,qq,MPFR_RNDN); if(mpfr_cmp(term,m->max_scaled_error)>0) mpfr_set(m->max_scaled_error,term,MPFR_RNDN); }
- mpfr_div_ui(m->sd_support,m->l1_error,2,MPFR_RNDN); mpfr_set(m->sd_infinite,m->sd_support,MPFR_RNDN); mpfr_set_zero(m->tail_mass,0); int first=1; mpfr_set_zero(maxlog,0); for(size_t i=0;i<n;i++){ set_u128(pp,p[i]); mpfr_div(pp,pp,qq,MPFR_RNDN); if(mpfr_zero_p(pp)) continue; if(mpfr_zero_p(qdist[i])){ m->renyi_infinite=1; mpfr_set_inf(m->renyi,1); mpfr_set_inf(m->renyi_minus_one,1); mpfr_clears(qq,pp,d,term,maxlog,sumexp,(mpfr_ptr)0); return 0; } mpfr_log(term,pp,MPFR_RNDN); mpfr_mul_si(term,term,ro,MPFR_RNDN); mpfr_log(d,qdist[i],MPFR_RNDN); mpfr_mul_si(d,d,ro-1,MPFR_RNDN); mpfr_sub(term,term,d,MPFR_RNDN); if(first||mpfr_cmp(term,maxlog)>0){mpfr_set(maxlog,term,MPFR_RNDN); first=0;} }
+int sda_compute_metrics(mpfr_t*qdist,size_t n,const sda_u128*p,sda_u128 q,long ro,sda_metrics*m){ mpfr_prec_t pr=mpfr_get_prec(qdist[0]); sda_workspace *ws=sda_ws_local(); size_t mk=sda_ws_mark(ws); mpfr_ptr qq=sda_ws_mpfr(ws,pr),pp=sda_ws_mpfr(ws,pr),d=sda_ws_mpfr(ws,pr),term=sda_ws_mpfr(ws,pr),maxlog=sda_ws_mpfr(ws,pr),sumexp=sda_ws_mpfr(ws,pr); set_u128(qq,q); mpfr_set_zero(m->l1_error,0); mpfr_set_zero(m->max_absolute_error,0); mpfr_set_zero(m->max_scaled_error,0); for(size_t i=0;i<n;i++){ set_u128(pp,p[i]); mpfr_div(pp,pp,qq,MPFR_RNDN); mpfr_sub(d,qdist[i],pp,MPFR_RNDN); mpfr_abs(d,d,MPFR_RNDN); mpfr_add(m->l1_error,m->l1_error,d,MPFR_RNDN); if(mpfr_cmp(d,m->max_absolute_error)>0) mpfr_set(m->max_absolute_error,d,MPFR_RNDN); mpfr_mul(term,d,qq,MPFR_RNDN); if(mpfr_cmp(term,m->max_scaled_error)>0) mpfr_set(m->max_scaled_error,term,MPFR_RNDN); }
+ mpfr_div_ui(m->sd_support,m->l1_error,2,MPFR_RNDN); mpfr_set(m->sd_infinite,m->sd_support,MPFR_RNDN); mpfr_set_zero(m->tail_mass,0); int first=1; mpfr_set_zero(maxlog,0); for(size_t i=0;i<n;i++){ set_u128(pp,p[i]); mpfr_div(pp,pp,qq,MPFR_RNDN); if(mpfr_zero_p(pp)) continue; if(mpfr_zero_p(qdist[i])){ m->renyi_infinite=1; mpfr_set_inf(m->renyi,1); mpfr_set_inf(m->renyi_minus_one,1); sda_ws_release(ws,mk); return 0; } mpfr_log(term,pp,MPFR_RNDN); mpfr_mul_si(term,term,ro,MPFR_RNDN); mpfr_log(d,qdist[i],MPFR_RNDN); mpfr_mul_si(d,d,ro-1,MPFR_RNDN); mpfr_sub(term,term,d,MPFR_RNDN); if(first||mpfr_cmp(term,maxlog)>0){mpfr_set(maxlog,term,MPFR_RNDN); first=0;} }
  if(first){ mpfr_set_ui(m->renyi,0,MPFR_RNDN); mpfr_set_si(m->renyi_minus_one,-1,MPFR_RNDN); } else { mpfr_set_zero(sumexp,0); for(size_t i=0;i<n;i++){ set_u128(pp,p[i]); mpfr_div(pp,pp,qq,MPFR_RNDN); if(mpfr_zero_p(pp)) continue; mpfr_log(term,pp,MPFR_RNDN); mpfr_mul_si(term,term,ro,MPFR_RNDN); mpfr_log(d,qdist[i],MPFR_RNDN); mpfr_mul_si(d,d,ro-1,MPFR_RNDN); mpfr_sub(term,term,d,MPFR_RNDN); mpfr_sub(term,term,maxlog,MPFR_RNDN); mpfr_exp(term,term,MPFR_RNDN); mpfr_add(sumexp,sumexp,term,MPFR_RNDN);} mpfr_log(sumexp,sumexp,MPFR_RNDN); mpfr_add(sumexp,sumexp,maxlog,MPFR_RNDN); mpfr_div_si(sumexp,sumexp,ro-1,MPFR_RNDN); mpfr_exp(m->renyi,sumexp,MPFR_RNDN); mpfr_sub_ui(m->renyi_minus_one,m->renyi,1,MPFR_RNDN); }
- mpfr_clears(qq,pp,d,term,maxlog,sumexp,(mpfr_ptr)0); return 0; }
+ sda_ws_release(ws,mk); return 0; }
@@ -0,0 +1,60 @@
+#include "sda_trace.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* pend[] collects rows under mu; the writer swaps it with its own buffers and
+ * writes outside the lock, so producers only ever wait for a memcpy. flushed
+ * catches up with requested once everything pending at the request is on disk.
+ * Without a writer thread rows are written directly. */
+enum { ALL, REJECTED, FEASIBLE, NFILES };
+static const char *const names[NFILES]={"sda_all_candidates.csv","sda_rejected_candidates.csv","sda_feasible_candidates.csv"};
+typedef struct { char *p; size_t len,cap; } tbuf;
+static struct { pthread_mutex_t mu; pthread_cond_t work,done; pthread_t tid; FILE *f[NFILES]; tbuf pend[NFILES]; size_t pending; unsigned long long requested,flushed; int open,threaded,stop; } S={.mu=PTHREAD_MUTEX_INITIALIZER,.work=PTHREAD_COND_INITIALIZER,.done=PTHREAD_COND_INITIALIZER};
+static int header_done, exit_hook;
+
+static int append(tbuf *b,const char *s,size_t n){ if(b->len+n>b->cap){ size_t c=b->cap?b->cap:SDA_TRACE_FLUSH_BYTES; while(c<b->len+n) c*=2; char *p=realloc(b->p,c); if(!p) return -1; b->p=p; b->cap=c; } memcpy(b->p+b->len,s,n); b->len+=n; return 0; }
+
+static void *writer(void *arg){ (void)arg; tbuf mine[NFILES]={{0}};
+  pthread_mutex_lock(&S.mu);
+  for(;;){
+    while(!S.stop&&S.flushed==S.requested&&S.pending<SDA_TRACE_FLUSH_BYTES) pthread_cond_wait(&S.work,&S.mu);
+    unsigned long long want=S.requested; int stop=S.stop; for(int i=0;i<NFILES;i++){ tbuf t=mine[i]; mine[i]=S.pend[i]; S.pend[i]=t; } S.pending=0;
+    pthread_mutex_unlock(&S.mu);
+    for(int i=0;i<NFILES;i++){ if(mine[i].len) fwrite(mine[i].p,1,mine[i].len,S.f[i]); mine[i].len=0; if(want>S.flushed) fflush(S.f[i]); }
+    pthread_mutex_lock(&S.mu); if(want>S.flushed){ S.flushed=want; pthread_cond_broadcast(&S.done); }
+    if(stop&&!S.pending) break;
+  }
+  pthread_mutex_unlock(&S.mu); for(int i=0;i<NFILES;i++) free(mine[i].p); return 0; }
+
+int sda_trace_open(const char *dir,const char *header){
+  pthread_mutex_lock(&S.mu); if(S.open){ pthread_mutex_unlock(&S.mu); return 0; }
+  char path[4096]; int ok=1; for(int i=0;i<NFILES;i++){ snprintf(path,sizeof path,"%s/%s",dir,names[i]); S.f[i]=ok?fopen(path,"a"):0; if(!S.f[i]) ok=0; }
+  if(!ok){ for(int i=0;i<NFILES;i++) if(S.f[i]){ fclose(S.f[i]); S.f[i]=0; } pthread_mutex_unlock(&S.mu); return -1; }
+  if(!header_done&&header){ for(int i=0;i<NFILES;i++) fputs(header,S.f[i]); header_done=1; }
+  S.open=1; S.stop=0; S.threaded=!pthread_create(&S.tid,0,writer,0);
+  if(!exit_hook) exit_hook=!atexit(sda_trace_close);
+  pthread_mutex_unlock(&S.mu); return 0;
+}
+
+int sda_trace_write(const char *row,size_t len,int feasible){
+  pthread_mutex_lock(&S.mu); int rc=-1, k=feasible?FEASIBLE:REJECTED;
+  if(S.open&&!S.threaded){ fwrite(row,1,len,S.f[ALL]); fwrite(row,1,len,S.f[k]); rc=0; }
+  else if(S.open){ rc=append(&S.pend[ALL],row,len); if(!rc) rc=append(&S.pend[k],row,len); if(!rc){ S.pending+=2*len; if(S.pending>=SDA_TRACE_FLUSH_BYTES) pthread_cond_signal(&S.work); } }
+  pthread_mutex_unlock(&S.mu); return rc;
+}
+
+void sda_trace_flush(void){
+  pthread_mutex_lock(&S.mu);
+  if(S.open&&S.threaded){ unsigned long long want=++S.requested; pthread_cond_signal(&S.work); while(S.flushed<want) pthread_cond_wait(&S.done,&S.mu); }
+  else if(S.open) for(int i=0;i<NFILES;i++) fflush(S.f[i]);
+  pthread_mutex_unlock(&S.mu);
+}
+
+void sda_trace_close(void){
+  pthread_mutex_lock(&S.mu); if(!S.open){ pthread_mutex_unlock(&S.mu); return; }
+  int threaded=S.threaded; S.stop=1; S.open=0; pthread_cond_signal(&S.work); pthread_mutex_unlock(&S.mu);
+  if(threaded) pthread_join(S.tid,0);
+  pthread_mutex_lock(&S.mu); for(int i=0;i<NFILES;i++){ fclose(S.f[i]); S.f[i]=0; free(S.pend[i].p); S.pend[i]=(tbuf){0}; } S.pending=0; S.requested=S.flushed=0; S.stop=0; pthread_mutex_unlock(&S.mu);
+}
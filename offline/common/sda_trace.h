@@ -0,0 +1,19 @@
+#ifndef SDA_TRACE_H
+#define SDA_TRACE_H
+#include <stddef.h>
+/* Candidate trace sink for sda_all_candidates.csv, sda_rejected_candidates.csv
+ * and sda_feasible_candidates.csv under dir. sda_trace_open opens the three
+ * files for appending once and keeps them open (later calls return 0 without
+ * reopening); the header goes out with the first open of the process. Rows are
+ * copied into in-memory buffers and a writer thread moves them to the files
+ * once SDA_TRACE_FLUSH_BYTES are pending, on sda_trace_flush and at close, in
+ * the order they were written. Every row goes to the all file and to the
+ * feasible or rejected one. The sink is closed at exit if sda_trace_close has
+ * not been called. open returns -1 when a file cannot be opened; write returns
+ * -1 when the sink is not open. */
+#define SDA_TRACE_FLUSH_BYTES (1u<<20)
+int sda_trace_open(const char *dir, const char *header);
+int sda_trace_write(const char *row, size_t len, int feasible);
+void sda_trace_flush(void);
+void sda_trace_close(void);
+#endif
@@ -0,0 +1,36 @@
+#include "sda_workspace.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+/* Every slot is an interval so scalar and interval draws share one stack per
+ * precision; a scalar uses lo. log[] records the pool of each live draw (MPZ
+ * for the integer stack) so a release can walk back to any mark. */
+#define MPZ ((unsigned)-1)
+typedef struct { mpfr_prec_t prec; sda_mpfr_interval **slot; size_t top,cap; } ws_pool;
+struct sda_workspace { ws_pool *pool; size_t npool; __mpz_struct **z; size_t ztop,zcap; unsigned *log; size_t len,logcap; unsigned long long allocations; };
+
+static void *grow(void *p,size_t *cap,size_t size){ size_t c=*cap?*cap*2:16; p=realloc(p,c*size); if(!p) abort(); *cap=c; return p; }
+static void push_log(sda_workspace *ws,unsigned id){ if(ws->len==ws->logcap) ws->log=grow(ws->log,&ws->logcap,sizeof *ws->log); ws->log[ws->len++]=id; }
+
+static void ws_free(void *arg){ sda_workspace *ws=arg; if(!ws) return;
+  for(size_t i=0;i<ws->npool;i++){ ws_pool *p=&ws->pool[i]; for(size_t j=0;j<p->cap&&p->slot[j];j++){ sda_interval_clear(p->slot[j]); free(p->slot[j]); } free(p->slot); }
+  for(size_t j=0;j<ws->zcap&&ws->z[j];j++){ mpz_clear(ws->z[j]); free(ws->z[j]); }
+  free(ws->pool); free(ws->z); free(ws->log); free(ws); }
+
+static pthread_key_t key; static pthread_once_t key_once=PTHREAD_ONCE_INIT; static _Thread_local sda_workspace *local;
+static void key_init(void){ if(pthread_key_create(&key,ws_free)) abort(); }
+sda_workspace *sda_ws_local(void){ if(local) return local; sda_workspace *ws=calloc(1,sizeof *ws); if(!ws) abort(); pthread_once(&key_once,key_init); if(pthread_setspecific(key,ws)) abort(); return local=ws; }
+
+size_t sda_ws_mark(const sda_workspace *ws){ return ws->len; }
+void sda_ws_release(sda_workspace *ws,size_t mark){ while(ws->len>mark){ unsigned id=ws->log[--ws->len]; if(id==MPZ) ws->ztop--; else ws->pool[id].top--; } }
+
+sda_mpfr_interval *sda_ws_interval(sda_workspace *ws,mpfr_prec_t prec){ size_t i=0; while(i<ws->npool&&ws->pool[i].prec!=prec) i++;
+  if(i==ws->npool){ if(i==MPZ) abort(); ws_pool *np=realloc(ws->pool,(i+1)*sizeof *np); if(!np) abort(); ws->pool=np; np[i]=(ws_pool){prec,0,0,0}; ws->npool++; }
+  ws_pool *p=&ws->pool[i]; if(p->top==p->cap){ size_t old=p->cap; p->slot=grow(p->slot,&p->cap,sizeof *p->slot); for(size_t j=old;j<p->cap;j++) p->slot[j]=0; }
+  if(!p->slot[p->top]){ sda_mpfr_interval *s=malloc(sizeof *s); if(!s) abort(); sda_interval_init(s,prec); p->slot[p->top]=s; ws->allocations+=2; }
+  push_log(ws,(unsigned)i); return p->slot[p->top++]; }
+mpfr_ptr sda_ws_mpfr(sda_workspace *ws,mpfr_prec_t prec){ return sda_ws_interval(ws,prec)->lo; }
+mpz_ptr sda_ws_mpz(sda_workspace *ws){ if(ws->ztop==ws->zcap){ size_t old=ws->zcap; ws->z=grow(ws->z,&ws->zcap,sizeof *ws->z); for(size_t j=old;j<ws->zcap;j++) ws->z[j]=0; }
+  if(!ws->z[ws->ztop]){ __mpz_struct *z=malloc(sizeof *z); if(!z) abort(); mpz_init(z); ws->z[ws->ztop]=z; ws->allocations++; }
+  push_log(ws,MPZ); return ws->z[ws->ztop++]; }
+unsigned long long sda_ws_allocations(const sda_workspace *ws){ return ws->allocations; }
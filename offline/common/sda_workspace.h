@@ -0,0 +1,23 @@
+#ifndef SDA_WORKSPACE_H
+#define SDA_WORKSPACE_H
+#include <stddef.h>
+#include <mpfr.h>
+#include <gmp.h>
+#include "sda_interval.h"
+/* Reusable MPFR/GMP temporaries for the certification hot loops. Slots are kept
+ * in one pool per precision and handed out LIFO: take a mark, draw what the
+ * call needs, release back to the mark before returning. Once a call has run
+ * at a given precision, repeating it allocates nothing. Drawn values hold
+ * whatever the previous user left. sda_ws_local() is the calling thread's
+ * workspace, created on first use and freed when the thread exits; like MPFR
+ * itself, running out of memory aborts. */
+typedef struct sda_workspace sda_workspace;
+sda_workspace *sda_ws_local(void);
+size_t sda_ws_mark(const sda_workspace *ws);
+void sda_ws_release(sda_workspace *ws, size_t mark);
+mpfr_ptr sda_ws_mpfr(sda_workspace *ws, mpfr_prec_t prec);
+sda_mpfr_interval *sda_ws_interval(sda_workspace *ws, mpfr_prec_t prec);
+mpz_ptr sda_ws_mpz(sda_workspace *ws);
+/* Slots initialised so far (mpfr_t and mpz_t), for checking steady state. */
+unsigned long long sda_ws_allocations(const sda_workspace *ws);
+#endif
@@ -0,0 +1,399 @@
+#!/usr/bin/python3
+"""Generate parameter-specialized Frodo online kernels.
+
+Reads the table manifest (online/tables/frodo/online_table_manifest.csv) for
+q, draw bits and support of every Frodo table, takes the cumulative thresholds
+from the frozen online source of truth (online/common/sdat_tables.c), and
+optionally appends research tables in the export_tables format
+(`<parameter_set> q=<q> masses=<m0> <m1> ...`, one per line).
+
+For every table it emits unrolled, constant-specialized kernels with the
+signatures of the hand-written frontends:
+  original-cdt-table  original-word lookup (scalar, AVX2)
+  sda-table           packed-bit sample_n / run and word-oriented
+                      sample_n / run (scalar, AVX2)
+plus the frodo_gen_reference / frodo_gen_avx2 registries and the
+frodo_gen_kernel_table_reference / frodo_gen_kernel_table_avx2 dispatch
+tables, which hold the manifest kernels at their frodo_param_id. Plans,
+streams and the parallel dispatcher run those. The generic entry points in
+online/frodo consult the registries by table content when a table is not one
+of the built-in pointers, so a new parameter set only needs a manifest row
+(or an exported table) and a regeneration.
+
+Usage:
+  offline/scripts/generate_online_kernels.py [--exported FILE ...] [--check]
+"""
+from __future__ import annotations
+import argparse, csv, re, sys
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[2]
+MANIFEST = ROOT / "online" / "tables" / "frodo" / "online_table_manifest.csv"
+TABLES_C = ROOT / "online" / "common" / "sdat_tables.c"
+OUT_DIR = ROOT / "online" / "frodo" / "generated"
+MAX_THRESHOLDS = 16
+HEADER = "/* Generated by offline/scripts/generate_online_kernels.py; do not edit. */\n"
+
+
+class Table:
+    def __init__(self, name, parameter_set, family, q, bits, value_type, thresholds, source, param=None):
+        self.name, self.parameter_set, self.family, self.param = name, parameter_set, family, param
+        self.q, self.bits, self.value_type = q, bits, value_type
+        self.thresholds, self.source = thresholds, source
+        self.sda = family == "sda-table"
+        if len(thresholds) > MAX_THRESHOLDS:
+            raise SystemExit(f"{name}: {len(thresholds)} thresholds, at most {MAX_THRESHOLDS} supported")
+        if self.sda and not (1 <= bits <= 15 and q <= (1 << bits)):
+            raise SystemExit(f"{name}: SDA tables need q <= 2^bits and bits <= 15 (sign bit inside a 16-bit word)")
+        if not self.sda and (bits != 15 or value_type != "U16"):
+            raise SystemExit(f"{name}: Original CDT tables use 15-bit draws and uint16_t thresholds")
+        if thresholds != sorted(thresholds) or (thresholds and thresholds[-1] >= (q if self.sda else 1 << bits)):
+            raise SystemExit(f"{name}: thresholds must be nondecreasing and below q")
+
+
+def c_arrays(path: Path) -> dict[str, tuple[str, list[int]]]:
+    text = path.read_text()
+    arrays = {}
+    for m in re.finditer(r"static const (uint8_t|uint16_t) (\w+)\[\]=\{([^}]*)\};", text):
+        arrays[m.group(2)] = (m.group(1), [int(v) for v in m.group(3).split(",") if v.strip()])
+    return arrays
+
+
+def manifest_tables(manifest: Path, tables_c: Path) -> list[Table]:
+    arrays = c_arrays(tables_c)
+    out = []
+    with manifest.open(newline="") as f:
+        for row in csv.DictReader(f):
+            if row["scheme"] != "Frodo":
+                continue
+            pset, family = row["parameter_set"], row["table_family"]
+            suffix = pset[len("frodo"):]
+            prefix = "orig" if family == "original-cdt-table" else "sda" if family == "sda-table" else None
+            if prefix is None or f"{prefix}{suffix}_c" not in arrays:
+                raise SystemExit(f"no threshold array for {pset}/{family} in {tables_c}")
+            ctype, cum = arrays[f"{prefix}{suffix}_c"]
+            lo, hi = (int(v) for v in row["support"].split(".."))
+            if len(cum) != hi - lo + 1:
+                raise SystemExit(f"{pset}/{family}: support {row['support']} but {len(cum)} cumulative entries")
+            q = int(row["q"])
+            # The terminal cumulative value (q, or 2^15 - 1 for the CDT) is not stored online.
+            name = f"{pset}_{prefix if prefix == 'sda' else 'original'}"
+            out.append(Table(name, pset, family, q, int(row["draw_bits"]),
+                             "U8" if ctype == "uint8_t" else "U16", cum[:-1], f"{manifest.name}:{pset}",
+                             f"FRODO_PARAM_{suffix}"))
+    return out
+
+
+def exported_tables(path: Path, taken: set[str]) -> list[Table]:
+    out = []
+    for line in path.read_text().splitlines():
+        m = re.match(r"\s*(\S+)\s+q=(\d+)\s+masses=(.*)$", line)
+        if not m:
+            continue
+        pset, q = m.group(1), int(m.group(2))
+        masses = [int(v) for v in m.group(3).split()]
+        cum, acc = [], 0
+        for v in masses:
+            acc += v
+            cum.append(acc)
+        if acc != q:
+            raise SystemExit(f"{path}:{pset}: masses sum to {acc}, expected q={q}")
+        base = re.sub(r"\W", "_", pset) + "_sda"
+        name, k = base, 2
+        while name in taken:
+            name, k = f"{base}_{k}", k + 1
+        taken.add(name)
+        out.append(Table(name, pset, "sda-table", q, (q - 1).bit_length(), "U8" if q <= 256 else "U16",
+                         cum[:-1], f"{path.name}:{pset}"))
+    return out
+
+
+def mag_expr(t: Table, var: str, op: str) -> str:
+    if not t.thresholds:
+        return "0"
+    return " + ".join(f"({var} {op} {v}u)" for v in t.thresholds)
+
+
+def emit_scalar_sda(t: Table) -> str:
+    n, b, q = t.name, t.bits, t.q
+    mask = (1 << b) - 1
+    return f"""
+/* {t.source}: q = {q}, {b}-bit candidates, {len(t.thresholds)} thresholds. */
+static inline uint16_t {n}_mag(uint32_t x) {{
+    return (uint16_t)({mag_expr(t, "x", ">=")});
+}}
+
+static inline int {n}_next(sdat_bitreader_fast *r, uint32_t *x, uint32_t *sg, sdat_stats *st) {{
+    for (;;) {{
+        uint32_t v;
+        if (gen_take(r, {b}u, &v)) return -2;
+        if (st) {{
+            st->attempts++;
+            st->random_bits += {b}u;
+        }}
+        if (v >= {q}u) {{
+            if (st) st->rejections++;
+            continue;
+        }}
+        if (gen_take(r, 1u, sg)) return -2;
+        if (st) st->random_bits++;
+        *x = v;
+        return 0;
+    }}
+}}
+
+static int {n}_packed(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {{
+    if (st) *st = (sdat_stats){{0}};
+    for (size_t i = 0; i < n; i++) {{
+        uint32_t x, s;
+        if ({n}_next(r, &x, &s, st)) return -2;
+        out[i] = frodo_apply_sign({n}_mag(x), (uint8_t)s);
+    }}
+    if (st) st->random_bytes = sdat_fast_bytes_used(r);
+    return 0;
+}}
+
+static size_t {n}_packed_run(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {{
+    size_t i = 0;
+    for (; i < n; i++) {{
+        sdat_bitreader_fast save = *r;
+        sdat_stats ss = st ? *st : (sdat_stats){{0}};
+        uint32_t x, s;
+        if ({n}_next(r, &x, &s, st)) {{
+            *r = save;
+            if (st) *st = ss;
+            break;
+        }}
+        out[i] = frodo_apply_sign({n}_mag(x), (uint8_t)s);
+    }}
+    return i;
+}}
+
+static size_t {n}_word_run(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed, sdat_stats *st) {{
+    const uint16_t *src = w, *end = w + wc;
+    uint16_t *dst = out, *dst_end = out + n;
+    while (dst < dst_end && src < end) {{
+        uint16_t z = *src++;
+        uint32_t c = z & 0x{mask:x}u;
+        *dst = frodo_apply_sign({n}_mag(c), (uint8_t)((z >> {b}) & 1u));
+        dst += (unsigned)(c < {q}u);
+    }}
+    size_t used = (size_t)(src - w), k = (size_t)(dst - out);
+    if (consumed) *consumed = used;
+    gen_word_account(k, used, {b}u, st);
+    return k;
+}}
+
+static int {n}_word(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {{
+    if (st) *st = (sdat_stats){{0}};
+    return {n}_word_run(out, n, w, wc, 0, st) == n ? 0 : -2;
+}}
+"""
+
+
+def emit_scalar_original(t: Table) -> str:
+    n = t.name
+    return f"""
+/* {t.source}: 15-bit draws, sign in bit 0, {len(t.thresholds)} thresholds. */
+static int {n}(uint16_t *s, size_t n) {{
+    for (size_t i = 0; i < n; i++) {{
+        uint32_t x = (uint32_t)(s[i] >> 1);
+        s[i] = frodo_apply_sign((uint16_t)({mag_expr(t, "x", ">")}), (uint8_t)(s[i] & 1u));
+    }}
+    return 0;
+}}
+"""
+
+
+def emit_avx2_sda(t: Table) -> str:
+    n, b, q = t.name, t.bits, t.q
+    thr = ", ".join(f"{v}u" for v in t.thresholds) or "0u"
+    return f"""
+static const uint32_t {n}_thr32[] = {{{thr}}};
+
+static int {n}_packed_avx2(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {{
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[{t.index}].packed(out, n, r, st);
+    if (st) *st = (sdat_stats){{0}};
+    sdat_avx2_stats tel = {{1, 0, 0, 0, 0, 0, 0}};
+    size_t d = packed_extract(r, out, n, {b}u, {q}u, {n}_thr32, {len(t.thresholds)}, st, &tel);
+    size_t k = frodo_gen_reference[{t.index}].packed_run(out + d, n - d, r, st);
+    SDAT_TEL_ADD(&tel, scalar_tail_samples, k);
+    SDAT_TEL_FLUSH(&tel);
+    if (d + k != n) return -2;
+    if (st) st->random_bytes = sdat_fast_bytes_used(r);
+    return 0;
+}}
+
+static size_t {n}_packed_run_avx2(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {{
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[{t.index}].packed_run(out, n, r, st);
+    sdat_avx2_stats tel = {{1, 0, 0, 0, 0, 0, 0}};
+    size_t d = packed_extract(r, out, n, {b}u, {q}u, {n}_thr32, {len(t.thresholds)}, st, &tel);
+    SDAT_TEL_FLUSH(&tel);
+    return d + frodo_gen_reference[{t.index}].packed_run(out + d, n - d, r, st);
+}}
+
+static size_t {n}_word_run_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed,
+                                sdat_stats *st) {{
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[{t.index}].word_run(out, n, w, wc, consumed, st);
+    size_t used;
+    uint64_t nb;
+    size_t k = word_kernel(out, n, w, wc, 0x{(1 << b) - 1:x}u, {b}, {q}u, {n}_thresholds, {len(t.thresholds)}, &used, &nb);
+    word_account(k, used, nb, {b}u, st);
+    if (consumed) *consumed = used;
+    return k;
+}}
+
+static int {n}_word_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {{
+    if (st) *st = (sdat_stats){{0}};
+    return {n}_word_run_avx2(out, n, w, wc, 0, st) == n ? 0 : -2;
+}}
+"""
+
+
+def emit_avx2_original(t: Table) -> str:
+    n = t.name
+    vec = "".join(f"\n        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16({v})));"
+                  for v in t.thresholds)
+    return f"""
+static int {n}_avx2(uint16_t *s, size_t n) {{
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[{t.index}].original(s, n);
+    const __m256i one = _mm256_set1_epi16(1), zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {{
+        __m256i w = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i x = _mm256_srli_epi16(w, 1), mag = zero;{vec}
+        __m256i sign = _mm256_and_si256(w, one);
+        _mm256_storeu_si256((__m256i *)(s + i), _mm256_add_epi16(_mm256_xor_si256(mag, _mm256_sub_epi16(zero, sign)), sign));
+    }}
+    frodo_gen_reference[{t.index}].original(s + i, n - i);
+    sdat_avx2_stats tel = {{1, n / 16, n - n % 16, n % 16, 0, 0, 0}};
+    SDAT_TEL_FLUSH(&tel);
+    return 0;
+}}
+"""
+
+
+def registry(tables: list[Table], array: str, suffix: str) -> str:
+    rows = []
+    for t in tables:
+        meta = (f'"{t.parameter_set}", "{t.family}", SDAT_TYPE_{t.value_type}, {t.q}u, {t.bits}u, '
+                f"{len(t.thresholds)}, {t.name}_thresholds")
+        if t.sda:
+            fns = (f"0, {t.name}_packed{suffix}, {t.name}_packed_run{suffix}, "
+                   f"{t.name}_word{suffix}, {t.name}_word_run{suffix}")
+        else:
+            fns = f"{t.name}{suffix}, 0, 0, 0, 0"
+        rows.append(f"    {{{meta},\n     {fns}}},")
+    return (f"const frodo_gen_kernels {array}[] = {{\n" + "\n".join(rows) + "\n};\n"
+            f"const size_t {array}_count = sizeof {array} / sizeof {array}[0];\n")
+
+
+def kernel_table(tables: list[Table], name: str, backend: str, suffix: str) -> str:
+    """frodo_kernel_table of the manifest tables, one Original and one SDA
+    table per frodo_param_id."""
+    orig, sda = {}, {}
+    for t in tables:
+        if not t.param:
+            continue
+        by = sda if t.sda else orig
+        if t.param in by:
+            raise SystemExit(f"{t.parameter_set}: more than one {t.family} in the manifest")
+        by[t.param] = t
+    if orig.keys() != sda.keys():
+        raise SystemExit("every manifest parameter set needs both an original-cdt-table and an sda-table")
+
+    def field(field_name, by, kernel):
+        entries = "".join(f"\n        [{p}] = {t.name}{kernel}{suffix}," for p, t in by.items())
+        return f"    .{field_name} = {{{entries}\n    }},"
+
+    rows = [f"    .backend = {backend},", field("original", orig, ""), field("packed", sda, "_packed"),
+            field("packed_run", sda, "_packed_run"), field("word", sda, "_word"), field("word_run", sda, "_word_run")]
+    return f"const frodo_kernel_table {name} = {{\n" + "\n".join(rows) + "\n};\n"
+
+
+def thresholds_block(tables: list[Table]) -> str:
+    out = []
+    for t in tables:
+        vals = ", ".join(str(v) for v in t.thresholds) or "0"
+        out.append(f"static const uint16_t {t.name}_thresholds[] = {{{vals}}};")
+    return "\n".join(out) + "\n"
+
+
+def render(tables: list[Table]) -> dict[str, str]:
+    for i, t in enumerate(tables):
+        t.index = i
+    scalar = HEADER + """#include "frodo_kernels_gen.h"
+#include "frodo_sampler.h"
+
+/* Bit extraction with a constant width; inlined per call site. */
+static inline __attribute__((always_inline)) int gen_take(sdat_bitreader_fast *r, unsigned bits, uint32_t *out) {
+    if (sdat_fast_refill64(r, bits)) return -2;
+    *out = (uint32_t)(r->reservoir & ((1u << bits) - 1u));
+    r->reservoir >>= bits;
+    r->available -= bits;
+    r->bits_consumed += bits;
+    return 0;
+}
+
+/* Word-oriented accounting of frodo_sda_word_sample_run. */
+static inline void gen_word_account(size_t produced, size_t consumed, unsigned bits, sdat_stats *st) {
+    if (st) {
+        st->attempts += consumed;
+        st->rejections += consumed - produced;
+        st->random_bits += (uint64_t)consumed * bits + produced;
+        st->random_bytes += (uint64_t)consumed * 2u;
+    }
+}
+"""
+    scalar += "\n" + thresholds_block(tables)
+    for t in tables:
+        scalar += emit_scalar_sda(t) if t.sda else emit_scalar_original(t)
+    scalar += "\n" + registry(tables, "frodo_gen_reference", "")
+    scalar += "\n" + kernel_table(tables, "frodo_gen_kernel_table_reference", "FRODO_BACKEND_REFERENCE", "")
+    avx2 = HEADER + """#include "frodo_kernels_avx2.h"
+#include "frodo_kernels_gen.h"
+#include "frodo_sampler.h"
+#include "sdat_avx2.h"
+
+/* Vector kernels with the thresholds as compile-time constants; tails and the
+ * non-AVX2 fallback go through the scalar entries of frodo_gen_reference. */
+"""
+    avx2 += "\n" + thresholds_block(tables)
+    for t in tables:
+        avx2 += emit_avx2_sda(t) if t.sda else emit_avx2_original(t)
+    avx2 += "\n" + registry(tables, "frodo_gen_avx2", "_avx2")
+    avx2 += "\n" + kernel_table(tables, "frodo_gen_kernel_table_avx2", "FRODO_BACKEND_AVX2", "_avx2")
+    return {"frodo_kernels_gen.c": scalar, "frodo_kernels_gen_avx2.c": avx2}
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--manifest", type=Path, default=MANIFEST)
+    ap.add_argument("--tables", type=Path, default=TABLES_C, help="C source holding the cumulative threshold arrays")
+    ap.add_argument("--exported", type=Path, action="append", default=[], help="export_tables output to append")
+    ap.add_argument("--out-dir", type=Path, default=OUT_DIR)
+    ap.add_argument("--check", action="store_true", help="fail if the files in --out-dir are stale")
+    args = ap.parse_args()
+    tables = manifest_tables(args.manifest, args.tables)
+    taken = {t.name for t in tables}
+    for path in args.exported:
+        tables += exported_tables(path, taken)
+    files = render(tables)
+    stale = []
+    for name, text in files.items():
+        path = args.out_dir / name
+        if args.check:
+            if not path.exists() or path.read_text() != text:
+                stale.append(str(path))
+        else:
+            path.parent.mkdir(parents=True, exist_ok=True)
+            path.write_text(text)
+    if stale:
+        print("stale generated kernels (rerun offline/scripts/generate_online_kernels.py):", *stale, sep="\n  ",
+              file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -7,6 +7,7 @@
 #include "sda_generation.h"
 #include "sda_lll.h"
 #include "sda_baseline.h"
+#include "sda_trace.h"
 static void print_mp(FILE*f,mpfr_t x){ mpfr_out_str(f,10,18,x,MPFR_RNDN); }
 static void u(FILE*f,sda_u128 v){ char b[64]; sda_print_u128(v,b,sizeof b); fputs(b,f); }
 static void set_mp_u128(mpfr_t r,sda_u128 v){ mpfr_set_ui_2exp(r,(unsigned long)(v>>64),64,MPFR_RNDN); mpfr_add_ui(r,r,(unsigned long)v,MPFR_RNDN); }
@@ -29,6 +30,7 @@ int main(int argc,char**argv){
   else if(!strcmp(argv[i],"--require-certified-linf-svp")){require_exact=1;require_certified_linf=1;}
   else if(!strcmp(argv[i],"--config")&&i+1<argc)cfg=argv[++i];
   else if(!strcmp(argv[i],"--solver")&&i+1<argc)solver=argv[++i];
+  else if(!strcmp(argv[i],"--threads")&&i+1<argc)setenv("SDA_GENERATION_THREADS",argv[++i],1);
   else if(!strcmp(argv[i],"--epsilon-schedule")&&i+1<argc)i++;
   else if(!strcmp(argv[i],"--selection")&&i+1<argc)i++;
  }
@@ -45,10 +47,11 @@ int main(int argc,char**argv){
   }
   if(all_available) fprintf(stderr,"status=partial-success: Falcon exact generation unresolved; frodo_failures=%d\n",failures);
  } else {
-  if(!cfg||!solver){fprintf(stderr,"usage: generate_sdat --all | --config file --solver exact-denominator|flint-lll\n"); return 2;}
+  if(!cfg||!solver){fprintf(stderr,"usage: generate_sdat --all | --config file --solver exact-denominator|exact-linf-svp|flint-lll|lll-bkz\n"); return 2;}
   if(one(cfg,solver,&r[0])) return 1;
   names[0]=strstr(cfg,"falcon")?"falcon":strstr(cfg,"976")?"frodo976":strstr(cfg,"1344")?"frodo1344":"frodo640"; m=1;
  }
+ sda_trace_close();
  if(write_outputs(r,names,m,repro)) return 1;
  for(size_t i=0;i<m;i++) sda_generation_result_clear(&r[i]);
  puts("generated production tables from distribution parameters; source_is_fixture=false");
@@ -0,0 +1,18 @@
+#include "sda_generation.h"
+#include "sda_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+static char root[]="/tmp/sda_sweep_XXXXXX";
+static const char*files[3]={"sda_all_candidates.csv","sda_rejected_candidates.csv","sda_feasible_candidates.csv"};
+static char *slurp(const char*threads,const char*name,size_t*len){ char path[256]; snprintf(path,sizeof path,"%s/%s/offline/generated/%s",root,threads,name); FILE*f=fopen(path,"rb"); if(!f) return 0; fseek(f,0,SEEK_END); long n=ftell(f); rewind(f); char*p=malloc((size_t)n+1); *len=fread(p,1,(size_t)n,f); p[*len]=0; fclose(f); return p; }
+static int mkdirs(const char*threads){ char path[256]; snprintf(path,sizeof path,"%s/%s",root,threads); if(mkdir(path,0700)) return 1; snprintf(path,sizeof path,"%s/%s/offline",root,threads); if(mkdir(path,0700)) return 1; snprintf(path,sizeof path,"%s/%s/offline/generated",root,threads); return mkdir(path,0700)!=0; }
+static void rmdirs(const char*threads){ char path[256]; for(int i=0;i<3;i++){ snprintf(path,sizeof path,"%s/%s/offline/generated/%s",root,threads,files[i]); remove(path); } snprintf(path,sizeof path,"%s/%s/offline/generated",root,threads); rmdir(path); snprintf(path,sizeof path,"%s/%s/offline",root,threads); rmdir(path); snprintf(path,sizeof path,"%s/%s",root,threads); rmdir(path); }
+/* The sweep traces into offline/generated under the working directory, so each thread count runs from its own tree. */
+static int run(const char*name,const char*threads,sda_generation_result*r,int*rc){ sda_config c; char dir[256]; if(sda_config_builtin(name,&c)) return 1; c.epsilon_initial_trials=7; c.epsilon_refinement_rounds=1; c.epsilon_max_total_instances=0; setenv("SDA_GENERATION_THREADS",threads,1); snprintf(dir,sizeof dir,"%s/%s",root,threads); if(chdir(dir)) return 1; sda_generation_result_init(r,c.mpfr_precision); *rc=sda_generate_for_config(&c,"exact-linf-svp",r); sda_trace_close(); return 0; }
+int main(void){ if(!mkdtemp(root)||mkdirs("1")||mkdirs("3")) return 1; setenv("SDA_TRACE_CANDIDATES","1",1); const char*names[]={"frodo1344","frodo976"}; for(int i=0;i<2;i++){ sda_generation_result a,b; int ra,rb; if(run(names[i],"1",&a,&ra)||run(names[i],"3",&b,&rb)) return 10+i; if(ra!=rb||a.q!=b.q||a.raw_svp_q!=b.raw_svp_q||a.enumerated_q_count!=b.enumerated_q_count||a.half_integer_ties!=b.half_integer_ties||a.production_eligible!=b.production_eligible||mpfr_cmp(a.epsilon,b.epsilon)) return 20+i; for(size_t j=0;j<a.n;j++) if(a.p[j]!=b.p[j]||a.raw_svp_p[j]!=b.raw_svp_p[j]) return 30+i; sda_generation_result_clear(&a); sda_generation_result_clear(&b); }
+  /* Same rows in the same order; only the first open of the process writes the header, which went to the 1-thread files. */
+  for(int i=0;i<3;i++){ size_t n1,n3; char*t1=slurp("1",files[i],&n1),*t3=slurp("3",files[i],&n3); if(!t1||!t3) return 40+i; char*rows=strchr(t1,'\n'); size_t hl=rows?(size_t)(rows-t1)+1:n1; if((!i&&!n3)||n1-hl!=n3||memcmp(t1+hl,t3,n3)) return 43+i; free(t1); free(t3); }
+  rmdirs("1"); rmdirs("3"); rmdir(root); return 0; }
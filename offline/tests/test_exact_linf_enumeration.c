@@ -0,0 +1,21 @@
+#include "sda_exact_linf_enumeration.h"
+#include <math.h>
+#include <stdlib.h>
+/* Dyadic bases keep the double brute force exact, so ties (and the lex rule) are real. */
+static unsigned long long st=88172645463325252ull; static double quarter(int lo,int hi){ st^=st<<13; st^=st>>7; st^=st<<17; return (lo+(int)(st%(unsigned long long)(hi-lo+1)))/4.0; }
+static double brute(const double*B,size_t d,size_t stride,long*best){ enum{K=7}; long x[4]; double bn=INFINITY; for(long i=0;i<(long)pow(2*K+1,(double)d);i++){ long t=i; int nz=0; for(size_t j=d;j-->0;){ x[j]=t%(2*K+1)-K; t/=2*K+1; nz|=x[j]!=0; } if(!nz) continue; double m=0; for(size_t a=0;a<d;a++){ double s=0; for(size_t b=a;b<d;b++) s+=B[a*stride+b]*(double)x[b]; if(fabs(s)>m) m=fabs(s); } if(m<bn){ bn=m; for(size_t j=0;j<d;j++) best[j]=x[j]; } } return bn; }
+static int run(const double*Bd,size_t d,sda_exact_linf_enum_result*r){ mpfr_t*B=malloc(d*d*sizeof(mpfr_t)); for(size_t i=0;i<d*d;i++){ mpfr_init2(B[i],128); mpfr_set_d(B[i],Bd[i],MPFR_RNDN); } sda_exact_linf_enum_result_init(r,d,128); int rc=sda_exact_linf_enumerate(B,d,128,r); for(size_t i=0;i<d*d;i++) mpfr_clear(B[i]); free(B); return rc; }
+static void block(double*B,size_t d,size_t o,size_t n){ for(size_t i=0;i<n;i++) for(size_t j=i;j<n;j++) B[(o+i)*d+o+j]=i==j?quarter(4,8):quarter(-2,2); }
+int main(void){
+  sda_exact_linf_enum_result r; double B[40*40];
+  for(int trial=0;trial<60;trial++){ size_t d=1+(size_t)trial%4; for(size_t i=0;i<d*d;i++) B[i]=0; block(B,d,0,d); long want[4]; double bn=brute(B,d,d,want);
+    if(run(B,d,&r)) return 1;
+    if(mpfr_cmp_d(r.norm_upper,bn)||!r.global_svp_certified) return 2;
+    for(size_t j=0;j<d;j++){ if(mpz_cmp_si(r.coefficients[j],want[j])) return 3; }
+    sda_exact_linf_enum_result_clear(&r); }
+  /* d=40: ten independent 4x4 blocks, so the minimum is the smallest block minimum. */
+  for(size_t i=0;i<40*40;i++) B[i]=0;
+  double m=INFINITY; for(size_t o=0;o<40;o+=4){ block(B,40,o,4); long x[4]; double bn=brute(B+o*40+o,4,40,x); if(bn<m) m=bn; }
+  if(run(B,40,&r)||mpfr_cmp_d(r.norm_upper,m)||!r.nodes_visited||!r.leaves_visited||!r.branches_pruned) return 4;
+  for(size_t i=0;i<40;i++){ double s=0; for(size_t j=i;j<40;j++) s+=B[i*40+j]*(double)mpz_get_si(r.coefficients[j]); if(mpfr_cmp_d(r.shortest_vector[i],s)) return 5; } sda_exact_linf_enum_result_clear(&r);
+  B[1*2+0]=1; if(run(B,2,&r)!=-2) return 6; sda_exact_linf_enum_result_clear(&r); return 0; }
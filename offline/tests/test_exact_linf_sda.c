@@ -1,10 +1,35 @@
 #include "sda_exact_linf_sda.h"
 #include <mpfr.h>
 #include <stdlib.h>
+static int same(const sda_exact_linf_sda_result*a,const sda_exact_linf_sda_result*b){ if(a->q!=b->q||a->q_enumerated!=b->q_enumerated||a->half_integer_ties!=b->half_integer_ties||a->q_search_upper!=b->q_search_upper||a->nearest_integer_certified!=b->nearest_integer_certified||a->norm_comparisons_certified!=b->norm_comparisons_certified||a->global_svp_certified!=b->global_svp_certified||mpfr_cmp(a->norm_lower,b->norm_lower)||mpfr_cmp(a->norm_upper,b->norm_upper)) return 0; for(size_t i=0;i<a->n;i++) if(a->p[i]!=b->p[i]) return 0; return 1; }
+/* Plain sequential scan over the public single-q evaluation: q = 1, 2, ...
+ * below the current limit, accept q when its upper bound is below the best
+ * lower bound and shrink the limit to that bound. */
+static int sequential(mpfr_t*a,size_t n,mpfr_t eps,sda_u128 q0,sda_exact_linf_sda_result*r){ sda_exact_linf_sda_result e; sda_exact_linf_sda_init(&e,n,512); int nearest=1;
+  mpfr_ui_div(r->C,1,eps,MPFR_RNDU); mpfr_pow_ui(r->C,r->C,(unsigned long)(n+1),MPFR_RNDU); mpfr_set(r->norm_lower,r->C,MPFR_RNDD); mpfr_set(r->norm_upper,r->C,MPFR_RNDU); r->q=0; for(size_t i=0;i<n;i++) r->p[i]=0; r->p[0]=1;
+  if(q0){ nearest&=!sda_exact_linf_sda_evaluate(a,n,eps,q0,&e); r->half_integer_ties=e.half_integer_ties; r->q=q0; for(size_t i=0;i<n;i++) r->p[i]=e.p[i]; mpfr_set(r->norm_lower,e.norm_lower,MPFR_RNDD); mpfr_set(r->norm_upper,e.norm_upper,MPFR_RNDU); }
+  unsigned long limit=mpfr_get_ui(r->norm_upper,MPFR_RNDU); if(!mpfr_integer_p(r->norm_upper)) limit++; if(limit<2) limit=2;
+  for(unsigned long q=1;q<limit;q++){ e.half_integer_ties=0; nearest&=!sda_exact_linf_sda_evaluate(a,n,eps,q,&e); r->q_enumerated++; r->half_integer_ties+=e.half_integer_ties;
+    if(mpfr_cmp(e.norm_upper,r->norm_lower)<0){ r->q=q; for(size_t i=0;i<n;i++) r->p[i]=e.p[i]; mpfr_set(r->norm_lower,e.norm_lower,MPFR_RNDD); mpfr_set(r->norm_upper,e.norm_upper,MPFR_RNDU); unsigned long nl=mpfr_get_ui(r->norm_upper,MPFR_RNDU); if(!mpfr_integer_p(r->norm_upper)) nl++; if(nl<limit) limit=nl; } }
+  r->q_search_upper=limit-1; r->nearest_integer_certified=nearest; r->norm_comparisons_certified=1; r->global_svp_certified=nearest; sda_exact_linf_sda_clear(&e); return nearest?0:-5; }
+/* Neither the fixed-point prefilter nor the worker count may change anything
+ * but the work done: every run matches the sequential scan. */
+static int check_prefilter(mpfr_t*a,size_t n,double e,sda_u128 q0,unsigned long long*rejected){ mpfr_t eps; mpfr_init2(eps,512); mpfr_set_d(eps,e,MPFR_RNDN); sda_exact_linf_sda_result m; sda_exact_linf_sda_init(&m,n,512); int rm=sequential(a,n,eps,q0,&m), ok=1;
+  static const unsigned threads[]={1,3,8}; for(int t=0;t<6;t++){ sda_exact_linf_sda_result r; sda_exact_linf_sda_init(&r,n,512); r.threads=threads[t%3]; r.mpfr_only=t>=3; int rr=sda_exact_linf_sda_solve(a,n,eps,q0,&r); ok&=rr==rm&&same(&r,&m)&&(!r.mpfr_only||!r.prefilter_rejections); *rejected+=r.prefilter_rejections; sda_exact_linf_sda_clear(&r); }
+  sda_exact_linf_sda_clear(&m); mpfr_clear(eps); return ok; }
 int main(void){
+  unsigned long long rejected=0;
   for(int rep=0; rep<500; rep++){
     size_t n=(size_t)(1+(rep%5)); mpfr_t a[5],eps; for(size_t i=0;i<n;i++){ mpfr_init2(a[i],512); mpfr_set_ui(a[i],(unsigned)(i+1+rep%7),MPFR_RNDN); mpfr_div_ui(a[i],a[i],(unsigned)(10+n+rep%11),MPFR_RNDN); }
-    mpfr_init2(eps,512); mpfr_set_d(eps,0.5,MPFR_RNDN); sda_exact_linf_sda_result r; sda_exact_linf_sda_init(&r,n,512); if(sda_exact_linf_sda_solve(a,n,eps,16,&r)) return 1; if(!r.exact_linf_svp||!r.global_svp_certified||r.q_enumerated==0) return 2; sda_exact_linf_sda_clear(&r); for(size_t i=0;i<n;i++) mpfr_clear(a[i]); mpfr_clear(eps);
+    mpfr_init2(eps,512); mpfr_set_d(eps,0.5,MPFR_RNDN); sda_exact_linf_sda_result r; sda_exact_linf_sda_init(&r,n,512); if(sda_exact_linf_sda_solve(a,n,eps,16,&r)) return 1; if(!r.exact_linf_svp||!r.global_svp_certified||r.q_enumerated==0) return 2; sda_exact_linf_sda_clear(&r);
+    if(rep%25==0 && !check_prefilter(a,n,0.5,16,&rejected)) return 3;
+    for(size_t i=0;i<n;i++) mpfr_clear(a[i]);
+    mpfr_clear(eps);
   }
-  return 0;
+  /* Gaussian-shaped masses, where most q are screened out without MPFR */
+  for(size_t n=4;n<=12;n++){ mpfr_t a[12],s; mpfr_init2(s,512); mpfr_set_zero(s,0); for(size_t i=0;i<n;i++){ mpfr_init2(a[i],512); mpfr_set_si(a[i],-(long)(i*i),MPFR_RNDN); mpfr_div_ui(a[i],a[i],9,MPFR_RNDN); mpfr_exp(a[i],a[i],MPFR_RNDN); mpfr_add(s,s,a[i],MPFR_RNDN); } for(size_t i=0;i<n;i++) mpfr_div(a[i],a[i],s,MPFR_RNDN);
+    if(!check_prefilter(a,n,0.45,0,&rejected)||!check_prefilter(a,n,0.6,0,&rejected)) return 4;
+    for(size_t i=0;i<n;i++) mpfr_clear(a[i]);
+    mpfr_clear(s); }
+  return rejected?0:5;
 }
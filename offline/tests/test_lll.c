@@ -0,0 +1,63 @@
+#include "sda_lll.h"
+#include "sda_generation.h"
+#include <stdlib.h>
+#include <math.h>
+
+static unsigned long long seed=0x2545f4914f6cdd1dull;
+static long rnd(long m){ seed=seed*6364136223846793005ull+1442695040888963407ull; return (long)((seed>>33)%(unsigned long long)m); }
+
+/* det of the Gram matrix (Bareiss; leading minors are positive). */
+static void gram_det(mpz_t *B,size_t d,size_t cols,mpz_t det){ mpz_t *M=malloc(d*d*sizeof *M),prev,t; mpz_init(prev); mpz_init(t); mpz_set_ui(prev,1);
+  for(size_t i=0;i<d;i++) for(size_t j=0;j<d;j++){ mpz_init(M[i*d+j]); for(size_t k=0;k<cols;k++) mpz_addmul(M[i*d+j],B[i*cols+k],B[j*cols+k]); }
+  for(size_t k=0;k+1<d;k++){ for(size_t i=k+1;i<d;i++) for(size_t j=k+1;j<d;j++){ mpz_mul(t,M[i*d+j],M[k*d+k]); mpz_submul(t,M[i*d+k],M[k*d+j]); mpz_divexact(M[i*d+j],t,prev); } mpz_set(prev,M[k*d+k]); }
+  mpz_set(det,M[d*d-1]); for(size_t i=0;i<d*d;i++) mpz_clear(M[i]); free(M); mpz_clear(prev); mpz_clear(t); }
+
+static double norm2(mpz_t *B,size_t i,size_t cols){ double s=0; for(size_t k=0;k<cols;k++){ double v=mpz_get_d(B[i*cols+k]); s+=v*v; } return s; }
+
+/* Size reduction and the Lovasz condition, checked in double. */
+static int is_lll(mpz_t *B,size_t d,size_t cols,double delta,double eta){ double *b=malloc(d*cols*sizeof *b),*mu=calloc(d*d,sizeof *mu),*r=calloc(d,sizeof *r); int ok=1;
+  for(size_t i=0;i<d*cols;i++) b[i]=mpz_get_d(B[i]);
+  for(size_t i=0;i<d;i++){ for(size_t j=0;j<i;j++){ double s=0; for(size_t k=0;k<cols;k++) s+=b[i*cols+k]*b[j*cols+k]; for(size_t l=0;l<j;l++) s-=mu[j*d+l]*mu[i*d+l]*r[l]; mu[i*d+j]=s/r[j]; }
+    double s=norm2(B,i,cols); for(size_t l=0;l<i;l++) s-=mu[i*d+l]*mu[i*d+l]*r[l]; r[i]=s;
+    for(size_t j=0;j<i;j++) if(fabs(mu[i*d+j])>eta+1e-6) ok=0;
+    if(i&&delta*r[i-1]>r[i]+mu[i*d+i-1]*mu[i*d+i-1]*r[i-1]+1e-6*r[i-1]) ok=0; }
+  free(b); free(mu); free(r); return ok; }
+
+/* No combination with coefficients in [-w/2, w/2] is shorter than delta*|b_0|^2. */
+static int below(mpz_t *B,size_t d,size_t cols,long w,double delta){ double b1=norm2(B,0,cols); long x[16],total=1; for(size_t i=0;i<d;i++) total*=w;
+  for(long n=1;n<total;n++){ long m=n; for(size_t i=0;i<d;i++){ x[i]=m%w-w/2; m/=w; } double s=0;
+    for(size_t k=0;k<cols;k++){ double v=0; for(size_t i=0;i<d;i++) v+=(double)x[i]*mpz_get_d(B[i*cols+k]); s+=v*v; } if(s>0&&s*1.0000001<delta*b1) return 0; }
+  return 1; }
+
+static void clear(mpz_t *B,size_t n){ for(size_t i=0;i<n;i++) mpz_clear(B[i]); free(B); }
+
+int main(void){
+  sda_lll_params p; sda_lll_params_default(&p); sda_lll_stats st; mpz_t det0,det1; mpz_init(det0); mpz_init(det1);
+  /* Square knapsack lattice, D = 2^40. */
+  size_t d=12; mpz_t *B=malloc(d*d*sizeof *B); for(size_t i=0;i<d*d;i++) mpz_init(B[i]);
+  for(size_t i=0;i+1<d;i++){ mpz_set_ui(B[i*d+i],1ul<<40); mpz_set_si(B[(d-1)*d+i],rnd(1l<<40)); } mpz_set_ui(B[d*d-1],1);
+  gram_det(B,d,d,det0); if(sda_lll_reduce(B,d,d,&p,&st)) return 1; gram_det(B,d,d,det1);
+  if(mpz_cmp(det0,det1)||!is_lll(B,d,d,p.delta,p.eta)||!st.precision_used||!st.insertions) return 2;
+  double lll1=norm2(B,0,d); p.block_size=12; if(sda_bkz_reduce(B,d,d,&p,&st)) return 3; gram_det(B,d,d,det1);
+  if(mpz_cmp(det0,det1)||!is_lll(B,d,d,p.delta,p.eta)||norm2(B,0,d)>lll1||!st.tours) return 4;
+  if(!below(B,d,d,3,p.delta)) return 4;
+  clear(B,d*d);
+  /* Non-square generating set of a rank-6 lattice in Z^9; full-block BKZ
+   * leaves no shorter vector among small combinations of the result. */
+  d=6; size_t c=9; B=malloc(d*c*sizeof *B); for(size_t i=0;i<d*c;i++){ mpz_init(B[i]); mpz_set_si(B[i],rnd(2001)-1000); }
+  gram_det(B,d,c,det0); p.delta=0.999; if(sda_bkz_reduce(B,d,c,&p,&st)) return 5; gram_det(B,d,c,det1);
+  if(mpz_cmp(det0,det1)||!is_lll(B,d,c,p.delta,p.eta)) return 6;
+  if(!below(B,d,c,5,p.delta)) return 7;
+  clear(B,d*c);
+  /* Invalid parameters. */
+  sda_lll_params_default(&p); p.delta=1.2; mpz_t one; mpz_init(one); mpz_set_ui(one,1); if(sda_lll_reduce(&one,1,1,&p,&st)!=-1||sda_lll_reduce(&one,0,1,0,&st)!=-1) return 8;
+  if(sda_lll_reduce(&one,1,1,0,&st)||mpz_cmp_si(one,1)) return 9;
+  mpz_clear(one); mpz_clear(det0); mpz_clear(det1);
+  /* One Falcon instance of the lll-bkz generator: a 72-bit q that is interval
+   * post-verified and meets the Renyi bound, but is not a certified SVP. */
+  sda_config cfg; if(sda_config_builtin("falcon",&cfg)) return 10; cfg.epsilon_min=cfg.epsilon_max=0.0625; cfg.epsilon_max_total_instances=1; cfg.max_log2_renyi_minus_one=-78;
+  sda_generation_result r; sda_generation_result_init(&r,cfg.mpfr_precision); if(sda_generate_for_config(&cfg,"lll-bkz",&r)) return 11;
+  sda_u128 sum=0; for(size_t i=0;i<r.n;i++) sum+=r.p[i];
+  if(r.q_bits!=72||sum!=r.q||!r.heuristic||!r.interval_certified||r.global_svp_certified||r.exact_linf_svp||!r.production_eligible||mpfr_cmp_si(r.log2_renyi_minus_one,-78)>0) return 12;
+  sda_generation_result_clear(&r); return 0;
+}
@@ -0,0 +1,33 @@
+#include "sda_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static char dir[]="/tmp/sda_trace_XXXXXX";
+static char *slurp(const char *name,size_t *len){ char path[256]; snprintf(path,sizeof path,"%s/%s",dir,name); FILE *f=fopen(path,"rb"); if(!f) return 0; fseek(f,0,SEEK_END); long n=ftell(f); rewind(f); char *p=malloc((size_t)n+1); *len=fread(p,1,(size_t)n,f); p[*len]=0; fclose(f); return p; }
+/* Expected contents of all (k<0), rejected (0) or feasible (1) after rows [0, rows). */
+static char *expect(int k,int rows,int headers,size_t *len){ size_t cap=64+(size_t)rows*128; char *p=malloc(cap); *len=0; for(int h=0;h<headers;h++) *len+=(size_t)sprintf(p+*len,"h,e,a,d\n");
+  for(int i=0;i<rows;i++){ if(k<0||(i%3==0)==k) *len+=(size_t)sprintf(p+*len,"row,%d,%.17g,%s\n",i,i*0.125,i%3==0?"true":"false"); }
+  return p; }
+static int check(int rows){ const char *f[3]={"sda_all_candidates.csv","sda_rejected_candidates.csv","sda_feasible_candidates.csv"}; int k[3]={-1,0,1};
+  for(int i=0;i<3;i++){ size_t n,m; char *got=slurp(f[i],&n),*want=expect(k[i],rows,1,&m); int bad=!got||n!=m||memcmp(got,want,n); free(got); free(want); if(bad) return 1; } return 0; }
+static int emit(int from,int to){ char row[128]; for(int i=from;i<to;i++){ int n=sprintf(row,"row,%d,%.17g,%s\n",i,i*0.125,i%3==0?"true":"false"); if(sda_trace_write(row,(size_t)n,i%3==0)) return 1; } return 0; }
+
+int main(void){
+  if(!mkdtemp(dir)) return 1;
+  char buf[8]="x"; if(sda_trace_write(buf,1,0)!=-1) return 2;
+  if(sda_trace_open(dir,"h,e,a,d\n")||sda_trace_open(dir,"h,e,a,d\n")) return 3;
+  /* Enough rows for several background flushes before the explicit one. */
+  if(emit(0,60000)) return 4;
+  sda_trace_flush(); if(check(60000)) return 5;
+  if(emit(60000,60010)) return 6;
+  sda_trace_close(); if(check(60010)) return 7;
+  if(sda_trace_write(buf,1,0)!=-1) return 8;
+  /* Reopening appends without a second header. */
+  if(sda_trace_open(dir,"h,e,a,d\n")||emit(60010,60020)) return 9;
+  sda_trace_close(); if(check(60020)) return 10;
+  char path[256]; snprintf(path,sizeof path,"%s/missing",dir); if(sda_trace_open(path,"h\n")!=-1) return 11;
+  const char *f[3]={"sda_all_candidates.csv","sda_rejected_candidates.csv","sda_feasible_candidates.csv"}; for(int i=0;i<3;i++){ snprintf(path,sizeof path,"%s/%s",dir,f[i]); remove(path); } rmdir(dir);
+  return 0;
+}
@@ -0,0 +1,16 @@
+#include "sda_workspace.h"
+#include "sda_metrics.h"
+#include "sda_generation.h"
+#include "sda_exact_linf_enumeration.h"
+#include <pthread.h>
+static void *other(void*arg){ *(sda_workspace**)arg=sda_ws_local(); return 0; }
+static int work(mpfr_t*a,size_t n,mpfr_t*B){ sda_u128 p[4]; mpfr_t ms,ma,l1; mpfr_inits2(256,ms,ma,l1,(mpfr_ptr)0); sda_fixed_q_minmax(a,n,1000,p,ms,ma,l1); sda_metrics m; sda_metrics_init(&m,256); sda_compute_metrics(a,n,p,1000,2,&m); sda_metrics_clear(&m); mpfr_clears(ms,ma,l1,(mpfr_ptr)0);
+  sda_exact_linf_enum_result r; sda_exact_linf_enum_result_init(&r,2,256); int bad=sda_exact_linf_enumerate(B,2,256,&r)||mpfr_cmp_ui(r.norm_upper,1); sda_exact_linf_enum_result_clear(&r); return bad; }
+int main(void){ sda_workspace *ws=sda_ws_local(); if(ws!=sda_ws_local()) return 1; sda_workspace *t=0; pthread_t th; if(pthread_create(&th,0,other,&t)||pthread_join(th,0)||!t||t==ws) return 2;
+  size_t mk=sda_ws_mark(ws); mpfr_ptr x=sda_ws_mpfr(ws,128); sda_mpfr_interval *y=sda_ws_interval(ws,300); mpz_ptr z=sda_ws_mpz(ws); if(mpfr_get_prec(x)!=128||mpfr_get_prec(y->lo)!=300||mpfr_get_prec(y->hi)!=300) return 3; mpz_set_ui(z,7);
+  size_t inner=sda_ws_mark(ws); mpfr_ptr x2=sda_ws_mpfr(ws,128); if(x2==x) return 4; sda_ws_release(ws,inner); if(sda_ws_mpfr(ws,128)!=x2||sda_ws_mpz(ws)==z) return 4; sda_ws_release(ws,mk); if(sda_ws_mark(ws)!=mk||sda_ws_mpfr(ws,128)!=x||sda_ws_interval(ws,300)!=y||sda_ws_mpz(ws)!=z) return 5; sda_ws_release(ws,mk);
+  mpfr_t a[4],B[4]; double v[4]={0.4,0.3,0.2,0.1}; for(int i=0;i<4;i++){ mpfr_init2(a[i],256); mpfr_set_d(a[i],v[i],MPFR_RNDN); mpfr_init2(B[i],256); mpfr_set_ui(B[i],i==0||i==3,MPFR_RNDN); }
+  if(work(a,4,B)) return 6;
+  unsigned long long warm=sda_ws_allocations(ws); if(work(a,4,B)||sda_ws_allocations(ws)!=warm||sda_ws_mark(ws)!=mk) return 7;
+  for(int i=0;i<4;i++){ mpfr_clear(a[i]); mpfr_clear(B[i]); }
+  return 0; }
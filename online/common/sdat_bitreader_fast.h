@@ -24,6 +24,9 @@ static inline int sdat_fast_refill64(sdat_bitreader_fast *r,unsigned need){
     while(r->available<need && r->ptr<r->end){ r->reservoir |= ((uint64_t)*r->ptr++) << r->available; r->available += 8; r->bytes_loaded++; r->tail_refills++; }
     return r->available>=need?0:-2;
 }
+/* Stream bytes holding consumed bits. Unlike bytes_loaded it does not depend
+ * on how far the reservoir has read ahead. */
+static inline uint64_t sdat_fast_bytes_used(const sdat_bitreader_fast *r){ return (r->bits_consumed+7u)/8u; }
 #define SDAT_TAKE_CONST(NAME,BITS,MASK) \
 static inline int NAME(sdat_bitreader_fast *r,uint32_t *out){ \
     if(sdat_fast_refill64(r,(BITS))) return -2; \
@@ -0,0 +1,95 @@
+#include "sdat_prg.h"
+#include "sdat_cpu.h"
+#include <string.h>
+
+/* RFC 8439 ChaCha20 block function in portable C: 20 rounds, the input state
+ * added back, words serialized little-endian. */
+#define ROTL32(x, k) (((x) << (k)) | ((x) >> (32 - (k))))
+#define QROUND(a, b, c, d)                                                                                          \
+    do {                                                                                                            \
+        a += b; d ^= a; d = ROTL32(d, 16);                                                                          \
+        c += d; b ^= c; b = ROTL32(b, 12);                                                                          \
+        a += b; d ^= a; d = ROTL32(d, 8);                                                                           \
+        c += d; b ^= c; b = ROTL32(b, 7);                                                                           \
+    } while (0)
+
+static inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void sdat_chacha20_block(const uint32_t in[16], uint8_t out[64]) {
+    uint32_t x[16];
+    memcpy(x, in, sizeof x);
+    for (unsigned i = 0; i < 10; i++) {
+        QROUND(x[0], x[4], x[8], x[12]);
+        QROUND(x[1], x[5], x[9], x[13]);
+        QROUND(x[2], x[6], x[10], x[14]);
+        QROUND(x[3], x[7], x[11], x[15]);
+        QROUND(x[0], x[5], x[10], x[15]);
+        QROUND(x[1], x[6], x[11], x[12]);
+        QROUND(x[2], x[7], x[8], x[13]);
+        QROUND(x[3], x[4], x[9], x[14]);
+    }
+    for (unsigned i = 0; i < 16; i++) {
+        uint32_t v = x[i] + in[i];
+        out[4 * i] = (uint8_t)v;
+        out[4 * i + 1] = (uint8_t)(v >> 8);
+        out[4 * i + 2] = (uint8_t)(v >> 16);
+        out[4 * i + 3] = (uint8_t)(v >> 24);
+    }
+}
+
+void sdat_chacha20_init(sdat_chacha20_ctx *ctx, const uint8_t key[32], const uint8_t nonce[12]) {
+    static const uint8_t sigma[16] = "expand 32-byte k";
+    for (unsigned i = 0; i < 4; i++) ctx->st[i] = load32_le(sigma + 4 * i);
+    for (unsigned i = 0; i < 8; i++) ctx->st[4 + i] = load32_le(key + 4 * i);
+    ctx->st[12] = 0;
+    for (unsigned i = 0; i < 3; i++) ctx->st[13 + i] = nonce ? load32_le(nonce + 4 * i) : 0;
+    ctx->pos = sizeof ctx->ks;
+}
+
+/* The AVX2 kernel adds 0..7 to st[12] without a carry, so a batch that would
+ * wrap it is left to the scalar loop. */
+void sdat_chacha20_blocks(uint32_t st[16], uint8_t *out, size_t blocks) {
+    if (sdat_cpu_has(SDAT_CPU_AVX2))
+        for (; blocks >= SDAT_CHACHA20_BATCH && st[12] <= UINT32_MAX - (SDAT_CHACHA20_BATCH - 1u);
+             blocks -= SDAT_CHACHA20_BATCH, out += 64 * SDAT_CHACHA20_BATCH) {
+            sdat_chacha20_blocks8_avx2(st, out);
+            st[13] += st[12] == 0;
+        }
+    for (; blocks; blocks--, out += 64) {
+        sdat_chacha20_block(st, out);
+        st[13] += !++st[12];
+    }
+}
+
+/* Words 12-13 become the 64-bit block index; see sdat_aes128_ctr_seek. */
+void sdat_chacha20_seek(sdat_chacha20_ctx *ctx, uint64_t offset) {
+    ctx->st[12] = (uint32_t)(offset / 64);
+    ctx->st[13] = (uint32_t)(offset / 64 >> 32);
+    sdat_chacha20_blocks(ctx->st, ctx->ks, SDAT_CHACHA20_BATCH);
+    ctx->pos = (unsigned)(offset % 64);
+}
+
+/* Whole batches go straight to out; anything shorter is served from ks. */
+void sdat_chacha20_squeeze(sdat_chacha20_ctx *ctx, uint8_t *out, size_t len) {
+    while (len) {
+        if (ctx->pos == sizeof ctx->ks) {
+            if (len >= sizeof ctx->ks) {
+                size_t blocks = len / sizeof ctx->ks * SDAT_CHACHA20_BATCH;
+                sdat_chacha20_blocks(ctx->st, out, blocks);
+                out += 64 * blocks;
+                len -= 64 * blocks;
+                continue;
+            }
+            sdat_chacha20_blocks(ctx->st, ctx->ks, SDAT_CHACHA20_BATCH);
+            ctx->pos = 0;
+        }
+        size_t m = sizeof ctx->ks - ctx->pos;
+        if (m > len) m = len;
+        memcpy(out, ctx->ks + ctx->pos, m);
+        ctx->pos += (unsigned)m;
+        out += m;
+        len -= m;
+    }
+}
@@ -0,0 +1,42 @@
+#include "sdat_cpu.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Bit 31 marks the cache as valid. Detection is idempotent, so a first-use
+ * race between threads stores the same value twice. forced is stored before
+ * usable, so a reader that sees a valid usable mask also sees the name. */
+#define VALID (1u << 31)
+static _Atomic unsigned detected, usable;
+static _Atomic(const char *) forced;
+
+static unsigned probe(void){
+    unsigned f=0;
+#if defined(__GNUC__) && (defined(__x86_64__)||defined(__i386__))
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))f|=SDAT_CPU_AVX2;
+    if(__builtin_cpu_supports("bmi2"))f|=SDAT_CPU_BMI2;
+    if(__builtin_cpu_supports("aes"))f|=SDAT_CPU_AESNI;
+    if(__builtin_cpu_supports("avx512f"))f|=SDAT_CPU_AVX512F;
+    if(__builtin_cpu_supports("avx512bw"))f|=SDAT_CPU_AVX512BW;
+#endif
+    return f;
+}
+
+static unsigned init(void){
+    unsigned f=probe(),mask=~0u;
+    const char *e=getenv("SDAT_FORCE_BACKEND"),*name=0;
+    if(e&&(!strcmp(e,"reference")||!strcmp(e,"scalar"))){mask=0;name="reference";}
+    else if(e&&!strcmp(e,"avx2")){mask=SDAT_CPU_AVX2|SDAT_CPU_BMI2|SDAT_CPU_AESNI;name="avx2";}
+    else if(e&&!strcmp(e,"avx512")){name="avx512";}
+    forced=name;
+    detected=f|VALID;
+    unsigned u=(f&mask)|VALID;
+    usable=u;
+    return u;
+}
+
+__attribute__((constructor)) static void sdat_cpu_load(void){init();}
+
+unsigned sdat_cpu_features(void){unsigned u=usable;if(!(u&VALID))u=init();return u&~VALID;}
+unsigned sdat_cpu_features_detected(void){unsigned d=detected;if(!(d&VALID)){init();d=detected;}return d&~VALID;}
+const char *sdat_cpu_forced_backend(void){sdat_cpu_features();return forced;}
@@ -0,0 +1,19 @@
+#ifndef SDAT_CPU_H
+#define SDAT_CPU_H
+/* CPU capabilities, detected once (at load time, or on first use when called
+ * from another constructor) and cached. SDAT_FORCE_BACKEND restricts what the
+ * kernels may use, for testing one binary on every path:
+ *   reference  no SIMD or crypto extensions
+ *   avx2       AVX2, BMI2 and AES-NI, no AVX-512
+ *   avx512     everything detected (same as unset)
+ * A forced backend never enables a feature the CPU lacks. */
+#define SDAT_CPU_AVX2     (1u << 0)
+#define SDAT_CPU_BMI2     (1u << 1)
+#define SDAT_CPU_AESNI    (1u << 2)
+#define SDAT_CPU_AVX512F  (1u << 3)
+#define SDAT_CPU_AVX512BW (1u << 4)
+unsigned sdat_cpu_features(void);
+unsigned sdat_cpu_features_detected(void);
+const char *sdat_cpu_forced_backend(void);
+static inline int sdat_cpu_has(unsigned features){return (sdat_cpu_features()&features)==features;}
+#endif
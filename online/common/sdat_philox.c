@@ -0,0 +1,81 @@
+#include "sdat_prg.h"
+#include <string.h>
+
+/* Philox4x32-10 (Salmon et al., SC'11, as in Random123): ten rounds of two
+ * 32x32->64 multiplies over a 128-bit counter, the 64-bit key bumped by the
+ * Weyl constants between rounds. Output words are serialized little-endian. */
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+static inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void sdat_philox4x32_block(const uint32_t key[2], const uint32_t ctr[4], uint8_t out[16]) {
+    uint32_t x0 = ctr[0], x1 = ctr[1], x2 = ctr[2], x3 = ctr[3], k0 = key[0], k1 = key[1];
+    for (unsigned round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * x0, p1 = (uint64_t)PHILOX_M1 * x2;
+        x0 = (uint32_t)(p1 >> 32) ^ x1 ^ k0;
+        x1 = (uint32_t)p1;
+        x2 = (uint32_t)(p0 >> 32) ^ x3 ^ k1;
+        x3 = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    const uint32_t x[4] = {x0, x1, x2, x3};
+    for (unsigned i = 0; i < 4; i++) {
+        out[4 * i] = (uint8_t)x[i];
+        out[4 * i + 1] = (uint8_t)(x[i] >> 8);
+        out[4 * i + 2] = (uint8_t)(x[i] >> 16);
+        out[4 * i + 3] = (uint8_t)(x[i] >> 24);
+    }
+}
+
+void sdat_philox4x32_init(sdat_philox4x32_ctx *ctx, const uint8_t key[8], uint64_t stream) {
+    ctx->key[0] = load32_le(key);
+    ctx->key[1] = load32_le(key + 4);
+    ctx->ctr[0] = ctx->ctr[1] = 0;
+    ctx->ctr[2] = (uint32_t)stream;
+    ctx->ctr[3] = (uint32_t)(stream >> 32);
+    ctx->pos = sizeof ctx->ks;
+}
+
+void sdat_philox4x32_blocks(const uint32_t key[2], uint32_t ctr[4], uint8_t *out, size_t blocks) {
+    for (; blocks; blocks--, out += 16) {
+        sdat_philox4x32_block(key, ctr, out);
+        ctr[1] += !++ctr[0];
+    }
+}
+
+/* Words 0-1 become the block index; see sdat_aes128_ctr_seek. */
+void sdat_philox4x32_seek(sdat_philox4x32_ctx *ctx, uint64_t offset) {
+    ctx->ctr[0] = (uint32_t)(offset / 16);
+    ctx->ctr[1] = (uint32_t)(offset / 16 >> 32);
+    sdat_philox4x32_blocks(ctx->key, ctx->ctr, ctx->ks, SDAT_PHILOX_BATCH);
+    ctx->pos = (unsigned)(offset % 16);
+}
+
+/* Whole batches go straight to out; anything shorter is served from ks. */
+void sdat_philox4x32_squeeze(sdat_philox4x32_ctx *ctx, uint8_t *out, size_t len) {
+    while (len) {
+        if (ctx->pos == sizeof ctx->ks) {
+            if (len >= sizeof ctx->ks) {
+                size_t blocks = len / sizeof ctx->ks * SDAT_PHILOX_BATCH;
+                sdat_philox4x32_blocks(ctx->key, ctx->ctr, out, blocks);
+                out += 16 * blocks;
+                len -= 16 * blocks;
+                continue;
+            }
+            sdat_philox4x32_blocks(ctx->key, ctx->ctr, ctx->ks, SDAT_PHILOX_BATCH);
+            ctx->pos = 0;
+        }
+        size_t m = sizeof ctx->ks - ctx->pos;
+        if (m > len) m = len;
+        memcpy(out, ctx->ks + ctx->pos, m);
+        ctx->pos += (unsigned)m;
+        out += m;
+        len -= m;
+    }
+}
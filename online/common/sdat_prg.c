@@ -0,0 +1,119 @@
+#include "sdat_prg.h"
+#include "sdat_cpu.h"
+#include <string.h>
+
+int sdat_prg_init(sdat_prg *g, sdat_prg_kind kind, const uint8_t *seed, size_t seed_len) {
+    if (!g || (!seed && seed_len)) return -1;
+    memset(g, 0, sizeof *g);
+    g->kind = kind;
+    if (kind == SDAT_PRG_SHAKE128) {
+        sdat_shake128_init(&g->u.shake);
+        sdat_shake128_absorb(&g->u.shake, seed, seed_len);
+        return 0;
+    }
+    if (kind == SDAT_PRG_AES128_CTR) {
+        if (seed_len != 16 && seed_len != 32) return -1;
+        sdat_aes128_ctr_init(&g->u.aes, seed, seed_len == 32 ? seed + 16 : 0);
+        g->seekable = seed_len == 16;
+        return 0;
+    }
+    if (kind == SDAT_PRG_CHACHA20) {
+        if (seed_len != 32 && seed_len != 44) return -1;
+        sdat_chacha20_init(&g->u.chacha, seed, seed_len == 44 ? seed + 32 : 0);
+        g->seekable = seed_len == 32;
+        return 0;
+    }
+    if (kind == SDAT_PRG_PHILOX4X32) {
+        if (seed_len != 8) return -1;
+        sdat_philox4x32_init(&g->u.philox, seed, 0);
+        g->seekable = 1;
+        return 0;
+    }
+    if (kind == SDAT_PRG_SHAKE128_X4) {
+        sdat_shake128x4_init(&g->u.shake4, seed, seed_len);
+        return 0;
+    }
+    return -1;
+}
+
+int sdat_prg_init_stream(sdat_prg *g, sdat_prg_kind kind, const uint8_t *key, size_t key_len, uint64_t stream) {
+    if (!g || !key) return -1;
+    if (kind == SDAT_PRG_AES128_CTR && key_len == 16) {
+        uint8_t iv[16] = {0};
+        for (unsigned i = 0; i < 8; i++) iv[i] = (uint8_t)(stream >> (56 - 8 * i));
+        memset(g, 0, sizeof *g);
+        g->kind = kind;
+        sdat_aes128_ctr_init(&g->u.aes, key, iv);
+    } else if (kind == SDAT_PRG_CHACHA20 && key_len == 32) {
+        memset(g, 0, sizeof *g);
+        g->kind = kind;
+        sdat_chacha20_init(&g->u.chacha, key, 0);
+        g->u.chacha.st[14] = (uint32_t)stream;
+        g->u.chacha.st[15] = (uint32_t)(stream >> 32);
+    } else if (kind == SDAT_PRG_PHILOX4X32 && key_len == 8) {
+        memset(g, 0, sizeof *g);
+        g->kind = kind;
+        sdat_philox4x32_init(&g->u.philox, key, stream);
+    } else {
+        return -1;
+    }
+    g->seekable = 1;
+    return 0;
+}
+
+size_t sdat_prg_stream_key_bytes(sdat_prg_kind kind) {
+    return kind == SDAT_PRG_AES128_CTR ? 16 : kind == SDAT_PRG_CHACHA20 ? 32 : kind == SDAT_PRG_PHILOX4X32 ? 8 : 0;
+}
+
+int sdat_prg_seek(sdat_prg *g, uint64_t offset) {
+    if (!g || !g->seekable) return -1;
+    if (g->kind == SDAT_PRG_AES128_CTR) sdat_aes128_ctr_seek(&g->u.aes, offset);
+    else if (g->kind == SDAT_PRG_CHACHA20) sdat_chacha20_seek(&g->u.chacha, offset);
+    else sdat_philox4x32_seek(&g->u.philox, offset);
+    return 0;
+}
+
+int sdat_prg_init_chunk(sdat_prg *g, sdat_prg_kind kind, const uint8_t *key, size_t key_len, uint64_t stream,
+                        uint64_t chunk) {
+    if (chunk > UINT64_MAX / SDAT_PRG_CHUNK_STRIDE) return -1;
+    if (sdat_prg_init_stream(g, kind, key, key_len, stream)) return -1;
+    return chunk ? sdat_prg_seek(g, chunk * SDAT_PRG_CHUNK_STRIDE) : 0;
+}
+
+void sdat_prg_generate(sdat_prg *g, uint8_t *out, size_t len) {
+    if (g->kind == SDAT_PRG_SHAKE128) sdat_shake128_squeeze(&g->u.shake, out, len);
+    else if (g->kind == SDAT_PRG_AES128_CTR) sdat_aes128_ctr_squeeze(&g->u.aes, out, len);
+    else if (g->kind == SDAT_PRG_CHACHA20) sdat_chacha20_squeeze(&g->u.chacha, out, len);
+    else if (g->kind == SDAT_PRG_PHILOX4X32) sdat_philox4x32_squeeze(&g->u.philox, out, len);
+    else sdat_shake128x4_squeeze(&g->u.shake4, out, len);
+}
+
+void sdat_secure_zero(void *p, size_t len) {
+    volatile uint8_t *v = (volatile uint8_t *)p;
+    while (len--) *v++ = 0;
+}
+
+void sdat_prg_wipe(sdat_prg *g) {
+    sdat_secure_zero(g, sizeof *g);
+}
+
+int sdat_prg_randombytes(void *ctx, uint8_t *out, size_t out_len) {
+    if (!ctx || (!out && out_len)) return -1;
+    sdat_prg_generate((sdat_prg *)ctx, out, out_len);
+    return 0;
+}
+
+const char *sdat_prg_name(sdat_prg_kind k) {
+    return k == SDAT_PRG_SHAKE128       ? "shake128"
+           : k == SDAT_PRG_AES128_CTR   ? "aes128-ctr"
+           : k == SDAT_PRG_CHACHA20     ? "chacha20"
+           : k == SDAT_PRG_SHAKE128_X4  ? "shake128x4"
+           : k == SDAT_PRG_PHILOX4X32   ? "philox4x32"
+                                        : "unknown";
+}
+
+const char *sdat_prg_backend_name(sdat_prg_kind k) {
+    if (k == SDAT_PRG_AES128_CTR) return sdat_cpu_has(SDAT_CPU_AESNI) ? "aesni" : "portable";
+    if (k == SDAT_PRG_CHACHA20 || k == SDAT_PRG_SHAKE128_X4) return sdat_cpu_has(SDAT_CPU_AVX2) ? "avx2" : "portable";
+    return "portable";
+}
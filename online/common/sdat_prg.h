@@ -0,0 +1,154 @@
+#ifndef SDAT_PRG_H
+#define SDAT_PRG_H
+#include <stddef.h>
+#include <stdint.h>
+
+/* Seed expanders used by the streaming samplers. Both produce a byte stream
+ * that is consumed in order; 16-bit words are read little-endian.
+ *   SHAKE128:    stream = SHAKE128(seed), any seed length.
+ *   AES128-CTR:  key = seed[0..15], initial counter block = seed[16..31]
+ *                (zero when seed_len == 16), counter incremented as a
+ *                128-bit big-endian integer (SP 800-38A).
+ *   ChaCha20:    RFC 8439 keystream, key = seed[0..31], nonce = seed[32..43]
+ *                (zero when seed_len == 32), block counter from 0. Past
+ *                2^32 blocks the counter carries into word 13, the 64-bit
+ *                counter of the original ChaCha; an RFC 8439 stream never
+ *                gets there.
+ *   SHAKE128x4:  four SHAKE128 instances, lane i absorbing seed || byte(i);
+ *                the stream is their rate blocks interleaved lane 0..3, i.e.
+ *                block j of lane i sits at offset 168 * (4j + i). Any seed
+ *                length.
+ *   Philox4x32:  Philox4x32-10 (Random123), key = seed[0..7], counter words
+ *                (block low, block high, 0, 0) with the block from 0.
+ * AES128-CTR uses AES-NI (eight blocks in flight), ChaCha20 an eight-block
+ * AVX2 kernel and SHAKE128x4 a four-lane AVX2 Keccak-f[1600] when sdat_cpu
+ * reports the features; otherwise the portable code below produces the same
+ * stream. Keystream is generated a full vector batch at a time and the unused
+ * part is buffered in the context. */
+typedef enum {
+    SDAT_PRG_SHAKE128,
+    SDAT_PRG_AES128_CTR,
+    SDAT_PRG_CHACHA20,
+    SDAT_PRG_SHAKE128_X4,
+    SDAT_PRG_PHILOX4X32
+} sdat_prg_kind;
+
+#define SDAT_SHAKE128_RATE 168u
+#define SDAT_AES128_CTR_BATCH 8u
+#define SDAT_CHACHA20_BATCH 8u
+#define SDAT_PHILOX_BATCH 8u
+
+typedef struct {
+    uint64_t s[25];
+    unsigned pos;
+    int squeezing;
+} sdat_shake128_ctx;
+
+/* Four interleaved Keccak states: lane (x, y) of instance i is s[x + 5y][i]. */
+typedef struct {
+    uint64_t s[25][4];
+    uint8_t buf[4 * SDAT_SHAKE128_RATE];
+    unsigned pos;
+} sdat_shake128x4_ctx;
+
+typedef struct {
+    uint8_t rk[176];
+    uint8_t ctr[16];
+    uint8_t ks[16 * SDAT_AES128_CTR_BATCH];
+    unsigned pos;
+} sdat_aes128_ctr_ctx;
+
+typedef struct {
+    uint32_t st[16];
+    uint8_t ks[64 * SDAT_CHACHA20_BATCH];
+    unsigned pos;
+} sdat_chacha20_ctx;
+
+typedef struct {
+    uint32_t key[2];
+    uint32_t ctr[4];
+    uint8_t ks[16 * SDAT_PHILOX_BATCH];
+    unsigned pos;
+} sdat_philox4x32_ctx;
+
+typedef struct {
+    sdat_prg_kind kind;
+    int seekable;
+    union {
+        sdat_shake128_ctx shake;
+        sdat_aes128_ctr_ctx aes;
+        sdat_chacha20_ctx chacha;
+        sdat_shake128x4_ctx shake4;
+        sdat_philox4x32_ctx philox;
+    } u;
+} sdat_prg;
+
+void sdat_keccak_f1600(uint64_t s[25]);
+void sdat_shake128_init(sdat_shake128_ctx *ctx);
+void sdat_shake128_absorb(sdat_shake128_ctx *ctx, const uint8_t *in, size_t len);
+void sdat_shake128_squeeze(sdat_shake128_ctx *ctx, uint8_t *out, size_t len);
+void sdat_shake128(uint8_t *out, size_t out_len, const uint8_t *in, size_t in_len);
+void sdat_keccak_f1600_x4(uint64_t s[25][4]);
+void sdat_shake128x4_init(sdat_shake128x4_ctx *ctx, const uint8_t *seed, size_t seed_len);
+void sdat_shake128x4_squeeze(sdat_shake128x4_ctx *ctx, uint8_t *out, size_t len);
+
+void sdat_aes128_expand_key(uint8_t rk[176], const uint8_t key[16]);
+void sdat_aes128_encrypt_block(const uint8_t rk[176], const uint8_t in[16], uint8_t out[16]);
+void sdat_aes128_ctr_init(sdat_aes128_ctr_ctx *ctx, const uint8_t key[16], const uint8_t iv[16]);
+void sdat_aes128_ctr_squeeze(sdat_aes128_ctr_ctx *ctx, uint8_t *out, size_t len);
+/* Positions the stream at byte `offset`, block index in the counter's low half. */
+void sdat_aes128_ctr_seek(sdat_aes128_ctr_ctx *ctx, uint64_t offset);
+/* `blocks` keystream blocks from ctr (advanced past them), portable or AES-NI
+ * as sdat_cpu allows. */
+void sdat_aes128_ctr_blocks(const uint8_t rk[176], uint8_t ctr[16], uint8_t *out, size_t blocks);
+
+void sdat_chacha20_block(const uint32_t in[16], uint8_t out[64]);
+void sdat_chacha20_init(sdat_chacha20_ctx *ctx, const uint8_t key[32], const uint8_t nonce[12]);
+void sdat_chacha20_squeeze(sdat_chacha20_ctx *ctx, uint8_t *out, size_t len);
+void sdat_chacha20_seek(sdat_chacha20_ctx *ctx, uint64_t offset);
+/* `blocks` consecutive blocks from st, advancing the block counter st[12]
+ * (carrying into st[13]). */
+void sdat_chacha20_blocks(uint32_t st[16], uint8_t *out, size_t blocks);
+
+void sdat_philox4x32_block(const uint32_t key[2], const uint32_t ctr[4], uint8_t out[16]);
+/* Counter words 2 and 3 hold the stream id; words 0 and 1 count blocks. */
+void sdat_philox4x32_init(sdat_philox4x32_ctx *ctx, const uint8_t key[8], uint64_t stream);
+void sdat_philox4x32_squeeze(sdat_philox4x32_ctx *ctx, uint8_t *out, size_t len);
+void sdat_philox4x32_seek(sdat_philox4x32_ctx *ctx, uint64_t offset);
+void sdat_philox4x32_blocks(const uint32_t key[2], uint32_t ctr[4], uint8_t *out, size_t blocks);
+
+/* x86 kernels (sdat_prg_x86.c); callers check sdat_cpu first. */
+void sdat_aes128_ctr_blocks_aesni(const uint8_t rk[176], uint8_t ctr[16], uint8_t *out, size_t blocks);
+void sdat_chacha20_blocks8_avx2(uint32_t st[16], uint8_t out[512]);
+void sdat_keccak_f1600_x4_avx2(uint64_t s[25][4]);
+
+/* Returns 0, or -1 for an unknown kind or a seed the kind cannot use. */
+int sdat_prg_init(sdat_prg *g, sdat_prg_kind kind, const uint8_t *seed, size_t seed_len);
+/* Counter-based streams. For AES128-CTR, ChaCha20 and Philox4x32 the
+ * keystream byte at `offset` is a function of (key, stream, offset) alone:
+ *   AES128-CTR  key 16 bytes, counter block be64(stream) || be64(offset / 16)
+ *   ChaCha20    key 32 bytes, words 12-13 = offset / 64, 14-15 = stream
+ *   Philox4x32  key 8 bytes, counter (offset / 16, stream) as 64-bit halves
+ * Stream 0 is the stream sdat_prg_init gives for a key of that length.
+ * Returns -1 for the other kinds or a wrong key length. */
+int sdat_prg_init_stream(sdat_prg *g, sdat_prg_kind kind, const uint8_t *key, size_t key_len, uint64_t stream);
+/* Key length sdat_prg_init_stream takes for the kind, 0 for SHAKE kinds. */
+size_t sdat_prg_stream_key_bytes(sdat_prg_kind kind);
+/* Repositions a counter-based stream at byte `offset` in O(1). Returns -1 for
+ * SHAKE-based kinds and for streams started from an explicit IV or nonce. */
+int sdat_prg_seek(sdat_prg *g, uint64_t offset);
+/* Sharded jobs: chunk j of the job (key, stream) reads the stream from offset
+ * j * SDAT_PRG_CHUNK_STRIDE, so any chunk can be generated on its own. */
+#define SDAT_PRG_CHUNK_STRIDE (UINT64_C(1) << 32)
+int sdat_prg_init_chunk(sdat_prg *g, sdat_prg_kind kind, const uint8_t *key, size_t key_len, uint64_t stream,
+                        uint64_t chunk);
+void sdat_prg_generate(sdat_prg *g, uint8_t *out, size_t len);
+void sdat_prg_wipe(sdat_prg *g);
+/* Zeroes len bytes through a volatile pointer so the store is not elided. */
+void sdat_secure_zero(void *p, size_t len);
+/* sdat_randombytes_fn adapter; ctx is an initialized sdat_prg. */
+int sdat_prg_randombytes(void *ctx, uint8_t *out, size_t out_len);
+const char *sdat_prg_name(sdat_prg_kind kind);
+/* Implementation the kind runs on here: "aesni", "avx2" or "portable". */
+const char *sdat_prg_backend_name(sdat_prg_kind kind);
+#endif
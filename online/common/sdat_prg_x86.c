@@ -0,0 +1,134 @@
+#include "sdat_prg.h"
+#include <immintrin.h>
+
+/* Vector kernels behind the portable seed expanders. Compiled with -mavx2
+ * -maes and only entered after sdat_cpu_has reports the features; each one
+ * produces exactly the bytes of the portable code. */
+
+/* AES-128-CTR with AES-NI: up to eight counter blocks in flight per round key,
+ * which hides the aesenc latency. The counter is carried as two big-endian
+ * halves so the next block is an add, not a byte loop. */
+void sdat_aes128_ctr_blocks_aesni(const uint8_t rk[176], uint8_t ctr[16], uint8_t *out, size_t blocks) {
+    __m128i k[11];
+    for (unsigned r = 0; r < 11; r++) k[r] = _mm_loadu_si128((const __m128i *)(rk + 16 * r));
+    uint64_t hi = 0, lo = 0;
+    for (unsigned i = 0; i < 8; i++) {
+        hi = hi << 8 | ctr[i];
+        lo = lo << 8 | ctr[8 + i];
+    }
+    while (blocks) {
+        size_t m = blocks < 8 ? blocks : 8;
+        __m128i b[8];
+        for (size_t i = 0; i < m; i++) {
+            b[i] = _mm_xor_si128(_mm_set_epi64x((long long)__builtin_bswap64(lo), (long long)__builtin_bswap64(hi)), k[0]);
+            hi += ++lo == 0;
+        }
+        for (unsigned r = 1; r < 10; r++)
+            for (size_t i = 0; i < m; i++) b[i] = _mm_aesenc_si128(b[i], k[r]);
+        for (size_t i = 0; i < m; i++) _mm_storeu_si128((__m128i *)(out + 16 * i), _mm_aesenclast_si128(b[i], k[10]));
+        out += 16 * m;
+        blocks -= m;
+    }
+    for (unsigned i = 0; i < 8; i++) {
+        ctr[i] = (uint8_t)(hi >> (56 - 8 * i));
+        ctr[8 + i] = (uint8_t)(lo >> (56 - 8 * i));
+    }
+}
+
+/* ChaCha20, eight blocks at once: vector x[i] holds state word i of blocks
+ * counter + 0 .. counter + 7, and an 8x8 transpose restores block order. */
+static inline __m256i rotl32x8(__m256i x, int k) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, k), _mm256_srli_epi32(x, 32 - k));
+}
+
+#define QROUND8(a, b, c, d)                                                                                         \
+    do {                                                                                                            \
+        a = _mm256_add_epi32(a, b); d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot16);                         \
+        c = _mm256_add_epi32(c, d); b = rotl32x8(_mm256_xor_si256(b, c), 12);                                      \
+        a = _mm256_add_epi32(a, b); d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot8);                          \
+        c = _mm256_add_epi32(c, d); b = rotl32x8(_mm256_xor_si256(b, c), 7);                                       \
+    } while (0)
+
+/* Stores words w[0..7] of the eight blocks at out + 64 * block. */
+static inline void transpose_store8(const __m256i w[8], uint8_t *out) {
+    __m256i t[8], u[8];
+    for (unsigned i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(w[i], w[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(w[i], w[i + 1]);
+    }
+    for (unsigned i = 0; i < 8; i += 4) {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (unsigned b = 0; b < 4; b++) {
+        _mm256_storeu_si256((__m256i *)(out + 64 * b), _mm256_permute2x128_si256(u[b], u[b + 4], 0x20));
+        _mm256_storeu_si256((__m256i *)(out + 64 * (b + 4)), _mm256_permute2x128_si256(u[b], u[b + 4], 0x31));
+    }
+}
+
+void sdat_chacha20_blocks8_avx2(uint32_t st[16], uint8_t out[512]) {
+    const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                           2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m256i rot8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                          3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    __m256i in[16], x[16];
+    for (unsigned i = 0; i < 16; i++) in[i] = _mm256_set1_epi32((int)st[i]);
+    in[12] = _mm256_add_epi32(in[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    for (unsigned i = 0; i < 16; i++) x[i] = in[i];
+    for (unsigned i = 0; i < 10; i++) {
+        QROUND8(x[0], x[4], x[8], x[12]);
+        QROUND8(x[1], x[5], x[9], x[13]);
+        QROUND8(x[2], x[6], x[10], x[14]);
+        QROUND8(x[3], x[7], x[11], x[15]);
+        QROUND8(x[0], x[5], x[10], x[15]);
+        QROUND8(x[1], x[6], x[11], x[12]);
+        QROUND8(x[2], x[7], x[8], x[13]);
+        QROUND8(x[3], x[4], x[9], x[14]);
+    }
+    for (unsigned i = 0; i < 16; i++) x[i] = _mm256_add_epi32(x[i], in[i]);
+    transpose_store8(x, out);
+    transpose_store8(x + 8, out + 32);
+    st[12] += 8;
+}
+
+/* Keccak-f[1600] on four interleaved states, one 64-bit lane per instance in
+ * each ymm register. Same round structure as sdat_keccak_f1600. */
+static const uint64_t keccak_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+static inline __m256i rotl64x4(__m256i x, unsigned k) {
+    return k ? _mm256_or_si256(_mm256_slli_epi64(x, (int)k), _mm256_srli_epi64(x, (int)(64 - k))) : x;
+}
+
+void sdat_keccak_f1600_x4_avx2(uint64_t s[25][4]) {
+    static const unsigned rho[25] = {
+        0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14,
+    };
+    __m256i a[25];
+    for (unsigned i = 0; i < 25; i++) a[i] = _mm256_loadu_si256((const __m256i *)s[i]);
+    for (unsigned round = 0; round < 24; round++) {
+        __m256i c[5], b[25];
+        for (unsigned x = 0; x < 5; x++)
+            c[x] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]), _mm256_xor_si256(a[x + 10], a[x + 15])),
+                                    a[x + 20]);
+        for (unsigned x = 0; x < 5; x++) {
+            __m256i d = _mm256_xor_si256(c[(x + 4) % 5], rotl64x4(c[(x + 1) % 5], 1));
+            for (unsigned y = 0; y < 25; y += 5) a[x + y] = _mm256_xor_si256(a[x + y], d);
+        }
+        for (unsigned x = 0; x < 5; x++)
+            for (unsigned y = 0; y < 5; y++) b[y + 5 * ((2 * x + 3 * y) % 5)] = rotl64x4(a[x + 5 * y], rho[x + 5 * y]);
+        for (unsigned y = 0; y < 25; y += 5)
+            for (unsigned x = 0; x < 5; x++)
+                a[x + y] = _mm256_xor_si256(b[x + y], _mm256_andnot_si256(b[(x + 1) % 5 + y], b[(x + 2) % 5 + y]));
+        a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x((long long)keccak_rc[round]));
+    }
+    for (unsigned i = 0; i < 25; i++) _mm256_storeu_si256((__m256i *)s[i], a[i]);
+}
@@ -0,0 +1,63 @@
+#ifndef SDAT_RANDBUF_H
+#define SDAT_RANDBUF_H
+#include <string.h>
+#include "sdat_prg.h"
+#include "sdat_types.h"
+
+/* Block-buffered view of an sdat_randombytes_fn for the generic batch APIs.
+ * Draws are served from a local block, and a refill asks the callback for up
+ * to SDAT_RANDBUF_BYTES at once instead of 1, 2 or 9 bytes per attempt.
+ *
+ * `hint` is a lower bound on the bytes the caller will still consume, counted
+ * from the current draw (remaining outputs times the draw size, since every
+ * output takes at least one draw). A refill never asks for more than that, so
+ * no byte is fetched that a per-draw caller would not also have fetched: a
+ * byte-stream callback yields the same draws, and sdat_stats.random_bytes,
+ * which counts consumed draws, stays exact. Only the request sizes change.
+ *
+ * The block lives in caller storage of `cap` bytes: SDAT_RANDBUF_BYTES for the
+ * batch forms, SDAT_RANDBUF_DRAW_BYTES (the largest single draw) for single
+ * samples. It holds secret bytes, so callers end with sdat_randbuf_wipe. */
+#define SDAT_RANDBUF_BYTES 4096u
+#define SDAT_RANDBUF_DRAW_BYTES 9u
+
+typedef struct {
+    sdat_randombytes_fn fn;
+    void *ctx;
+    size_t pos, len, cap;
+    uint8_t *buf;
+} sdat_randbuf;
+
+static inline void sdat_randbuf_init(sdat_randbuf *b, sdat_randombytes_fn fn, void *ctx, uint8_t *buf, size_t cap) {
+    b->fn = fn;
+    b->ctx = ctx;
+    b->pos = b->len = 0;
+    b->cap = cap;
+    b->buf = buf;
+}
+
+/* Zeroes the part of the block the callback has written. */
+static inline void sdat_randbuf_wipe(sdat_randbuf *b) {
+    sdat_secure_zero(b->buf, b->len);
+    b->pos = b->len = 0;
+}
+
+/* `bytes` <= cap fresh bytes, or NULL when the callback fails. */
+static inline const uint8_t *sdat_randbuf_take(sdat_randbuf *b, size_t bytes, size_t hint) {
+    if (b->len - b->pos < bytes) {
+        size_t left = b->len - b->pos, want = hint < bytes ? bytes : hint;
+        if (want > b->cap) want = b->cap;
+        memmove(b->buf, b->buf + b->pos, left);
+        b->pos = 0;
+        b->len = left;
+        if (b->fn(b->ctx, b->buf + left, want - left)) {
+            sdat_secure_zero(b->buf + left, want - left);
+            return 0;
+        }
+        b->len = want;
+    }
+    const uint8_t *p = b->buf + b->pos;
+    b->pos += bytes;
+    return p;
+}
+#endif
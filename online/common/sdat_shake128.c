@@ -0,0 +1,151 @@
+#include "sdat_prg.h"
+#include "sdat_cpu.h"
+#include <string.h>
+
+static const uint64_t keccak_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+static inline uint64_t rol64(uint64_t x, unsigned k) {
+    return k ? (x << k) | (x >> (64u - k)) : x;
+}
+
+/* Lane (x, y) lives at s[x + 5y]. */
+void sdat_keccak_f1600(uint64_t s[25]) {
+    static const unsigned rho[25] = {
+        0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14,
+    };
+    for (unsigned round = 0; round < 24; round++) {
+        uint64_t c[5], b[25];
+        for (unsigned x = 0; x < 5; x++) c[x] = s[x] ^ s[x + 5] ^ s[x + 10] ^ s[x + 15] ^ s[x + 20];
+        for (unsigned x = 0; x < 5; x++) {
+            uint64_t d = c[(x + 4) % 5] ^ rol64(c[(x + 1) % 5], 1);
+            for (unsigned y = 0; y < 25; y += 5) s[x + y] ^= d;
+        }
+        for (unsigned x = 0; x < 5; x++)
+            for (unsigned y = 0; y < 5; y++) b[y + 5 * ((2 * x + 3 * y) % 5)] = rol64(s[x + 5 * y], rho[x + 5 * y]);
+        for (unsigned y = 0; y < 25; y += 5)
+            for (unsigned x = 0; x < 5; x++) s[x + y] = b[x + y] ^ (~b[(x + 1) % 5 + y] & b[(x + 2) % 5 + y]);
+        s[0] ^= keccak_rc[round];
+    }
+}
+
+static inline void xor_byte(uint64_t s[25], unsigned i, uint8_t v) {
+    s[i >> 3] ^= (uint64_t)v << (8u * (i & 7u));
+}
+
+static inline uint8_t get_byte(const uint64_t s[25], unsigned i) {
+    return (uint8_t)(s[i >> 3] >> (8u * (i & 7u)));
+}
+
+void sdat_shake128_init(sdat_shake128_ctx *ctx) {
+    memset(ctx, 0, sizeof *ctx);
+}
+
+void sdat_shake128_absorb(sdat_shake128_ctx *ctx, const uint8_t *in, size_t len) {
+    while (len--) {
+        xor_byte(ctx->s, ctx->pos++, *in++);
+        if (ctx->pos == SDAT_SHAKE128_RATE) {
+            sdat_keccak_f1600(ctx->s);
+            ctx->pos = 0;
+        }
+    }
+}
+
+/* The first squeeze pads the message (SHAKE domain bits 1111 then pad10*1). */
+void sdat_shake128_squeeze(sdat_shake128_ctx *ctx, uint8_t *out, size_t len) {
+    if (!ctx->squeezing) {
+        xor_byte(ctx->s, ctx->pos, 0x1f);
+        xor_byte(ctx->s, SDAT_SHAKE128_RATE - 1u, 0x80);
+        ctx->squeezing = 1;
+        ctx->pos = SDAT_SHAKE128_RATE;
+    }
+    while (len) {
+        if (ctx->pos == SDAT_SHAKE128_RATE) {
+            sdat_keccak_f1600(ctx->s);
+            ctx->pos = 0;
+        }
+        if (ctx->pos == 0 && len >= SDAT_SHAKE128_RATE) {
+            for (unsigned i = 0; i < SDAT_SHAKE128_RATE / 8u; i++)
+                for (unsigned j = 0; j < 8; j++) out[8 * i + j] = (uint8_t)(ctx->s[i] >> (8 * j));
+            out += SDAT_SHAKE128_RATE;
+            len -= SDAT_SHAKE128_RATE;
+            ctx->pos = SDAT_SHAKE128_RATE;
+            continue;
+        }
+        *out++ = get_byte(ctx->s, ctx->pos++);
+        len--;
+    }
+}
+
+void sdat_shake128(uint8_t *out, size_t out_len, const uint8_t *in, size_t in_len) {
+    sdat_shake128_ctx ctx;
+    sdat_shake128_init(&ctx);
+    sdat_shake128_absorb(&ctx, in, in_len);
+    sdat_shake128_squeeze(&ctx, out, out_len);
+    memset(&ctx, 0, sizeof ctx);
+}
+
+void sdat_keccak_f1600_x4(uint64_t s[25][4]) {
+    if (sdat_cpu_has(SDAT_CPU_AVX2)) {
+        sdat_keccak_f1600_x4_avx2(s);
+        return;
+    }
+    for (unsigned i = 0; i < 4; i++) {
+        uint64_t t[25];
+        for (unsigned j = 0; j < 25; j++) t[j] = s[j][i];
+        sdat_keccak_f1600(t);
+        for (unsigned j = 0; j < 25; j++) s[j][i] = t[j];
+    }
+}
+
+/* Seeds longer than one rate block are absorbed by the scalar sponge and the
+ * states interleaved afterwards; the squeeze is where the four lanes pay off. */
+void sdat_shake128x4_init(sdat_shake128x4_ctx *ctx, const uint8_t *seed, size_t seed_len) {
+    memset(ctx, 0, sizeof *ctx);
+    for (unsigned i = 0; i < 4; i++) {
+        sdat_shake128_ctx one;
+        uint8_t lane = (uint8_t)i;
+        sdat_shake128_init(&one);
+        sdat_shake128_absorb(&one, seed, seed_len);
+        sdat_shake128_absorb(&one, &lane, 1);
+        xor_byte(one.s, one.pos, 0x1f);
+        xor_byte(one.s, SDAT_SHAKE128_RATE - 1u, 0x80);
+        for (unsigned j = 0; j < 25; j++) ctx->s[j][i] = one.s[j];
+        memset(&one, 0, sizeof one);
+    }
+    ctx->pos = sizeof ctx->buf;
+}
+
+static void shake128x4_blocks(sdat_shake128x4_ctx *ctx, uint8_t *out) {
+    sdat_keccak_f1600_x4(ctx->s);
+    for (unsigned i = 0; i < 4; i++)
+        for (unsigned w = 0; w < SDAT_SHAKE128_RATE / 8u; w++)
+            for (unsigned j = 0; j < 8; j++) out[SDAT_SHAKE128_RATE * i + 8 * w + j] = (uint8_t)(ctx->s[w][i] >> (8 * j));
+}
+
+void sdat_shake128x4_squeeze(sdat_shake128x4_ctx *ctx, uint8_t *out, size_t len) {
+    while (len) {
+        if (ctx->pos == sizeof ctx->buf) {
+            if (len >= sizeof ctx->buf) {
+                shake128x4_blocks(ctx, out);
+                out += sizeof ctx->buf;
+                len -= sizeof ctx->buf;
+                continue;
+            }
+            shake128x4_blocks(ctx, ctx->buf);
+            ctx->pos = 0;
+        }
+        size_t m = sizeof ctx->buf - ctx->pos;
+        if (m > len) m = len;
+        memcpy(out, ctx->buf + ctx->pos, m);
+        ctx->pos += (unsigned)m;
+        out += m;
+        len -= m;
+    }
+}
@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L
+#include "sdat_table_file.h"
+#include "sdat_tables.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(sdat_table_file_header) == 256, "table file header must stay 256 bytes");
+_Static_assert(sizeof(sdat_u72) == 16, "U72 records are stored in the host sdat_u72 layout");
+
+/* Bounds for a sane table; they only guard the loader against huge counts. */
+#define MAX_COUNT 4096u
+#define NSTRINGS 11u
+
+static size_t value_size(sdat_value_type vt) {
+    return vt == SDAT_TYPE_U8 ? 1u : vt == SDAT_TYPE_U16 ? 2u : vt == SDAT_TYPE_U72 ? sizeof(sdat_u72) : 0u;
+}
+
+static size_t align_up(size_t x) {
+    return (x + SDAT_TABLE_FILE_ALIGN - 1u) & ~(size_t)(SDAT_TABLE_FILE_ALIGN - 1u);
+}
+
+static uint64_t native(const sdat_table *t, const void *a, size_t i) {
+    return t->value_type == SDAT_TYPE_U8 ? ((const uint8_t *)a)[i] : ((const uint16_t *)a)[i];
+}
+
+static void put_values(uint8_t *dst, const sdat_table *t, const void *src, size_t n) {
+    if (t->value_type != SDAT_TYPE_U72) {
+        memcpy(dst, src, n * value_size(t->value_type));
+        return;
+    }
+    const sdat_u72 *v = src;
+    for (size_t i = 0; i < n; i++) {
+        memcpy(dst + 16 * i, &v[i].lo, 8);
+        dst[16 * i + 8] = v[i].hi;
+    }
+}
+
+/* Places a section of `bytes` at the next aligned offset; empty ones stay 0. */
+static void place(uint64_t *field, size_t *off, size_t bytes) {
+    if (bytes) {
+        *off = align_up(*off);
+        *field = *off;
+        *off += bytes;
+    }
+}
+
+static void strings_of(const sdat_table *t, const char *s[NSTRINGS]) {
+    const char *v[NSTRINGS] = {t->table_id, t->scheme, t->parameter_set, t->table_family, t->source_kind,
+                               t->source_artifact, t->source_hash, t->threshold_encoding, t->zero_semantics,
+                               t->sign_semantics, t->output_semantics};
+    for (unsigned i = 0; i < NSTRINGS; i++) s[i] = v[i] ? v[i] : "";
+}
+
+size_t sdat_table_file_encode(const sdat_table *t, uint32_t id, uint8_t *out, size_t cap) {
+    if (!t) return 0;
+    size_t vs = value_size(t->value_type);
+    size_t nthr = t->mass_count > t->threshold_count ? t->mass_count : t->threshold_count;
+    size_t tn = t->threshold_count;
+    if (!vs || t->mass_count > MAX_COUNT || nthr > MAX_COUNT || (nthr && !t->thresholds) || (t->mass_count && !t->pmf))
+        return 0;
+    const char *s[NSTRINGS];
+    strings_of(t, s);
+    int wide = t->value_type == SDAT_TYPE_U72;
+    sdat_table_file_header h = {0};
+    size_t off = sizeof h, slen = 0;
+    for (unsigned i = 0; i < NSTRINGS; i++) slen += strlen(s[i]) + 1u;
+    place(&h.off_strings, &off, slen);
+    place(&h.off_pmf, &off, t->mass_count * vs);
+    place(&h.off_thresholds, &off, nthr * vs);
+    place(&h.off_thr_gt16, &off, wide ? 0 : tn * 2u);
+    place(&h.off_thr_gt32, &off, wide ? 0 : tn * 4u);
+    place(&h.off_soa_lo, &off, wide ? tn * 8u : 0);
+    place(&h.off_soa_hi, &off, wide ? tn : 0);
+    place(&h.off_limbs24, &off, wide ? tn * 12u : 0);
+    size_t total = align_up(off);
+    if (!out || cap < total) return total;
+
+    memset(out, 0, total);
+    memcpy(h.magic, SDAT_TABLE_FILE_MAGIC, sizeof SDAT_TABLE_FILE_MAGIC);
+    h.version = SDAT_TABLE_FILE_VERSION;
+    h.header_bytes = sizeof h;
+    h.file_bytes = total;
+    h.table_id = id;
+    h.value_type = (uint32_t)t->value_type;
+    h.support_min = t->support_min;
+    h.support_max = t->support_max;
+    h.support_length = t->support_length;
+    h.mass_count = t->mass_count;
+    h.threshold_count = tn;
+    h.denominator_bits = t->denominator_bits;
+    h.random_draw_bits = t->random_draw_bits;
+    h.denominator_u64 = t->denominator_u64;
+    h.denominator_u72_lo = t->denominator_u72.lo;
+    h.denominator_u72_hi = t->denominator_u72.hi;
+    h.flags = (t->terminal_threshold_stored ? SDAT_TABLE_FILE_TERMINAL_STORED : 0u) |
+              (t->available ? SDAT_TABLE_FILE_AVAILABLE : 0u) |
+              (t->source_verified ? SDAT_TABLE_FILE_SOURCE_VERIFIED : 0u) |
+              (t->heuristic_bkz ? SDAT_TABLE_FILE_HEURISTIC_BKZ : 0u) |
+              (t->exact_svp ? SDAT_TABLE_FILE_EXACT_SVP : 0u) |
+              (t->global_svp_certified ? SDAT_TABLE_FILE_GLOBAL_SVP_CERTIFIED : 0u);
+    h.native_table_bytes = t->native_table_bytes;
+    h.packed_bits = t->packed_bits;
+
+    uint8_t *p = out + h.off_strings;
+    for (unsigned i = 0; i < NSTRINGS; i++) {
+        size_t l = strlen(s[i]) + 1u;
+        memcpy(p, s[i], l);
+        p += l;
+    }
+    if (h.off_pmf) put_values(out + h.off_pmf, t, t->pmf, t->mass_count);
+    if (h.off_thresholds) put_values(out + h.off_thresholds, t, t->thresholds, nthr);
+    int original = t->table_family && !strcmp(t->table_family, "original-cdt-table");
+    for (size_t j = 0; j < tn && !wide; j++) {
+        uint64_t v = native(t, t->thresholds, j);
+        uint16_t g16 = (uint16_t)(original ? v : v - 1u);
+        uint32_t g32 = (uint32_t)(original ? v : v - 1u);
+        memcpy(out + h.off_thr_gt16 + 2 * j, &g16, 2);
+        memcpy(out + h.off_thr_gt32 + 4 * j, &g32, 4);
+    }
+    for (size_t j = 0; j < tn && wide; j++) {
+        sdat_u72 v = ((const sdat_u72 *)t->thresholds)[j];
+        uint32_t limbs[3] = {(uint32_t)(v.lo & 0xFFFFFFu), (uint32_t)((v.lo >> 24) & 0xFFFFFFu),
+                             (uint32_t)(v.lo >> 48) | ((uint32_t)v.hi << 16)};
+        memcpy(out + h.off_soa_lo + 8 * j, &v.lo, 8);
+        out[h.off_soa_hi + j] = v.hi;
+        memcpy(out + h.off_limbs24 + 12 * j, limbs, 12);
+    }
+    sdat_sha256(out + sizeof h, total - sizeof h, h.payload_sha256);
+    memcpy(out, &h, sizeof h);
+    return total;
+}
+
+int sdat_table_file_write(const sdat_table *t, uint32_t id, const char *path) {
+    size_t n = sdat_table_file_encode(t, id, 0, 0);
+    if (!n || !path) return -1;
+    uint8_t *buf = malloc(n);
+    if (!buf) return -2;
+    sdat_table_file_encode(t, id, buf, n);
+    FILE *f = fopen(path, "wb");
+    int rc = f && fwrite(buf, 1, n, f) == n ? 0 : -2;
+    if (f && fclose(f)) rc = -2;
+    free(buf);
+    return rc;
+}
+
+/* Section [off, off + bytes) must be aligned and inside the file; absent
+ * (offset 0) exactly when it is empty. */
+static int section(const sdat_table_file *f, uint64_t off, uint64_t bytes, const void **p) {
+    *p = 0;
+    if (!bytes) return off ? -2 : 0;
+    if (off < sizeof(sdat_table_file_header) || off % SDAT_TABLE_FILE_ALIGN || off > f->len || bytes > f->len - off)
+        return -2;
+    *p = f->base + off;
+    return 0;
+}
+
+int sdat_table_file_view(sdat_table_file *f, const void *buf, size_t len) {
+    if (!f || !buf || (uintptr_t)buf % SDAT_TABLE_FILE_ALIGN) return -1;
+    *f = (sdat_table_file){0};
+    f->base = buf;
+    f->len = len;
+    if (len < sizeof(sdat_table_file_header)) return -2;
+    const sdat_table_file_header *h = buf;
+    if (memcmp(h->magic, SDAT_TABLE_FILE_MAGIC, sizeof SDAT_TABLE_FILE_MAGIC) ||
+        h->version != SDAT_TABLE_FILE_VERSION || h->header_bytes != sizeof *h)
+        return -3;
+    size_t vs = value_size((sdat_value_type)h->value_type);
+    if (!vs) return -3;
+    if (h->file_bytes != len || h->mass_count > MAX_COUNT || h->threshold_count > MAX_COUNT) return -2;
+    uint8_t digest[32];
+    sdat_sha256(f->base + sizeof *h, len - sizeof *h, digest);
+    if (memcmp(digest, h->payload_sha256, sizeof digest)) return -4;
+
+    size_t tn = (size_t)h->threshold_count, nthr = h->mass_count > tn ? (size_t)h->mass_count : tn;
+    int wide = h->value_type == SDAT_TYPE_U72;
+    const void *str, *pmf, *thr, *g16, *g32, *lo, *hi, *limbs;
+    int rc = section(f, h->off_strings, 1, &str);
+    if (!rc) rc = section(f, h->off_pmf, h->mass_count * vs, &pmf);
+    if (!rc) rc = section(f, h->off_thresholds, nthr * vs, &thr);
+    if (!rc) rc = section(f, h->off_thr_gt16, wide ? 0 : tn * 2u, &g16);
+    if (!rc) rc = section(f, h->off_thr_gt32, wide ? 0 : tn * 4u, &g32);
+    if (!rc) rc = section(f, h->off_soa_lo, wide ? tn * 8u : 0, &lo);
+    if (!rc) rc = section(f, h->off_soa_hi, wide ? tn : 0, &hi);
+    if (!rc) rc = section(f, h->off_limbs24, wide ? tn * 12u : 0, &limbs);
+    if (rc) return rc;
+    const char *s[NSTRINGS], *p = str, *end = (const char *)f->base + len;
+    for (unsigned i = 0; i < NSTRINGS; i++) {
+        const char *z = memchr(p, 0, (size_t)(end - p));
+        if (!z) return -2;
+        s[i] = p;
+        p = z + 1;
+    }
+
+    sdat_table *t = &f->table;
+    *t = (sdat_table){s[0], s[1], s[2], s[3], s[4], s[5], s[6], h->support_min, h->support_max,
+                      (size_t)h->support_length, (sdat_value_type)h->value_type, h->denominator_bits,
+                      h->random_draw_bits, (size_t)h->mass_count, tn, pmf, thr,
+                      !!(h->flags & SDAT_TABLE_FILE_TERMINAL_STORED), s[7], s[8], s[9], s[10],
+                      (size_t)h->native_table_bytes, (size_t)h->packed_bits,
+                      {h->denominator_u72_lo, (uint8_t)h->denominator_u72_hi}, h->denominator_u64,
+                      !!(h->flags & SDAT_TABLE_FILE_AVAILABLE), !!(h->flags & SDAT_TABLE_FILE_SOURCE_VERIFIED),
+                      !!(h->flags & SDAT_TABLE_FILE_HEURISTIC_BKZ), !!(h->flags & SDAT_TABLE_FILE_EXACT_SVP),
+                      !!(h->flags & SDAT_TABLE_FILE_GLOBAL_SVP_CERTIFIED)};
+    f->id = h->table_id;
+    f->thr_gt16 = g16;
+    f->thr_gt32 = g32;
+    f->soa = (sdat_u72_soa){lo, hi, wide ? tn : 0};
+    f->limbs24 = limbs;
+    if (t->available && online_table_validate(t)) return -5;
+    return 0;
+}
+
+int sdat_table_file_open(sdat_table_file *f, const char *path) {
+    if (!f || !path) return -1;
+    *f = (sdat_table_file){0};
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st)) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size < (off_t)sizeof(sdat_table_file_header)) {
+        close(fd);
+        return -2;
+    }
+    void *m = mmap(0, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) return -1;
+    int rc = sdat_table_file_view(f, m, (size_t)st.st_size);
+    if (rc) {
+        munmap(m, (size_t)st.st_size);
+        *f = (sdat_table_file){0};
+        return rc;
+    }
+    f->mapped = 1;
+    return 0;
+}
+
+void sdat_table_file_close(sdat_table_file *f) {
+    if (!f) return;
+    if (f->mapped) munmap((void *)f->base, f->len);
+    *f = (sdat_table_file){0};
+}
@@ -0,0 +1,90 @@
+#ifndef SDAT_TABLE_FILE_H
+#define SDAT_TABLE_FILE_H
+#include <stddef.h>
+#include <stdint.h>
+#include "sdat_types.h"
+
+/* Versioned binary table files (.sdtb) that are used in place: the loader maps
+ * the file read-only and points an sdat_table straight into the mapping, so
+ * processes loading the same file share one page-cached copy and startup does
+ * no parsing beyond bounds checks, the payload digest and
+ * online_table_validate.
+ *
+ * Layout (little-endian, host struct layout of x86-64/aarch64 LP64):
+ *   [0, 256)  sdat_table_file_header
+ *   sections, each starting on a 64-byte boundary, addressed by header offsets
+ *   (0 = absent):
+ *     strings    the eleven metadata strings of sdat_table, NUL-terminated, in
+ *                declaration order (table_id ... output_semantics)
+ *     pmf        mass_count native values
+ *     thresholds max(mass_count, threshold_count) native values, i.e. the C
+ *                array including a stored terminal entry
+ *     thr_gt16/32  U8/U16 only: threshold_count values g such that the lookup
+ *                counts x > g (t - 1 for SDA's x >= t, t for the Original
+ *                x > t), widened for _mm256_cmpgt_epi16/_epi32 broadcasts
+ *     soa_lo/hi, limbs24  U72 only: the sdat_u72_soa arrays and the 24-bit
+ *                limbs (l, m, h per threshold) of falcon_u72_avx2.h
+ * U72 values are stored as 16-byte sdat_u72 records with zero padding.
+ * payload_sha256 covers bytes [256, file_bytes); the SHA-256 of the whole file
+ * is what online_table_hashes.txt records. */
+#define SDAT_TABLE_FILE_MAGIC "SDATTBL"
+#define SDAT_TABLE_FILE_VERSION 1u
+#define SDAT_TABLE_FILE_ALIGN 64u
+
+enum {
+    SDAT_TABLE_FILE_TERMINAL_STORED = 1u << 0,
+    SDAT_TABLE_FILE_AVAILABLE = 1u << 1,
+    SDAT_TABLE_FILE_SOURCE_VERIFIED = 1u << 2,
+    SDAT_TABLE_FILE_HEURISTIC_BKZ = 1u << 3,
+    SDAT_TABLE_FILE_EXACT_SVP = 1u << 4,
+    SDAT_TABLE_FILE_GLOBAL_SVP_CERTIFIED = 1u << 5,
+};
+
+typedef struct {
+    char magic[8];
+    uint32_t version, header_bytes;
+    uint64_t file_bytes;
+    uint32_t table_id, value_type;
+    int32_t support_min, support_max;
+    uint64_t support_length, mass_count, threshold_count;
+    uint32_t denominator_bits, random_draw_bits;
+    uint64_t denominator_u64, denominator_u72_lo;
+    uint32_t denominator_u72_hi, flags;
+    uint64_t native_table_bytes, packed_bits;
+    uint64_t off_strings, off_pmf, off_thresholds, off_thr_gt16, off_thr_gt32, off_soa_lo, off_soa_hi, off_limbs24;
+    uint8_t payload_sha256[32];
+    uint8_t reserved[48];
+} sdat_table_file_header;
+
+/* A loaded table. Every pointer, table.* included, refers to the mapping or
+ * caller buffer and stays valid until sdat_table_file_close. */
+typedef struct {
+    sdat_table table;
+    uint32_t id;
+    const uint16_t *thr_gt16;
+    const uint32_t *thr_gt32;
+    sdat_u72_soa soa;
+    const uint32_t *limbs24;
+    const uint8_t *base;
+    size_t len;
+    int mapped;
+} sdat_table_file;
+
+void sdat_sha256(const uint8_t *in, size_t len, uint8_t out[32]);
+
+/* Serializes t under registry ID id. Returns the file size; out is written only
+ * when cap is at least that size (pass out = NULL to query). 0 for a table the
+ * format cannot hold. The output depends only on the table contents. */
+size_t sdat_table_file_encode(const sdat_table *t, uint32_t id, uint8_t *out, size_t cap);
+/* Writes sdat_table_file_encode output to path: 0, -1 for a bad table, -2 on
+ * an I/O error. */
+int sdat_table_file_write(const sdat_table *t, uint32_t id, const char *path);
+/* Both return 0, or: -1 invalid argument or unreadable file, -2 short file or
+ * a section out of bounds or misaligned, -3 bad magic, version or value type,
+ * -4 payload digest mismatch, -5 table contents fail online_table_validate.
+ * sdat_table_file_view uses a caller buffer (SDAT_TABLE_FILE_ALIGN-aligned)
+ * that must outlive f. */
+int sdat_table_file_open(sdat_table_file *f, const char *path);
+int sdat_table_file_view(sdat_table_file *f, const void *buf, size_t len);
+void sdat_table_file_close(sdat_table_file *f);
+#endif
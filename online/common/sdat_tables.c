@@ -1,7 +1,13 @@
 #include "sdat_tables.h"
+#include <stdatomic.h>
 #include <string.h>
 #define U72(lo,hi) {(uint64_t)(lo),(uint8_t)(hi)}
-#define FROM24(a,b,c) U72((((uint64_t)((a)&0xFFFFu))<<48)|((uint64_t)(b)<<24)|(uint64_t)(c), ((a)>>16)&0xFFu)
+#define FROM24_LO(a,b,c) ((((uint64_t)((a)&0xFFFFu))<<48)|((uint64_t)(b)<<24)|(uint64_t)(c)),
+#define FROM24_HI(a,b,c) (uint8_t)(((a)>>16)&0xFFu),
+#define FROM24_AOS(a,b,c) U72((((uint64_t)((a)&0xFFFFu))<<48)|((uint64_t)(b)<<24)|(uint64_t)(c), ((a)>>16)&0xFFu),
+#define U72_LO(lo,hi) (uint64_t)(lo),
+#define U72_HI(lo,hi) (uint8_t)(hi),
+#define U72_AOS(lo,hi) U72(lo,hi),
 static const uint16_t orig640_p[]={4643,8720,7216,5264,3384,1918,958,422,164,56,17,4,2};
 static const uint16_t orig640_c[]={4643,13363,20579,25843,29227,31145,32103,32525,32689,32745,32762,32766,32767};
 static const uint16_t orig976_p[]={5638,10277,7774,4882,2545,1101,396,118,29,6,2};
@@ -14,19 +20,37 @@ static const uint16_t sda976_p[]={1291,2349,1769,1103,569,243,86,25,6,1};
 static const uint16_t sda976_c[]={1291,3640,5409,6512,7081,7324,7410,7435,7441,7442};
 static const uint8_t sda1344_p[]={29,45,21,6,1};
 static const uint8_t sda1344_c[]={29,74,95,101,102};
-static const sdat_u72 falcon_orig_thr[19]={FROM24(10745844u,3068844u,3741698u),FROM24(5559083u,1580863u,8248194u),FROM24(2260429u,13669192u,2736639u),FROM24(708981u,4421575u,10046180u),FROM24(169348u,7122675u,4136815u),FROM24(30538u,13063405u,7650655u),FROM24(4132u,14505003u,7826148u),FROM24(417u,16768101u,11363290u),FROM24(31u,8444042u,8086568u),FROM24(1u,12844466u,265321u),FROM24(0u,1232676u,13644283u),FROM24(0u,38047u,9111839u),FROM24(0u,870u,6138264u),FROM24(0u,14u,12545723u),FROM24(0u,0u,3104126u),FROM24(0u,0u,28824u),FROM24(0u,0u,198u),FROM24(0u,0u,1u),FROM24(0u,0u,0u)};
+/* The Falcon threshold lists expand once per layout (sdat_u72 array and SoA
+ * lo/hi arrays), so the two layouts cannot drift apart. */
+#define FALCON_ORIG_THR(E) E(10745844u,3068844u,3741698u) E(5559083u,1580863u,8248194u) E(2260429u,13669192u,2736639u) E(708981u,4421575u,10046180u) E(169348u,7122675u,4136815u) E(30538u,13063405u,7650655u) E(4132u,14505003u,7826148u) E(417u,16768101u,11363290u) E(31u,8444042u,8086568u) E(1u,12844466u,265321u) E(0u,1232676u,13644283u) E(0u,38047u,9111839u) E(0u,870u,6138264u) E(0u,14u,12545723u) E(0u,0u,3104126u) E(0u,0u,28824u) E(0u,0u,198u) E(0u,0u,1u) E(0u,0u,0u)
+static const sdat_u72 falcon_orig_thr[19]={FALCON_ORIG_THR(FROM24_AOS)};
 static const sdat_u72 falcon_p[19]={U72(9435933141634180562ULL,91),U72(12849852419418020136ULL,78),U72(905900638993666375,50),U72(9951843566600711290ULL,23),U72(3461107862077052791,8),U72(1957229869125800708,2),U72(7390615507826259779ULL,0),U72(1039734493031882893,0),U72(108174420739448281,0),U72(8323135945700700,0),U72(473597805886727,0),U72(19929328173236,0),U72(620205936904,0),U72(14273795266,0),U72(242942385,0),U72(3057929,0),U72(28465,0),U72(196,0),U72(1,0)};
-static const sdat_u72 falcon_c[19]={U72(9435933141634180562ULL,91),U72(3839041487342649082,170),U72(4744942126336315457,220),U72(14696785692937026747ULL,243),U72(18157893555014079538ULL,251),U72(1668379350430328630,254),U72(9058994858256588409,254),U72(10098729351288471302ULL,254),U72(10206903772027919583ULL,254),U72(10215226907973620283ULL,254),U72(10215700505779507010ULL,254),U72(10215720435107680246ULL,254),U72(10215721055313617150ULL,254),U72(10215721069587412416ULL,254),U72(10215721069830354801ULL,254),U72(10215721069833412730ULL,254),U72(10215721069833441195ULL,254),U72(10215721069833441391ULL,254),U72(10215721069833441392ULL,254)};
+#define FALCON_C(E) E(9435933141634180562ULL,91) E(3839041487342649082,170) E(4744942126336315457,220) E(14696785692937026747ULL,243) E(18157893555014079538ULL,251) E(1668379350430328630,254) E(9058994858256588409,254) E(10098729351288471302ULL,254) E(10206903772027919583ULL,254) E(10215226907973620283ULL,254) E(10215700505779507010ULL,254) E(10215720435107680246ULL,254) E(10215721055313617150ULL,254) E(10215721069587412416ULL,254) E(10215721069830354801ULL,254) E(10215721069833412730ULL,254) E(10215721069833441195ULL,254) E(10215721069833441391ULL,254) E(10215721069833441392ULL,254)
+static const sdat_u72 falcon_c[19]={FALCON_C(U72_AOS)};
 #define ORIG(NAME,MAX,N,P,C,BYTES,PACK,HASH) const sdat_table original_cdt_table_##NAME={"original-cdt-"#NAME,"Frodo",#NAME,"original-cdt-table","generated-original-baseline","offline/generated/original_baseline_tables.h","sha256=" HASH,0,MAX,N,SDAT_TYPE_U16,15,15,N,N-1,P,C,0,"ordinary cumulative thresholds; terminal q omitted online","zero is magnitude 0","sign external; not sampled here","nonnegative magnitude/support index",BYTES,PACK,{0,0},32768,1,1,0,0,0};
 ORIG(frodo640,12,13,orig640_p,orig640_c,26,192,"18b518ff6b76a99ecf786454191fb6ee7cfc56849372f0b37e76d8dbdb6b4cc1")
 ORIG(frodo976,10,11,orig976_p,orig976_c,22,162,"18b518ff6b76a99ecf786454191fb6ee7cfc56849372f0b37e76d8dbdb6b4cc1")
 ORIG(frodo1344,6,7,orig1344_p,orig1344_c,14,104,"18b518ff6b76a99ecf786454191fb6ee7cfc56849372f0b37e76d8dbdb6b4cc1")
+static const uint64_t falcon_orig_thr_lo[19]={FALCON_ORIG_THR(FROM24_LO)};
+static const uint8_t falcon_orig_thr_hi[19]={FALCON_ORIG_THR(FROM24_HI)};
+static const uint64_t falcon_c_lo[19]={FALCON_C(U72_LO)};
+static const uint8_t falcon_c_hi[19]={FALCON_C(U72_HI)};
+const sdat_u72_soa original_cdt_soa_falcon_base={falcon_orig_thr_lo,falcon_orig_thr_hi,19};
+const sdat_u72_soa sda_soa_falcon_base={falcon_c_lo,falcon_c_hi,18};
 const sdat_table original_cdt_table_falcon_base={"original-cdt-falcon-base","Falcon","falcon","original-cdt-table","official-falcon-reference","https://falcon-sign.info/impl/sign.c.html lines 1090-1284","sha256(raw-sign.c-html)=see online/tables/falcon/falcon_original_source_provenance.txt",0,18,19,SDAT_TYPE_U72,72,72,0,19,0,falcon_orig_thr,0,"official reverse-tail comparison thresholds; output=count(threshold>x)","zero is magnitude 0","sign external in full Falcon sampler","nonnegative base magnitude",19*9,19*72,U72(0,0),0,1,1,0,0,0};
 #define SDA_U16(NAME,MAX,N,Q,BITS,P,C,BYTES,HASH) const sdat_table sda_table_##NAME={"sda-table-"#NAME,"Frodo",#NAME,"sda-table","historical-paper-sda","paper Table 5 / Table 6 exact integer masses and cumulative thresholds","pmf_hash=" HASH,0,MAX,N,SDAT_TYPE_U16,BITS,BITS,N,N-1,P,C,0,"ordinary cumulative thresholds; terminal q omitted online","zero is magnitude 0","sign external; not sampled here","nonnegative magnitude/support index",BYTES,(N)*BITS,{0,0},Q,1,1,0,0,0};
 SDA_U16(frodo640,11,12,14534,14,sda640_p,sda640_c,22,"326dae3ad828e5ead907ffea0c341c4d07a3cc6ff0999d9c2f591d6b69239570;cumulative_hash=2b95ba3ee428d74cac5c2f9eb44a34790dc111b6abdf8276c82e22c53219edcd")
 SDA_U16(frodo976,9,10,7442,13,sda976_p,sda976_c,18,"bcd641a9fd954161185a83f46f0fd590c2e2b5ad47a6734aad9d6b6f69f2cbb3;cumulative_hash=f03c0a76dff335db1a83eca315c624efa2158c4ff82376e51bfffde2068ea94c")
 const sdat_table sda_table_frodo1344={"sda-table-frodo1344","Frodo","frodo1344","sda-table","historical-paper-sda","paper Table 5 / Table 6 exact integer masses and cumulative thresholds","pmf_hash=7319c2954a3186f3f5931b54eeafef1484087cf473879a09818516e3c3dd489e;cumulative_hash=63594c67d3b8e2ec16892f94ad746d3c1cf88245999d8681cb19dcb96165267e",0,4,5,SDAT_TYPE_U8,7,7,5,4,sda1344_p,sda1344_c,0,"ordinary cumulative thresholds; terminal q omitted online","zero is magnitude 0","sign external; not sampled here","nonnegative magnitude/support index",4,5*7,{0,0},102,1,1,0,0,0};
 const sdat_table sda_table_falcon_base={"sda-table-falcon-base","Falcon","falcon","sda-table","epsilon-bkz-selected-sdat","offline/generated/legacy/research/falcon/falcon_sdat_selected.h; offline/generated/legacy/research/falcon/falcon_sdat_selected.csv; offline/generated/legacy/research/falcon/falcon_sdat_certificate.txt","pmf_hash=15cb40167eda4761313ad83a6779b4657a7340625dac863a48843822e5802caa;cumulative_hash=13996a00c89a842e899ed50451d75ade30c51850fc97329d1dd0e579bf373e02",0,18,19,SDAT_TYPE_U72,72,72,19,18,falcon_p,falcon_c,0,"ordinary cumulative thresholds; terminal q omitted online","zero is magnitude 0","sign external; not sampled here","nonnegative magnitude/support index",162,19*72,U72(10215721069833441392ULL,254),0,1,1,1,0,0};
-const sdat_table *online_get_table(const char*f,const char*p){ if(!f||!p)return 0; if(!strcmp(f,"original-cdt-table")){ if(!strcmp(p,"frodo640"))return &original_cdt_table_frodo640; if(!strcmp(p,"frodo976"))return &original_cdt_table_frodo976; if(!strcmp(p,"frodo1344"))return &original_cdt_table_frodo1344; if(!strcmp(p,"falcon"))return &original_cdt_table_falcon_base; } if(!strcmp(f,"sda-table")){ if(!strcmp(p,"falcon"))return &sda_table_falcon_base; if(!strcmp(p,"frodo640"))return &sda_table_frodo640; if(!strcmp(p,"frodo976"))return &sda_table_frodo976; if(!strcmp(p,"frodo1344"))return &sda_table_frodo1344; } return 0; }
+/* Integer-ID registry: built-ins occupy fixed slots, loaded tables register
+ * into the rest. Readers are lock-free; registration is a compare-exchange on
+ * an empty slot. */
+static _Atomic(const sdat_table*) registry[SDAT_TABLE_ID_MAX]={[SDAT_TABLE_FRODO640_ORIGINAL]=&original_cdt_table_frodo640,[SDAT_TABLE_FRODO640_SDA]=&sda_table_frodo640,[SDAT_TABLE_FRODO976_ORIGINAL]=&original_cdt_table_frodo976,[SDAT_TABLE_FRODO976_SDA]=&sda_table_frodo976,[SDAT_TABLE_FRODO1344_ORIGINAL]=&original_cdt_table_frodo1344,[SDAT_TABLE_FRODO1344_SDA]=&sda_table_frodo1344,[SDAT_TABLE_FALCON_ORIGINAL]=&original_cdt_table_falcon_base,[SDAT_TABLE_FALCON_SDA]=&sda_table_falcon_base};
+static const struct{const char*family,*pset;sdat_table_id id;}names[]={{"original-cdt-table","frodo640",SDAT_TABLE_FRODO640_ORIGINAL},{"original-cdt-table","frodo976",SDAT_TABLE_FRODO976_ORIGINAL},{"original-cdt-table","frodo1344",SDAT_TABLE_FRODO1344_ORIGINAL},{"original-cdt-table","falcon",SDAT_TABLE_FALCON_ORIGINAL},{"sda-table","frodo640",SDAT_TABLE_FRODO640_SDA},{"sda-table","frodo976",SDAT_TABLE_FRODO976_SDA},{"sda-table","frodo1344",SDAT_TABLE_FRODO1344_SDA},{"sda-table","falcon",SDAT_TABLE_FALCON_SDA}};
+const sdat_table *online_table_by_id(uint32_t id){ return id<SDAT_TABLE_ID_MAX?atomic_load_explicit(&registry[id],memory_order_acquire):0; }
+sdat_table_id online_table_id(const char*f,const char*p){ if(!f||!p)return SDAT_TABLE_ID_NONE; for(size_t i=0;i<sizeof names/sizeof names[0];i++)if(!strcmp(f,names[i].family)&&!strcmp(p,names[i].pset))return names[i].id; return SDAT_TABLE_ID_NONE; }
+const sdat_table *online_get_table(const char*f,const char*p){ sdat_table_id id=online_table_id(f,p); return id?online_table_by_id(id):0; }
+int online_table_register(uint32_t id,const sdat_table*t){ if(id<SDAT_TABLE_ID_FIRST_DYNAMIC||id>=SDAT_TABLE_ID_MAX||!t)return -1; const sdat_table*empty=0; return atomic_compare_exchange_strong_explicit(&registry[id],&empty,t,memory_order_acq_rel,memory_order_acquire)||empty==t?0:-2; }
+int online_table_unregister(uint32_t id,const sdat_table*t){ if(id<SDAT_TABLE_ID_FIRST_DYNAMIC||id>=SDAT_TABLE_ID_MAX||!t)return -1; return atomic_compare_exchange_strong_explicit(&registry[id],&t,0,memory_order_acq_rel,memory_order_acquire)?0:-2; }
 int online_table_validate(const sdat_table*t){ if(!t||!t->available)return -1; if(t->value_type==SDAT_TYPE_U8){const uint8_t*p=t->pmf,*c=t->thresholds; uint32_t s=0; for(size_t i=0;i<t->mass_count;i++){s+=p[i]; if(c[i]!=(uint8_t)s)return -2;} return s==t->denominator_u64?0:-3;} if(t->value_type==SDAT_TYPE_U16){const uint16_t*p=t->pmf,*c=t->thresholds; uint32_t s=0; for(size_t i=0;i<t->mass_count;i++){s+=p[i]; uint16_t expect=(uint16_t)((t->denominator_u64==32768 && i+1==t->mass_count)?(s-1):s); if(c[i]!=expect)return -2;} return s==t->denominator_u64?0:-3;} if(t->value_type==SDAT_TYPE_U72&&t->mass_count){sdat_u72 s={0,0}; const sdat_u72*p=t->pmf,*c=t->thresholds; for(size_t i=0;i<t->mass_count;i++){uint64_t old=s.lo; s.lo+=p[i].lo; s.hi=(uint8_t)(s.hi+p[i].hi+(s.lo<old)); if(sdat_u72_cmp(s,c[i]))return -4;} return sdat_u72_cmp(s,t->denominator_u72);} return 0; }
-static sdat_avx2_stats st; const sdat_avx2_stats *online_avx2_stats(void){return &st;} void online_avx2_stats_reset(void){memset(&st,0,sizeof st);} void online_avx2_stats_add(uint64_t b,uint64_t v,uint64_t tail,uint64_t fb){st.api_calls++;st.avx2_vector_batches+=b;st.avx2_vectorized_samples+=v;st.scalar_tail_samples+=tail;st.fallback_samples+=fb;} void online_avx2_stats_refill(uint64_t r,uint64_t rej){st.refill_rounds+=r;st.rejected_lanes+=rej;}
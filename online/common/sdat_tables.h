@@ -1,9 +1,23 @@
 #ifndef SDAT_TABLES_H
 #define SDAT_TABLES_H
 #include "sdat_types.h"
+#include "sdat_telemetry.h"
 extern const sdat_table original_cdt_table_frodo640, original_cdt_table_frodo976, original_cdt_table_frodo1344, original_cdt_table_falcon_base;
+/* Falcon thresholds in sdat_u72_soa layout, same values and counts as the tables. */
+extern const sdat_u72_soa original_cdt_soa_falcon_base, sda_soa_falcon_base;
 extern const sdat_table sda_table_frodo640, sda_table_frodo976, sda_table_frodo1344, sda_table_falcon_base;
+/* Stable integer IDs (also stored in .sdtb files). Hot paths resolve tables by
+ * ID; the family/parameter-set strings are for configuration parsing only. */
+typedef enum { SDAT_TABLE_ID_NONE=0, SDAT_TABLE_FRODO640_ORIGINAL=1, SDAT_TABLE_FRODO640_SDA=2, SDAT_TABLE_FRODO976_ORIGINAL=3, SDAT_TABLE_FRODO976_SDA=4, SDAT_TABLE_FRODO1344_ORIGINAL=5, SDAT_TABLE_FRODO1344_SDA=6, SDAT_TABLE_FALCON_ORIGINAL=7, SDAT_TABLE_FALCON_SDA=8, SDAT_TABLE_ID_FIRST_DYNAMIC=16, SDAT_TABLE_ID_MAX=64 } sdat_table_id;
+const sdat_table *online_table_by_id(uint32_t id);
+sdat_table_id online_table_id(const char *family, const char *parameter_set);
 const sdat_table *online_get_table(const char *family, const char *parameter_set);
+/* Publishes a loaded table (e.g. sdat_table_file.table) under a dynamic ID in
+ * [SDAT_TABLE_ID_FIRST_DYNAMIC, SDAT_TABLE_ID_MAX). 0, -1 bad ID or table, -2
+ * slot held by another table. Unregister before the table's storage goes away. */
+int online_table_register(uint32_t id, const sdat_table *t);
+int online_table_unregister(uint32_t id, const sdat_table *t);
 int online_table_validate(const sdat_table *t);
+/* Calling thread's telemetry (see sdat_telemetry.h). */
 const sdat_avx2_stats *online_avx2_stats(void); void online_avx2_stats_reset(void); void online_avx2_stats_add(uint64_t batches,uint64_t vec,uint64_t tail,uint64_t fb); void online_avx2_stats_refill(uint64_t rounds,uint64_t rejected);
 #endif
@@ -0,0 +1,76 @@
+#include "sdat_telemetry.h"
+#include "sdat_tables.h"
+#include <pthread.h>
+#include <string.h>
+
+/* Each thread owns one slot and is its only writer; stores and the aggregator's
+ * loads are relaxed atomics, so a flush is plain loads and stores on x86.
+ * Slots are linked into a registry on first flush and folded into `retired`
+ * by a thread-exit destructor. */
+#define NFIELDS (sizeof(sdat_avx2_stats)/sizeof(uint64_t))
+typedef struct slot { uint64_t c[NFIELDS]; struct slot *prev, *next; int live; } slot;
+static _Thread_local slot self;
+static slot *head;
+static uint64_t retired[NFIELDS];
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+#if SDAT_TELEMETRY
+static pthread_key_t key;
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+
+static void slot_retire(void *p){
+    slot *s=p;
+    pthread_mutex_lock(&lock);
+    for(size_t i=0;i<NFIELDS;i++)retired[i]+=__atomic_load_n(&s->c[i],__ATOMIC_RELAXED);
+    if(s->prev)s->prev->next=s->next; else head=s->next;
+    if(s->next)s->next->prev=s->prev;
+    s->live=0;
+    pthread_mutex_unlock(&lock);
+}
+static void key_init(void){pthread_key_create(&key,slot_retire);}
+
+static slot *slot_get(void){
+    slot *s=&self;
+    if(!s->live){
+        pthread_once(&key_once,key_init);
+        pthread_mutex_lock(&lock);
+        s->prev=0; s->next=head; if(head)head->prev=s; head=s; s->live=1;
+        pthread_mutex_unlock(&lock);
+        pthread_setspecific(key,s);
+    }
+    return s;
+}
+#endif
+
+void sdat_telemetry_flush(const sdat_avx2_stats *delta){
+#if SDAT_TELEMETRY
+    uint64_t d[NFIELDS]; memcpy(d,delta,sizeof d);
+    slot *s=slot_get();
+    for(size_t i=0;i<NFIELDS;i++)if(d[i])__atomic_store_n(&s->c[i],s->c[i]+d[i],__ATOMIC_RELAXED);
+#else
+    (void)delta;
+#endif
+}
+
+sdat_avx2_stats sdat_telemetry_thread(void){
+    sdat_avx2_stats r; memcpy(&r,self.c,sizeof r); return r;
+}
+
+void sdat_telemetry_reset_thread(void){
+    for(size_t i=0;i<NFIELDS;i++)__atomic_store_n(&self.c[i],0,__ATOMIC_RELAXED);
+}
+
+void sdat_telemetry_aggregate(sdat_avx2_stats *out){
+    uint64_t a[NFIELDS];
+    pthread_mutex_lock(&lock);
+    memcpy(a,retired,sizeof a);
+    for(slot *s=head;s;s=s->next)for(size_t i=0;i<NFIELDS;i++)a[i]+=__atomic_load_n(&s->c[i],__ATOMIC_RELAXED);
+    pthread_mutex_unlock(&lock);
+    memcpy(out,a,sizeof a);
+}
+
+/* Single-thread view kept for the benchmarks: the calling thread's counters. */
+static _Thread_local sdat_avx2_stats view;
+const sdat_avx2_stats *online_avx2_stats(void){view=sdat_telemetry_thread();return &view;}
+void online_avx2_stats_reset(void){sdat_telemetry_reset_thread();}
+void online_avx2_stats_add(uint64_t b,uint64_t v,uint64_t tail,uint64_t fb){sdat_avx2_stats d={1,b,v,tail,fb,0,0};sdat_telemetry_flush(&d);}
+void online_avx2_stats_refill(uint64_t r,uint64_t rej){sdat_avx2_stats d={0,0,0,0,0,r,rej};sdat_telemetry_flush(&d);}
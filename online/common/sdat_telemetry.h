@@ -0,0 +1,28 @@
+#ifndef SDAT_TELEMETRY_H
+#define SDAT_TELEMETRY_H
+#include "sdat_types.h"
+/* AVX2 kernel telemetry. A kernel counts into a local sdat_avx2_stats and
+ * flushes it once per API call into the calling thread's counters, so the hot
+ * loops touch no shared memory and threads never race. Counters of all live
+ * and exited threads are merged on demand by sdat_telemetry_aggregate.
+ * Configuring with -DSDA_ENABLE_TELEMETRY=OFF defines SDAT_TELEMETRY=0: the
+ * SDAT_TEL_* macros expand to nothing and every reader reports zeros. */
+#ifndef SDAT_TELEMETRY
+#define SDAT_TELEMETRY 1
+#endif
+#if SDAT_TELEMETRY
+#define SDAT_TEL_ADD(tel,field,v) ((tel)->field+=(uint64_t)(v))
+#define SDAT_TEL_FLUSH(tel) sdat_telemetry_flush(tel)
+#else
+#define SDAT_TEL_ADD(tel,field,v) ((void)(tel),(void)(v))
+#define SDAT_TEL_FLUSH(tel) ((void)(tel))
+#endif
+/* Adds delta (api_calls included) to the calling thread's counters. */
+void sdat_telemetry_flush(const sdat_avx2_stats *delta);
+/* Snapshot of the calling thread's counters. */
+sdat_avx2_stats sdat_telemetry_thread(void);
+void sdat_telemetry_reset_thread(void);
+/* Sum over every thread that has flushed, including threads that exited. */
+void sdat_telemetry_aggregate(sdat_avx2_stats *out);
+static inline void sdat_avx2_stats_merge(sdat_avx2_stats *dst,const sdat_avx2_stats *src){dst->api_calls+=src->api_calls;dst->avx2_vector_batches+=src->avx2_vector_batches;dst->avx2_vectorized_samples+=src->avx2_vectorized_samples;dst->scalar_tail_samples+=src->scalar_tail_samples;dst->fallback_samples+=src->fallback_samples;dst->refill_rounds+=src->refill_rounds;dst->rejected_lanes+=src->rejected_lanes;}
+#endif
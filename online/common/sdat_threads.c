@@ -0,0 +1,15 @@
+#include "sdat_threads.h"
+#include <pthread.h>
+#include <unistd.h>
+
+unsigned sdat_thread_count(unsigned threads){
+    if(!threads){long c=sysconf(_SC_NPROCESSORS_ONLN);threads=c>0?(unsigned)c:1u;}
+    return threads<SDAT_MAX_THREADS?threads:SDAT_MAX_THREADS;
+}
+
+void sdat_run_parts(void*(*fn)(void*),void*parts,size_t stride,unsigned k){
+    pthread_t tid[SDAT_MAX_THREADS]; int started[SDAT_MAX_THREADS]={0}; char*p=parts;
+    for(unsigned i=1;i<k;i++)started[i]=pthread_create(&tid[i],0,fn,p+i*stride)==0;
+    if(k)fn(p);
+    for(unsigned i=1;i<k;i++){if(started[i])pthread_join(tid[i],0);else fn(p+i*stride);}
+}
@@ -0,0 +1,14 @@
+#ifndef SDAT_THREADS_H
+#define SDAT_THREADS_H
+#include <stddef.h>
+/* Fork-join helpers for the parallel sampling jobs. */
+#define SDAT_MAX_THREADS 64u
+/* `threads`, or the number of online CPUs when it is 0, capped at
+ * SDAT_MAX_THREADS; at least 1. */
+unsigned sdat_thread_count(unsigned threads);
+/* Runs fn on the k <= SDAT_MAX_THREADS parts of `stride` bytes at parts:
+ * parts 1..k-1 on worker threads, part 0 on the caller. A worker that cannot
+ * be started runs inline; results only depend on the part boundaries, never
+ * on scheduling. */
+void sdat_run_parts(void *(*fn)(void *), void *parts, size_t stride, unsigned k);
+#endif
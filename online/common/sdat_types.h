@@ -6,8 +6,22 @@ typedef struct { uint64_t lo; uint8_t hi; } sdat_u72;
 static inline int sdat_u72_cmp(sdat_u72 a, sdat_u72 b){ if(a.hi!=b.hi) return a.hi<b.hi?-1:1; if(a.lo!=b.lo) return a.lo<b.lo?-1:1; return 0; }
 static inline int sdat_u72_lt(sdat_u72 a,sdat_u72 b){return sdat_u72_cmp(a,b)<0;}
 static inline int sdat_u72_ge(sdat_u72 a,sdat_u72 b){return sdat_u72_cmp(a,b)>=0;}
+/* Branch-free a < b: the sign of a 128-bit difference (sub/sbb), or a borrow
+ * out of the 64-bit low words followed by the high-byte difference. Use on
+ * secret values; sdat_u72_cmp may branch. */
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 sdat_u128;
+static inline int sdat_u72_lt_ct(sdat_u72 a,sdat_u72 b){ sdat_u128 x=((sdat_u128)a.hi<<64)|a.lo, y=((sdat_u128)b.hi<<64)|b.lo; return (int)((x-y)>>127); }
+#else
+static inline int sdat_u72_lt_ct(sdat_u72 a,sdat_u72 b){ uint64_t d=a.lo-b.lo; uint32_t br=(uint32_t)(((~a.lo&b.lo)|(~(a.lo^b.lo)&d))>>63); return (int)((((uint32_t)a.hi-(uint32_t)b.hi-br)>>31)&1u); }
+#endif
+static inline int sdat_u72_ge_ct(sdat_u72 a,sdat_u72 b){return 1-sdat_u72_lt_ct(a,b);}
 static inline sdat_u72 sdat_u72_from_le9(const uint8_t in[9]){ sdat_u72 r={0,0}; for(int i=7;i>=0;i--) r.lo=(r.lo<<8)|in[i]; r.hi=in[8]; return r; }
 static inline void sdat_u72_to_le9(sdat_u72 x,uint8_t out[9]){ for(int i=0;i<8;i++) out[i]=(uint8_t)(x.lo>>(8*i)); out[8]=x.hi; }
+/* Structure-of-arrays u72 thresholds: 9 bytes per entry instead of the 16 of
+ * a padded sdat_u72, and the compare loop streams two dense arrays. */
+typedef struct { const uint64_t *lo; const uint8_t *hi; size_t count; } sdat_u72_soa;
+static inline int sdat_u72_soa_lt_ct(sdat_u72 x,const sdat_u72_soa *t,size_t i){return sdat_u72_lt_ct(x,(sdat_u72){t->lo[i],t->hi[i]});}
 typedef int (*sdat_randombytes_fn)(void *ctx, uint8_t *out, size_t out_len);
 typedef enum { SDAT_TYPE_U8=1, SDAT_TYPE_U16=2, SDAT_TYPE_U72=9 } sdat_value_type;
 typedef struct { uint64_t attempts,rejections,random_bytes,random_bits; } sdat_stats;
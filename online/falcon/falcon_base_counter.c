@@ -0,0 +1,97 @@
+#include "falcon_base_counter.h"
+#include "sdat_threads.h"
+
+static void add_stats(sdat_stats *a, const sdat_stats *b) {
+    a->attempts += b->attempts;
+    a->rejections += b->rejections;
+    a->random_bytes += b->random_bytes;
+    a->random_bits += b->random_bits;
+}
+
+static size_t sample_n(falcon_base_kind kind, sdat_prg *g, uint32_t *out, size_t n, sdat_stats *st) {
+    return kind == FALCON_BASE_ORIGINAL ? falcon_original_gaussian0_sample_n_avx2(sdat_prg_randombytes, g, out, n, st)
+                                        : falcon_sda_gaussian0_sample_n_avx2(sdat_prg_randombytes, g, out, n, st);
+}
+
+int falcon_gaussian0_sample_n_counter(falcon_base_kind kind, uint32_t *out, uint64_t first, size_t n,
+                                      sdat_prg_kind prg, const uint8_t *key, size_t key_len, uint64_t stream,
+                                      sdat_stats *stats) {
+    if ((!out && n) || !key || !key_len || key_len != sdat_prg_stream_key_bytes(prg) || n > UINT64_MAX - first)
+        return -1;
+    if (kind != FALCON_BASE_ORIGINAL && kind != FALCON_BASE_SDA) return -1;
+    if (stats) *stats = (sdat_stats){0};
+    sdat_prg g = {0};
+    uint32_t skip[256];
+    size_t done = 0;
+    int rc = 0;
+    while (done < n && !rc) {
+        uint64_t at = first + done;
+        size_t lead = (size_t)(at % FALCON_COUNTER_CHUNK), take = FALCON_COUNTER_CHUNK - lead;
+        if (take > n - done) take = n - done;
+        if (sdat_prg_init_chunk(&g, prg, key, key_len, stream, at / FALCON_COUNTER_CHUNK)) {
+            rc = -1;
+            break;
+        }
+        sdat_stats st;
+        while (lead && !rc) {
+            size_t m = lead < 256 ? lead : 256;
+            if (sample_n(kind, &g, skip, m, &st) != m) rc = -2;
+            if (stats) add_stats(stats, &st);
+            lead -= m;
+        }
+        if (!rc && sample_n(kind, &g, out + done, take, &st) != take) rc = -2;
+        if (!rc && stats) add_stats(stats, &st);
+        done += take;
+    }
+    sdat_secure_zero(skip, sizeof skip);
+    sdat_prg_wipe(&g);
+    return rc;
+}
+
+typedef struct {
+    falcon_base_kind kind;
+    uint32_t *out;
+    uint64_t first;
+    size_t n;
+    sdat_prg_kind prg;
+    const uint8_t *key;
+    size_t key_len;
+    uint64_t stream;
+    sdat_stats stats;
+    int rc;
+} part;
+
+static void *run_part(void *arg) {
+    part *t = arg;
+    t->rc = falcon_gaussian0_sample_n_counter(t->kind, t->out, t->first, t->n, t->prg, t->key, t->key_len, t->stream,
+                                              &t->stats);
+    return 0;
+}
+
+/* Parts start on chunk boundaries, so every chunk is sampled by one part. */
+int falcon_gaussian0_sample_n_counter_parallel(falcon_base_kind kind, uint32_t *out, uint64_t first, size_t n,
+                                               sdat_prg_kind prg, const uint8_t *key, size_t key_len,
+                                               uint64_t stream, sdat_stats *stats, unsigned threads) {
+    if ((!out && n) || n > UINT64_MAX - first) return -1;
+    uint64_t c0 = first / FALCON_COUNTER_CHUNK, chunks = n ? (first + n - 1) / FALCON_COUNTER_CHUNK - c0 + 1 : 0;
+    unsigned k = sdat_thread_count(threads);
+    if (k > chunks) k = chunks ? (unsigned)chunks : 1u;
+    if (k < 2) return falcon_gaussian0_sample_n_counter(kind, out, first, n, prg, key, key_len, stream, stats);
+    part parts[SDAT_MAX_THREADS];
+    uint64_t per = (chunks + k - 1) / k;
+    size_t begin = 0;
+    for (unsigned i = 0; i < k; i++) {
+        uint64_t e = (c0 + (i + 1) * per) * FALCON_COUNTER_CHUNK;
+        size_t end = i + 1 < k && e - first < n ? (size_t)(e - first) : n;
+        if (end < begin) end = begin;
+        parts[i] = (part){kind, out + begin, first + begin, end - begin, prg, key, key_len, stream, {0}, 0};
+        begin = end;
+    }
+    sdat_run_parts(run_part, parts, sizeof parts[0], k);
+    if (stats) *stats = (sdat_stats){0};
+    for (unsigned i = 0; i < k; i++) {
+        if (parts[i].rc) return parts[i].rc;
+        if (stats) add_stats(stats, &parts[i].stats);
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef FALCON_BASE_COUNTER_H
+#define FALCON_BASE_COUNTER_H
+#include <stddef.h>
+#include <stdint.h>
+#include "falcon_base_sampler.h"
+#include "sdat_prg.h"
+
+/* Counter-based base-sampler jobs, the Falcon counterpart of
+ * frodo_sample_n_counter: output i of the job (key, stream) is output
+ * i % FALCON_COUNTER_CHUNK of falcon_{original,sda}_gaussian0_sample_n over
+ * chunk i / FALCON_COUNTER_CHUNK of the counter-based PRG
+ * (sdat_prg_init_chunk). out[0..n) receives outputs first .. first + n - 1,
+ * so a job split into shards at any boundaries gives the same samples for
+ * every shard count. The AVX2 sample_n is used when available; it consumes
+ * the same bytes as the scalar one. Stats cover everything sampled, including
+ * the discarded head of a chunk the range starts inside, and add up across
+ * shards cut at multiples of FALCON_COUNTER_CHUNK.
+ * Returns 0, -1 for bad arguments or a prg that is not counter-based, -2 when
+ * sampling fails. */
+#define FALCON_COUNTER_CHUNK 4096u
+int falcon_gaussian0_sample_n_counter(falcon_base_kind kind, uint32_t *out, uint64_t first, size_t n,
+                                      sdat_prg_kind prg, const uint8_t *key, size_t key_len, uint64_t stream,
+                                      sdat_stats *stats);
+/* The same on up to `threads` threads (0: online CPUs), split at chunk
+ * boundaries; outputs and stats equal the single-threaded call. */
+int falcon_gaussian0_sample_n_counter_parallel(falcon_base_kind kind, uint32_t *out, uint64_t first, size_t n,
+                                               sdat_prg_kind prg, const uint8_t *key, size_t key_len,
+                                               uint64_t stream, sdat_stats *stats, unsigned threads);
+#endif
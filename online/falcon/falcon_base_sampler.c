@@ -1,13 +1,16 @@
 #include "falcon_base_sampler.h"
 #include "sdat_ref.h"
+#include <string.h>
 
 /* Falcon reference provenance: the Original path uses the gaussian0_sampler()
  * base distribution thresholds from the Falcon reference implementation
  * (sign.c, gaussian0_sampler). This file implements only the center-0,
- * sigma0=1.8205 half-Gaussian base sampler over support {0,...,18}; it does
- * not implement samplerZ, BerExp, FFT sampling, signing, verification, or keygen.
+ * sigma0=1.8205 half-Gaussian base sampler over support {0,...,18}; samplerZ
+ * and BerExp live in falcon_samplerz.c, and there is no FFT sampling,
+ * signing, verification, or keygen.
  * Random 72-bit words are interpreted little-endian as three 24-bit limbs
- * packed in the existing sdat_u72 representation. */
+ * packed in the existing sdat_u72 representation. Lookups walk the
+ * structure-of-arrays threshold copies with branch-free compares. */
 
 static int draw_u72(sdat_randombytes_fn randombytes, void *ctx, sdat_u72 *x, sdat_stats *stats, int rejected) {
     uint8_t b[FALCON_BASE_RANDOM_BYTES];
@@ -25,20 +28,18 @@ static int draw_u72(sdat_randombytes_fn randombytes, void *ctx, sdat_u72 *x, sda
 
 int falcon_original_gaussian0_sample_from_u72(sdat_u72 x, uint32_t *out) {
     if (!out) return -1;
-    *out = online_lookup_u72_reverse_tail(x, (const sdat_u72 *)original_cdt_table_falcon_base.thresholds,
-                                          original_cdt_table_falcon_base.threshold_count);
+    *out = online_lookup_u72_reverse_tail_soa(x, &original_cdt_soa_falcon_base);
     return *out <= FALCON_BASE_SUPPORT_MAX ? 0 : -2;
 }
 
 int falcon_sda_gaussian0_sample_from_u72(sdat_u72 x, uint32_t *out, int *accepted) {
     if (!out || !accepted) return -1;
-    if (sdat_u72_ge(x, sda_table_falcon_base.denominator_u72)) {
+    if (sdat_u72_ge_ct(x, sda_table_falcon_base.denominator_u72)) {
         *accepted = 0;
         return 0;
     }
     *accepted = 1;
-    *out = online_lookup_u72(x, (const sdat_u72 *)sda_table_falcon_base.thresholds,
-                             sda_table_falcon_base.threshold_count);
+    *out = online_lookup_u72_soa(x, &sda_soa_falcon_base);
     return *out <= FALCON_BASE_SUPPORT_MAX ? 0 : -2;
 }
 
@@ -53,13 +54,11 @@ size_t falcon_original_gaussian0_sample_n(sdat_randombytes_fn randombytes, void
     if (!out && n) return 0;
     if (!randombytes && n) return 0;
     if (!stats) {
-        const sdat_u72 *thr = (const sdat_u72 *)original_cdt_table_falcon_base.thresholds;
-        const size_t tn = original_cdt_table_falcon_base.threshold_count;
         size_t i = 0;
         for (; i < n; i++) {
             uint8_t b[FALCON_BASE_RANDOM_BYTES];
             if (randombytes(ctx, b, sizeof b)) return i;
-            uint32_t y = online_lookup_u72_reverse_tail(sdat_u72_from_le9(b), thr, tn);
+            uint32_t y = online_lookup_u72_reverse_tail_soa(sdat_u72_from_le9(b), &original_cdt_soa_falcon_base);
             if (y > FALCON_BASE_SUPPORT_MAX) return i;
             out[i] = y;
         }
@@ -96,8 +95,6 @@ size_t falcon_sda_gaussian0_sample_n(sdat_randombytes_fn randombytes, void *ctx,
     if (!out && n) return 0;
     if (!randombytes && n) return 0;
     if (!stats) {
-        const sdat_u72 *thr = (const sdat_u72 *)sda_table_falcon_base.thresholds;
-        const size_t tn = sda_table_falcon_base.threshold_count;
         const sdat_u72 q = sda_table_falcon_base.denominator_u72;
         size_t i = 0;
         for (; i < n; i++) {
@@ -106,11 +103,8 @@ size_t falcon_sda_gaussian0_sample_n(sdat_randombytes_fn randombytes, void *ctx,
                 uint8_t b[FALCON_BASE_RANDOM_BYTES];
                 if (randombytes(ctx, b, sizeof b)) return i;
                 x = sdat_u72_from_le9(b);
-            } while (sdat_u72_ge(x, q));
-            uint32_t y = 0;
-            for (size_t j = 0; j < tn; j++) {
-                y += (uint32_t)sdat_u72_ge(x, thr[j]);
-            }
+            } while (sdat_u72_ge_ct(x, q));
+            uint32_t y = online_lookup_u72_soa(x, &sda_soa_falcon_base);
             if (y > FALCON_BASE_SUPPORT_MAX) return i;
             out[i] = y;
         }
@@ -124,6 +118,156 @@ size_t falcon_sda_gaussian0_sample_n(sdat_randombytes_fn randombytes, void *ctx,
     return i;
 }
 
+/* Buffer variants: draws are read in place from `in` (nine bytes each, the
+ * same byte order as the callback samplers), so there is no callback and no
+ * copy per attempt. Sampling stops when n outputs are produced or fewer than
+ * nine bytes remain; *in_used is the number of bytes consumed. Outputs and
+ * stats equal *_sample_n fed the same bytes through a callback. */
+size_t falcon_original_gaussian0_sample_n_from_buffer(const uint8_t *in, size_t in_len, size_t *in_used,
+                                                      uint32_t *out, size_t n, sdat_stats *stats) {
+    size_t i = 0, u = 0;
+    if (in_used) *in_used = 0;
+    if (stats) *stats = (sdat_stats){0};
+    if ((!in && in_len) || (!out && n)) return 0;
+    for (; i < n && in_len - u >= FALCON_BASE_RANDOM_BYTES; i++) {
+        uint32_t y = online_lookup_u72_reverse_tail_soa(sdat_u72_from_le9(in + u), &original_cdt_soa_falcon_base);
+        if (y > FALCON_BASE_SUPPORT_MAX) break;
+        out[i] = y;
+        u += FALCON_BASE_RANDOM_BYTES;
+    }
+    if (stats) {
+        stats->attempts = i;
+        stats->random_bytes = u;
+        stats->random_bits = (uint64_t)i * 72u;
+    }
+    if (in_used) *in_used = u;
+    return i;
+}
+
+size_t falcon_sda_gaussian0_sample_n_from_buffer(const uint8_t *in, size_t in_len, size_t *in_used,
+                                                 uint32_t *out, size_t n, sdat_stats *stats) {
+    const sdat_u72 q = sda_table_falcon_base.denominator_u72;
+    size_t i = 0, u = 0;
+    uint64_t rejected = 0;
+    if (in_used) *in_used = 0;
+    if (stats) *stats = (sdat_stats){0};
+    if ((!in && in_len) || (!out && n)) return 0;
+    while (i < n && in_len - u >= FALCON_BASE_RANDOM_BYTES) {
+        sdat_u72 x = sdat_u72_from_le9(in + u);
+        if (sdat_u72_ge_ct(x, q)) {
+            rejected++;
+            u += FALCON_BASE_RANDOM_BYTES;
+            continue;
+        }
+        uint32_t y = online_lookup_u72_soa(x, &sda_soa_falcon_base);
+        if (y > FALCON_BASE_SUPPORT_MAX) break;
+        out[i++] = y;
+        u += FALCON_BASE_RANDOM_BYTES;
+    }
+    if (stats) {
+        stats->attempts = u / FALCON_BASE_RANDOM_BYTES;
+        stats->rejections = rejected;
+        stats->random_bytes = u;
+        stats->random_bits = (uint64_t)stats->attempts * 72u;
+    }
+    if (in_used) *in_used = u;
+    return i;
+}
+
+int falcon_base_stream_init(falcon_base_stream *s, falcon_base_kind kind) {
+    if (!s || (kind != FALCON_BASE_ORIGINAL && kind != FALCON_BASE_SDA)) return -1;
+    memset(s, 0, sizeof *s);
+    s->kind = kind;
+    return 0;
+}
+
+void falcon_base_stream_set_refill(falcon_base_stream *s, sdat_randombytes_fn refill, void *ctx) {
+    s->refill = refill;
+    s->refill_ctx = ctx;
+}
+
+/* One complete draw: returns 1 and writes *out when a sample is produced, 0
+ * for an SDA rejection, -2 for an out-of-support lookup (draw not consumed). */
+static int stream_draw(falcon_base_stream *s, const uint8_t b[FALCON_BASE_RANDOM_BYTES], uint32_t *out) {
+    sdat_u72 x = sdat_u72_from_le9(b);
+    uint32_t y;
+    int accepted = 1;
+    if (s->kind == FALCON_BASE_ORIGINAL) {
+        if (falcon_original_gaussian0_sample_from_u72(x, &y)) return -2;
+    } else if (falcon_sda_gaussian0_sample_from_u72(x, &y, &accepted)) {
+        return -2;
+    }
+    s->stats.attempts++;
+    s->stats.random_bytes += FALCON_BASE_RANDOM_BYTES;
+    s->stats.random_bits += 72;
+    if (!accepted) {
+        s->stats.rejections++;
+        return 0;
+    }
+    *out = y;
+    return 1;
+}
+
+size_t falcon_base_stream_push(falcon_base_stream *s, const uint8_t *in, size_t in_len, size_t *in_used,
+                               uint32_t *out, size_t n) {
+    size_t done = 0, u = 0;
+    if (in_used) *in_used = 0;
+    if (!s || (!in && in_len) || (!out && n)) return 0;
+    while (done < n && s->held_len && u < in_len) {
+        size_t m = FALCON_BASE_RANDOM_BYTES - s->held_len;
+        if (m > in_len - u) m = in_len - u;
+        memcpy(s->held + s->held_len, in + u, m);
+        if (s->held_len + m < FALCON_BASE_RANDOM_BYTES) {
+            s->held_len += (unsigned)m;
+            u += m;
+            break;
+        }
+        int rc = stream_draw(s, s->held, &out[done]);
+        if (rc < 0) break;
+        s->held_len = 0;
+        u += m;
+        done += (size_t)rc;
+    }
+    if (done < n && !s->held_len && in_len - u >= FALCON_BASE_RANDOM_BYTES) {
+        size_t used;
+        sdat_stats st;
+        done += s->kind == FALCON_BASE_ORIGINAL
+                    ? falcon_original_gaussian0_sample_n_from_buffer(in + u, in_len - u, &used, out + done, n - done, &st)
+                    : falcon_sda_gaussian0_sample_n_from_buffer(in + u, in_len - u, &used, out + done, n - done, &st);
+        u += used;
+        s->stats.attempts += st.attempts;
+        s->stats.rejections += st.rejections;
+        s->stats.random_bytes += st.random_bytes;
+        s->stats.random_bits += st.random_bits;
+    }
+    if (done < n && !s->held_len && u < in_len && in_len - u < FALCON_BASE_RANDOM_BYTES) {
+        memcpy(s->held, in + u, in_len - u);
+        s->held_len = (unsigned)(in_len - u);
+        u = in_len;
+    }
+    if (in_used) *in_used = u;
+    return done;
+}
+
+size_t falcon_base_stream_sample_n(falcon_base_stream *s, uint32_t *out, size_t n) {
+    size_t done = 0;
+    if (!s || (!out && n)) return 0;
+    while (done < n) {
+        if (s->refill_pos == s->refill_len) {
+            if (!s->refill || s->refill(s->refill_ctx, s->refill_buf, sizeof s->refill_buf)) break;
+            s->refill_pos = 0;
+            s->refill_len = sizeof s->refill_buf;
+        }
+        size_t used;
+        size_t k = falcon_base_stream_push(s, s->refill_buf + s->refill_pos, s->refill_len - s->refill_pos, &used,
+                                           out + done, n - done);
+        if (!k && !used) break;
+        done += k;
+        s->refill_pos += used;
+    }
+    return done;
+}
+
 uint64_t falcon_base_checksum(const uint32_t *out, size_t n) {
     uint64_t h = 1469598103934665603ULL;
     for (size_t i = 0; i < n; i++) {
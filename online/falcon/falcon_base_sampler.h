@@ -13,6 +13,50 @@ int falcon_original_gaussian0_sample(sdat_randombytes_fn randombytes, void *ctx,
 size_t falcon_original_gaussian0_sample_n(sdat_randombytes_fn randombytes, void *ctx, uint32_t *out, size_t n, sdat_stats *stats);
 int falcon_sda_gaussian0_sample(sdat_randombytes_fn randombytes, void *ctx, uint32_t *out, sdat_stats *stats);
 size_t falcon_sda_gaussian0_sample_n(sdat_randombytes_fn randombytes, void *ctx, uint32_t *out, size_t n, sdat_stats *stats);
+/* Buffer variants of *_sample_n: draws are read in place from one contiguous
+ * buffer, stopping after n outputs or when fewer than nine bytes remain.
+ * *in_used reports the bytes consumed (a multiple of nine). Callers holding
+ * only a callback get the same path through falcon_base_stream, which pulls
+ * FALCON_STREAM_CHUNK_BYTES blocks. */
+size_t falcon_original_gaussian0_sample_n_from_buffer(const uint8_t *in, size_t in_len, size_t *in_used,
+                                                      uint32_t *out, size_t n, sdat_stats *stats);
+size_t falcon_sda_gaussian0_sample_n_from_buffer(const uint8_t *in, size_t in_len, size_t *in_used,
+                                                 uint32_t *out, size_t n, sdat_stats *stats);
 uint64_t falcon_base_checksum(const uint32_t *out, size_t n);
+/* AVX2 *_sample_n: eight draws per vector in 24-bit limb lanes, constant-time
+ * per draw. Same outputs, bytes consumed and stats as the scalar versions;
+ * draws are requested up to 72 bytes per callback call. Fall back to the
+ * scalar code when AVX2 is unavailable. */
+size_t falcon_original_gaussian0_sample_n_avx2(sdat_randombytes_fn randombytes, void *ctx, uint32_t *out, size_t n, sdat_stats *stats);
+size_t falcon_sda_gaussian0_sample_n_avx2(sdat_randombytes_fn randombytes, void *ctx, uint32_t *out, size_t n, sdat_stats *stats);
+size_t falcon_original_gaussian0_sample_n_from_buffer_avx2(const uint8_t *in, size_t in_len, size_t *in_used,
+                                                           uint32_t *out, size_t n, sdat_stats *stats);
+size_t falcon_sda_gaussian0_sample_n_from_buffer_avx2(const uint8_t *in, size_t in_len, size_t *in_used,
+                                                      uint32_t *out, size_t n, sdat_stats *stats);
+
+/* Resumable base sampler: randomness is pushed (zlib-style, *in_used reports
+ * how much of `in` was taken) or pulled through a refill callback in
+ * FALCON_STREAM_CHUNK_BYTES blocks. A partial 9-byte draw is kept in the
+ * context, so a short input or a failing callback never loses progress.
+ * Outputs over any split of a byte stream equal one *_sample_n call over it;
+ * stats accumulate with the *_sample_n accounting. */
+#define FALCON_STREAM_CHUNK_BYTES 2052u
+typedef enum { FALCON_BASE_ORIGINAL, FALCON_BASE_SDA } falcon_base_kind;
+typedef struct {
+    falcon_base_kind kind;
+    sdat_stats stats;
+    uint8_t held[FALCON_BASE_RANDOM_BYTES];
+    unsigned held_len;
+    sdat_randombytes_fn refill;
+    void *refill_ctx;
+    size_t refill_pos, refill_len;
+    uint8_t refill_buf[FALCON_STREAM_CHUNK_BYTES];
+} falcon_base_stream;
+
+int falcon_base_stream_init(falcon_base_stream *s, falcon_base_kind kind);
+void falcon_base_stream_set_refill(falcon_base_stream *s, sdat_randombytes_fn refill, void *ctx);
+size_t falcon_base_stream_push(falcon_base_stream *s, const uint8_t *in, size_t in_len, size_t *in_used,
+                               uint32_t *out, size_t n);
+size_t falcon_base_stream_sample_n(falcon_base_stream *s, uint32_t *out, size_t n);
 
 #endif
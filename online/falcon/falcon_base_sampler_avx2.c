@@ -0,0 +1,171 @@
+#include "falcon_base_sampler.h"
+#include "falcon_u72_avx2.h"
+#include "sdat_avx2.h"
+#include <pthread.h>
+#include <string.h>
+
+/* AVX2 Falcon base samplers: eight draws per vector, every draw compared with
+ * every threshold in 24-bit limb lanes, so time depends only on n (and, for
+ * SDA, on the public rejection count). The Original thresholds end in 0 and
+ * the SDA table has 18 thresholds, so no lane can leave the support. */
+
+static sdat_u72_limbs orig_thr[19], sda_thr[19], sda_q;
+static size_t orig_tn, sda_tn;
+static pthread_once_t limbs_once = PTHREAD_ONCE_INIT;
+
+static void limbs_init(void) {
+    const sdat_u72 *o = (const sdat_u72 *)original_cdt_table_falcon_base.thresholds;
+    const sdat_u72 *s = (const sdat_u72 *)sda_table_falcon_base.thresholds;
+    orig_tn = original_cdt_table_falcon_base.threshold_count;
+    sda_tn = sda_table_falcon_base.threshold_count;
+    for (size_t j = 0; j < orig_tn; j++) orig_thr[j] = sdat_u72_split(o[j]);
+    for (size_t j = 0; j < sda_tn; j++) sda_thr[j] = sdat_u72_split(s[j]);
+    sda_q = sdat_u72_split(sda_table_falcon_base.denominator_u72);
+}
+
+static void account(sdat_stats *stats, uint64_t draws, uint64_t rejected) {
+    if (stats) {
+        stats->attempts += draws;
+        stats->random_bytes += draws * FALCON_BASE_RANDOM_BYTES;
+        stats->random_bits += draws * 72u;
+        stats->rejections += rejected;
+    }
+}
+
+/* One batch of m <= 8 draws at p (readable for SDAT_U72X8_LOAD_BYTES). */
+static inline void original8(const uint8_t *p, size_t m, uint32_t *dst) {
+    __m256i c = sdat_u72x8_count_lt(sdat_u72x8_load_le9(p), orig_thr, orig_tn);
+    if (m == 8) {
+        _mm256_storeu_si256((__m256i *)dst, c);
+    } else {
+        uint32_t y[8];
+        _mm256_storeu_si256((__m256i *)y, c);
+        memcpy(dst, y, m * sizeof y[0]);
+    }
+}
+
+/* Writes the accepted draws of the batch in order; dst has room for m. */
+static inline size_t sda8(const uint8_t *p, size_t m, uint32_t *dst) {
+    uint32_t y[8], a[8];
+    sdat_u72x8 x = sdat_u72x8_load_le9(p);
+    __m256i lt = sdat_u72x8_lt(x, sda_q);
+    __m256i c = _mm256_sub_epi32(_mm256_set1_epi32((int)sda_tn), sdat_u72x8_count_lt(x, sda_thr, sda_tn));
+    _mm256_storeu_si256((__m256i *)y, c);
+    _mm256_storeu_si256((__m256i *)a, lt);
+    size_t k = 0;
+    for (size_t i = 0; i < m; i++) {
+        dst[k] = y[i];
+        k += a[i] & 1u;
+    }
+    return k;
+}
+
+/* Up to eight draws are taken with one callback call of 9 * m bytes. For a
+ * byte-stream callback the outputs, the bytes consumed and the stats equal the
+ * scalar *_sample_n; a failing callback loses only the batch it failed on. */
+size_t falcon_original_gaussian0_sample_n_avx2(sdat_randombytes_fn randombytes, void *ctx, uint32_t *out, size_t n,
+                                               sdat_stats *stats) {
+    if (!sdat_avx2_cpu_supported()) return falcon_original_gaussian0_sample_n(randombytes, ctx, out, n, stats);
+    if ((!out || !randombytes) && n) return 0;
+    if (stats) *stats = (sdat_stats){0};
+    pthread_once(&limbs_once, limbs_init);
+    uint8_t buf[8 * FALCON_BASE_RANDOM_BYTES + 4] = {0};
+    size_t done = 0;
+    uint64_t batches = 0;
+    while (done < n) {
+        size_t m = n - done < 8 ? n - done : 8;
+        if (randombytes(ctx, buf, m * FALCON_BASE_RANDOM_BYTES)) break;
+        original8(buf, m, out + done);
+        done += m;
+        batches++;
+    }
+    account(stats, done, 0);
+    sdat_avx2_stats tel = {1, batches, done, 0, 0, 0, 0};
+    SDAT_TEL_FLUSH(&tel);
+    return done;
+}
+
+size_t falcon_sda_gaussian0_sample_n_avx2(sdat_randombytes_fn randombytes, void *ctx, uint32_t *out, size_t n,
+                                          sdat_stats *stats) {
+    if (!sdat_avx2_cpu_supported()) return falcon_sda_gaussian0_sample_n(randombytes, ctx, out, n, stats);
+    if ((!out || !randombytes) && n) return 0;
+    if (stats) *stats = (sdat_stats){0};
+    pthread_once(&limbs_once, limbs_init);
+    uint8_t buf[8 * FALCON_BASE_RANDOM_BYTES + 4] = {0};
+    size_t done = 0;
+    uint64_t batches = 0, draws = 0;
+    while (done < n) {
+        /* At most as many draws as outputs still owed, so no draw is wasted. */
+        size_t m = n - done < 8 ? n - done : 8;
+        if (randombytes(ctx, buf, m * FALCON_BASE_RANDOM_BYTES)) break;
+        done += sda8(buf, m, out + done);
+        draws += m;
+        batches++;
+    }
+    account(stats, draws, draws - done);
+    sdat_avx2_stats tel = {1, batches, draws, 0, 0, batches, draws - done};
+    SDAT_TEL_FLUSH(&tel);
+    return done;
+}
+
+/* Buffer variants: batches are gathered straight from `in` while a full
+ * eight-lane load stays inside it; the tail goes through a padded copy. */
+size_t falcon_original_gaussian0_sample_n_from_buffer_avx2(const uint8_t *in, size_t in_len, size_t *in_used,
+                                                           uint32_t *out, size_t n, sdat_stats *stats) {
+    if (!sdat_avx2_cpu_supported())
+        return falcon_original_gaussian0_sample_n_from_buffer(in, in_len, in_used, out, n, stats);
+    if (in_used) *in_used = 0;
+    if (stats) *stats = (sdat_stats){0};
+    if ((!in && in_len) || (!out && n)) return 0;
+    pthread_once(&limbs_once, limbs_init);
+    size_t avail = in_len / FALCON_BASE_RANDOM_BYTES, total = n < avail ? n : avail, done = 0;
+    uint64_t batches = 0;
+    for (; done < total; batches++) {
+        size_t m = total - done < 8 ? total - done : 8;
+        const uint8_t *p = in + done * FALCON_BASE_RANDOM_BYTES;
+        if (in_len - done * FALCON_BASE_RANDOM_BYTES >= SDAT_U72X8_LOAD_BYTES) {
+            original8(p, m, out + done);
+        } else {
+            uint8_t buf[8 * FALCON_BASE_RANDOM_BYTES + 4] = {0};
+            memcpy(buf, p, m * FALCON_BASE_RANDOM_BYTES);
+            original8(buf, m, out + done);
+        }
+        done += m;
+    }
+    account(stats, done, 0);
+    if (in_used) *in_used = done * FALCON_BASE_RANDOM_BYTES;
+    sdat_avx2_stats tel = {1, batches, done, 0, 0, 0, 0};
+    SDAT_TEL_FLUSH(&tel);
+    return done;
+}
+
+size_t falcon_sda_gaussian0_sample_n_from_buffer_avx2(const uint8_t *in, size_t in_len, size_t *in_used,
+                                                      uint32_t *out, size_t n, sdat_stats *stats) {
+    if (!sdat_avx2_cpu_supported())
+        return falcon_sda_gaussian0_sample_n_from_buffer(in, in_len, in_used, out, n, stats);
+    if (in_used) *in_used = 0;
+    if (stats) *stats = (sdat_stats){0};
+    if ((!in && in_len) || (!out && n)) return 0;
+    pthread_once(&limbs_once, limbs_init);
+    size_t avail = in_len / FALCON_BASE_RANDOM_BYTES, draws = 0, done = 0;
+    uint64_t batches = 0;
+    while (done < n && draws < avail) {
+        size_t m = n - done < 8 ? n - done : 8;
+        if (m > avail - draws) m = avail - draws;
+        const uint8_t *p = in + draws * FALCON_BASE_RANDOM_BYTES;
+        if (in_len - draws * FALCON_BASE_RANDOM_BYTES >= SDAT_U72X8_LOAD_BYTES) {
+            done += sda8(p, m, out + done);
+        } else {
+            uint8_t buf[8 * FALCON_BASE_RANDOM_BYTES + 4] = {0};
+            memcpy(buf, p, m * FALCON_BASE_RANDOM_BYTES);
+            done += sda8(buf, m, out + done);
+        }
+        draws += m;
+        batches++;
+    }
+    account(stats, draws, draws - done);
+    if (in_used) *in_used = draws * FALCON_BASE_RANDOM_BYTES;
+    sdat_avx2_stats tel = {1, batches, draws, 0, 0, batches, draws - done};
+    SDAT_TEL_FLUSH(&tel);
+    return done;
+}
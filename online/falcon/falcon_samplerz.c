@@ -0,0 +1,145 @@
+#include "falcon_samplerz.h"
+#include <math.h>
+#include <string.h>
+
+/* Port of sampler(), BerExp() and fpr_expm_p63() from the Falcon reference
+ * code (sign.c, fpr.h) over native doubles. The only change of substance is
+ * the base sampler, which is either gaussian0_sampler() (Original table) or
+ * the SDA table with its rejection on the 72-bit draw. */
+
+/* 1/(2*sigma0^2) for sigma0 = 1.8205, and ln 2 with its inverse. */
+#define INV_2SQRSIGMA0 0.150865048875372721532312163019
+#define LOG2 0.69314718055994530941723212146
+#define INV_LOG2 1.4426950408889634073599246810
+#define PTWO63 9223372036854775808.0
+
+static void refill(falcon_samplerz_ctx *sc) {
+    sdat_prg_generate(&sc->prg, sc->buf, sizeof sc->buf);
+    sc->pos = 0;
+    sc->stats.prng_bytes += sizeof sc->buf;
+}
+
+static inline uint8_t get_u8(falcon_samplerz_ctx *sc) {
+    if (sc->pos == sizeof sc->buf) refill(sc);
+    return sc->buf[sc->pos++];
+}
+
+/* gaussian0_sampler() reads prng_get_u64() then prng_get_u8(); the former
+ * starts a fresh block once pos >= sizeof buf - 9, so the byte after the u64
+ * is always in the same block. */
+static inline uint32_t base_inline(falcon_samplerz_ctx *sc) {
+    for (;;) {
+        if (sc->pos >= sizeof sc->buf - FALCON_BASE_RANDOM_BYTES) refill(sc);
+        sdat_u72 x = {0, 0};
+        for (int i = 7; i >= 0; i--) x.lo = (x.lo << 8) | sc->buf[sc->pos + i];
+        sc->pos += 8;
+        x.hi = get_u8(sc);
+        sc->stats.base_draws++;
+        uint32_t z0 = 0;
+        int accepted = 1;
+        if (sc->base == FALCON_BASE_ORIGINAL) falcon_original_gaussian0_sample_from_u72(x, &z0);
+        else falcon_sda_gaussian0_sample_from_u72(x, &z0, &accepted);
+        if (accepted) return z0;
+        sc->stats.base_rejections++;
+    }
+}
+
+/* draw_buf carries no padding: the AVX2 buffer samplers stop gathering from it
+ * once fewer than SDAT_U72X8_LOAD_BYTES remain and copy the tail. */
+static inline uint32_t base_batched(falcon_samplerz_ctx *sc) {
+    while (sc->z0_pos == sc->z0_len) {
+        sdat_stats st;
+        size_t used;
+        sdat_prg_generate(&sc->prg, sc->draw_buf, sizeof sc->draw_buf);
+        sc->z0_len = sc->base == FALCON_BASE_ORIGINAL
+                         ? falcon_original_gaussian0_sample_n_from_buffer_avx2(sc->draw_buf, sizeof sc->draw_buf, &used,
+                                                                               sc->z0, FALCON_SAMPLERZ_BASE_BATCH, &st)
+                         : falcon_sda_gaussian0_sample_n_from_buffer_avx2(sc->draw_buf, sizeof sc->draw_buf, &used,
+                                                                          sc->z0, FALCON_SAMPLERZ_BASE_BATCH, &st);
+        sc->z0_pos = 0;
+        sc->stats.prng_bytes += sizeof sc->draw_buf;
+        sc->stats.base_draws += st.attempts;
+        sc->stats.base_rejections += st.rejections;
+    }
+    return sc->z0[sc->z0_pos++];
+}
+
+int falcon_samplerz_init(falcon_samplerz_ctx *sc, falcon_base_kind base, falcon_samplerz_mode mode, sdat_prg_kind prg,
+                         const uint8_t *seed, size_t seed_len, double sigma_min) {
+    if (!sc) return -1;
+    if (base != FALCON_BASE_ORIGINAL && base != FALCON_BASE_SDA) return -3;
+    if (mode != FALCON_SAMPLERZ_INLINE && mode != FALCON_SAMPLERZ_BATCHED) return -3;
+    if (!(sigma_min > 0.0 && sigma_min <= FALCON_SAMPLERZ_SIGMA_MAX)) return -1;
+    memset(sc, 0, sizeof *sc);
+    if (sdat_prg_init(&sc->prg, prg, seed, seed_len)) return -1;
+    sc->base = base;
+    sc->mode = mode;
+    sc->sigma_min = sigma_min;
+    sc->pos = sizeof sc->buf;
+    return 0;
+}
+
+void falcon_samplerz_wipe(falcon_samplerz_ctx *sc) {
+    if (sc) sdat_secure_zero(sc, sizeof *sc);
+}
+
+/* High 64 bits of a 64x64 product from 32-bit partial products, as in the
+ * reference (no reliance on a 128-bit type). */
+static inline uint64_t mulhi64(uint64_t z, uint64_t y) {
+    uint32_t z0 = (uint32_t)z, z1 = (uint32_t)(z >> 32), y0 = (uint32_t)y, y1 = (uint32_t)(y >> 32);
+    uint64_t a = ((uint64_t)z0 * y1) + (((uint64_t)z0 * y0) >> 32);
+    uint64_t b = (uint64_t)z1 * y0;
+    uint64_t c = (a >> 32) + (b >> 32);
+    c += ((uint64_t)(uint32_t)a + (uint64_t)(uint32_t)b) >> 32;
+    return c + (uint64_t)z1 * y1;
+}
+
+uint64_t falcon_samplerz_expm_p63(double x, double ccs) {
+    static const uint64_t C[] = {
+        0x00000004741183A3u, 0x00000036548CFC06u, 0x0000024FDCBF140Au, 0x0000171D939DE045u, 0x0000D00CF58F6F84u,
+        0x000680681CF796E3u, 0x002D82D8305B0FEAu, 0x011111110E066FD0u, 0x0555555555070F00u, 0x155555555581FF00u,
+        0x400000000002B400u, 0x7FFFFFFFFFFF4800u, 0x8000000000000000u,
+    };
+    /* Horner on z = 2^64 * x, then scaled by 2^64 * ccs. ccs = 1 (reached
+     * when sigma rounds to sigma_min) saturates to 2^64 - 1 instead of
+     * wrapping to 0. */
+    uint64_t y = C[0], z = (uint64_t)(x * PTWO63) << 1;
+    for (size_t u = 1; u < sizeof C / sizeof C[0]; u++) y = C[u] - mulhi64(z, y);
+    uint64_t t = (uint64_t)(ccs * PTWO63);
+    return mulhi64((t << 1) | (0 - (t >> 63)), y);
+}
+
+int falcon_samplerz_berexp(falcon_samplerz_ctx *sc, double x, double ccs) {
+    /* x = s*ln2 + r with r in [0, ln2); exp(-x) = 2^-s * exp(-r), and s is
+     * capped at 63 (the value is then below 2^-63 anyway). */
+    uint32_t s = (uint32_t)(int)(x * INV_LOG2);
+    double r = x - (double)s * LOG2;
+    s ^= (s ^ 63u) & -((63u - s) >> 31);
+    uint64_t z = ((falcon_samplerz_expm_p63(r, ccs) << 1) - 1) >> s;
+    /* Lazy byte-wise compare of a uniform 64-bit value with z. */
+    uint32_t w;
+    int i = 64;
+    do {
+        i -= 8;
+        w = (uint32_t)get_u8(sc) - ((uint32_t)(z >> i) & 0xFFu);
+    } while (!w && i > 0);
+    return (int)(w >> 31);
+}
+
+int falcon_samplerz(falcon_samplerz_ctx *sc, double mu, double isigma) {
+    /* mu = s + r with r in [0, 1); sample z around r, return s + z. */
+    int s = (int)floor(mu);
+    double r = mu - (double)s;
+    double dss = 0.5 * isigma * isigma;
+    double ccs = isigma * sc->sigma_min;
+    sc->stats.calls++;
+    for (;;) {
+        sc->stats.iterations++;
+        int z0 = (int)(sc->mode == FALCON_SAMPLERZ_BATCHED ? base_batched(sc) : base_inline(sc));
+        int b = (int)get_u8(sc) & 1;
+        int z = b + ((b << 1) - 1) * z0;
+        /* Accept with probability ccs * exp(-((z-r)^2/(2 sigma^2) - z0^2/(2 sigma0^2))). */
+        double x = ((double)z - r) * ((double)z - r) * dss - (double)(z0 * z0) * INV_2SQRSIGMA0;
+        if (falcon_samplerz_berexp(sc, x, ccs)) return s + z;
+    }
+}
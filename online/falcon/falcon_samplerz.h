@@ -0,0 +1,66 @@
+#ifndef FALCON_SAMPLERZ_H
+#define FALCON_SAMPLERZ_H
+#include <stddef.h>
+#include <stdint.h>
+#include "falcon_base_sampler.h"
+#include "sdat_prg.h"
+
+/* Falcon samplerZ: integers from D_{Z, mu, sigma} for sigma in
+ * [sigma_min, FALCON_SAMPLERZ_SIGMA_MAX], by rejection from the half-Gaussian
+ * base sampler (Original or SDA table) with a sign bit and a BerExp test, as
+ * in sampler() of the Falcon reference code (sign.c). Randomness comes from a
+ * seed expander (ChaCha20 like the reference PRNG, or SHAKE128/AES128-CTR)
+ * read through a FALCON_SAMPLERZ_PRNG_BYTES buffer; base draws take nine
+ * bytes, sign and BerExp bytes one each.
+ *   INLINE:   base draws are taken in order from the same buffer with the
+ *             reference prng_get_u64()/prng_get_u8() refill rule, so with the
+ *             Original table outputs and byte consumption match the reference
+ *             sampler() over the same byte stream.
+ *   BATCHED:  base draws come from a separate cache refilled
+ *             FALCON_SAMPLERZ_BASE_BATCH draws at a time by the AVX2 buffer
+ *             samplers (scalar when AVX2 is unavailable). Same distribution,
+ *             different byte layout. */
+#define FALCON_SAMPLERZ_SIGMA_MAX 1.8205
+#define FALCON_SAMPLERZ_SIGMA_MIN_512 1.1165085072329102588881898380334015
+#define FALCON_SAMPLERZ_SIGMA_MIN_1024 1.2982803343442918539708792538826807
+#define FALCON_SAMPLERZ_PRNG_BYTES 512u
+#define FALCON_SAMPLERZ_BASE_BATCH 64u
+
+typedef enum { FALCON_SAMPLERZ_INLINE, FALCON_SAMPLERZ_BATCHED } falcon_samplerz_mode;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t iterations;        /* rejection-loop rounds, >= calls */
+    uint64_t base_draws;        /* 72-bit base-sampler draws, incl. SDA rejections */
+    uint64_t base_rejections;
+    uint64_t prng_bytes;
+} falcon_samplerz_stats;
+
+typedef struct {
+    falcon_base_kind base;
+    falcon_samplerz_mode mode;
+    double sigma_min;
+    sdat_prg prg;
+    size_t pos;
+    uint8_t buf[FALCON_SAMPLERZ_PRNG_BYTES];
+    size_t z0_pos, z0_len;
+    uint32_t z0[FALCON_SAMPLERZ_BASE_BATCH];
+    uint8_t draw_buf[FALCON_SAMPLERZ_BASE_BATCH * FALCON_BASE_RANDOM_BYTES];
+    falcon_samplerz_stats stats;
+} falcon_samplerz_ctx;
+
+/* Returns 0, -1 for a bad seed or sigma_min outside (0, SIGMA_MAX], -3 for an
+ * unknown base kind or mode. */
+int falcon_samplerz_init(falcon_samplerz_ctx *sc, falcon_base_kind base, falcon_samplerz_mode mode, sdat_prg_kind prg,
+                         const uint8_t *seed, size_t seed_len, double sigma_min);
+/* One sample from D_{Z, mu, 1/isigma}; isigma is the inverse of sigma as in
+ * the reference code, and the caller keeps 1/isigma within [sigma_min, SIGMA_MAX]. */
+int falcon_samplerz(falcon_samplerz_ctx *sc, double mu, double isigma);
+/* 1 with probability ccs * exp(-x), for x >= 0 and ccs in [0, 1]. */
+int falcon_samplerz_berexp(falcon_samplerz_ctx *sc, double x, double ccs);
+/* ccs * exp(-x) * 2^63 for x in [0, ln 2) and ccs in [0, 1], by the
+ * reference fixed-point polynomial. */
+uint64_t falcon_samplerz_expm_p63(double x, double ccs);
+void falcon_samplerz_wipe(falcon_samplerz_ctx *sc);
+
+#endif
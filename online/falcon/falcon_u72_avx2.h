@@ -0,0 +1,61 @@
+#ifndef FALCON_U72_AVX2_H
+#define FALCON_U72_AVX2_H
+#include <immintrin.h>
+#include "sdat_types.h"
+
+/* Eight 72-bit values as three 24-bit limbs in 32-bit lanes (x = h*2^48 +
+ * m*2^24 + l), the layout of FROM24 and of gaussian0_sampler() in the Falcon
+ * reference code. Compares subtract limb by limb and propagate the borrow
+ * through the sign bit, so they are branch-free and independent of the data.
+ * Only for translation units built with -mavx2. */
+typedef struct { __m256i l, m, h; } sdat_u72x8;
+typedef struct { uint32_t l, m, h; } sdat_u72_limbs;
+
+static inline sdat_u72_limbs sdat_u72_split(sdat_u72 x) {
+    sdat_u72_limbs r = {(uint32_t)(x.lo & 0xFFFFFFu), (uint32_t)((x.lo >> 24) & 0xFFFFFFu),
+                        (uint32_t)(x.lo >> 48) | ((uint32_t)x.hi << 16)};
+    return r;
+}
+
+/* Lanes of `in` are nine-byte little-endian draws; all eight lanes are
+ * gathered whatever the number of draws in use, so `in` must stay readable for
+ * one byte past the eighth draw. */
+#define SDAT_U72X8_LOAD_BYTES 73
+static inline sdat_u72x8 sdat_u72x8_load_le9(const uint8_t *in) {
+    const __m256i off = _mm256_setr_epi32(0, 9, 18, 27, 36, 45, 54, 63);
+    const __m256i mask = _mm256_set1_epi32(0xFFFFFF);
+    sdat_u72x8 x;
+    x.l = _mm256_and_si256(_mm256_i32gather_epi32((const int *)in, off, 1), mask);
+    x.m = _mm256_and_si256(_mm256_i32gather_epi32((const int *)(in + 3), off, 1), mask);
+    x.h = _mm256_and_si256(_mm256_i32gather_epi32((const int *)(in + 6), off, 1), mask);
+    return x;
+}
+
+static inline sdat_u72x8 sdat_u72x8_load(const sdat_u72 *x, size_t n) {
+    uint32_t l[8] = {0}, m[8] = {0}, h[8] = {0};
+    for (size_t i = 0; i < n && i < 8; i++) {
+        sdat_u72_limbs s = sdat_u72_split(x[i]);
+        l[i] = s.l;
+        m[i] = s.m;
+        h[i] = s.h;
+    }
+    sdat_u72x8 r = {_mm256_loadu_si256((const __m256i *)l), _mm256_loadu_si256((const __m256i *)m),
+                    _mm256_loadu_si256((const __m256i *)h)};
+    return r;
+}
+
+/* All-ones in lanes where x < t. */
+static inline __m256i sdat_u72x8_lt(sdat_u72x8 x, sdat_u72_limbs t) {
+    __m256i d = _mm256_sub_epi32(x.l, _mm256_set1_epi32((int)t.l));
+    d = _mm256_add_epi32(_mm256_sub_epi32(x.m, _mm256_set1_epi32((int)t.m)), _mm256_srai_epi32(d, 31));
+    d = _mm256_add_epi32(_mm256_sub_epi32(x.h, _mm256_set1_epi32((int)t.h)), _mm256_srai_epi32(d, 31));
+    return _mm256_srai_epi32(d, 31);
+}
+
+/* Per lane, the number of thresholds with x < t[j]. */
+static inline __m256i sdat_u72x8_count_lt(sdat_u72x8 x, const sdat_u72_limbs *t, size_t tn) {
+    __m256i acc = _mm256_setzero_si256();
+    for (size_t j = 0; j < tn; j++) acc = _mm256_sub_epi32(acc, sdat_u72x8_lt(x, t[j]));
+    return acc;
+}
+#endif
@@ -1,22 +1,33 @@
 #include "sdat_avx2.h"
+#include "sdat_cpu.h"
+#include "falcon_u72_avx2.h"
+#include "sdat_randbuf.h"
+#include <string.h>
 #include <immintrin.h>
-int sdat_avx2_cpu_supported(void){
-#if defined(__GNUC__) && (defined(__x86_64__)||defined(__i386__))
- return __builtin_cpu_supports("avx2");
-#else
- return 0;
-#endif
-}
+/* Cached by sdat_cpu; honours SDAT_FORCE_BACKEND. */
+int sdat_avx2_cpu_supported(void){return sdat_cpu_has(SDAT_CPU_AVX2);}
 static __m256i uge32(__m256i a,__m256i b){const __m256i s=_mm256_set1_epi32((int)0x80000000U); __m256i ax=_mm256_xor_si256(a,s), bx=_mm256_xor_si256(b,s); __m256i lt=_mm256_cmpgt_epi32(bx,ax); return _mm256_andnot_si256(lt,_mm256_set1_epi32(-1));}
-static __m256i uge64(__m256i a,__m256i b){const __m256i s=_mm256_set1_epi64x((long long)0x8000000000000000ULL); __m256i ax=_mm256_xor_si256(a,s), bx=_mm256_xor_si256(b,s); __m256i lt=_mm256_cmpgt_epi64(bx,ax); return _mm256_andnot_si256(lt,_mm256_set1_epi64x(-1));}
-void original_cdt_avx2_lookup_u16_batch(const uint16_t*x,size_t n,const uint16_t*t,size_t tn,uint32_t*out){size_t i=0; for(;i+8<=n;i+=8){__m256i xv=_mm256_set_epi32(x[i+7],x[i+6],x[i+5],x[i+4],x[i+3],x[i+2],x[i+1],x[i]); __m256i acc=_mm256_setzero_si256(); for(size_t j=0;j<tn;j++){__m256i m=uge32(xv,_mm256_set1_epi32(t[j])); acc=_mm256_sub_epi32(acc,m);} _mm256_storeu_si256((__m256i*)(out+i),acc); online_avx2_stats_add(1,8,0,0);} for(;i<n;i++){uint32_t r=0;for(size_t j=0;j<tn;j++)r+=(uint32_t)(x[i]>=t[j]);out[i]=r; online_avx2_stats_add(0,0,1,0);} }
-void sda_cdt_avx2_lookup_u8_batch(const uint8_t*x,size_t n,const uint8_t*t,size_t tn,uint32_t*out){size_t i=0; for(;i+8<=n;i+=8){__m256i xv=_mm256_set_epi32(x[i+7],x[i+6],x[i+5],x[i+4],x[i+3],x[i+2],x[i+1],x[i]); __m256i acc=_mm256_setzero_si256(); for(size_t j=0;j<tn;j++){__m256i m=uge32(xv,_mm256_set1_epi32(t[j])); acc=_mm256_sub_epi32(acc,m);} _mm256_storeu_si256((__m256i*)(out+i),acc); online_avx2_stats_add(1,8,0,0);} for(;i<n;i++){uint32_t r=0;for(size_t j=0;j<tn;j++)r+=(uint32_t)(x[i]>=t[j]);out[i]=r; online_avx2_stats_add(0,0,1,0);} }
+/* Lookup counts follow from n and the lane width; nothing is counted per lane. */
+static inline void lookup_account(sdat_avx2_stats*tel,size_t n,size_t w){SDAT_TEL_ADD(tel,avx2_vector_batches,n/w);SDAT_TEL_ADD(tel,avx2_vectorized_samples,n-n%w);SDAT_TEL_ADD(tel,scalar_tail_samples,n%w);}
+static void lookup_u16(const uint16_t*x,size_t n,const uint16_t*t,size_t tn,uint32_t*out,sdat_avx2_stats*tel){size_t i=0; for(;i+8<=n;i+=8){__m256i xv=_mm256_set_epi32(x[i+7],x[i+6],x[i+5],x[i+4],x[i+3],x[i+2],x[i+1],x[i]); __m256i acc=_mm256_setzero_si256(); for(size_t j=0;j<tn;j++){__m256i m=uge32(xv,_mm256_set1_epi32(t[j])); acc=_mm256_sub_epi32(acc,m);} _mm256_storeu_si256((__m256i*)(out+i),acc); } for(;i<n;i++){uint32_t r=0;for(size_t j=0;j<tn;j++)r+=(uint32_t)(x[i]>=t[j]);out[i]=r;} lookup_account(tel,n,8); }
+static void lookup_u8(const uint8_t*x,size_t n,const uint8_t*t,size_t tn,uint32_t*out,sdat_avx2_stats*tel){size_t i=0; for(;i+8<=n;i+=8){__m256i xv=_mm256_set_epi32(x[i+7],x[i+6],x[i+5],x[i+4],x[i+3],x[i+2],x[i+1],x[i]); __m256i acc=_mm256_setzero_si256(); for(size_t j=0;j<tn;j++){__m256i m=uge32(xv,_mm256_set1_epi32(t[j])); acc=_mm256_sub_epi32(acc,m);} _mm256_storeu_si256((__m256i*)(out+i),acc); } for(;i<n;i++){uint32_t r=0;for(size_t j=0;j<tn;j++)r+=(uint32_t)(x[i]>=t[j]);out[i]=r;} lookup_account(tel,n,8); }
 
-void sda_cdt_avx2_lookup_u72_batch(const sdat_u72*x,size_t n,const sdat_u72*t,size_t tn,uint32_t*out){ size_t i=0; for(;i+4<=n;i+=4){ __m256i lo=_mm256_set_epi64x((long long)x[i+3].lo,(long long)x[i+2].lo,(long long)x[i+1].lo,(long long)x[i].lo); __m256i hi=_mm256_set_epi64x(x[i+3].hi,x[i+2].hi,x[i+1].hi,x[i].hi); uint32_t acc[4]={0,0,0,0}; for(size_t j=0;j<tn;j++){ __m256i th=_mm256_set1_epi64x(t[j].hi); __m256i gt=_mm256_cmpgt_epi64(hi,th); __m256i eq=_mm256_cmpeq_epi64(hi,th); __m256i ge=_mm256_and_si256(eq,uge64(lo,_mm256_set1_epi64x((long long)t[j].lo))); __m256i m=_mm256_or_si256(gt,ge); uint64_t mm[4]; _mm256_storeu_si256((__m256i*)mm,m); acc[0]+=(uint32_t)(mm[0]>>63); acc[1]+=(uint32_t)(mm[1]>>63); acc[2]+=(uint32_t)(mm[2]>>63); acc[3]+=(uint32_t)(mm[3]>>63); } out[i]=acc[0]; out[i+1]=acc[1]; out[i+2]=acc[2]; out[i+3]=acc[3]; online_avx2_stats_add(1,4,0,0); } for(;i<n;i++){uint32_t r=0;for(size_t j=0;j<tn;j++)r+=(uint32_t)sdat_u72_ge(x[i],t[j]);out[i]=r; online_avx2_stats_add(0,0,1,0);} }
-void original_cdt_avx2_lookup_u72_reverse_batch(const sdat_u72*x,size_t n,const sdat_u72*t,size_t tn,uint32_t*out){ size_t i=0; for(;i+4<=n;i+=4){uint32_t acc[4]={0,0,0,0}; for(size_t j=0;j<tn;j++){acc[0]+=(uint32_t)sdat_u72_lt(x[i],t[j]);acc[1]+=(uint32_t)sdat_u72_lt(x[i+1],t[j]);acc[2]+=(uint32_t)sdat_u72_lt(x[i+2],t[j]);acc[3]+=(uint32_t)sdat_u72_lt(x[i+3],t[j]);} out[i]=acc[0];out[i+1]=acc[1];out[i+2]=acc[2];out[i+3]=acc[3]; online_avx2_stats_add(1,4,0,0);} for(;i<n;i++){uint32_t r=0;for(size_t j=0;j<tn;j++)r+=(uint32_t)sdat_u72_lt(x[i],t[j]);out[i]=r; online_avx2_stats_add(0,0,1,0);} }
+/* u72 lookups run eight lanes of 24-bit limbs (falcon_u72_avx2.h). */
+static __m256i count_lt_u72(sdat_u72x8 x,const sdat_u72*t,size_t tn){__m256i acc=_mm256_setzero_si256(); for(size_t j=0;j<tn;j++)acc=_mm256_sub_epi32(acc,sdat_u72x8_lt(x,sdat_u72_split(t[j]))); return acc;}
+static void lookup_u72(const sdat_u72*x,size_t n,const sdat_u72*t,size_t tn,uint32_t*out,sdat_avx2_stats*tel){ for(size_t i=0;i<n;i+=8){size_t m=n-i<8?n-i:8; uint32_t r[8]; __m256i c=_mm256_sub_epi32(_mm256_set1_epi32((int)tn),count_lt_u72(sdat_u72x8_load(x+i,m),t,tn)); _mm256_storeu_si256((__m256i*)r,c); memcpy(out+i,r,m*sizeof r[0]);} lookup_account(tel,n,8); }
+static void lookup_u72_reverse(const sdat_u72*x,size_t n,const sdat_u72*t,size_t tn,uint32_t*out,sdat_avx2_stats*tel){ for(size_t i=0;i<n;i+=8){size_t m=n-i<8?n-i:8; uint32_t r[8]; _mm256_storeu_si256((__m256i*)r,count_lt_u72(sdat_u72x8_load(x+i,m),t,tn)); memcpy(out+i,r,m*sizeof r[0]);} lookup_account(tel,n,8); }
+void original_cdt_avx2_lookup_u16_batch(const uint16_t*x,size_t n,const uint16_t*t,size_t tn,uint32_t*out){sdat_avx2_stats tel={1,0,0,0,0,0,0}; lookup_u16(x,n,t,tn,out,&tel); SDAT_TEL_FLUSH(&tel);}
+void sda_cdt_avx2_lookup_u8_batch(const uint8_t*x,size_t n,const uint8_t*t,size_t tn,uint32_t*out){sdat_avx2_stats tel={1,0,0,0,0,0,0}; lookup_u8(x,n,t,tn,out,&tel); SDAT_TEL_FLUSH(&tel);}
+void sda_cdt_avx2_lookup_u72_batch(const sdat_u72*x,size_t n,const sdat_u72*t,size_t tn,uint32_t*out){sdat_avx2_stats tel={1,0,0,0,0,0,0}; lookup_u72(x,n,t,tn,out,&tel); SDAT_TEL_FLUSH(&tel);}
+void original_cdt_avx2_lookup_u72_reverse_batch(const sdat_u72*x,size_t n,const sdat_u72*t,size_t tn,uint32_t*out){sdat_avx2_stats tel={1,0,0,0,0,0,0}; lookup_u72_reverse(x,n,t,tn,out,&tel); SDAT_TEL_FLUSH(&tel);}
 static void addst(sdat_stats*st,unsigned bytes,unsigned bits,int rej){ if(st){st->attempts++;st->random_bytes+=bytes;st->random_bits+=bits;if(rej)st->rejections++;}}
-static int draw8(unsigned bits,sdat_randombytes_fn fn,void*ctx,uint8_t*out,sdat_stats*st){uint8_t b; if(fn(ctx,&b,1))return -1; b&=(uint8_t)((1u<<bits)-1u); *out=b; addst(st,1,bits,0); return 0;}
-static int draw16(unsigned bits,sdat_randombytes_fn fn,void*ctx,uint16_t*out,sdat_stats*st){uint8_t b[2]; if(fn(ctx,b,2))return -1; uint16_t mask=(bits==16)?65535u:(uint16_t)((1u<<bits)-1u); *out=(uint16_t)(b[0]|((uint16_t)b[1]<<8)); *out&=mask; addst(st,2,bits,0); return 0;}
-int original_cdt_avx2_sample_batch(const sdat_table*t,sdat_randombytes_fn fn,void*ctx,uint32_t*out,size_t n,sdat_stats*st){ if(n==0)return 0; if(!t||!fn||!out||!t->available)return -1; size_t done=0; if(t->value_type==SDAT_TYPE_U16){uint16_t xs[8]; while(done<n){size_t m=n-done>=8?8:n-done; for(size_t k=0;k<m;k++) if(draw16(t->random_draw_bits,fn,ctx,&xs[k],st))return -2; original_cdt_avx2_lookup_u16_batch(xs,m,t->thresholds,t->threshold_count,out+done); done+=m;} return 0;} if(t->value_type==SDAT_TYPE_U72){sdat_u72 xs[4]; while(done<n){size_t m=n-done>=4?4:n-done; for(size_t k=0;k<m;k++){uint8_t b[9]; if(fn(ctx,b,9))return -3; xs[k]=sdat_u72_from_le9(b); addst(st,9,72,0);} original_cdt_avx2_lookup_u72_reverse_batch(xs,m,t->thresholds,t->threshold_count,out+done); done+=m;} return 0;} return -4;}
-int sda_cdt_avx2_sample_batch(const sdat_table*t,sdat_randombytes_fn fn,void*ctx,uint32_t*out,size_t n,sdat_stats*st){ if(n==0)return 0; if(!t||!fn||!out||!t->available)return -1; size_t done=0; if(t->value_type==SDAT_TYPE_U8){uint8_t xs[8]; while(done<n){size_t m=n-done>=8?8:n-done; for(size_t k=0;k<m;k++){uint8_t x; do{ if(draw8(t->random_draw_bits,fn,ctx,&x,st))return -2; online_avx2_stats_refill(1,x>=t->denominator_u64); if(x>=t->denominator_u64 && st)st->rejections++; }while(x>=t->denominator_u64); xs[k]=x;} sda_cdt_avx2_lookup_u8_batch(xs,m,t->thresholds,t->threshold_count,out+done); done+=m;} return 0;} if(t->value_type==SDAT_TYPE_U16){uint16_t xs[8]; while(done<n){size_t m=n-done>=8?8:n-done; for(size_t k=0;k<m;k++){uint16_t x; do{ if(draw16(t->random_draw_bits,fn,ctx,&x,st))return -2; online_avx2_stats_refill(1,x>=t->denominator_u64); if(x>=t->denominator_u64 && st)st->rejections++; }while(x>=t->denominator_u64); xs[k]=x;} original_cdt_avx2_lookup_u16_batch(xs,m,t->thresholds,t->threshold_count,out+done); done+=m;} return 0;} if(t->value_type==SDAT_TYPE_U72){sdat_u72 xs[4]; while(done<n){size_t m=n-done>=4?4:n-done; for(size_t k=0;k<m;k++){uint8_t b[9]; do{ if(fn(ctx,b,9))return -3; xs[k]=sdat_u72_from_le9(b); int rej=sdat_u72_ge(xs[k],t->denominator_u72); addst(st,9,72,rej); online_avx2_stats_refill(1,rej); }while(sdat_u72_ge(xs[k],t->denominator_u72));} sda_cdt_avx2_lookup_u72_batch(xs,m,t->thresholds,t->threshold_count,out+done); done+=m;} return 0;} return -4;}
+static int draw8(unsigned bits,sdat_randbuf*rb,size_t hint,uint8_t*out,sdat_stats*st){const uint8_t*b=sdat_randbuf_take(rb,1,hint); if(!b)return -1; *out=(uint8_t)(b[0]&((1u<<bits)-1u)); addst(st,1,bits,0); return 0;}
+static int draw16(unsigned bits,sdat_randbuf*rb,size_t hint,uint16_t*out,sdat_stats*st){const uint8_t*b=sdat_randbuf_take(rb,2,hint); if(!b)return -1; uint16_t mask=(bits==16)?65535u:(uint16_t)((1u<<bits)-1u); *out=(uint16_t)((b[0]|((uint16_t)b[1]<<8))&mask); addst(st,2,bits,0); return 0;}
+/* Draws come from one sdat_randbuf per call, wiped on return; hints are the
+ * outputs still owed times the draw size, so the callback is never asked for
+ * unused bytes. */
+static int original_batch(const sdat_table*t,sdat_randbuf*rb,uint32_t*out,size_t n,sdat_stats*st,sdat_avx2_stats*tel){ if(n==0)return 0; if(!t||!rb->fn||!out||!t->available)return -1; size_t done=0; if(t->value_type==SDAT_TYPE_U16){uint16_t xs[8]; while(done<n){size_t m=n-done>=8?8:n-done; for(size_t k=0;k<m;k++) if(draw16(t->random_draw_bits,rb,2*(n-done-k),&xs[k],st))return -2; lookup_u16(xs,m,t->thresholds,t->threshold_count,out+done,tel); done+=m;} return 0;} if(t->value_type==SDAT_TYPE_U72){sdat_u72 xs[8]; while(done<n){size_t m=n-done>=8?8:n-done; const uint8_t*b=sdat_randbuf_take(rb,9*m,9*(n-done)); if(!b)return -3; for(size_t k=0;k<m;k++){xs[k]=sdat_u72_from_le9(b+9*k); addst(st,9,72,0);} lookup_u72_reverse(xs,m,t->thresholds,t->threshold_count,out+done,tel); done+=m;} return 0;} return -4;}
+static int sda_batch(const sdat_table*t,sdat_randbuf*rb,uint32_t*out,size_t n,sdat_stats*st,sdat_avx2_stats*tel){ if(n==0)return 0; if(!t||!rb->fn||!out||!t->available)return -1; size_t done=0; if(t->value_type==SDAT_TYPE_U8){uint8_t xs[8]; while(done<n){size_t m=n-done>=8?8:n-done; for(size_t k=0;k<m;k++){uint8_t x; do{ if(draw8(t->random_draw_bits,rb,n-done-k,&x,st))return -2; SDAT_TEL_ADD(tel,refill_rounds,1); SDAT_TEL_ADD(tel,rejected_lanes,x>=t->denominator_u64); if(x>=t->denominator_u64 && st)st->rejections++; }while(x>=t->denominator_u64); xs[k]=x;} lookup_u8(xs,m,t->thresholds,t->threshold_count,out+done,tel); done+=m;} return 0;} if(t->value_type==SDAT_TYPE_U16){uint16_t xs[8]; while(done<n){size_t m=n-done>=8?8:n-done; for(size_t k=0;k<m;k++){uint16_t x; do{ if(draw16(t->random_draw_bits,rb,2*(n-done-k),&x,st))return -2; SDAT_TEL_ADD(tel,refill_rounds,1); SDAT_TEL_ADD(tel,rejected_lanes,x>=t->denominator_u64); if(x>=t->denominator_u64 && st)st->rejections++; }while(x>=t->denominator_u64); xs[k]=x;} lookup_u16(xs,m,t->thresholds,t->threshold_count,out+done,tel); done+=m;} return 0;} if(t->value_type==SDAT_TYPE_U72){sdat_u72 xs[8]; while(done<n){size_t m=n-done>=8?8:n-done; for(size_t k=0;k<m;k++){do{ const uint8_t*b=sdat_randbuf_take(rb,9,9*(n-done-k)); if(!b)return -3; xs[k]=sdat_u72_from_le9(b); int rej=sdat_u72_ge_ct(xs[k],t->denominator_u72); addst(st,9,72,rej); SDAT_TEL_ADD(tel,refill_rounds,1); SDAT_TEL_ADD(tel,rejected_lanes,rej); }while(sdat_u72_ge_ct(xs[k],t->denominator_u72));} lookup_u72(xs,m,t->thresholds,t->threshold_count,out+done,tel); done+=m;} return 0;} return -4;}
+int original_cdt_avx2_sample_batch(const sdat_table*t,sdat_randombytes_fn fn,void*ctx,uint32_t*out,size_t n,sdat_stats*st){sdat_avx2_stats tel={1,0,0,0,0,0,0}; uint8_t blk[SDAT_RANDBUF_BYTES]; sdat_randbuf rb; sdat_randbuf_init(&rb,fn,ctx,blk,sizeof blk); int r=original_batch(t,&rb,out,n,st,&tel); sdat_randbuf_wipe(&rb); SDAT_TEL_FLUSH(&tel); return r;}
+int sda_cdt_avx2_sample_batch(const sdat_table*t,sdat_randombytes_fn fn,void*ctx,uint32_t*out,size_t n,sdat_stats*st){sdat_avx2_stats tel={1,0,0,0,0,0,0}; uint8_t blk[SDAT_RANDBUF_BYTES]; sdat_randbuf rb; sdat_randbuf_init(&rb,fn,ctx,blk,sizeof blk); int r=sda_batch(t,&rb,out,n,st,&tel); sdat_randbuf_wipe(&rb); SDAT_TEL_FLUSH(&tel); return r;}
 int sdat_avx2_sample_batch(const sdat_table*t,sdat_randombytes_fn fn,void*ctx,uint32_t*out,size_t n){return sda_cdt_avx2_sample_batch(t,fn,ctx,out,n,0);} 
@@ -0,0 +1,128 @@
+#ifndef FRODO_KERNELS_AVX2_H
+#define FRODO_KERNELS_AVX2_H
+#include <immintrin.h>
+#include "frodo_sample_n_fast.h"
+
+/* AVX2 inner loops shared by the hand-written Frodo kernels and the generated
+ * ones in online/frodo/generated; all are always_inline so the per-parameter
+ * wrappers propagate their constants. Only for translation units built with
+ * -mavx2. */
+
+/* frodo_pack_shuffle[m] moves the 16-bit lanes selected by the 8-bit mask m
+ * to the front of a 128-bit register; frodo_pack_count[m] is popcount(m). */
+extern const uint8_t frodo_pack_shuffle[256][16];
+extern const uint8_t frodo_pack_count[256];
+
+static inline __m128i pack_lanes(__m128i v, unsigned m) {
+    return _mm_shuffle_epi8(v, _mm_load_si128((const __m128i *)frodo_pack_shuffle[m]));
+}
+
+/* Returns the number of outputs written; *consumed receives the number of
+ * words read. Constant arguments are propagated by the per-parameter wrappers. */
+static inline __attribute__((always_inline)) size_t word_kernel(uint16_t *out, size_t n, const uint16_t *w, size_t wc,
+                                                                uint16_t cmask, int sign_shift, uint16_t q,
+                                                                const uint16_t *thr, size_t tn, size_t *consumed,
+                                                                uint64_t *batches) {
+    __m256i tv[16];
+    for (size_t j = 0; j < tn; j++) tv[j] = _mm256_set1_epi16((short)(thr[j] - 1u));
+    const __m256i vmask = _mm256_set1_epi16((short)cmask);
+    const __m256i vq = _mm256_set1_epi16((short)q);
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const uint16_t *src = w;
+    const uint16_t *end = w + wc;
+    uint16_t *dst = out;
+    uint16_t *dst_end = out + n;
+    uint64_t nb = 0;
+    while ((size_t)(dst_end - dst) >= 16 && (size_t)(end - src) >= 16) {
+        __m256i z = _mm256_loadu_si256((const __m256i *)src);
+        src += 16;
+        __m256i c = _mm256_and_si256(z, vmask);
+        __m256i mag = zero;
+        for (size_t j = 0; j < tn; j++) mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(c, tv[j]));
+        __m256i sign = _mm256_and_si256(_mm256_srli_epi16(z, sign_shift), one);
+        __m256i s = _mm256_add_epi16(_mm256_xor_si256(mag, _mm256_sub_epi16(zero, sign)), sign);
+        __m256i acc = _mm256_cmpgt_epi16(vq, c);
+        unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_packs_epi16(acc, acc));
+        unsigned lo = m & 0xffu, hi = (m >> 16) & 0xffu;
+        _mm_storeu_si128((__m128i *)dst, pack_lanes(_mm256_castsi256_si128(s), lo));
+        dst += frodo_pack_count[lo];
+        _mm_storeu_si128((__m128i *)dst, pack_lanes(_mm256_extracti128_si256(s, 1), hi));
+        dst += frodo_pack_count[hi];
+        nb++;
+    }
+    while (dst < dst_end && src < end) {
+        uint16_t z = *src++;
+        uint16_t c = (uint16_t)(z & cmask);
+        uint16_t mag = 0;
+        for (size_t j = 0; j < tn; j++) mag += (uint16_t)(c >= thr[j]);
+        *dst = frodo_apply_sign(mag, (uint8_t)((z >> sign_shift) & 1u));
+        dst += (unsigned)(c < q);
+    }
+    *consumed = (size_t)(src - w);
+    *batches = nb;
+    return (size_t)(dst - out);
+}
+
+/* Same accounting as the scalar word*_with_stats loops: every consumed word is
+ * one attempt of `bits` candidate bits, every accepted word adds one sign bit. */
+static inline void word_account(size_t produced, size_t consumed, uint64_t batches, unsigned bits, sdat_stats *st) {
+    if (st) {
+        st->attempts += consumed;
+        st->rejections += consumed - produced;
+        st->random_bits += (uint64_t)consumed * bits + produced;
+        st->random_bytes += (uint64_t)consumed * 2u;
+    }
+    sdat_avx2_stats tel = {1, batches, batches * 16u, consumed - batches * 16u, 0, 0, 0};
+    SDAT_TEL_FLUSH(&tel);
+}
+
+/* Batched packed-bit extractor. Eight (candidate, sign) fields are decoded per
+ * vector under the speculation that every lane is accepted, i.e. lane k starts
+ * at bit s+k*(b+1) of the LSB-first stream. Each lane's source bytes are
+ * gathered with one pshufb (the upper four lanes read from a second 16-byte
+ * window) and aligned with a variable shift. The accepted prefix up to the
+ * first rejected lane is committed; the rejected candidate consumes b bits and
+ * no sign bit, exactly as in nx640/nx976/nx1344, so outputs and consumed bits
+ * equal the sdat_take_* path. The reader is re-synchronised to the final bit
+ * position before the scalar tail. */
+typedef struct { const uint8_t *p; unsigned s; } packed_pos;
+static inline packed_pos packed_begin(const sdat_bitreader_fast*r){unsigned a=r->available;packed_pos q={r->ptr-(a+7u)/8u,(8u-(a&7u))&7u};return q;}
+static inline void packed_sync(sdat_bitreader_fast*r,packed_pos q,uint64_t bits){
+    if(!bits)return;
+    if(bits<r->available){r->reservoir>>=bits;r->available-=(unsigned)bits;r->bits_consumed+=bits;return;}
+    const uint8_t*np=q.p+(q.s?1:0);
+    r->bytes_loaded+=(uint64_t)(np-r->ptr); r->ptr=np; r->reservoir=q.s?(uint64_t)(*q.p>>q.s):0; r->available=q.s?8u-q.s:0; r->bits_consumed+=bits;
+}
+static inline __attribute__((always_inline)) size_t packed_extract(sdat_bitreader_fast*r,uint16_t*out,size_t n,unsigned b,uint32_t q,const uint32_t*thr,size_t tn,sdat_stats*st,sdat_avx2_stats*tel){
+    const unsigned w=b+1u;
+    const __m256i kw=_mm256_setr_epi32(0,(int)w,(int)(2*w),(int)(3*w),(int)(4*w),(int)(5*w),(int)(6*w),(int)(7*w));
+    const __m256i bcast=_mm256_setr_epi8(0,0,0,0,4,4,4,4,8,8,8,8,12,12,12,12,0,0,0,0,4,4,4,4,8,8,8,8,12,12,12,12);
+    const __m256i seq=_mm256_set1_epi32(0x03020100),seven=_mm256_set1_epi32(7);
+    const __m256i cmask=_mm256_set1_epi32((int)((1u<<b)-1u)),one=_mm256_set1_epi32(1),vq=_mm256_set1_epi32((int)q),zero=_mm256_setzero_si256();
+    __m256i tv[16]; for(size_t j=0;j<tn;j++)tv[j]=_mm256_set1_epi32((int)(thr[j]-1u));
+    packed_pos pos=packed_begin(r); uint64_t bits=0,att=0,rej=0,nb=0; size_t d=0;
+    while(n-d>=8 && r->end-pos.p>=32){
+        unsigned hb=(pos.s+4u*w)>>3;
+        __m256i start=_mm256_add_epi32(_mm256_set1_epi32((int)pos.s),kw);
+        __m256i rel=_mm256_sub_epi32(_mm256_srli_epi32(start,3),_mm256_setr_epi32(0,0,0,0,(int)hb,(int)hb,(int)hb,(int)hb));
+        __m256i ctrl=_mm256_add_epi32(_mm256_shuffle_epi8(rel,bcast),seq);
+        __m256i v=_mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)pos.p)),_mm_loadu_si128((const __m128i*)(pos.p+hb)),1);
+        __m256i x=_mm256_srlv_epi32(_mm256_shuffle_epi8(v,ctrl),_mm256_and_si256(start,seven));
+        __m256i c=_mm256_and_si256(x,cmask),sg=_mm256_and_si256(_mm256_srli_epi32(x,(int)b),one);
+        __m256i mag=zero; for(size_t j=0;j<tn;j++)mag=_mm256_sub_epi32(mag,_mm256_cmpgt_epi32(c,tv[j]));
+        __m256i y=_mm256_add_epi32(_mm256_xor_si256(mag,_mm256_sub_epi32(zero,sg)),sg);
+        y=_mm256_permute4x64_epi64(_mm256_packs_epi32(y,y),0x08);
+        _mm_storeu_si128((__m128i*)(out+d),_mm256_castsi256_si128(y));
+        unsigned acc=(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vq,c)));
+        unsigned k=(unsigned)__builtin_ctz(~acc),miss=k<8u;
+        unsigned adv=k*w+(miss?b:0u);
+        d+=k; att+=k+miss; rej+=miss; bits+=adv; nb++;
+        pos.s+=adv; pos.p+=pos.s>>3; pos.s&=7u;
+    }
+    packed_sync(r,pos,bits);
+    if(st){st->attempts+=att;st->rejections+=rej;st->random_bits+=bits;}
+    SDAT_TEL_ADD(tel,avx2_vector_batches,nb); SDAT_TEL_ADD(tel,avx2_vectorized_samples,d);
+    return d;
+}
+#endif
@@ -0,0 +1,36 @@
+#ifndef FRODO_KERNELS_GEN_H
+#define FRODO_KERNELS_GEN_H
+#include "frodo_sample_n_fast.h"
+
+/* Parameter-specialized kernels emitted by offline/scripts/generate_online_kernels.py
+ * into online/frodo/generated from the table manifest (and optionally exported
+ * research tables). Each entry carries the table it was generated for; the
+ * generic frodo_* entry points fall back to a content match against these
+ * registries when a table is not one of the built-in sdat_table objects, so
+ * a copied or newly added table still runs unrolled, constant-folded code.
+ * Original CDT entries fill only `original`, SDA entries the other four. */
+typedef struct {
+    const char *parameter_set, *table_family;
+    sdat_value_type value_type;
+    uint64_t q;
+    unsigned draw_bits;
+    size_t threshold_count;
+    const uint16_t *thresholds; /* widened from the native type */
+    int (*original)(uint16_t *s, size_t n);
+    int (*packed)(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st);
+    size_t (*packed_run)(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st);
+    int (*word)(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st);
+    size_t (*word_run)(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed, sdat_stats *st);
+} frodo_gen_kernels;
+
+extern const frodo_gen_kernels frodo_gen_reference[];
+extern const size_t frodo_gen_reference_count;
+extern const frodo_gen_kernels frodo_gen_avx2[];
+extern const size_t frodo_gen_avx2_count;
+
+/* Entry whose family, value type, q, draw bits and thresholds equal those of
+ * t, or NULL. frodo_gen_find_avx2 returns the entry at the same index of
+ * frodo_gen_avx2. */
+const frodo_gen_kernels *frodo_gen_find(const sdat_table *t);
+const frodo_gen_kernels *frodo_gen_find_avx2(const sdat_table *t);
+#endif
@@ -1,20 +1,26 @@
 #include "frodo_sample_n.h"
+#include "frodo_kernels_gen.h"
 #include "sdat_avx2.h"
 #include <immintrin.h>
 static inline __m256i ugt16(__m256i a,__m256i b){__m256i s=_mm256_set1_epi16((short)0x8000);return _mm256_cmpgt_epi16(_mm256_xor_si256(a,s),_mm256_xor_si256(b,s));}
 static inline __m256i uge16(__m256i a,__m256i b){__m256i gt=ugt16(a,b),eq=_mm256_cmpeq_epi16(a,b);return _mm256_or_si256(gt,eq);} 
 static inline __m256i ugt8(__m256i a,__m256i b){__m256i s=_mm256_set1_epi8((char)0x80);return _mm256_cmpgt_epi8(_mm256_xor_si256(a,s),_mm256_xor_si256(b,s));}
 static inline __m256i uge8(__m256i a,__m256i b){return _mm256_or_si256(ugt8(a,b),_mm256_cmpeq_epi8(a,b));}
-int frodo_original_sample_n_avx2(uint16_t*s,size_t n,const sdat_table*t){ if(!s||!t||t->value_type!=SDAT_TYPE_U16)return -1; if(!sdat_avx2_cpu_supported())return frodo_original_sample_n(s,n,t); size_t i=0; const uint16_t*thr=t->thresholds; size_t tn=t->threshold_count; for(;i+16<=n;i+=16){__m256i w=_mm256_loadu_si256((const __m256i*)(s+i)); __m256i x=_mm256_srli_epi16(w,1); __m256i acc=_mm256_setzero_si256(); for(size_t j=0;j<tn;j++)acc=_mm256_sub_epi16(acc,ugt16(x,_mm256_set1_epi16((short)thr[j]))); __m256i sign=_mm256_and_si256(w,_mm256_set1_epi16(1)); __m256i neg=_mm256_sub_epi16(_mm256_setzero_si256(),sign); _mm256_storeu_si256((__m256i*)(s+i),_mm256_add_epi16(_mm256_xor_si256(neg,acc),sign)); online_avx2_stats_add(1,16,0,0);} for(;i<n;i++){uint16_t w=s[i],mag=0;for(size_t j=0;j<tn;j++)mag+=(uint16_t)((w>>1)>thr[j]);s[i]=frodo_apply_sign(mag,(uint8_t)(w&1));online_avx2_stats_add(0,0,1,0);} return 0; }
-static void lookup16(const uint16_t*x,const uint8_t*sg,uint16_t*out,size_t m,const uint16_t*thr,size_t tn){size_t i=0; for(;i+16<=m;i+=16){__m256i xv=_mm256_loadu_si256((const __m256i*)(x+i));__m256i acc=_mm256_setzero_si256();for(size_t j=0;j<tn;j++)acc=_mm256_sub_epi16(acc,uge16(xv,_mm256_set1_epi16((short)thr[j]))); uint16_t tmp[16];_mm256_storeu_si256((__m256i*)tmp,acc);for(int k=0;k<16;k++)out[i+k]=frodo_apply_sign(tmp[k],sg[i+k]);online_avx2_stats_add(1,16,0,0);} for(;i<m;i++){uint16_t mag=0;for(size_t j=0;j<tn;j++)mag+=(uint16_t)(x[i]>=thr[j]);out[i]=frodo_apply_sign(mag,sg[i]);online_avx2_stats_add(0,0,1,0);} }
-static void lookup8(const uint8_t*x,const uint8_t*sg,uint16_t*out,size_t m,const uint8_t*thr,size_t tn){size_t i=0; for(;i+32<=m;i+=32){__m256i xv=_mm256_loadu_si256((const __m256i*)(x+i));__m256i acc=_mm256_setzero_si256();for(size_t j=0;j<tn;j++)acc=_mm256_sub_epi8(acc,uge8(xv,_mm256_set1_epi8((char)thr[j]))); uint8_t tmp[32];_mm256_storeu_si256((__m256i*)tmp,acc);for(int k=0;k<32;k++)out[i+k]=frodo_apply_sign(tmp[k],sg[i+k]);online_avx2_stats_add(1,32,0,0);} for(;i<m;i++){uint16_t mag=0;for(size_t j=0;j<tn;j++)mag+=(uint16_t)(x[i]>=thr[j]);out[i]=frodo_apply_sign(mag,sg[i]);online_avx2_stats_add(0,0,1,0);} }
-int frodo_sda_sample_n_avx2(uint16_t*out,size_t n,sdat_bitreader*r,const sdat_table*t,sdat_stats*st){ if(!sdat_avx2_cpu_supported())return frodo_sda_sample_n(out,n,r,t,st); if(st)*st=(sdat_stats){0,0,0,0}; size_t done=0; if(t->value_type==SDAT_TYPE_U16){uint16_t a[16];uint8_t sg[16];while(done<n){size_t m=n-done<16?n-done:16;if(frodo_uniform_bounded_u16_batch(r,(uint16_t)t->denominator_u64,t->random_draw_bits,a,sg,m,st)!=m)return -2;lookup16(a,sg,out+done,m,t->thresholds,t->threshold_count);done+=m;}return 0;} if(t->value_type==SDAT_TYPE_U8){uint8_t a[32],sg[32];while(done<n){size_t m=n-done<32?n-done:32;if(frodo_uniform_bounded_u8_batch(r,(uint8_t)t->denominator_u64,t->random_draw_bits,a,sg,m,st)!=m)return -2;lookup8(a,sg,out+done,m,t->thresholds,t->threshold_count);done+=m;}return 0;} return -1;}
-#include "frodo_sample_n_fast.h"
+const frodo_gen_kernels *frodo_gen_find_avx2(const sdat_table*t){ const frodo_gen_kernels*g=frodo_gen_find(t); return g?&frodo_gen_avx2[g-frodo_gen_reference]:0; }
+int frodo_original_sample_n_avx2(uint16_t*s,size_t n,const sdat_table*t){ if(!s||!t||t->value_type!=SDAT_TYPE_U16)return -1; if(!sdat_avx2_cpu_supported())return frodo_original_sample_n(s,n,t); if(t!=&original_cdt_table_frodo640&&t!=&original_cdt_table_frodo976&&t!=&original_cdt_table_frodo1344){const frodo_gen_kernels*g=frodo_gen_find_avx2(t); if(g&&g->original)return g->original(s,n);} size_t i=0; const uint16_t*thr=t->thresholds; size_t tn=t->threshold_count; for(;i+16<=n;i+=16){__m256i w=_mm256_loadu_si256((const __m256i*)(s+i)); __m256i x=_mm256_srli_epi16(w,1); __m256i acc=_mm256_setzero_si256(); for(size_t j=0;j<tn;j++)acc=_mm256_sub_epi16(acc,ugt16(x,_mm256_set1_epi16((short)thr[j]))); __m256i sign=_mm256_and_si256(w,_mm256_set1_epi16(1)); __m256i neg=_mm256_sub_epi16(_mm256_setzero_si256(),sign); _mm256_storeu_si256((__m256i*)(s+i),_mm256_add_epi16(_mm256_xor_si256(neg,acc),sign));} for(;i<n;i++){uint16_t w=s[i],mag=0;for(size_t j=0;j<tn;j++)mag+=(uint16_t)((w>>1)>thr[j]);s[i]=frodo_apply_sign(mag,(uint8_t)(w&1));} sdat_avx2_stats tel={1,n/16,n-n%16,n%16,0,0,0}; SDAT_TEL_FLUSH(&tel); return 0; }
+static inline __m256i sign16v(__m256i mag,__m256i sg){sg=_mm256_and_si256(sg,_mm256_set1_epi16(1));return _mm256_add_epi16(_mm256_xor_si256(mag,_mm256_sub_epi16(_mm256_setzero_si256(),sg)),sg);}
+static void lookup16(const uint16_t*x,const uint8_t*sg,uint16_t*out,size_t m,const uint16_t*thr,size_t tn,sdat_avx2_stats*tel){size_t i=0; for(;i+16<=m;i+=16){__m256i xv=_mm256_loadu_si256((const __m256i*)(x+i));__m256i acc=_mm256_setzero_si256();for(size_t j=0;j<tn;j++)acc=_mm256_sub_epi16(acc,uge16(xv,_mm256_set1_epi16((short)thr[j]))); __m256i sv=_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(sg+i)));_mm256_storeu_si256((__m256i*)(out+i),sign16v(acc,sv));} for(;i<m;i++){uint16_t mag=0;for(size_t j=0;j<tn;j++)mag+=(uint16_t)(x[i]>=thr[j]);out[i]=frodo_apply_sign(mag,sg[i]);} SDAT_TEL_ADD(tel,avx2_vector_batches,m/16);SDAT_TEL_ADD(tel,avx2_vectorized_samples,m-m%16);SDAT_TEL_ADD(tel,scalar_tail_samples,m%16); }
+static void lookup8(const uint8_t*x,const uint8_t*sg,uint16_t*out,size_t m,const uint8_t*thr,size_t tn,sdat_avx2_stats*tel){size_t i=0; for(;i+32<=m;i+=32){__m256i xv=_mm256_loadu_si256((const __m256i*)(x+i));__m256i acc=_mm256_setzero_si256();for(size_t j=0;j<tn;j++)acc=_mm256_sub_epi8(acc,uge8(xv,_mm256_set1_epi8((char)thr[j]))); __m256i s0=_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(sg+i))),s1=_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(sg+i+16)));_mm256_storeu_si256((__m256i*)(out+i),sign16v(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(acc)),s0));_mm256_storeu_si256((__m256i*)(out+i+16),sign16v(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(acc,1)),s1));} for(;i<m;i++){uint16_t mag=0;for(size_t j=0;j<tn;j++)mag+=(uint16_t)(x[i]>=thr[j]);out[i]=frodo_apply_sign(mag,sg[i]);} SDAT_TEL_ADD(tel,avx2_vector_batches,m/32);SDAT_TEL_ADD(tel,avx2_vectorized_samples,m-m%32);SDAT_TEL_ADD(tel,scalar_tail_samples,m%32); }
+static int sda_sample_n(uint16_t*out,size_t n,sdat_bitreader*r,const sdat_table*t,sdat_stats*st,sdat_avx2_stats*tel){ if(st)*st=(sdat_stats){0,0,0,0}; size_t done=0; if(t->value_type==SDAT_TYPE_U16){uint16_t a[16];uint8_t sg[16];while(done<n){size_t m=n-done<16?n-done:16;if(frodo_uniform_bounded_u16_batch(r,(uint16_t)t->denominator_u64,t->random_draw_bits,a,sg,m,st)!=m)return -2;lookup16(a,sg,out+done,m,t->thresholds,t->threshold_count,tel);done+=m;}return 0;} if(t->value_type==SDAT_TYPE_U8){uint8_t a[32],sg[32];while(done<n){size_t m=n-done<32?n-done:32;if(frodo_uniform_bounded_u8_batch(r,(uint8_t)t->denominator_u64,t->random_draw_bits,a,sg,m,st)!=m)return -2;lookup8(a,sg,out+done,m,t->thresholds,t->threshold_count,tel);done+=m;}return 0;} return -1;}
+int frodo_sda_sample_n_avx2(uint16_t*out,size_t n,sdat_bitreader*r,const sdat_table*t,sdat_stats*st){ if(!sdat_avx2_cpu_supported())return frodo_sda_sample_n(out,n,r,t,st); sdat_avx2_stats tel={1,0,0,0,0,0,0}; int rc=sda_sample_n(out,n,r,t,st,&tel); SDAT_TEL_FLUSH(&tel); return rc;}
+#include "frodo_kernels_avx2.h"
 static inline void stat_try_fast(sdat_stats*st,unsigned b,int rej){if(st){st->attempts++;st->random_bits+=b;if(rej)st->rejections++;}}
 static inline int nx640(sdat_bitreader_fast*r,uint16_t*x,uint8_t*sg,sdat_stats*st){uint32_t v,s;for(;;){if(sdat_take_14(r,&v))return -2;if(v>=14534u){stat_try_fast(st,14,1);continue;}stat_try_fast(st,14,0);if(sdat_take_1(r,&s))return -2;if(st)st->random_bits++;*x=(uint16_t)v;*sg=(uint8_t)s;return 0;}}
 static inline int nx976(sdat_bitreader_fast*r,uint16_t*x,uint8_t*sg,sdat_stats*st){uint32_t v,s;for(;;){if(sdat_take_13(r,&v))return -2;if(v>=7442u){stat_try_fast(st,13,1);continue;}stat_try_fast(st,13,0);if(sdat_take_1(r,&s))return -2;if(st)st->random_bits++;*x=(uint16_t)v;*sg=(uint8_t)s;return 0;}}
 static inline int nx1344(sdat_bitreader_fast*r,uint8_t*x,uint8_t*sg,sdat_stats*st){uint32_t v,s;for(;;){if(sdat_take_7(r,&v))return -2;if(v>=102u){stat_try_fast(st,7,1);continue;}stat_try_fast(st,7,0);if(sdat_take_1(r,&s))return -2;if(st)st->random_bits++;*x=(uint8_t)v;*sg=(uint8_t)s;return 0;}}
-int frodo640_sda_sample_n_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,sdat_stats*st){if(!sdat_avx2_cpu_supported())return frodo640_sda_sample_n_scalar(out,n,r,st);if(st)*st=(sdat_stats){0};uint16_t a[16];uint8_t sg[16];size_t d=0;while(d<n){size_t m=n-d<16?n-d:16;for(size_t i=0;i<m;i++)if(nx640(r,&a[i],&sg[i],st))return -2;lookup16(a,sg,out+d,m,sda_table_frodo640.thresholds,11);d+=m;}if(st)st->random_bytes=r->bytes_loaded;return 0;}
-int frodo976_sda_sample_n_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,sdat_stats*st){if(!sdat_avx2_cpu_supported())return frodo976_sda_sample_n_scalar(out,n,r,st);if(st)*st=(sdat_stats){0};uint16_t a[16];uint8_t sg[16];size_t d=0;while(d<n){size_t m=n-d<16?n-d:16;for(size_t i=0;i<m;i++)if(nx976(r,&a[i],&sg[i],st))return -2;lookup16(a,sg,out+d,m,sda_table_frodo976.thresholds,9);d+=m;}if(st)st->random_bytes=r->bytes_loaded;return 0;}
-int frodo1344_sda_sample_n_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,sdat_stats*st){if(!sdat_avx2_cpu_supported())return frodo1344_sda_sample_n_scalar(out,n,r,st);if(st)*st=(sdat_stats){0};uint8_t a[32],sg[32];size_t d=0;while(d<n){size_t m=n-d<32?n-d:32;for(size_t i=0;i<m;i++)if(nx1344(r,&a[i],&sg[i],st))return -2;lookup8(a,sg,out+d,m,sda_table_frodo1344.thresholds,4);d+=m;}if(st)st->random_bytes=r->bytes_loaded;return 0;}
-int frodo_sda_sample_n_fast_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,const sdat_table*t,sdat_stats*st){if(t==&sda_table_frodo640)return frodo640_sda_sample_n_avx2(out,n,r,st);if(t==&sda_table_frodo976)return frodo976_sda_sample_n_avx2(out,n,r,st);if(t==&sda_table_frodo1344)return frodo1344_sda_sample_n_avx2(out,n,r,st);return -1;}
+static size_t thr_u32(const sdat_table*t,uint32_t*o){if(t->value_type==SDAT_TYPE_U8){const uint8_t*c=t->thresholds;for(size_t j=0;j<t->threshold_count;j++)o[j]=c[j];}else{const uint16_t*c=t->thresholds;for(size_t j=0;j<t->threshold_count;j++)o[j]=c[j];}return t->threshold_count;}
+int frodo640_sda_sample_n_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,sdat_stats*st){if(!sdat_avx2_cpu_supported())return frodo640_sda_sample_n_scalar(out,n,r,st);if(st)*st=(sdat_stats){0};sdat_avx2_stats tel={1,0,0,0,0,0,0};uint32_t thr[16];size_t d=packed_extract(r,out,n,14,14534u,thr,thr_u32(&sda_table_frodo640,thr),st,&tel);uint16_t a[16];uint8_t sg[16];while(d<n){size_t m=n-d<16?n-d:16;for(size_t i=0;i<m;i++)if(nx640(r,&a[i],&sg[i],st)){SDAT_TEL_FLUSH(&tel);return -2;}lookup16(a,sg,out+d,m,sda_table_frodo640.thresholds,11,&tel);d+=m;}if(st)st->random_bytes=sdat_fast_bytes_used(r);SDAT_TEL_FLUSH(&tel);return 0;}
+int frodo976_sda_sample_n_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,sdat_stats*st){if(!sdat_avx2_cpu_supported())return frodo976_sda_sample_n_scalar(out,n,r,st);if(st)*st=(sdat_stats){0};sdat_avx2_stats tel={1,0,0,0,0,0,0};uint32_t thr[16];size_t d=packed_extract(r,out,n,13,7442u,thr,thr_u32(&sda_table_frodo976,thr),st,&tel);uint16_t a[16];uint8_t sg[16];while(d<n){size_t m=n-d<16?n-d:16;for(size_t i=0;i<m;i++)if(nx976(r,&a[i],&sg[i],st)){SDAT_TEL_FLUSH(&tel);return -2;}lookup16(a,sg,out+d,m,sda_table_frodo976.thresholds,9,&tel);d+=m;}if(st)st->random_bytes=sdat_fast_bytes_used(r);SDAT_TEL_FLUSH(&tel);return 0;}
+int frodo1344_sda_sample_n_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,sdat_stats*st){if(!sdat_avx2_cpu_supported())return frodo1344_sda_sample_n_scalar(out,n,r,st);if(st)*st=(sdat_stats){0};sdat_avx2_stats tel={1,0,0,0,0,0,0};uint32_t thr[16];size_t d=packed_extract(r,out,n,7,102u,thr,thr_u32(&sda_table_frodo1344,thr),st,&tel);uint8_t a[32],sg[32];while(d<n){size_t m=n-d<32?n-d:32;for(size_t i=0;i<m;i++)if(nx1344(r,&a[i],&sg[i],st)){SDAT_TEL_FLUSH(&tel);return -2;}lookup8(a,sg,out+d,m,sda_table_frodo1344.thresholds,4,&tel);d+=m;}if(st)st->random_bytes=sdat_fast_bytes_used(r);SDAT_TEL_FLUSH(&tel);return 0;}
+int frodo_sda_sample_n_fast_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,const sdat_table*t,sdat_stats*st){if(t==&sda_table_frodo640)return frodo640_sda_sample_n_avx2(out,n,r,st);if(t==&sda_table_frodo976)return frodo976_sda_sample_n_avx2(out,n,r,st);if(t==&sda_table_frodo1344)return frodo1344_sda_sample_n_avx2(out,n,r,st);const frodo_gen_kernels*g=frodo_gen_find_avx2(t);if(g&&g->packed)return g->packed(out,n,r,st);return -1;}
+size_t frodo_sda_sample_n_fast_run_avx2(uint16_t*out,size_t n,sdat_bitreader_fast*r,const sdat_table*t,sdat_stats*st){if(!out||!r||!sdat_avx2_cpu_supported())return frodo_sda_sample_n_fast_run(out,n,r,t,st);uint32_t thr[16];size_t d;sdat_avx2_stats tel={1,0,0,0,0,0,0};if(t==&sda_table_frodo640)d=packed_extract(r,out,n,14,14534u,thr,thr_u32(t,thr),st,&tel);else if(t==&sda_table_frodo976)d=packed_extract(r,out,n,13,7442u,thr,thr_u32(t,thr),st,&tel);else if(t==&sda_table_frodo1344)d=packed_extract(r,out,n,7,102u,thr,thr_u32(t,thr),st,&tel);else{const frodo_gen_kernels*g=frodo_gen_find_avx2(t);return g&&g->packed_run?g->packed_run(out,n,r,st):0;}SDAT_TEL_FLUSH(&tel);return d+frodo_sda_sample_n_fast_run(out+d,n-d,r,t,st);}
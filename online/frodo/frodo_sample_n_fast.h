@@ -2,6 +2,8 @@
 #define FRODO_SAMPLE_N_FAST_H
 #include "frodo_sample_n.h"
 #include "sdat_bitreader_fast.h"
+/* Packed-bit samplers: random_bytes is sdat_fast_bytes_used() of the reader,
+ * so the scalar and AVX2 paths report the same count over the same input. */
 int frodo640_sda_sample_n_scalar(uint16_t *out,size_t n,sdat_bitreader_fast *r,sdat_stats *st);
 int frodo976_sda_sample_n_scalar(uint16_t *out,size_t n,sdat_bitreader_fast *r,sdat_stats *st);
 int frodo1344_sda_sample_n_scalar(uint16_t *out,size_t n,sdat_bitreader_fast *r,sdat_stats *st);
@@ -10,6 +12,20 @@ int frodo976_sda_sample_n_avx2(uint16_t *out,size_t n,sdat_bitreader_fast *r,sda
 int frodo1344_sda_sample_n_avx2(uint16_t *out,size_t n,sdat_bitreader_fast *r,sdat_stats *st);
 int frodo_sda_sample_n_fast(uint16_t *out,size_t n,sdat_bitreader_fast *r,const sdat_table *t,sdat_stats *st);
 int frodo_sda_sample_n_fast_avx2(uint16_t *out,size_t n,sdat_bitreader_fast *r,const sdat_table *t,sdat_stats *st);
+int frodo640_sda_word_sample_n(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,sdat_stats *st);
+int frodo976_sda_word_sample_n(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,sdat_stats *st);
+int frodo1344_sda_word_sample_n(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,sdat_stats *st);
+int frodo640_sda_word_sample_n_avx2(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,sdat_stats *st);
+int frodo976_sda_word_sample_n_avx2(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,sdat_stats *st);
+int frodo1344_sda_word_sample_n_avx2(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,sdat_stats *st);
 int frodo_sda_word_sample_n(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,const sdat_table *t,sdat_stats *st);
 int frodo_sda_word_sample_n_avx2(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,const sdat_table *t,sdat_stats *st);
+/* Resumable entry points: write up to n outputs, return how many were written,
+ * and accumulate into st instead of resetting it. The packed form leaves the
+ * reader at the first sample it could not finish (random_bytes is left to the
+ * caller); the word form reports the words it read through consumed. */
+size_t frodo_sda_sample_n_fast_run(uint16_t *out,size_t n,sdat_bitreader_fast *r,const sdat_table *t,sdat_stats *st);
+size_t frodo_sda_sample_n_fast_run_avx2(uint16_t *out,size_t n,sdat_bitreader_fast *r,const sdat_table *t,sdat_stats *st);
+size_t frodo_sda_word_sample_run(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,const sdat_table *t,size_t *consumed,sdat_stats *st);
+size_t frodo_sda_word_sample_run_avx2(uint16_t *out,size_t n,const uint16_t *words,size_t word_count,const sdat_table *t,size_t *consumed,sdat_stats *st);
 #endif
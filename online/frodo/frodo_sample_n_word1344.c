@@ -10,8 +10,8 @@ static inline uint16_t ge1344(uint8_t x) {
     return (uint16_t)((x >= t[0]) + (x >= t[1]) + (x >= t[2]) + (x >= t[3]));
 }
 
-int frodo1344_sda_word_no_stats_branchless(uint16_t *out, size_t n,
-                                            const uint16_t *w, size_t wc) {
+size_t frodo1344_sda_word_run(uint16_t *out, size_t n,
+                              const uint16_t *w, size_t wc, size_t *consumed) {
     const uint16_t *src = w;
     const uint16_t *end = w + wc;
     uint16_t *dst = out;
@@ -24,5 +24,12 @@ int frodo1344_sda_word_no_stats_branchless(uint16_t *out, size_t n,
         *dst = sample;
         dst += accept;
     }
-    return dst == dst_end ? 0 : -2;
+    *consumed = (size_t)(src - w);
+    return (size_t)(dst - out);
+}
+
+int frodo1344_sda_word_no_stats_branchless(uint16_t *out, size_t n,
+                                           const uint16_t *w, size_t wc) {
+    size_t used;
+    return frodo1344_sda_word_run(out, n, w, wc, &used) == n ? 0 : -2;
 }
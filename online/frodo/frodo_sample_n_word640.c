@@ -13,8 +13,8 @@ static inline uint16_t ge640(uint16_t x) {
                       (x >= t[9]) + (x >= t[10]));
 }
 
-int frodo640_sda_word_no_stats(uint16_t *out, size_t n,
-                                const uint16_t *w, size_t wc) {
+size_t frodo640_sda_word_run(uint16_t *out, size_t n,
+                             const uint16_t *w, size_t wc, size_t *consumed) {
     const uint16_t *src = w;
     const uint16_t *end = w + wc;
     uint16_t *dst = out;
@@ -27,5 +27,12 @@ int frodo640_sda_word_no_stats(uint16_t *out, size_t n,
         *dst = sample;
         dst += accept;
     }
-    return dst == dst_end ? 0 : -2;
+    *consumed = (size_t)(src - w);
+    return (size_t)(dst - out);
+}
+
+int frodo640_sda_word_no_stats(uint16_t *out, size_t n,
+                               const uint16_t *w, size_t wc) {
+    size_t used;
+    return frodo640_sda_word_run(out, n, w, wc, &used) == n ? 0 : -2;
 }
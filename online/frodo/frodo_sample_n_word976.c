@@ -11,8 +11,8 @@ static inline uint16_t ge976(uint16_t x) {
                       (x >= t[3]) + (x >= t[4]) + (x >= t[5]) +
                       (x >= t[6]) + (x >= t[7]) + (x >= t[8]));
 }
-int frodo976_sda_word_no_stats(uint16_t *out, size_t n,
-                                const uint16_t *w, size_t wc) {
+size_t frodo976_sda_word_run(uint16_t *out, size_t n,
+                             const uint16_t *w, size_t wc, size_t *consumed) {
     const uint16_t *src = w;
     const uint16_t *end = w + wc;
     uint16_t *dst = out;
@@ -25,5 +25,12 @@ int frodo976_sda_word_no_stats(uint16_t *out, size_t n,
         *dst = sample;
         dst += accept;
     }
-    return dst == dst_end ? 0 : -2;
+    *consumed = (size_t)(src - w);
+    return (size_t)(dst - out);
+}
+
+int frodo976_sda_word_no_stats(uint16_t *out, size_t n,
+                               const uint16_t *w, size_t wc) {
+    size_t used;
+    return frodo976_sda_word_run(out, n, w, wc, &used) == n ? 0 : -2;
 }
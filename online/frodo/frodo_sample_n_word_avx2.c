@@ -0,0 +1,225 @@
+#include "frodo_sample_n_fast.h"
+#include "frodo_kernels_avx2.h"
+#include "frodo_kernels_gen.h"
+#include "sdat_avx2.h"
+
+/* AVX2 word-oriented SDA frontend. Sixteen uniform 16-bit words are loaded per
+ * vector; candidate masking, the `candidate < q` test, the threshold count and
+ * the sign are all computed in registers. Accepted lanes are left-packed per
+ * 128-bit half through a pshufb table, so the output order and the number of
+ * consumed words match frodo*_sda_word_no_stats exactly. The final partial
+ * block is finished by a scalar loop so that no word past the n-th acceptance
+ * is consumed and no store runs past out[n-1]. */
+
+int frodo640_sda_word_no_stats(uint16_t *out, size_t n, const uint16_t *w, size_t wc);
+int frodo976_sda_word_no_stats(uint16_t *out, size_t n, const uint16_t *w, size_t wc);
+int frodo1344_sda_word_no_stats_branchless(uint16_t *out, size_t n, const uint16_t *w, size_t wc);
+
+const uint8_t frodo_pack_shuffle[256][16] __attribute__((aligned(16))) = {
+    {128,128,128,128,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,128,128,128,128,128,128,128,128,128,128,128,128,128,128},
+    {2,3,128,128,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,128,128,128,128,128,128,128,128,128,128,128,128},
+    {4,5,128,128,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,128,128,128,128,128,128,128,128,128,128,128,128},
+    {2,3,4,5,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,128,128,128,128,128,128,128,128,128,128},
+    {6,7,128,128,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,128,128,128,128,128,128,128,128,128,128,128,128},
+    {2,3,6,7,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,128,128,128,128,128,128,128,128,128,128},
+    {4,5,6,7,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,128,128,128,128,128,128,128,128,128,128},
+    {2,3,4,5,6,7,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,128,128,128,128,128,128,128,128},
+    {8,9,128,128,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,8,9,128,128,128,128,128,128,128,128,128,128,128,128},
+    {2,3,8,9,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,8,9,128,128,128,128,128,128,128,128,128,128},
+    {4,5,8,9,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,8,9,128,128,128,128,128,128,128,128,128,128},
+    {2,3,4,5,8,9,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,8,9,128,128,128,128,128,128,128,128},
+    {6,7,8,9,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,8,9,128,128,128,128,128,128,128,128,128,128},
+    {2,3,6,7,8,9,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,8,9,128,128,128,128,128,128,128,128},
+    {4,5,6,7,8,9,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,8,9,128,128,128,128,128,128,128,128},
+    {2,3,4,5,6,7,8,9,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,8,9,128,128,128,128,128,128},
+    {10,11,128,128,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,10,11,128,128,128,128,128,128,128,128,128,128,128,128},
+    {2,3,10,11,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,10,11,128,128,128,128,128,128,128,128,128,128},
+    {4,5,10,11,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,10,11,128,128,128,128,128,128,128,128,128,128},
+    {2,3,4,5,10,11,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,10,11,128,128,128,128,128,128,128,128},
+    {6,7,10,11,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,10,11,128,128,128,128,128,128,128,128,128,128},
+    {2,3,6,7,10,11,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,10,11,128,128,128,128,128,128,128,128},
+    {4,5,6,7,10,11,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,10,11,128,128,128,128,128,128,128,128},
+    {2,3,4,5,6,7,10,11,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,10,11,128,128,128,128,128,128},
+    {8,9,10,11,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,8,9,10,11,128,128,128,128,128,128,128,128,128,128},
+    {2,3,8,9,10,11,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,8,9,10,11,128,128,128,128,128,128,128,128},
+    {4,5,8,9,10,11,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,8,9,10,11,128,128,128,128,128,128,128,128},
+    {2,3,4,5,8,9,10,11,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,8,9,10,11,128,128,128,128,128,128},
+    {6,7,8,9,10,11,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,8,9,10,11,128,128,128,128,128,128,128,128},
+    {2,3,6,7,8,9,10,11,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,8,9,10,11,128,128,128,128,128,128},
+    {4,5,6,7,8,9,10,11,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,8,9,10,11,128,128,128,128,128,128},
+    {2,3,4,5,6,7,8,9,10,11,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,8,9,10,11,128,128,128,128},
+    {12,13,128,128,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,12,13,128,128,128,128,128,128,128,128,128,128,128,128},
+    {2,3,12,13,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,12,13,128,128,128,128,128,128,128,128,128,128},
+    {4,5,12,13,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,12,13,128,128,128,128,128,128,128,128,128,128},
+    {2,3,4,5,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,12,13,128,128,128,128,128,128,128,128},
+    {6,7,12,13,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,12,13,128,128,128,128,128,128,128,128,128,128},
+    {2,3,6,7,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,12,13,128,128,128,128,128,128,128,128},
+    {4,5,6,7,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,12,13,128,128,128,128,128,128,128,128},
+    {2,3,4,5,6,7,12,13,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,12,13,128,128,128,128,128,128},
+    {8,9,12,13,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,8,9,12,13,128,128,128,128,128,128,128,128,128,128},
+    {2,3,8,9,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,8,9,12,13,128,128,128,128,128,128,128,128},
+    {4,5,8,9,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,8,9,12,13,128,128,128,128,128,128,128,128},
+    {2,3,4,5,8,9,12,13,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,8,9,12,13,128,128,128,128,128,128},
+    {6,7,8,9,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,8,9,12,13,128,128,128,128,128,128,128,128},
+    {2,3,6,7,8,9,12,13,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,8,9,12,13,128,128,128,128,128,128},
+    {4,5,6,7,8,9,12,13,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,8,9,12,13,128,128,128,128,128,128},
+    {2,3,4,5,6,7,8,9,12,13,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,8,9,12,13,128,128,128,128},
+    {10,11,12,13,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,10,11,12,13,128,128,128,128,128,128,128,128,128,128},
+    {2,3,10,11,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,10,11,12,13,128,128,128,128,128,128,128,128},
+    {4,5,10,11,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,10,11,12,13,128,128,128,128,128,128,128,128},
+    {2,3,4,5,10,11,12,13,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,10,11,12,13,128,128,128,128,128,128},
+    {6,7,10,11,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,10,11,12,13,128,128,128,128,128,128,128,128},
+    {2,3,6,7,10,11,12,13,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,10,11,12,13,128,128,128,128,128,128},
+    {4,5,6,7,10,11,12,13,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,10,11,12,13,128,128,128,128,128,128},
+    {2,3,4,5,6,7,10,11,12,13,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,10,11,12,13,128,128,128,128},
+    {8,9,10,11,12,13,128,128,128,128,128,128,128,128,128,128},{0,1,8,9,10,11,12,13,128,128,128,128,128,128,128,128},
+    {2,3,8,9,10,11,12,13,128,128,128,128,128,128,128,128},{0,1,2,3,8,9,10,11,12,13,128,128,128,128,128,128},
+    {4,5,8,9,10,11,12,13,128,128,128,128,128,128,128,128},{0,1,4,5,8,9,10,11,12,13,128,128,128,128,128,128},
+    {2,3,4,5,8,9,10,11,12,13,128,128,128,128,128,128},{0,1,2,3,4,5,8,9,10,11,12,13,128,128,128,128},
+    {6,7,8,9,10,11,12,13,128,128,128,128,128,128,128,128},{0,1,6,7,8,9,10,11,12,13,128,128,128,128,128,128},
+    {2,3,6,7,8,9,10,11,12,13,128,128,128,128,128,128},{0,1,2,3,6,7,8,9,10,11,12,13,128,128,128,128},
+    {4,5,6,7,8,9,10,11,12,13,128,128,128,128,128,128},{0,1,4,5,6,7,8,9,10,11,12,13,128,128,128,128},
+    {2,3,4,5,6,7,8,9,10,11,12,13,128,128,128,128},{0,1,2,3,4,5,6,7,8,9,10,11,12,13,128,128},
+    {14,15,128,128,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,14,15,128,128,128,128,128,128,128,128,128,128,128,128},
+    {2,3,14,15,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,14,15,128,128,128,128,128,128,128,128,128,128},
+    {4,5,14,15,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,14,15,128,128,128,128,128,128,128,128,128,128},
+    {2,3,4,5,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,14,15,128,128,128,128,128,128,128,128},
+    {6,7,14,15,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,14,15,128,128,128,128,128,128,128,128,128,128},
+    {2,3,6,7,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,14,15,128,128,128,128,128,128,128,128},
+    {4,5,6,7,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,14,15,128,128,128,128,128,128,128,128},
+    {2,3,4,5,6,7,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,14,15,128,128,128,128,128,128},
+    {8,9,14,15,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,8,9,14,15,128,128,128,128,128,128,128,128,128,128},
+    {2,3,8,9,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,8,9,14,15,128,128,128,128,128,128,128,128},
+    {4,5,8,9,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,8,9,14,15,128,128,128,128,128,128,128,128},
+    {2,3,4,5,8,9,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,8,9,14,15,128,128,128,128,128,128},
+    {6,7,8,9,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,8,9,14,15,128,128,128,128,128,128,128,128},
+    {2,3,6,7,8,9,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,8,9,14,15,128,128,128,128,128,128},
+    {4,5,6,7,8,9,14,15,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,8,9,14,15,128,128,128,128,128,128},
+    {2,3,4,5,6,7,8,9,14,15,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,8,9,14,15,128,128,128,128},
+    {10,11,14,15,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,10,11,14,15,128,128,128,128,128,128,128,128,128,128},
+    {2,3,10,11,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,10,11,14,15,128,128,128,128,128,128,128,128},
+    {4,5,10,11,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,10,11,14,15,128,128,128,128,128,128,128,128},
+    {2,3,4,5,10,11,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,10,11,14,15,128,128,128,128,128,128},
+    {6,7,10,11,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,10,11,14,15,128,128,128,128,128,128,128,128},
+    {2,3,6,7,10,11,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,10,11,14,15,128,128,128,128,128,128},
+    {4,5,6,7,10,11,14,15,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,10,11,14,15,128,128,128,128,128,128},
+    {2,3,4,5,6,7,10,11,14,15,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,10,11,14,15,128,128,128,128},
+    {8,9,10,11,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,8,9,10,11,14,15,128,128,128,128,128,128,128,128},
+    {2,3,8,9,10,11,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,8,9,10,11,14,15,128,128,128,128,128,128},
+    {4,5,8,9,10,11,14,15,128,128,128,128,128,128,128,128},{0,1,4,5,8,9,10,11,14,15,128,128,128,128,128,128},
+    {2,3,4,5,8,9,10,11,14,15,128,128,128,128,128,128},{0,1,2,3,4,5,8,9,10,11,14,15,128,128,128,128},
+    {6,7,8,9,10,11,14,15,128,128,128,128,128,128,128,128},{0,1,6,7,8,9,10,11,14,15,128,128,128,128,128,128},
+    {2,3,6,7,8,9,10,11,14,15,128,128,128,128,128,128},{0,1,2,3,6,7,8,9,10,11,14,15,128,128,128,128},
+    {4,5,6,7,8,9,10,11,14,15,128,128,128,128,128,128},{0,1,4,5,6,7,8,9,10,11,14,15,128,128,128,128},
+    {2,3,4,5,6,7,8,9,10,11,14,15,128,128,128,128},{0,1,2,3,4,5,6,7,8,9,10,11,14,15,128,128},
+    {12,13,14,15,128,128,128,128,128,128,128,128,128,128,128,128},{0,1,12,13,14,15,128,128,128,128,128,128,128,128,128,128},
+    {2,3,12,13,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,2,3,12,13,14,15,128,128,128,128,128,128,128,128},
+    {4,5,12,13,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,4,5,12,13,14,15,128,128,128,128,128,128,128,128},
+    {2,3,4,5,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,4,5,12,13,14,15,128,128,128,128,128,128},
+    {6,7,12,13,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,6,7,12,13,14,15,128,128,128,128,128,128,128,128},
+    {2,3,6,7,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,6,7,12,13,14,15,128,128,128,128,128,128},
+    {4,5,6,7,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,4,5,6,7,12,13,14,15,128,128,128,128,128,128},
+    {2,3,4,5,6,7,12,13,14,15,128,128,128,128,128,128},{0,1,2,3,4,5,6,7,12,13,14,15,128,128,128,128},
+    {8,9,12,13,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,8,9,12,13,14,15,128,128,128,128,128,128,128,128},
+    {2,3,8,9,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,8,9,12,13,14,15,128,128,128,128,128,128},
+    {4,5,8,9,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,4,5,8,9,12,13,14,15,128,128,128,128,128,128},
+    {2,3,4,5,8,9,12,13,14,15,128,128,128,128,128,128},{0,1,2,3,4,5,8,9,12,13,14,15,128,128,128,128},
+    {6,7,8,9,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,6,7,8,9,12,13,14,15,128,128,128,128,128,128},
+    {2,3,6,7,8,9,12,13,14,15,128,128,128,128,128,128},{0,1,2,3,6,7,8,9,12,13,14,15,128,128,128,128},
+    {4,5,6,7,8,9,12,13,14,15,128,128,128,128,128,128},{0,1,4,5,6,7,8,9,12,13,14,15,128,128,128,128},
+    {2,3,4,5,6,7,8,9,12,13,14,15,128,128,128,128},{0,1,2,3,4,5,6,7,8,9,12,13,14,15,128,128},
+    {10,11,12,13,14,15,128,128,128,128,128,128,128,128,128,128},{0,1,10,11,12,13,14,15,128,128,128,128,128,128,128,128},
+    {2,3,10,11,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,2,3,10,11,12,13,14,15,128,128,128,128,128,128},
+    {4,5,10,11,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,4,5,10,11,12,13,14,15,128,128,128,128,128,128},
+    {2,3,4,5,10,11,12,13,14,15,128,128,128,128,128,128},{0,1,2,3,4,5,10,11,12,13,14,15,128,128,128,128},
+    {6,7,10,11,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,6,7,10,11,12,13,14,15,128,128,128,128,128,128},
+    {2,3,6,7,10,11,12,13,14,15,128,128,128,128,128,128},{0,1,2,3,6,7,10,11,12,13,14,15,128,128,128,128},
+    {4,5,6,7,10,11,12,13,14,15,128,128,128,128,128,128},{0,1,4,5,6,7,10,11,12,13,14,15,128,128,128,128},
+    {2,3,4,5,6,7,10,11,12,13,14,15,128,128,128,128},{0,1,2,3,4,5,6,7,10,11,12,13,14,15,128,128},
+    {8,9,10,11,12,13,14,15,128,128,128,128,128,128,128,128},{0,1,8,9,10,11,12,13,14,15,128,128,128,128,128,128},
+    {2,3,8,9,10,11,12,13,14,15,128,128,128,128,128,128},{0,1,2,3,8,9,10,11,12,13,14,15,128,128,128,128},
+    {4,5,8,9,10,11,12,13,14,15,128,128,128,128,128,128},{0,1,4,5,8,9,10,11,12,13,14,15,128,128,128,128},
+    {2,3,4,5,8,9,10,11,12,13,14,15,128,128,128,128},{0,1,2,3,4,5,8,9,10,11,12,13,14,15,128,128},
+    {6,7,8,9,10,11,12,13,14,15,128,128,128,128,128,128},{0,1,6,7,8,9,10,11,12,13,14,15,128,128,128,128},
+    {2,3,6,7,8,9,10,11,12,13,14,15,128,128,128,128},{0,1,2,3,6,7,8,9,10,11,12,13,14,15,128,128},
+    {4,5,6,7,8,9,10,11,12,13,14,15,128,128,128,128},{0,1,4,5,6,7,8,9,10,11,12,13,14,15,128,128},
+    {2,3,4,5,6,7,8,9,10,11,12,13,14,15,128,128},{0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15}
+};
+const uint8_t frodo_pack_count[256] = {
+    0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,
+    1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
+    1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
+    2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
+    1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
+    2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
+    2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
+    3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,4,5,5,6,5,6,6,7,5,6,6,7,6,7,7,8
+};
+
+static size_t run640(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *used, sdat_stats *st) {
+    uint64_t nb;
+    size_t k = word_kernel(out, n, w, wc, 0x3fffu, 14, 14534u, sda_table_frodo640.thresholds, 11, used, &nb);
+    word_account(k, *used, nb, 14, st);
+    return k;
+}
+
+static size_t run976(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *used, sdat_stats *st) {
+    uint64_t nb;
+    size_t k = word_kernel(out, n, w, wc, 0x1fffu, 13, 7442u, sda_table_frodo976.thresholds, 9, used, &nb);
+    word_account(k, *used, nb, 13, st);
+    return k;
+}
+
+static size_t run1344(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *used, sdat_stats *st) {
+    const uint8_t *t8 = sda_table_frodo1344.thresholds;
+    const uint16_t thr[4] = {t8[0], t8[1], t8[2], t8[3]};
+    uint64_t nb;
+    size_t k = word_kernel(out, n, w, wc, 0x007fu, 7, 102u, thr, 4, used, &nb);
+    word_account(k, *used, nb, 7, st);
+    return k;
+}
+
+int frodo640_sda_word_sample_n_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo640_sda_word_sample_n(out, n, w, wc, st);
+    size_t used;
+    if (st) *st = (sdat_stats){0};
+    return run640(out, n, w, wc, &used, st) == n ? 0 : -2;
+}
+
+int frodo976_sda_word_sample_n_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo976_sda_word_sample_n(out, n, w, wc, st);
+    size_t used;
+    if (st) *st = (sdat_stats){0};
+    return run976(out, n, w, wc, &used, st) == n ? 0 : -2;
+}
+
+int frodo1344_sda_word_sample_n_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo1344_sda_word_sample_n(out, n, w, wc, st);
+    size_t used;
+    if (st) *st = (sdat_stats){0};
+    return run1344(out, n, w, wc, &used, st) == n ? 0 : -2;
+}
+
+int frodo_sda_word_sample_n_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, const sdat_table *t, sdat_stats *st) {
+    if (t == &sda_table_frodo640) return frodo640_sda_word_sample_n_avx2(out, n, w, wc, st);
+    if (t == &sda_table_frodo976) return frodo976_sda_word_sample_n_avx2(out, n, w, wc, st);
+    if (t == &sda_table_frodo1344) return frodo1344_sda_word_sample_n_avx2(out, n, w, wc, st);
+    const frodo_gen_kernels *g = frodo_gen_find_avx2(t);
+    if (g && g->word) return g->word(out, n, w, wc, st);
+    return -1;
+}
+
+size_t frodo_sda_word_sample_run_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, const sdat_table *t,
+                                      size_t *consumed, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_sda_word_sample_run(out, n, w, wc, t, consumed, st);
+    size_t used = 0, k = 0;
+    if (t == &sda_table_frodo640) k = run640(out, n, w, wc, &used, st);
+    else if (t == &sda_table_frodo976) k = run976(out, n, w, wc, &used, st);
+    else if (t == &sda_table_frodo1344) k = run1344(out, n, w, wc, &used, st);
+    else {
+        const frodo_gen_kernels *g = frodo_gen_find_avx2(t);
+        if (g && g->word_run) return g->word_run(out, n, w, wc, consumed, st);
+    }
+    if (consumed) *consumed = used;
+    return k;
+}
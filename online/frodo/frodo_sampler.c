@@ -1,5 +1,6 @@
 #include "frodo_sampler.h"
 #include "sdat_avx2.h"
+#include <pthread.h>
 #include <string.h>
 
 static frodo_sampler_params params[] = {
@@ -8,47 +9,112 @@ static frodo_sampler_params params[] = {
     {FRODO_PARAM_1344,"frodo1344",&original_cdt_table_frodo1344,&sda_table_frodo1344,102u,7u,7u,0x007fu,0,7,0,4,6,10752},
 };
 
+/* The table-derived pointers are not constant expressions; they are filled in
+ * exactly once so concurrent callers never write the shared array. */
+static pthread_once_t params_once=PTHREAD_ONCE_INIT;
+static void params_init(void){
+    for(size_t i=0;i<sizeof(params)/sizeof(params[0]);i++){
+        params[i].original_cdf=(const uint16_t *)params[i].original_table->thresholds;
+        params[i].sda_thresholds=params[i].sda_table->thresholds;
+    }
+}
 const frodo_sampler_params *frodo_get_sampler_params(frodo_param_id id){
     if(id<0 || (size_t)id>=sizeof(params)/sizeof(params[0]))return 0;
-    frodo_sampler_params *p=&params[id];
-    p->original_cdf=(const uint16_t *)p->original_table->thresholds;
-    p->sda_thresholds=p->sda_table->thresholds;
-    return p;
+    pthread_once(&params_once,params_init);
+    return &params[id];
 }
 const char *frodo_sampler_kind_name(frodo_sampler_kind k){return k==FRODO_SAMPLER_ORIGINAL_CDT?"original-cdt":k==FRODO_SAMPLER_SDA_CDT?"sda-cdt":"unknown";}
-const char *frodo_backend_name(frodo_backend b){return b==FRODO_BACKEND_REFERENCE?"reference":b==FRODO_BACKEND_AVX2?"avx2":"unknown";}
+const char *frodo_backend_name(frodo_backend b){return b==FRODO_BACKEND_REFERENCE?"reference":b==FRODO_BACKEND_AVX2?"avx2":b==FRODO_BACKEND_AUTO?"auto":"unknown";}
 const char *frodo_frontend_name(frodo_frontend f){return f==FRODO_FRONTEND_ORIGINAL_WORD?"original-word":f==FRODO_FRONTEND_PACKED_BIT?"packed-bit":f==FRODO_FRONTEND_WORD_ORIENTED?"word-oriented":"unknown";}
 const char *frodo_implementation_label(frodo_sampler_kind k,frodo_backend b,frodo_frontend f){
+    b=frodo_resolve_backend(b);
     if(k==FRODO_SAMPLER_ORIGINAL_CDT)return b==FRODO_BACKEND_AVX2?"original-avx2":"original-reference";
     if(f==FRODO_FRONTEND_PACKED_BIT)return b==FRODO_BACKEND_AVX2?"sda-packed-avx2":"sda-packed-reference";
     if(f==FRODO_FRONTEND_WORD_ORIENTED)return b==FRODO_BACKEND_AVX2?"sda-word-avx2":"sda-word-reference";
     return "invalid";
 }
-int frodo_backend_available(frodo_backend b){return b==FRODO_BACKEND_REFERENCE || (b==FRODO_BACKEND_AVX2 && sdat_avx2_cpu_supported());}
-int frodo_sample_n_dispatch(frodo_sampler_kind kind,frodo_backend backend,frodo_frontend frontend,
-                            frodo_param_id param,uint16_t*out,size_t n,
-                            const uint8_t*packed_source,size_t packed_source_len,
-                            const uint16_t*word_source,size_t word_count,
-                            frodo_sampler_stats*fs){
-    const frodo_sampler_params*p=frodo_get_sampler_params(param); if(!p||!out)return -1;
-    if(!frodo_backend_available(backend))return -9;
+int frodo_backend_available(frodo_backend b){return b==FRODO_BACKEND_REFERENCE || b==FRODO_BACKEND_AUTO || (b==FRODO_BACKEND_AVX2 && sdat_avx2_cpu_supported());}
+frodo_backend frodo_resolve_backend(frodo_backend b){return b==FRODO_BACKEND_AUTO?(sdat_avx2_cpu_supported()?FRODO_BACKEND_AVX2:FRODO_BACKEND_REFERENCE):b;}
+
+const frodo_kernel_table *frodo_kernels(frodo_backend b){
+    b=frodo_resolve_backend(b);
+    if(b==FRODO_BACKEND_REFERENCE)return &frodo_gen_kernel_table_reference;
+    if(b==FRODO_BACKEND_AVX2&&sdat_avx2_cpu_supported())return &frodo_gen_kernel_table_avx2;
+    return 0;
+}
+static int plan_original(const frodo_sampler_plan*pl,uint16_t*out,size_t n,const uint8_t*packed_source,size_t packed_source_len,const uint16_t*word_source,size_t word_count,frodo_sampler_stats*fs){
+    (void)packed_source;(void)packed_source_len;
+    if(!out)return -1;
+    if(fs)*fs=(frodo_sampler_stats){0};
+    if(!word_source||word_count<n)return -2;
+    memcpy(out,word_source,n*sizeof *out);
+    return pl->original(out,n);
+}
+static int plan_packed(const frodo_sampler_plan*pl,uint16_t*out,size_t n,const uint8_t*packed_source,size_t packed_source_len,const uint16_t*word_source,size_t word_count,frodo_sampler_stats*fs){
+    (void)word_source;(void)word_count;
+    if(!out)return -1;
+    if(fs)*fs=(frodo_sampler_stats){0};
+    if(!packed_source)return -4;
+    sdat_bitreader_fast br; sdat_bitreader_fast_init(&br,packed_source,packed_source_len);
+    int rc=pl->packed(out,n,&br,fs?&fs->stats:0);
+    if(fs)fs->reader=br;
+    return rc;
+}
+static int plan_word(const frodo_sampler_plan*pl,uint16_t*out,size_t n,const uint8_t*packed_source,size_t packed_source_len,const uint16_t*word_source,size_t word_count,frodo_sampler_stats*fs){
+    (void)packed_source;(void)packed_source_len;
+    if(!out)return -1;
     if(fs)*fs=(frodo_sampler_stats){0};
+    if(!word_source)return -5;
+    return pl->word(out,n,word_source,word_count,fs?&fs->stats:0);
+}
+
+int frodo_sampler_plan_init(frodo_sampler_plan*pl,frodo_sampler_kind kind,frodo_backend backend,frodo_frontend frontend,frodo_param_id param){
+    const frodo_sampler_params*p=frodo_get_sampler_params(param); if(!pl||!p)return -1;
+    const frodo_kernel_table*kt=frodo_kernels(backend); if(!kt)return -9;
+    *pl=(frodo_sampler_plan){0};
+    pl->kind=kind; pl->backend=kt->backend; pl->frontend=frontend; pl->params=p; pl->kernels=kt;
+    pl->label=frodo_implementation_label(kind,kt->backend,frontend);
     if(kind==FRODO_SAMPLER_ORIGINAL_CDT){
-        if(frontend!=FRODO_FRONTEND_ORIGINAL_WORD||!word_source||word_count<n)return -2;
-        memcpy(out,word_source,n*sizeof *out);
-        return backend==FRODO_BACKEND_AVX2?frodo_original_sample_n_avx2(out,n,p->original_table):frodo_original_sample_n(out,n,p->original_table);
+        if(frontend!=FRODO_FRONTEND_ORIGINAL_WORD)return -2;
+        pl->table=p->original_table; pl->original=kt->original[param]; pl->kernel=plan_original;
+        pl->attempt_bits=16; pl->accept_num=pl->accept_den=1;
+        return 0;
     }
     if(kind!=FRODO_SAMPLER_SDA_CDT)return -3;
+    pl->table=p->sda_table; pl->accept_num=p->sda_q; pl->accept_den=1u<<p->sda_candidate_bits;
     if(frontend==FRODO_FRONTEND_PACKED_BIT){
-        if(!packed_source)return -4;
-        sdat_bitreader_fast br; sdat_bitreader_fast_init(&br,packed_source,packed_source_len);
-        int rc=backend==FRODO_BACKEND_AVX2?frodo_sda_sample_n_fast_avx2(out,n,&br,p->sda_table,fs?&fs->stats:0):frodo_sda_sample_n_fast(out,n,&br,p->sda_table,fs?&fs->stats:0);
-        if(fs)fs->reader=br;
-        return rc;
+        pl->packed=kt->packed[param]; pl->kernel=plan_packed;
+        pl->attempt_bits=p->sda_candidate_bits; pl->sign_bits=1;
+        return 0;
     }
     if(frontend==FRODO_FRONTEND_WORD_ORIENTED){
-        if(!word_source)return -5;
-        return backend==FRODO_BACKEND_AVX2?frodo_sda_word_sample_n_avx2(out,n,word_source,word_count,p->sda_table,fs?&fs->stats:0):frodo_sda_word_sample_n(out,n,word_source,word_count,p->sda_table,fs?&fs->stats:0);
+        pl->word=kt->word[param]; pl->kernel=plan_word;
+        pl->attempt_bits=16;
+        return 0;
     }
     return -6;
 }
+int frodo_sampler_plan_sample_n(const frodo_sampler_plan*pl,uint16_t*out,size_t n,
+                                const uint8_t*packed_source,size_t packed_source_len,
+                                const uint16_t*word_source,size_t word_count,
+                                frodo_sampler_stats*fs){
+    if(!pl||!pl->kernel)return -1;
+    return pl->kernel(pl,out,n,packed_source,packed_source_len,word_source,word_count,fs);
+}
+size_t frodo_sampler_plan_expected_bytes(const frodo_sampler_plan*pl,size_t n){
+    if(!pl||!pl->accept_num)return 0;
+    uint64_t bits=(uint64_t)n*pl->attempt_bits*pl->accept_den/pl->accept_num+(uint64_t)n*pl->sign_bits;
+    return (size_t)((bits+7u)/8u);
+}
+int frodo_sample_n_dispatch(frodo_sampler_kind kind,frodo_backend backend,frodo_frontend frontend,
+                            frodo_param_id param,uint16_t*out,size_t n,
+                            const uint8_t*packed_source,size_t packed_source_len,
+                            const uint16_t*word_source,size_t word_count,
+                            frodo_sampler_stats*fs){
+    if(!frodo_get_sampler_params(param)||!out)return -1;
+    if(!frodo_backend_available(backend))return -9;
+    if(fs)*fs=(frodo_sampler_stats){0};
+    frodo_sampler_plan pl; int rc=frodo_sampler_plan_init(&pl,kind,backend,frontend,param);
+    if(rc)return rc;
+    return frodo_sampler_plan_sample_n(&pl,out,n,packed_source,packed_source_len,word_source,word_count,fs);
+}
@@ -1,9 +1,13 @@
 #ifndef FRODO_SAMPLER_H
 #define FRODO_SAMPLER_H
 #include "frodo_sample_n_fast.h"
+#include "sdat_prg.h"
 
-typedef enum { FRODO_PARAM_640, FRODO_PARAM_976, FRODO_PARAM_1344 } frodo_param_id;
-typedef enum { FRODO_BACKEND_REFERENCE, FRODO_BACKEND_AVX2 } frodo_backend;
+typedef enum { FRODO_PARAM_640, FRODO_PARAM_976, FRODO_PARAM_1344, FRODO_PARAM_COUNT } frodo_param_id;
+/* FRODO_BACKEND_AUTO resolves to the best backend the CPU (and
+ * SDAT_FORCE_BACKEND, see sdat_cpu.h) allows; plans and streams store the
+ * resolved backend. */
+typedef enum { FRODO_BACKEND_REFERENCE, FRODO_BACKEND_AVX2, FRODO_BACKEND_AUTO } frodo_backend;
 typedef enum { FRODO_SAMPLER_ORIGINAL_CDT, FRODO_SAMPLER_SDA_CDT } frodo_sampler_kind;
 typedef enum { FRODO_FRONTEND_ORIGINAL_WORD, FRODO_FRONTEND_PACKED_BIT, FRODO_FRONTEND_WORD_ORIENTED } frodo_frontend;
 
@@ -29,7 +33,61 @@ typedef struct {
     sdat_bitreader_fast reader;
 } frodo_sampler_stats;
 
+typedef int (*frodo_packed_kernel)(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st);
+typedef int (*frodo_word_kernel)(uint16_t *out, size_t n, const uint16_t *words, size_t word_count, sdat_stats *st);
+typedef int (*frodo_original_kernel)(uint16_t *samples, size_t n);
+typedef size_t (*frodo_packed_run_kernel)(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st);
+typedef size_t (*frodo_word_run_kernel)(uint16_t *out, size_t n, const uint16_t *words, size_t word_count,
+                                        size_t *consumed, sdat_stats *st);
+
+/* Kernel entry points of one backend, indexed by frodo_param_id. The tables
+ * are emitted with the generated kernels by
+ * offline/scripts/generate_online_kernels.py from the table manifest, so
+ * dispatch runs the constant-specialized code; they are static and immutable.
+ * frodo_kernels resolves a backend once per call site instead of probing the
+ * CPU per sample call. The AVX2 entries keep their cached capability guard for
+ * direct callers. */
+typedef struct {
+    frodo_backend backend;
+    frodo_original_kernel original[FRODO_PARAM_COUNT];
+    frodo_packed_kernel packed[FRODO_PARAM_COUNT];
+    frodo_packed_run_kernel packed_run[FRODO_PARAM_COUNT];
+    frodo_word_kernel word[FRODO_PARAM_COUNT];
+    frodo_word_run_kernel word_run[FRODO_PARAM_COUNT];
+} frodo_kernel_table;
+extern const frodo_kernel_table frodo_gen_kernel_table_reference;
+extern const frodo_kernel_table frodo_gen_kernel_table_avx2;
+
+/* Immutable once built: a plan resolves (kind, backend, frontend, param) to its
+ * kernel and tables up front, so frodo_sampler_plan_sample_n performs no
+ * table lookups, pointer-compare chains or CPU probes. Plans may be shared
+ * between threads. Source sizing: an attempt draws attempt_bits bits and is
+ * accepted with probability accept_num / accept_den; an accepted attempt
+ * draws sign_bits more. */
+typedef struct frodo_sampler_plan frodo_sampler_plan;
+typedef int (*frodo_plan_kernel)(const frodo_sampler_plan *plan, uint16_t *out, size_t n,
+                                 const uint8_t *packed_source, size_t packed_source_len,
+                                 const uint16_t *word_source, size_t word_count, frodo_sampler_stats *stats);
+struct frodo_sampler_plan {
+    frodo_sampler_kind kind;
+    frodo_backend backend;
+    frodo_frontend frontend;
+    const frodo_sampler_params *params;
+    const sdat_table *table;
+    const char *label;
+    const frodo_kernel_table *kernels;
+    frodo_plan_kernel kernel;
+    frodo_packed_kernel packed;
+    frodo_word_kernel word;
+    frodo_original_kernel original;
+    unsigned attempt_bits, sign_bits;
+    uint32_t accept_num, accept_den;
+};
+
 const frodo_sampler_params *frodo_get_sampler_params(frodo_param_id id);
+frodo_backend frodo_resolve_backend(frodo_backend backend);
+/* Returns 0 when the backend is unavailable. */
+const frodo_kernel_table *frodo_kernels(frodo_backend backend);
 const char *frodo_sampler_kind_name(frodo_sampler_kind kind);
 const char *frodo_backend_name(frodo_backend backend);
 const char *frodo_frontend_name(frodo_frontend frontend);
@@ -40,4 +98,89 @@ int frodo_sample_n_dispatch(frodo_sampler_kind kind, frodo_backend backend, frod
                             const uint8_t *packed_source, size_t packed_source_len,
                             const uint16_t *word_source, size_t word_count,
                             frodo_sampler_stats *stats);
+/* Returns 0 or the frodo_sample_n_dispatch error code for the combination. */
+int frodo_sampler_plan_init(frodo_sampler_plan *plan, frodo_sampler_kind kind, frodo_backend backend,
+                            frodo_frontend frontend, frodo_param_id param);
+int frodo_sampler_plan_sample_n(const frodo_sampler_plan *plan, uint16_t *out, size_t n,
+                                const uint8_t *packed_source, size_t packed_source_len,
+                                const uint16_t *word_source, size_t word_count,
+                                frodo_sampler_stats *stats);
+/* Expected source bytes for n outputs (packed_source bytes or 2 * words). */
+size_t frodo_sampler_plan_expected_bytes(const frodo_sampler_plan *plan, size_t n);
+/* Multi-threaded frodo_sample_n_dispatch with bit-identical outputs and stats.
+ * Word-oriented SDA uses a two-pass count / exclusive-scan / write split of
+ * word_source; original-word splits the outputs. Packed-bit input has no
+ * position-independent split and runs single-threaded. threads == 0 uses the
+ * online CPU count; small inputs use fewer threads. */
+int frodo_sample_n_dispatch_parallel(frodo_sampler_kind kind, frodo_backend backend, frodo_frontend frontend,
+                                     frodo_param_id param, uint16_t *out, size_t n,
+                                     const uint8_t *packed_source, size_t packed_source_len,
+                                     const uint16_t *word_source, size_t word_count,
+                                     frodo_sampler_stats *stats, unsigned threads);
+
+/* Resumable sampler context. Randomness arrives either through
+ * frodo_stream_push (zlib-style: *in_used reports how much of `in` was taken,
+ * the caller resumes from in + *in_used) or through a refill callback pulled
+ * in FRODO_STREAM_CHUNK_BYTES blocks by frodo_stream_sample_n. Running out of
+ * input never loses work: cursor, unread bits and an unfinished sample stay in
+ * the context and the next call continues where this one stopped. Concatenated
+ * over any split of the same byte stream, outputs equal one
+ * frodo_sample_n_dispatch call over the whole stream. stats accumulate; for
+ * packed-bit input random_bytes counts the stream bytes holding consumed bits. */
+#define FRODO_STREAM_CHUNK_BYTES 2048u
+typedef struct {
+    const frodo_sampler_params *params;
+    frodo_sampler_kind kind;
+    frodo_backend backend;
+    frodo_frontend frontend;
+    const frodo_kernel_table *kernels;
+    sdat_stats stats;
+    uint64_t bits_consumed;
+    size_t lead;
+    unsigned skip;
+    sdat_randombytes_fn refill;
+    void *refill_ctx;
+    size_t refill_pos, refill_len;
+    uint16_t stage[(FRODO_STREAM_CHUNK_BYTES + 16u) / 2u] __attribute__((aligned(32)));
+    uint8_t refill_buf[FRODO_STREAM_CHUNK_BYTES];
+} frodo_stream;
+
+int frodo_stream_init(frodo_stream *s, frodo_sampler_kind kind, frodo_backend backend, frodo_frontend frontend,
+                      frodo_param_id param);
+void frodo_stream_set_refill(frodo_stream *s, sdat_randombytes_fn refill, void *ctx);
+size_t frodo_stream_push(frodo_stream *s, const uint8_t *in, size_t in_len, size_t *in_used, uint16_t *out, size_t n);
+size_t frodo_stream_sample_n(frodo_stream *s, uint16_t *out, size_t n);
+void frodo_stream_wipe(frodo_stream *s);
+
+/* Seed-driven form of frodo_sample_n_dispatch: a frodo_stream refilled from
+ * the PRG, so the PRG stream is expanded in FRODO_STREAM_CHUNK_BYTES pieces
+ * and each piece is sampled while it is still in L1. Outputs and stats are
+ * those of frodo_sample_n_dispatch over the same stream (words little-endian)
+ * with the packed-bit random_bytes rule above; stats->reader is left zeroed. */
+int frodo_sample_n_from_seed(frodo_sampler_kind kind, frodo_backend backend, frodo_frontend frontend,
+                             frodo_param_id param, uint16_t *out, size_t n,
+                             sdat_prg_kind prg, const uint8_t *seed, size_t seed_len,
+                             frodo_sampler_stats *stats);
+
+/* Counter-based jobs for sharded sampling. Output i of the job (key, stream)
+ * is output i % FRODO_COUNTER_CHUNK of a frodo_stream refilled from chunk
+ * i / FRODO_COUNTER_CHUNK of the counter-based PRG (sdat_prg_init_chunk), so
+ * out[0..n) = outputs first .. first + n - 1 can be produced without the rest
+ * of the job, and splitting a job into shards at any boundaries reproduces
+ * one call over the whole range. A range starting inside a chunk samples and
+ * discards the earlier outputs of that chunk. Stats cover everything sampled,
+ * so they add up across shards whose boundaries are multiples of
+ * FRODO_COUNTER_CHUNK. prg is AES128_CTR, CHACHA20 or PHILOX4X32 with its
+ * sdat_prg_init_stream key; -1 otherwise. */
+#define FRODO_COUNTER_CHUNK 4096u
+int frodo_sample_n_counter(frodo_sampler_kind kind, frodo_backend backend, frodo_frontend frontend,
+                           frodo_param_id param, uint16_t *out, uint64_t first, size_t n,
+                           sdat_prg_kind prg, const uint8_t *key, size_t key_len, uint64_t stream,
+                           frodo_sampler_stats *stats);
+/* frodo_sample_n_counter on up to `threads` threads (0: online CPUs), split at
+ * chunk boundaries; outputs and stats equal the single-threaded call. */
+int frodo_sample_n_counter_parallel(frodo_sampler_kind kind, frodo_backend backend, frodo_frontend frontend,
+                                    frodo_param_id param, uint16_t *out, uint64_t first, size_t n,
+                                    sdat_prg_kind prg, const uint8_t *key, size_t key_len, uint64_t stream,
+                                    frodo_sampler_stats *stats, unsigned threads);
 #endif
@@ -0,0 +1,128 @@
+#include "frodo_sampler.h"
+#include "sdat_threads.h"
+#include <string.h>
+
+#define MIN_WORDS_PER_THREAD 4096u
+
+typedef struct {
+    const frodo_sampler_params*p; const frodo_kernel_table*kt;
+    const uint16_t*w; size_t begin,end;
+    uint16_t*out; size_t n,off;
+    size_t count,produced,used; int rc;
+    const void*job; sdat_stats st;
+} part;
+
+static void run_parts(void*(*fn)(void*),part*parts,unsigned k){ sdat_run_parts(fn,parts,sizeof *parts,k); }
+
+static void*count_part(void*a){
+    part*t=a; const uint16_t*w=t->w+t->begin; size_t len=t->end-t->begin,c=0;
+    const uint16_t mask=t->p->sda_candidate_mask,q=t->p->sda_q;
+    for(size_t i=0;i<len;i++)c+=(size_t)((uint16_t)(w[i]&mask)<q);
+    t->count=c; return 0;
+}
+
+/* The limit is the part's own acceptance count, so no kernel store (vector
+ * or scalar) reaches into the next part's output range. */
+static void*write_word_part(void*a){
+    part*t=a; t->produced=t->used=0;
+    if(t->off>=t->n)return 0;
+    size_t len=t->end-t->begin,lim=t->n-t->off<t->count?t->n-t->off:t->count;
+    t->produced=t->kt->word_run[t->p->id](t->out+t->off,lim,t->w+t->begin,len,&t->used,0);
+    if(t->off+t->count<t->n)t->used=len;
+    return 0;
+}
+
+static void*write_original_part(void*a){
+    part*t=a; size_t m=t->end-t->begin;
+    memcpy(t->out+t->begin,t->w+t->begin,m*sizeof *t->out);
+    t->rc=t->kt->original[t->p->id](t->out+t->begin,m);
+    return 0;
+}
+
+static unsigned pick_threads(unsigned threads,size_t work){
+    threads=sdat_thread_count(threads);
+    size_t cap=work/MIN_WORDS_PER_THREAD;
+    if(cap<threads)threads=cap?(unsigned)cap:1u;
+    return threads;
+}
+
+static void split(part*parts,unsigned k,size_t total,const part*proto){
+    size_t step=(total/k+15u)&~(size_t)15u;
+    for(unsigned i=0;i<k;i++){parts[i]=*proto;parts[i].begin=i*step<total?i*step:total;parts[i].end=(i+1)*step<total&&i+1<k?(i+1)*step:total;}
+}
+
+/* Pass 1 counts acceptances per part of a window sized for n outputs, an
+ * exclusive scan turns the counts into output offsets, and pass 2 lets every
+ * part write its accepted samples at its offset. Words past the window are
+ * only read when the window falls short, sequentially, as the single call would. */
+static int parallel_word(const frodo_sampler_params*p,const frodo_kernel_table*kt,uint16_t*out,size_t n,const uint16_t*w,size_t wc,sdat_stats*st,unsigned threads){
+    uint64_t expect=((uint64_t)n<<p->sda_candidate_bits)/p->sda_q;
+    size_t window=(size_t)(expect+expect/16u+4096u); if(window>wc)window=wc;
+    unsigned k=pick_threads(threads,window);
+    part parts[SDAT_MAX_THREADS],proto={0}; proto.p=p; proto.kt=kt; proto.w=w; proto.out=out; proto.n=n;
+    split(parts,k,window,&proto);
+    run_parts(count_part,parts,k);
+    size_t off=0; for(unsigned i=0;i<k;i++){parts[i].off=off;off+=parts[i].count;}
+    run_parts(write_word_part,parts,k);
+    size_t done=0,consumed=0;
+    for(unsigned i=0;i<k;i++){done+=parts[i].produced;consumed+=parts[i].used;}
+    if(done<n){size_t used;done+=kt->word_run[p->id](out+done,n-done,w+window,wc-window,&used,0);consumed+=used;}
+    /* Word-frontend accounting, as in the single-threaded call. */
+    if(st){st->attempts=consumed;st->rejections=consumed-done;st->random_bits=(uint64_t)consumed*p->sda_candidate_bits+done;st->random_bytes=(uint64_t)consumed*2u;}
+    return done==n?0:-2;
+}
+
+int frodo_sample_n_dispatch_parallel(frodo_sampler_kind kind,frodo_backend backend,frodo_frontend frontend,
+                                     frodo_param_id param,uint16_t*out,size_t n,
+                                     const uint8_t*packed_source,size_t packed_source_len,
+                                     const uint16_t*word_source,size_t word_count,
+                                     frodo_sampler_stats*fs,unsigned threads){
+    const frodo_sampler_params*p=frodo_get_sampler_params(param); if(!p||!out)return -1;
+    const frodo_kernel_table*kt=frodo_kernels(backend); if(!kt)return -9;
+    int word=kind==FRODO_SAMPLER_SDA_CDT&&frontend==FRODO_FRONTEND_WORD_ORIENTED&&word_source;
+    int original=kind==FRODO_SAMPLER_ORIGINAL_CDT&&frontend==FRODO_FRONTEND_ORIGINAL_WORD&&word_source&&word_count>=n;
+    if(!word&&!original)return frodo_sample_n_dispatch(kind,backend,frontend,param,out,n,packed_source,packed_source_len,word_source,word_count,fs);
+    if(fs)*fs=(frodo_sampler_stats){0};
+    if(word)return parallel_word(p,kt,out,n,word_source,word_count,fs?&fs->stats:0,threads);
+    unsigned k=pick_threads(threads,n);
+    part parts[SDAT_MAX_THREADS],proto={0}; proto.p=p; proto.kt=kt; proto.w=word_source; proto.out=out; proto.n=n;
+    split(parts,k,n,&proto);
+    run_parts(write_original_part,parts,k);
+    for(unsigned i=0;i<k;i++)if(parts[i].rc)return parts[i].rc;
+    return 0;
+}
+
+typedef struct{frodo_sampler_kind kind;frodo_backend backend;frodo_frontend frontend;frodo_param_id param;sdat_prg_kind prg;const uint8_t*key;size_t key_len;uint64_t stream,first;} counter_job;
+
+static void*counter_part(void*a){
+    part*t=a; const counter_job*j=t->job; frodo_sampler_stats fs;
+    t->rc=frodo_sample_n_counter(j->kind,j->backend,j->frontend,j->param,t->out+t->begin,j->first+t->begin,t->end-t->begin,j->prg,j->key,j->key_len,j->stream,&fs);
+    t->st=fs.stats; return 0;
+}
+
+/* Part boundaries fall on chunk boundaries of the job, so every chunk is
+ * sampled by exactly one part and the per-part stats add up to the single call. */
+int frodo_sample_n_counter_parallel(frodo_sampler_kind kind,frodo_backend backend,frodo_frontend frontend,
+                                    frodo_param_id param,uint16_t*out,uint64_t first,size_t n,
+                                    sdat_prg_kind prg,const uint8_t*key,size_t key_len,uint64_t stream,
+                                    frodo_sampler_stats*fs,unsigned threads){
+    if((!out&&n)||n>UINT64_MAX-first)return -1;
+    uint64_t c0=first/FRODO_COUNTER_CHUNK,chunks=n?(first+n-1)/FRODO_COUNTER_CHUNK-c0+1:0;
+    unsigned k=pick_threads(threads,n); if(k>chunks)k=chunks?(unsigned)chunks:1u;
+    if(k<2)return frodo_sample_n_counter(kind,backend,frontend,param,out,first,n,prg,key,key_len,stream,fs);
+    counter_job job={kind,backend,frontend,param,prg,key,key_len,stream,first};
+    part parts[SDAT_MAX_THREADS]; uint64_t per=(chunks+k-1)/k;
+    for(unsigned i=0;i<k;i++){
+        uint64_t b=(c0+i*per)*FRODO_COUNTER_CHUNK,e=(c0+(i+1)*per)*FRODO_COUNTER_CHUNK;
+        parts[i]=(part){0}; parts[i].job=&job; parts[i].out=out;
+        parts[i].begin=i?(size_t)(b-first):0; parts[i].end=i+1<k&&e-first<n?(size_t)(e-first):n;
+        if(parts[i].begin>n)parts[i].begin=n;
+    }
+    run_parts(counter_part,parts,k);
+    if(fs)*fs=(frodo_sampler_stats){0};
+    for(unsigned i=0;i<k;i++){
+        if(parts[i].rc)return parts[i].rc;
+        if(fs){fs->stats.attempts+=parts[i].st.attempts;fs->stats.rejections+=parts[i].st.rejections;fs->stats.random_bytes+=parts[i].st.random_bytes;fs->stats.random_bits+=parts[i].st.random_bits;}
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include "frodo_sampler.h"
+
+int frodo_sample_n_from_seed(frodo_sampler_kind kind,frodo_backend backend,frodo_frontend frontend,
+                             frodo_param_id param,uint16_t*out,size_t n,
+                             sdat_prg_kind prg,const uint8_t*seed,size_t seed_len,
+                             frodo_sampler_stats*fs){
+    if(!out||!seed)return -1;
+    if(fs)*fs=(frodo_sampler_stats){0};
+    frodo_stream s; int rc=frodo_stream_init(&s,kind,backend,frontend,param); if(rc)return rc;
+    sdat_prg g; if(sdat_prg_init(&g,prg,seed,seed_len)){sdat_prg_wipe(&g);return -1;}
+    frodo_stream_set_refill(&s,sdat_prg_randombytes,&g);
+    size_t done=frodo_stream_sample_n(&s,out,n);
+    if(fs&&kind==FRODO_SAMPLER_SDA_CDT)fs->stats=s.stats;
+    sdat_prg_wipe(&g); frodo_stream_wipe(&s);
+    return done==n?0:-2;
+}
+
+static void add_stats(sdat_stats*a,const sdat_stats*b){a->attempts+=b->attempts;a->rejections+=b->rejections;a->random_bytes+=b->random_bytes;a->random_bits+=b->random_bits;}
+
+/* One frodo_stream per chunk, started at the chunk's counter offset; outputs
+ * of the chunk before `first` are sampled into a scratch buffer and dropped. */
+int frodo_sample_n_counter(frodo_sampler_kind kind,frodo_backend backend,frodo_frontend frontend,
+                           frodo_param_id param,uint16_t*out,uint64_t first,size_t n,
+                           sdat_prg_kind prg,const uint8_t*key,size_t key_len,uint64_t stream,
+                           frodo_sampler_stats*fs){
+    if((!out&&n)||!key||!key_len||key_len!=sdat_prg_stream_key_bytes(prg)||n>UINT64_MAX-first)return -1;
+    if(fs)*fs=(frodo_sampler_stats){0};
+    frodo_stream s; int rc=frodo_stream_init(&s,kind,backend,frontend,param); if(rc)return rc;
+    sdat_prg g={0}; uint16_t skip[256]; size_t done=0;
+    while(done<n&&!rc){
+        uint64_t at=first+done; size_t lead=(size_t)(at%FRODO_COUNTER_CHUNK),take=FRODO_COUNTER_CHUNK-lead; if(take>n-done)take=n-done;
+        if(done)frodo_stream_init(&s,kind,backend,frontend,param);
+        if(sdat_prg_init_chunk(&g,prg,key,key_len,stream,at/FRODO_COUNTER_CHUNK)){rc=-1;break;}
+        frodo_stream_set_refill(&s,sdat_prg_randombytes,&g);
+        while(lead&&!rc){size_t m=lead<256?lead:256; if(frodo_stream_sample_n(&s,skip,m)!=m)rc=-2; lead-=m;}
+        if(!rc&&frodo_stream_sample_n(&s,out+done,take)!=take)rc=-2;
+        if(fs&&kind==FRODO_SAMPLER_SDA_CDT)add_stats(&fs->stats,&s.stats);
+        done+=take;
+    }
+    sdat_secure_zero(skip,sizeof skip); sdat_prg_wipe(&g); frodo_stream_wipe(&s);
+    return rc;
+}
@@ -0,0 +1,96 @@
+#include "frodo_sampler.h"
+#include <string.h>
+
+#define CHUNK FRODO_STREAM_CHUNK_BYTES
+
+int frodo_stream_init(frodo_stream*s,frodo_sampler_kind kind,frodo_backend backend,frodo_frontend frontend,frodo_param_id param){
+    const frodo_sampler_params*p=frodo_get_sampler_params(param); if(!s||!p)return -1;
+    const frodo_kernel_table*kt=frodo_kernels(backend); if(!kt)return -9;
+    if(kind==FRODO_SAMPLER_ORIGINAL_CDT&&frontend!=FRODO_FRONTEND_ORIGINAL_WORD)return -2;
+    if(kind!=FRODO_SAMPLER_ORIGINAL_CDT&&kind!=FRODO_SAMPLER_SDA_CDT)return -3;
+    if(kind==FRODO_SAMPLER_SDA_CDT&&frontend!=FRODO_FRONTEND_PACKED_BIT&&frontend!=FRODO_FRONTEND_WORD_ORIENTED)return -6;
+    memset(s,0,sizeof *s);
+    s->params=p; s->kind=kind; s->backend=kt->backend; s->frontend=frontend; s->kernels=kt;
+    return 0;
+}
+
+void frodo_stream_set_refill(frodo_stream*s,sdat_randombytes_fn refill,void*ctx){s->refill=refill;s->refill_ctx=ctx;}
+
+static inline int take_bits(sdat_bitreader_fast*r,unsigned b,uint32_t*v){
+    if(sdat_fast_refill64(r,b))return -2;
+    *v=(uint32_t)(r->reservoir&((1u<<b)-1u)); r->reservoir>>=b; r->available-=b; r->bits_consumed+=b; return 0;
+}
+
+/* Samples from stage[0..sl) starting `skip` bits in; returns outputs written
+ * and sets *pos to the bit position of the first unused bit. When input runs
+ * out, rejected candidates that are complete are consumed (and counted) so the
+ * carried tail stays shorter than one candidate plus its sign bit. */
+static size_t stage_packed(frodo_stream*s,size_t sl,uint16_t*out,size_t n,uint64_t*pos){
+    const frodo_sampler_params*p=s->params; const uint8_t*buf=(const uint8_t*)s->stage;
+    sdat_bitreader_fast r; sdat_bitreader_fast_init(&r,buf,sl);
+    for(unsigned i=0;i<s->skip;i++){uint32_t v;sdat_take_1(&r,&v);}
+    r.bits_consumed=0;
+    size_t k=s->kernels->packed_run[p->id](out,n,&r,&s->stats);
+    if(k<n){
+        for(;;){
+            sdat_bitreader_fast save=r; uint32_t v;
+            if(take_bits(&r,p->sda_candidate_bits,&v)||v<p->sda_q){r=save;break;}
+            s->stats.attempts++; s->stats.rejections++; s->stats.random_bits+=p->sda_candidate_bits;
+        }
+    }
+    s->bits_consumed+=r.bits_consumed;
+    s->stats.random_bytes=(s->bits_consumed+7u)/8u;
+    *pos=(uint64_t)(r.ptr-buf)*8u-r.available;
+    return k;
+}
+
+static size_t stage_words(frodo_stream*s,size_t sl,uint16_t*out,size_t n,uint64_t*pos){
+    const frodo_sampler_params*p=s->params; size_t wc=sl/2u,used,k;
+    if(s->kind==FRODO_SAMPLER_ORIGINAL_CDT){
+        k=wc<n?wc:n; used=k;
+        memcpy(out,s->stage,k*sizeof *out);
+        s->kernels->original[p->id](out,k);
+    }else{
+        k=s->kernels->word_run[p->id](out,n,s->stage,wc,&used,&s->stats);
+    }
+    *pos=(uint64_t)used*16u;
+    return k;
+}
+
+/* Input is staged behind the carried tail (s->lead bytes, the first s->skip
+ * bits of which are already used) in CHUNK pieces, so every kernel, including
+ * the AVX2 packed extractor, reads one contiguous buffer. */
+size_t frodo_stream_push(frodo_stream*s,const uint8_t*in,size_t in_len,size_t*in_used,uint16_t*out,size_t n){
+    size_t done=0,u=0;
+    if(in_used)*in_used=0;
+    if(!s||!s->params||(!in&&in_len)||(!out&&n))return 0;
+    uint8_t*stage=(uint8_t*)s->stage;
+    while(done<n&&u<in_len){
+        size_t lead=s->lead,m=in_len-u<CHUNK?in_len-u:CHUNK,sl=lead+m; uint64_t pos;
+        memcpy(stage+lead,in+u,m);
+        done+=s->frontend==FRODO_FRONTEND_PACKED_BIT?stage_packed(s,sl,out+done,n-done,&pos):stage_words(s,sl,out+done,n-done,&pos);
+        size_t at=(size_t)(pos>>3); s->skip=(unsigned)(pos&7u);
+        if(done<n){memmove(stage,stage+at,sl-at);s->lead=sl-at;u+=m;}
+        else if(at>=lead){s->lead=0;u+=at-lead;}
+        else{memmove(stage,stage+at,lead-at);s->lead=lead-at;}
+    }
+    if(in_used)*in_used=u;
+    return done;
+}
+
+size_t frodo_stream_sample_n(frodo_stream*s,uint16_t*out,size_t n){
+    size_t done=0;
+    if(!s||!s->params||(!out&&n))return 0;
+    while(done<n){
+        if(s->refill_pos==s->refill_len){
+            if(!s->refill||s->refill(s->refill_ctx,s->refill_buf,CHUNK))break;
+            s->refill_pos=0; s->refill_len=CHUNK;
+        }
+        size_t used;
+        done+=frodo_stream_push(s,s->refill_buf+s->refill_pos,s->refill_len-s->refill_pos,&used,out+done,n-done);
+        s->refill_pos+=used;
+    }
+    return done;
+}
+
+void frodo_stream_wipe(frodo_stream*s){if(s)sdat_secure_zero(s,sizeof *s);}
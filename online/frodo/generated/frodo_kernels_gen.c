@@ -0,0 +1,315 @@
+/* Generated by offline/scripts/generate_online_kernels.py; do not edit. */
+#include "frodo_kernels_gen.h"
+#include "frodo_sampler.h"
+
+/* Bit extraction with a constant width; inlined per call site. */
+static inline __attribute__((always_inline)) int gen_take(sdat_bitreader_fast *r, unsigned bits, uint32_t *out) {
+    if (sdat_fast_refill64(r, bits)) return -2;
+    *out = (uint32_t)(r->reservoir & ((1u << bits) - 1u));
+    r->reservoir >>= bits;
+    r->available -= bits;
+    r->bits_consumed += bits;
+    return 0;
+}
+
+/* Word-oriented accounting of frodo_sda_word_sample_run. */
+static inline void gen_word_account(size_t produced, size_t consumed, unsigned bits, sdat_stats *st) {
+    if (st) {
+        st->attempts += consumed;
+        st->rejections += consumed - produced;
+        st->random_bits += (uint64_t)consumed * bits + produced;
+        st->random_bytes += (uint64_t)consumed * 2u;
+    }
+}
+
+static const uint16_t frodo640_original_thresholds[] = {4643, 13363, 20579, 25843, 29227, 31145, 32103, 32525, 32689, 32745, 32762, 32766};
+static const uint16_t frodo640_sda_thresholds[] = {2071, 5957, 9166, 11499, 12992, 13833, 14250, 14432, 14502, 14526, 14533};
+static const uint16_t frodo976_original_thresholds[] = {5638, 15915, 23689, 28571, 31116, 32217, 32613, 32731, 32760, 32766};
+static const uint16_t frodo976_sda_thresholds[] = {1291, 3640, 5409, 6512, 7081, 7324, 7410, 7435, 7441};
+static const uint16_t frodo1344_original_thresholds[] = {9142, 23462, 30338, 32361, 32725, 32765};
+static const uint16_t frodo1344_sda_thresholds[] = {29, 74, 95, 101};
+
+/* online_table_manifest.csv:frodo640: 15-bit draws, sign in bit 0, 12 thresholds. */
+static int frodo640_original(uint16_t *s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x = (uint32_t)(s[i] >> 1);
+        s[i] = frodo_apply_sign((uint16_t)((x > 4643u) + (x > 13363u) + (x > 20579u) + (x > 25843u) + (x > 29227u) + (x > 31145u) + (x > 32103u) + (x > 32525u) + (x > 32689u) + (x > 32745u) + (x > 32762u) + (x > 32766u)), (uint8_t)(s[i] & 1u));
+    }
+    return 0;
+}
+
+/* online_table_manifest.csv:frodo640: q = 14534, 14-bit candidates, 11 thresholds. */
+static inline uint16_t frodo640_sda_mag(uint32_t x) {
+    return (uint16_t)((x >= 2071u) + (x >= 5957u) + (x >= 9166u) + (x >= 11499u) + (x >= 12992u) + (x >= 13833u) + (x >= 14250u) + (x >= 14432u) + (x >= 14502u) + (x >= 14526u) + (x >= 14533u));
+}
+
+static inline int frodo640_sda_next(sdat_bitreader_fast *r, uint32_t *x, uint32_t *sg, sdat_stats *st) {
+    for (;;) {
+        uint32_t v;
+        if (gen_take(r, 14u, &v)) return -2;
+        if (st) {
+            st->attempts++;
+            st->random_bits += 14u;
+        }
+        if (v >= 14534u) {
+            if (st) st->rejections++;
+            continue;
+        }
+        if (gen_take(r, 1u, sg)) return -2;
+        if (st) st->random_bits++;
+        *x = v;
+        return 0;
+    }
+}
+
+static int frodo640_sda_packed(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x, s;
+        if (frodo640_sda_next(r, &x, &s, st)) return -2;
+        out[i] = frodo_apply_sign(frodo640_sda_mag(x), (uint8_t)s);
+    }
+    if (st) st->random_bytes = sdat_fast_bytes_used(r);
+    return 0;
+}
+
+static size_t frodo640_sda_packed_run(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    size_t i = 0;
+    for (; i < n; i++) {
+        sdat_bitreader_fast save = *r;
+        sdat_stats ss = st ? *st : (sdat_stats){0};
+        uint32_t x, s;
+        if (frodo640_sda_next(r, &x, &s, st)) {
+            *r = save;
+            if (st) *st = ss;
+            break;
+        }
+        out[i] = frodo_apply_sign(frodo640_sda_mag(x), (uint8_t)s);
+    }
+    return i;
+}
+
+static size_t frodo640_sda_word_run(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed, sdat_stats *st) {
+    const uint16_t *src = w, *end = w + wc;
+    uint16_t *dst = out, *dst_end = out + n;
+    while (dst < dst_end && src < end) {
+        uint16_t z = *src++;
+        uint32_t c = z & 0x3fffu;
+        *dst = frodo_apply_sign(frodo640_sda_mag(c), (uint8_t)((z >> 14) & 1u));
+        dst += (unsigned)(c < 14534u);
+    }
+    size_t used = (size_t)(src - w), k = (size_t)(dst - out);
+    if (consumed) *consumed = used;
+    gen_word_account(k, used, 14u, st);
+    return k;
+}
+
+static int frodo640_sda_word(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    return frodo640_sda_word_run(out, n, w, wc, 0, st) == n ? 0 : -2;
+}
+
+/* online_table_manifest.csv:frodo976: 15-bit draws, sign in bit 0, 10 thresholds. */
+static int frodo976_original(uint16_t *s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x = (uint32_t)(s[i] >> 1);
+        s[i] = frodo_apply_sign((uint16_t)((x > 5638u) + (x > 15915u) + (x > 23689u) + (x > 28571u) + (x > 31116u) + (x > 32217u) + (x > 32613u) + (x > 32731u) + (x > 32760u) + (x > 32766u)), (uint8_t)(s[i] & 1u));
+    }
+    return 0;
+}
+
+/* online_table_manifest.csv:frodo976: q = 7442, 13-bit candidates, 9 thresholds. */
+static inline uint16_t frodo976_sda_mag(uint32_t x) {
+    return (uint16_t)((x >= 1291u) + (x >= 3640u) + (x >= 5409u) + (x >= 6512u) + (x >= 7081u) + (x >= 7324u) + (x >= 7410u) + (x >= 7435u) + (x >= 7441u));
+}
+
+static inline int frodo976_sda_next(sdat_bitreader_fast *r, uint32_t *x, uint32_t *sg, sdat_stats *st) {
+    for (;;) {
+        uint32_t v;
+        if (gen_take(r, 13u, &v)) return -2;
+        if (st) {
+            st->attempts++;
+            st->random_bits += 13u;
+        }
+        if (v >= 7442u) {
+            if (st) st->rejections++;
+            continue;
+        }
+        if (gen_take(r, 1u, sg)) return -2;
+        if (st) st->random_bits++;
+        *x = v;
+        return 0;
+    }
+}
+
+static int frodo976_sda_packed(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x, s;
+        if (frodo976_sda_next(r, &x, &s, st)) return -2;
+        out[i] = frodo_apply_sign(frodo976_sda_mag(x), (uint8_t)s);
+    }
+    if (st) st->random_bytes = sdat_fast_bytes_used(r);
+    return 0;
+}
+
+static size_t frodo976_sda_packed_run(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    size_t i = 0;
+    for (; i < n; i++) {
+        sdat_bitreader_fast save = *r;
+        sdat_stats ss = st ? *st : (sdat_stats){0};
+        uint32_t x, s;
+        if (frodo976_sda_next(r, &x, &s, st)) {
+            *r = save;
+            if (st) *st = ss;
+            break;
+        }
+        out[i] = frodo_apply_sign(frodo976_sda_mag(x), (uint8_t)s);
+    }
+    return i;
+}
+
+static size_t frodo976_sda_word_run(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed, sdat_stats *st) {
+    const uint16_t *src = w, *end = w + wc;
+    uint16_t *dst = out, *dst_end = out + n;
+    while (dst < dst_end && src < end) {
+        uint16_t z = *src++;
+        uint32_t c = z & 0x1fffu;
+        *dst = frodo_apply_sign(frodo976_sda_mag(c), (uint8_t)((z >> 13) & 1u));
+        dst += (unsigned)(c < 7442u);
+    }
+    size_t used = (size_t)(src - w), k = (size_t)(dst - out);
+    if (consumed) *consumed = used;
+    gen_word_account(k, used, 13u, st);
+    return k;
+}
+
+static int frodo976_sda_word(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    return frodo976_sda_word_run(out, n, w, wc, 0, st) == n ? 0 : -2;
+}
+
+/* online_table_manifest.csv:frodo1344: 15-bit draws, sign in bit 0, 6 thresholds. */
+static int frodo1344_original(uint16_t *s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x = (uint32_t)(s[i] >> 1);
+        s[i] = frodo_apply_sign((uint16_t)((x > 9142u) + (x > 23462u) + (x > 30338u) + (x > 32361u) + (x > 32725u) + (x > 32765u)), (uint8_t)(s[i] & 1u));
+    }
+    return 0;
+}
+
+/* online_table_manifest.csv:frodo1344: q = 102, 7-bit candidates, 4 thresholds. */
+static inline uint16_t frodo1344_sda_mag(uint32_t x) {
+    return (uint16_t)((x >= 29u) + (x >= 74u) + (x >= 95u) + (x >= 101u));
+}
+
+static inline int frodo1344_sda_next(sdat_bitreader_fast *r, uint32_t *x, uint32_t *sg, sdat_stats *st) {
+    for (;;) {
+        uint32_t v;
+        if (gen_take(r, 7u, &v)) return -2;
+        if (st) {
+            st->attempts++;
+            st->random_bits += 7u;
+        }
+        if (v >= 102u) {
+            if (st) st->rejections++;
+            continue;
+        }
+        if (gen_take(r, 1u, sg)) return -2;
+        if (st) st->random_bits++;
+        *x = v;
+        return 0;
+    }
+}
+
+static int frodo1344_sda_packed(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x, s;
+        if (frodo1344_sda_next(r, &x, &s, st)) return -2;
+        out[i] = frodo_apply_sign(frodo1344_sda_mag(x), (uint8_t)s);
+    }
+    if (st) st->random_bytes = sdat_fast_bytes_used(r);
+    return 0;
+}
+
+static size_t frodo1344_sda_packed_run(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    size_t i = 0;
+    for (; i < n; i++) {
+        sdat_bitreader_fast save = *r;
+        sdat_stats ss = st ? *st : (sdat_stats){0};
+        uint32_t x, s;
+        if (frodo1344_sda_next(r, &x, &s, st)) {
+            *r = save;
+            if (st) *st = ss;
+            break;
+        }
+        out[i] = frodo_apply_sign(frodo1344_sda_mag(x), (uint8_t)s);
+    }
+    return i;
+}
+
+static size_t frodo1344_sda_word_run(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed, sdat_stats *st) {
+    const uint16_t *src = w, *end = w + wc;
+    uint16_t *dst = out, *dst_end = out + n;
+    while (dst < dst_end && src < end) {
+        uint16_t z = *src++;
+        uint32_t c = z & 0x7fu;
+        *dst = frodo_apply_sign(frodo1344_sda_mag(c), (uint8_t)((z >> 7) & 1u));
+        dst += (unsigned)(c < 102u);
+    }
+    size_t used = (size_t)(src - w), k = (size_t)(dst - out);
+    if (consumed) *consumed = used;
+    gen_word_account(k, used, 7u, st);
+    return k;
+}
+
+static int frodo1344_sda_word(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    return frodo1344_sda_word_run(out, n, w, wc, 0, st) == n ? 0 : -2;
+}
+
+const frodo_gen_kernels frodo_gen_reference[] = {
+    {"frodo640", "original-cdt-table", SDAT_TYPE_U16, 32768u, 15u, 12, frodo640_original_thresholds,
+     frodo640_original, 0, 0, 0, 0},
+    {"frodo640", "sda-table", SDAT_TYPE_U16, 14534u, 14u, 11, frodo640_sda_thresholds,
+     0, frodo640_sda_packed, frodo640_sda_packed_run, frodo640_sda_word, frodo640_sda_word_run},
+    {"frodo976", "original-cdt-table", SDAT_TYPE_U16, 32768u, 15u, 10, frodo976_original_thresholds,
+     frodo976_original, 0, 0, 0, 0},
+    {"frodo976", "sda-table", SDAT_TYPE_U16, 7442u, 13u, 9, frodo976_sda_thresholds,
+     0, frodo976_sda_packed, frodo976_sda_packed_run, frodo976_sda_word, frodo976_sda_word_run},
+    {"frodo1344", "original-cdt-table", SDAT_TYPE_U16, 32768u, 15u, 6, frodo1344_original_thresholds,
+     frodo1344_original, 0, 0, 0, 0},
+    {"frodo1344", "sda-table", SDAT_TYPE_U8, 102u, 7u, 4, frodo1344_sda_thresholds,
+     0, frodo1344_sda_packed, frodo1344_sda_packed_run, frodo1344_sda_word, frodo1344_sda_word_run},
+};
+const size_t frodo_gen_reference_count = sizeof frodo_gen_reference / sizeof frodo_gen_reference[0];
+
+const frodo_kernel_table frodo_gen_kernel_table_reference = {
+    .backend = FRODO_BACKEND_REFERENCE,
+    .original = {
+        [FRODO_PARAM_640] = frodo640_original,
+        [FRODO_PARAM_976] = frodo976_original,
+        [FRODO_PARAM_1344] = frodo1344_original,
+    },
+    .packed = {
+        [FRODO_PARAM_640] = frodo640_sda_packed,
+        [FRODO_PARAM_976] = frodo976_sda_packed,
+        [FRODO_PARAM_1344] = frodo1344_sda_packed,
+    },
+    .packed_run = {
+        [FRODO_PARAM_640] = frodo640_sda_packed_run,
+        [FRODO_PARAM_976] = frodo976_sda_packed_run,
+        [FRODO_PARAM_1344] = frodo1344_sda_packed_run,
+    },
+    .word = {
+        [FRODO_PARAM_640] = frodo640_sda_word,
+        [FRODO_PARAM_976] = frodo976_sda_word,
+        [FRODO_PARAM_1344] = frodo1344_sda_word,
+    },
+    .word_run = {
+        [FRODO_PARAM_640] = frodo640_sda_word_run,
+        [FRODO_PARAM_976] = frodo976_sda_word_run,
+        [FRODO_PARAM_1344] = frodo1344_sda_word_run,
+    },
+};
@@ -0,0 +1,253 @@
+/* Generated by offline/scripts/generate_online_kernels.py; do not edit. */
+#include "frodo_kernels_avx2.h"
+#include "frodo_kernels_gen.h"
+#include "frodo_sampler.h"
+#include "sdat_avx2.h"
+
+/* Vector kernels with the thresholds as compile-time constants; tails and the
+ * non-AVX2 fallback go through the scalar entries of frodo_gen_reference. */
+
+static const uint16_t frodo640_original_thresholds[] = {4643, 13363, 20579, 25843, 29227, 31145, 32103, 32525, 32689, 32745, 32762, 32766};
+static const uint16_t frodo640_sda_thresholds[] = {2071, 5957, 9166, 11499, 12992, 13833, 14250, 14432, 14502, 14526, 14533};
+static const uint16_t frodo976_original_thresholds[] = {5638, 15915, 23689, 28571, 31116, 32217, 32613, 32731, 32760, 32766};
+static const uint16_t frodo976_sda_thresholds[] = {1291, 3640, 5409, 6512, 7081, 7324, 7410, 7435, 7441};
+static const uint16_t frodo1344_original_thresholds[] = {9142, 23462, 30338, 32361, 32725, 32765};
+static const uint16_t frodo1344_sda_thresholds[] = {29, 74, 95, 101};
+
+static int frodo640_original_avx2(uint16_t *s, size_t n) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[0].original(s, n);
+    const __m256i one = _mm256_set1_epi16(1), zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i w = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i x = _mm256_srli_epi16(w, 1), mag = zero;
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(4643)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(13363)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(20579)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(25843)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(29227)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(31145)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32103)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32525)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32689)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32745)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32762)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32766)));
+        __m256i sign = _mm256_and_si256(w, one);
+        _mm256_storeu_si256((__m256i *)(s + i), _mm256_add_epi16(_mm256_xor_si256(mag, _mm256_sub_epi16(zero, sign)), sign));
+    }
+    frodo_gen_reference[0].original(s + i, n - i);
+    sdat_avx2_stats tel = {1, n / 16, n - n % 16, n % 16, 0, 0, 0};
+    SDAT_TEL_FLUSH(&tel);
+    return 0;
+}
+
+static const uint32_t frodo640_sda_thr32[] = {2071u, 5957u, 9166u, 11499u, 12992u, 13833u, 14250u, 14432u, 14502u, 14526u, 14533u};
+
+static int frodo640_sda_packed_avx2(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[1].packed(out, n, r, st);
+    if (st) *st = (sdat_stats){0};
+    sdat_avx2_stats tel = {1, 0, 0, 0, 0, 0, 0};
+    size_t d = packed_extract(r, out, n, 14u, 14534u, frodo640_sda_thr32, 11, st, &tel);
+    size_t k = frodo_gen_reference[1].packed_run(out + d, n - d, r, st);
+    SDAT_TEL_ADD(&tel, scalar_tail_samples, k);
+    SDAT_TEL_FLUSH(&tel);
+    if (d + k != n) return -2;
+    if (st) st->random_bytes = sdat_fast_bytes_used(r);
+    return 0;
+}
+
+static size_t frodo640_sda_packed_run_avx2(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[1].packed_run(out, n, r, st);
+    sdat_avx2_stats tel = {1, 0, 0, 0, 0, 0, 0};
+    size_t d = packed_extract(r, out, n, 14u, 14534u, frodo640_sda_thr32, 11, st, &tel);
+    SDAT_TEL_FLUSH(&tel);
+    return d + frodo_gen_reference[1].packed_run(out + d, n - d, r, st);
+}
+
+static size_t frodo640_sda_word_run_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed,
+                                sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[1].word_run(out, n, w, wc, consumed, st);
+    size_t used;
+    uint64_t nb;
+    size_t k = word_kernel(out, n, w, wc, 0x3fffu, 14, 14534u, frodo640_sda_thresholds, 11, &used, &nb);
+    word_account(k, used, nb, 14u, st);
+    if (consumed) *consumed = used;
+    return k;
+}
+
+static int frodo640_sda_word_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    return frodo640_sda_word_run_avx2(out, n, w, wc, 0, st) == n ? 0 : -2;
+}
+
+static int frodo976_original_avx2(uint16_t *s, size_t n) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[2].original(s, n);
+    const __m256i one = _mm256_set1_epi16(1), zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i w = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i x = _mm256_srli_epi16(w, 1), mag = zero;
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(5638)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(15915)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(23689)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(28571)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(31116)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32217)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32613)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32731)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32760)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32766)));
+        __m256i sign = _mm256_and_si256(w, one);
+        _mm256_storeu_si256((__m256i *)(s + i), _mm256_add_epi16(_mm256_xor_si256(mag, _mm256_sub_epi16(zero, sign)), sign));
+    }
+    frodo_gen_reference[2].original(s + i, n - i);
+    sdat_avx2_stats tel = {1, n / 16, n - n % 16, n % 16, 0, 0, 0};
+    SDAT_TEL_FLUSH(&tel);
+    return 0;
+}
+
+static const uint32_t frodo976_sda_thr32[] = {1291u, 3640u, 5409u, 6512u, 7081u, 7324u, 7410u, 7435u, 7441u};
+
+static int frodo976_sda_packed_avx2(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[3].packed(out, n, r, st);
+    if (st) *st = (sdat_stats){0};
+    sdat_avx2_stats tel = {1, 0, 0, 0, 0, 0, 0};
+    size_t d = packed_extract(r, out, n, 13u, 7442u, frodo976_sda_thr32, 9, st, &tel);
+    size_t k = frodo_gen_reference[3].packed_run(out + d, n - d, r, st);
+    SDAT_TEL_ADD(&tel, scalar_tail_samples, k);
+    SDAT_TEL_FLUSH(&tel);
+    if (d + k != n) return -2;
+    if (st) st->random_bytes = sdat_fast_bytes_used(r);
+    return 0;
+}
+
+static size_t frodo976_sda_packed_run_avx2(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[3].packed_run(out, n, r, st);
+    sdat_avx2_stats tel = {1, 0, 0, 0, 0, 0, 0};
+    size_t d = packed_extract(r, out, n, 13u, 7442u, frodo976_sda_thr32, 9, st, &tel);
+    SDAT_TEL_FLUSH(&tel);
+    return d + frodo_gen_reference[3].packed_run(out + d, n - d, r, st);
+}
+
+static size_t frodo976_sda_word_run_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed,
+                                sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[3].word_run(out, n, w, wc, consumed, st);
+    size_t used;
+    uint64_t nb;
+    size_t k = word_kernel(out, n, w, wc, 0x1fffu, 13, 7442u, frodo976_sda_thresholds, 9, &used, &nb);
+    word_account(k, used, nb, 13u, st);
+    if (consumed) *consumed = used;
+    return k;
+}
+
+static int frodo976_sda_word_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    return frodo976_sda_word_run_avx2(out, n, w, wc, 0, st) == n ? 0 : -2;
+}
+
+static int frodo1344_original_avx2(uint16_t *s, size_t n) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[4].original(s, n);
+    const __m256i one = _mm256_set1_epi16(1), zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i w = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i x = _mm256_srli_epi16(w, 1), mag = zero;
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(9142)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(23462)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(30338)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32361)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32725)));
+        mag = _mm256_sub_epi16(mag, _mm256_cmpgt_epi16(x, _mm256_set1_epi16(32765)));
+        __m256i sign = _mm256_and_si256(w, one);
+        _mm256_storeu_si256((__m256i *)(s + i), _mm256_add_epi16(_mm256_xor_si256(mag, _mm256_sub_epi16(zero, sign)), sign));
+    }
+    frodo_gen_reference[4].original(s + i, n - i);
+    sdat_avx2_stats tel = {1, n / 16, n - n % 16, n % 16, 0, 0, 0};
+    SDAT_TEL_FLUSH(&tel);
+    return 0;
+}
+
+static const uint32_t frodo1344_sda_thr32[] = {29u, 74u, 95u, 101u};
+
+static int frodo1344_sda_packed_avx2(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[5].packed(out, n, r, st);
+    if (st) *st = (sdat_stats){0};
+    sdat_avx2_stats tel = {1, 0, 0, 0, 0, 0, 0};
+    size_t d = packed_extract(r, out, n, 7u, 102u, frodo1344_sda_thr32, 4, st, &tel);
+    size_t k = frodo_gen_reference[5].packed_run(out + d, n - d, r, st);
+    SDAT_TEL_ADD(&tel, scalar_tail_samples, k);
+    SDAT_TEL_FLUSH(&tel);
+    if (d + k != n) return -2;
+    if (st) st->random_bytes = sdat_fast_bytes_used(r);
+    return 0;
+}
+
+static size_t frodo1344_sda_packed_run_avx2(uint16_t *out, size_t n, sdat_bitreader_fast *r, sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[5].packed_run(out, n, r, st);
+    sdat_avx2_stats tel = {1, 0, 0, 0, 0, 0, 0};
+    size_t d = packed_extract(r, out, n, 7u, 102u, frodo1344_sda_thr32, 4, st, &tel);
+    SDAT_TEL_FLUSH(&tel);
+    return d + frodo_gen_reference[5].packed_run(out + d, n - d, r, st);
+}
+
+static size_t frodo1344_sda_word_run_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, size_t *consumed,
+                                sdat_stats *st) {
+    if (!sdat_avx2_cpu_supported()) return frodo_gen_reference[5].word_run(out, n, w, wc, consumed, st);
+    size_t used;
+    uint64_t nb;
+    size_t k = word_kernel(out, n, w, wc, 0x7fu, 7, 102u, frodo1344_sda_thresholds, 4, &used, &nb);
+    word_account(k, used, nb, 7u, st);
+    if (consumed) *consumed = used;
+    return k;
+}
+
+static int frodo1344_sda_word_avx2(uint16_t *out, size_t n, const uint16_t *w, size_t wc, sdat_stats *st) {
+    if (st) *st = (sdat_stats){0};
+    return frodo1344_sda_word_run_avx2(out, n, w, wc, 0, st) == n ? 0 : -2;
+}
+
+const frodo_gen_kernels frodo_gen_avx2[] = {
+    {"frodo640", "original-cdt-table", SDAT_TYPE_U16, 32768u, 15u, 12, frodo640_original_thresholds,
+     frodo640_original_avx2, 0, 0, 0, 0},
+    {"frodo640", "sda-table", SDAT_TYPE_U16, 14534u, 14u, 11, frodo640_sda_thresholds,
+     0, frodo640_sda_packed_avx2, frodo640_sda_packed_run_avx2, frodo640_sda_word_avx2, frodo640_sda_word_run_avx2},
+    {"frodo976", "original-cdt-table", SDAT_TYPE_U16, 32768u, 15u, 10, frodo976_original_thresholds,
+     frodo976_original_avx2, 0, 0, 0, 0},
+    {"frodo976", "sda-table", SDAT_TYPE_U16, 7442u, 13u, 9, frodo976_sda_thresholds,
+     0, frodo976_sda_packed_avx2, frodo976_sda_packed_run_avx2, frodo976_sda_word_avx2, frodo976_sda_word_run_avx2},
+    {"frodo1344", "original-cdt-table", SDAT_TYPE_U16, 32768u, 15u, 6, frodo1344_original_thresholds,
+     frodo1344_original_avx2, 0, 0, 0, 0},
+    {"frodo1344", "sda-table", SDAT_TYPE_U8, 102u, 7u, 4, frodo1344_sda_thresholds,
+     0, frodo1344_sda_packed_avx2, frodo1344_sda_packed_run_avx2, frodo1344_sda_word_avx2, frodo1344_sda_word_run_avx2},
+};
+const size_t frodo_gen_avx2_count = sizeof frodo_gen_avx2 / sizeof frodo_gen_avx2[0];
+
+const frodo_kernel_table frodo_gen_kernel_table_avx2 = {
+    .backend = FRODO_BACKEND_AVX2,
+    .original = {
+        [FRODO_PARAM_640] = frodo640_original_avx2,
+        [FRODO_PARAM_976] = frodo976_original_avx2,
+        [FRODO_PARAM_1344] = frodo1344_original_avx2,
+    },
+    .packed = {
+        [FRODO_PARAM_640] = frodo640_sda_packed_avx2,
+        [FRODO_PARAM_976] = frodo976_sda_packed_avx2,
+        [FRODO_PARAM_1344] = frodo1344_sda_packed_avx2,
+    },
+    .packed_run = {
+        [FRODO_PARAM_640] = frodo640_sda_packed_run_avx2,
+        [FRODO_PARAM_976] = frodo976_sda_packed_run_avx2,
+        [FRODO_PARAM_1344] = frodo1344_sda_packed_run_avx2,
+    },
+    .word = {
+        [FRODO_PARAM_640] = frodo640_sda_word_avx2,
+        [FRODO_PARAM_976] = frodo976_sda_word_avx2,
+        [FRODO_PARAM_1344] = frodo1344_sda_word_avx2,
+    },
+    .word_run = {
+        [FRODO_PARAM_640] = frodo640_sda_word_run_avx2,
+        [FRODO_PARAM_976] = frodo976_sda_word_run_avx2,
+        [FRODO_PARAM_1344] = frodo1344_sda_word_run_avx2,
+    },
+};
@@ -0,0 +1,267 @@
+#include "sdat_noise_pool.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* head is written only by the ring's producer and tail only by its consumer,
+ * each on its own cache line; slot contents are published by the release
+ * store of head and handed back by the release store of tail. */
+typedef struct {
+    _Alignas(64) _Atomic size_t head;
+    _Alignas(64) _Atomic size_t tail;
+    _Atomic uint64_t empty_polls;
+    _Atomic size_t min_depth;
+    _Alignas(64) uint8_t *slots;
+    _Atomic int status;
+    sdat_prg prg;
+    frodo_stream *stream;
+} ring;
+
+typedef struct {
+    sdat_noise_pool *pool;
+    unsigned index;
+    int started;
+    pthread_t tid;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    int wake;
+    _Atomic int sleeping;
+    _Atomic uint64_t wakeups;
+} producer;
+
+struct sdat_noise_pool {
+    sdat_noise_pool_config cfg;
+    size_t block_samples, block_bytes, stride, mask;
+    _Atomic int stop;
+    ring *rings;
+    producer *prods;
+};
+
+/* Zeroizes a released slot: a plain memset the compiler must assume is read
+ * afterwards, so it is neither elided nor byte-by-byte like sdat_secure_zero. */
+static void wipe(void *p, size_t len) {
+#if defined(__GNUC__) || defined(__clang__)
+    memset(p, 0, len);
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+#else
+    sdat_secure_zero(p, len);
+#endif
+}
+
+static int fill(sdat_noise_pool *pool, ring *r, uint8_t *slot) {
+    const sdat_noise_pool_config *c = &pool->cfg;
+    size_t n = pool->block_samples;
+    if (c->source == SDAT_NOISE_FRODO) return frodo_stream_sample_n(r->stream, (uint16_t *)slot, n) == n ? 0 : -3;
+    int avx2 = c->backend == FRODO_BACKEND_AVX2;
+    size_t got = c->falcon_kind == FALCON_BASE_ORIGINAL
+                     ? (avx2 ? falcon_original_gaussian0_sample_n_avx2 : falcon_original_gaussian0_sample_n)(
+                           sdat_prg_randombytes, &r->prg, (uint32_t *)slot, n, 0)
+                     : (avx2 ? falcon_sda_gaussian0_sample_n_avx2 : falcon_sda_gaussian0_sample_n)(
+                           sdat_prg_randombytes, &r->prg, (uint32_t *)slot, n, 0);
+    return got == n ? 0 : -3;
+}
+
+static size_t depth(ring *r) {
+    return atomic_load_explicit(&r->head, memory_order_relaxed) - atomic_load(&r->tail);
+}
+
+static int needs_refill(sdat_noise_pool *pool, unsigned index) {
+    for (unsigned c = index; c < pool->cfg.consumers; c += pool->cfg.producers) {
+        ring *r = &pool->rings[c];
+        if (!atomic_load_explicit(&r->status, memory_order_relaxed) && depth(r) <= pool->cfg.low_watermark) return 1;
+    }
+    return 0;
+}
+
+static void *produce(void *arg) {
+    producer *p = arg;
+    sdat_noise_pool *pool = p->pool;
+    while (!atomic_load(&pool->stop)) {
+        for (unsigned c = p->index; c < pool->cfg.consumers && !atomic_load(&pool->stop); c += pool->cfg.producers) {
+            ring *r = &pool->rings[c];
+            size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+            while (!atomic_load_explicit(&r->status, memory_order_relaxed) && !atomic_load(&pool->stop) &&
+                   head - atomic_load_explicit(&r->tail, memory_order_acquire) < pool->cfg.slots) {
+                int rc = fill(pool, r, r->slots + (head & pool->mask) * pool->stride);
+                if (rc) {
+                    atomic_store(&r->status, rc);
+                    break;
+                }
+                atomic_store_explicit(&r->head, ++head, memory_order_release);
+            }
+        }
+        pthread_mutex_lock(&p->mu);
+        atomic_store(&p->sleeping, 1);
+        while (!p->wake && !atomic_load(&pool->stop) && !needs_refill(pool, p->index)) pthread_cond_wait(&p->cv, &p->mu);
+        atomic_store(&p->sleeping, 0);
+        p->wake = 0;
+        pthread_mutex_unlock(&p->mu);
+        atomic_fetch_add_explicit(&p->wakeups, 1, memory_order_relaxed);
+    }
+    return 0;
+}
+
+static void kick(producer *p) {
+    pthread_mutex_lock(&p->mu);
+    p->wake = 1;
+    pthread_cond_signal(&p->cv);
+    pthread_mutex_unlock(&p->mu);
+}
+
+static int valid(const sdat_noise_pool_config *c) {
+    if (!c || !c->seed || !c->consumers || c->consumers > SDAT_NOISE_POOL_MAX_CONSUMERS) return 0;
+    if (c->slots < 2 || (c->slots & (c->slots - 1)) || c->low_watermark >= c->slots) return 0;
+    if (!c->producers || c->producers > c->consumers) return 0;
+    if (c->source == SDAT_NOISE_FALCON_BASE)
+        return c->falcon_kind == FALCON_BASE_ORIGINAL || c->falcon_kind == FALCON_BASE_SDA;
+    return c->source == SDAT_NOISE_FRODO && frodo_get_sampler_params(c->param);
+}
+
+static int ring_init(sdat_noise_pool *pool, unsigned index, const uint8_t *seed, size_t seed_len) {
+    const sdat_noise_pool_config *c = &pool->cfg;
+    ring *r = &pool->rings[index];
+    uint8_t le[4] = {(uint8_t)index, (uint8_t)(index >> 8), (uint8_t)(index >> 16), (uint8_t)(index >> 24)}, key[32];
+    sdat_shake128_ctx h;
+    sdat_shake128_init(&h);
+    sdat_shake128_absorb(&h, seed, seed_len);
+    sdat_shake128_absorb(&h, le, sizeof le);
+    sdat_shake128_squeeze(&h, key, sizeof key);
+    sdat_secure_zero(&h, sizeof h);
+    size_t key_len = sdat_prg_stream_key_bytes(c->prg);
+    int rc = sdat_prg_init(&r->prg, c->prg, key, key_len ? key_len : sizeof key);
+    sdat_secure_zero(key, sizeof key);
+    if (rc) return -3;
+    atomic_init(&r->min_depth, c->slots);
+    if (!(r->slots = aligned_alloc(64, c->slots * pool->stride))) return -2;
+    memset(r->slots, 0, c->slots * pool->stride);
+    if (c->source != SDAT_NOISE_FRODO) return 0;
+    if (!(r->stream = aligned_alloc(64, (sizeof *r->stream + 63u) & ~(size_t)63u))) return -2;
+    if (frodo_stream_init(r->stream, c->frodo_kind, c->backend, c->frontend, c->param)) return -3;
+    frodo_stream_set_refill(r->stream, sdat_prg_randombytes, &r->prg);
+    return 0;
+}
+
+int sdat_noise_pool_create(sdat_noise_pool **out, const sdat_noise_pool_config *cfg) {
+    if (!out || !valid(cfg)) return -1;
+    *out = 0;
+    sdat_noise_pool *pool = calloc(1, sizeof *pool);
+    if (!pool) return -2;
+    pool->cfg = *cfg;
+    pool->cfg.seed = 0; /* only used to key the rings below */
+    pool->cfg.backend = frodo_resolve_backend(cfg->backend);
+    pool->block_samples = cfg->block_samples ? cfg->block_samples
+                          : cfg->source == SDAT_NOISE_FRODO ? frodo_get_sampler_params(cfg->param)->native_sample_count
+                                                            : SDAT_NOISE_FALCON_BLOCK;
+    pool->block_bytes = pool->block_samples * (cfg->source == SDAT_NOISE_FRODO ? sizeof(uint16_t) : sizeof(uint32_t));
+    pool->stride = (pool->block_bytes + 63u) & ~(size_t)63u;
+    pool->mask = cfg->slots - 1u;
+    pool->rings = aligned_alloc(64, cfg->consumers * sizeof *pool->rings);
+    pool->prods = calloc(cfg->producers, sizeof *pool->prods);
+    if (!pool->rings || !pool->prods) {
+        free(pool->rings);
+        free(pool->prods);
+        free(pool);
+        return -2;
+    }
+    memset(pool->rings, 0, cfg->consumers * sizeof *pool->rings);
+    int rc = frodo_backend_available(cfg->backend) ? 0 : -3;
+    for (unsigned c = 0; c < cfg->consumers && !rc; c++) rc = ring_init(pool, c, cfg->seed, cfg->seed_len);
+    for (unsigned i = 0; i < cfg->producers && !rc; i++) {
+        producer *p = &pool->prods[i];
+        p->pool = pool;
+        p->index = i;
+        pthread_mutex_init(&p->mu, 0);
+        pthread_cond_init(&p->cv, 0);
+        p->started = pthread_create(&p->tid, 0, produce, p) == 0;
+        if (!p->started) rc = -2;
+    }
+    if (rc) {
+        sdat_noise_pool_destroy(pool);
+        return rc;
+    }
+    *out = pool;
+    return 0;
+}
+
+void sdat_noise_pool_destroy(sdat_noise_pool *pool) {
+    if (!pool) return;
+    atomic_store(&pool->stop, 1);
+    for (unsigned i = 0; i < pool->cfg.producers; i++) {
+        producer *p = &pool->prods[i];
+        if (!p->pool) continue;
+        if (p->started) {
+            kick(p);
+            pthread_join(p->tid, 0);
+        }
+        pthread_mutex_destroy(&p->mu);
+        pthread_cond_destroy(&p->cv);
+    }
+    for (unsigned c = 0; c < pool->cfg.consumers; c++) {
+        ring *r = &pool->rings[c];
+        if (r->slots) sdat_secure_zero(r->slots, pool->cfg.slots * pool->stride);
+        free(r->slots);
+        if (r->stream) {
+            frodo_stream_wipe(r->stream);
+            free(r->stream);
+        }
+        sdat_prg_wipe(&r->prg);
+    }
+    free(pool->rings);
+    free(pool->prods);
+    free(pool);
+}
+
+size_t sdat_noise_pool_block_samples(const sdat_noise_pool *pool) { return pool->block_samples; }
+size_t sdat_noise_pool_block_bytes(const sdat_noise_pool *pool) { return pool->block_bytes; }
+
+const void *sdat_noise_pool_acquire(sdat_noise_pool *pool, unsigned consumer) {
+    ring *r = &pool->rings[consumer];
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (atomic_load_explicit(&r->head, memory_order_acquire) == tail) {
+        atomic_fetch_add_explicit(&r->empty_polls, 1, memory_order_relaxed);
+        return 0;
+    }
+    return r->slots + (tail & pool->mask) * pool->stride;
+}
+
+void sdat_noise_pool_release(sdat_noise_pool *pool, unsigned consumer) {
+    ring *r = &pool->rings[consumer];
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    wipe(r->slots + (tail & pool->mask) * pool->stride, pool->block_bytes);
+    atomic_store(&r->tail, tail + 1);
+    size_t d = atomic_load_explicit(&r->head, memory_order_relaxed) - (tail + 1);
+    if (d < atomic_load_explicit(&r->min_depth, memory_order_relaxed))
+        atomic_store_explicit(&r->min_depth, d, memory_order_relaxed);
+    producer *p = &pool->prods[consumer % pool->cfg.producers];
+    if (d <= pool->cfg.low_watermark && atomic_load(&p->sleeping)) kick(p);
+}
+
+int sdat_noise_pool_pop(sdat_noise_pool *pool, unsigned consumer, void *out) {
+    const void *b = sdat_noise_pool_acquire(pool, consumer);
+    if (!b) return atomic_load_explicit(&pool->rings[consumer].status, memory_order_relaxed) ? -2 : -1;
+    memcpy(out, b, pool->block_bytes);
+    sdat_noise_pool_release(pool, consumer);
+    return 0;
+}
+
+int sdat_noise_pool_pop_wait(sdat_noise_pool *pool, unsigned consumer, void *out) {
+    for (unsigned spin = 0;; spin++) {
+        int rc = sdat_noise_pool_pop(pool, consumer, out);
+        if (rc != -1) return rc;
+        if (spin >= 64) sched_yield();
+    }
+}
+
+void sdat_noise_pool_get_stats(const sdat_noise_pool *pool, unsigned consumer, sdat_noise_pool_stats *st) {
+    ring *r = &pool->rings[consumer];
+    size_t head = atomic_load(&r->head), tail = atomic_load(&r->tail);
+    st->produced = head;
+    st->consumed = tail;
+    st->empty_polls = atomic_load_explicit(&r->empty_polls, memory_order_relaxed);
+    st->wakeups = atomic_load_explicit(&pool->prods[consumer % pool->cfg.producers].wakeups, memory_order_relaxed);
+    st->depth = head - tail;
+    st->capacity = pool->cfg.slots;
+    st->min_depth = atomic_load_explicit(&r->min_depth, memory_order_relaxed);
+}
@@ -0,0 +1,81 @@
+#ifndef SDAT_NOISE_POOL_H
+#define SDAT_NOISE_POOL_H
+#include <stddef.h>
+#include <stdint.h>
+#include "falcon_base_sampler.h"
+#include "frodo_sampler.h"
+
+/* Precomputed noise for latency-sensitive callers. Background producer
+ * threads sample fixed-size blocks ahead of time into one lock-free
+ * single-producer/single-consumer ring per consumer; a consumer takes a ready
+ * block in O(1) (sdat_noise_pool_acquire / _release) without touching a lock
+ * or the sampler.
+ *
+ * Each ring has its own PRG, seeded with SHAKE128(seed || le32(consumer))
+ * truncated to sdat_prg_stream_key_bytes of the kind (32 bytes for the SHAKE
+ * kinds), and its blocks are the consecutive outputs of one sampler over that
+ * stream:
+ *   Frodo   frodo_stream (refilled from the PRG) with the configured kind,
+ *           backend and frontend, block_samples uint16_t values per block
+ *   Falcon  falcon_{original,sda}_gaussian0_sample_n[_avx2] pulling from the
+ *           PRG, block_samples uint32_t values per block
+ * so what a consumer sees never depends on the number of producers or on
+ * scheduling.
+ *
+ * Producers fill a ring up to its capacity, then sleep until some ring they
+ * own has drained to low_watermark blocks; only a consumer that crosses the
+ * watermark takes the producer's mutex to wake it. Released slots are
+ * zeroized before the producer may reuse them, and sdat_noise_pool_destroy
+ * wipes every slot and PRG state. */
+typedef enum { SDAT_NOISE_FRODO, SDAT_NOISE_FALCON_BASE } sdat_noise_source;
+
+typedef struct {
+    sdat_noise_source source;
+    frodo_sampler_kind frodo_kind;   /* Frodo: sampler, backend, frontend, parameter set */
+    frodo_backend backend;           /* also picks the Falcon sample_n; AUTO resolves */
+    frodo_frontend frontend;
+    frodo_param_id param;
+    falcon_base_kind falcon_kind;    /* Falcon: base table */
+    size_t block_samples;            /* 0: Frodo native_sample_count, Falcon 1024 */
+    unsigned consumers;              /* rings, 1..SDAT_NOISE_POOL_MAX_CONSUMERS */
+    unsigned slots;                  /* blocks per ring, a power of two >= 2 */
+    unsigned low_watermark;          /* refill when a ring holds <= this many blocks */
+    unsigned producers;              /* threads, 1..consumers; ring c belongs to c % producers */
+    sdat_prg_kind prg;
+    const uint8_t *seed;
+    size_t seed_len;
+} sdat_noise_pool_config;
+
+#define SDAT_NOISE_POOL_MAX_CONSUMERS 64u
+#define SDAT_NOISE_FALCON_BLOCK 1024u
+
+/* Per-ring counters; depth is a snapshot. */
+typedef struct {
+    uint64_t produced, consumed, empty_polls, wakeups;
+    size_t depth, capacity, min_depth;
+} sdat_noise_pool_stats;
+
+typedef struct sdat_noise_pool sdat_noise_pool;
+
+/* Returns 0, or -1 invalid configuration, -2 allocation or thread start
+ * failure, -3 a sampler or PRG that cannot be set up (e.g. an unavailable
+ * backend). Producers start filling immediately. */
+int sdat_noise_pool_create(sdat_noise_pool **pool, const sdat_noise_pool_config *cfg);
+/* Stops and joins the producers, then zeroizes and frees everything. */
+void sdat_noise_pool_destroy(sdat_noise_pool *pool);
+size_t sdat_noise_pool_block_samples(const sdat_noise_pool *pool);
+size_t sdat_noise_pool_block_bytes(const sdat_noise_pool *pool);
+
+/* Consumer side; consumer c must be used by one thread at a time.
+ * acquire returns the oldest ready block (uint16_t or uint32_t samples) or
+ * NULL when the ring is empty; the block stays valid until release, which
+ * zeroizes it and hands the slot back. pop copies the block to out and
+ * releases it: 0, or -1 when empty. A nonzero producer status (sampler or PRG
+ * failure) is returned as -2 once the ring has drained. */
+const void *sdat_noise_pool_acquire(sdat_noise_pool *pool, unsigned consumer);
+void sdat_noise_pool_release(sdat_noise_pool *pool, unsigned consumer);
+int sdat_noise_pool_pop(sdat_noise_pool *pool, unsigned consumer, void *out);
+/* Blocks until a block is ready (spinning, then yielding). */
+int sdat_noise_pool_pop_wait(sdat_noise_pool *pool, unsigned consumer, void *out);
+void sdat_noise_pool_get_stats(const sdat_noise_pool *pool, unsigned consumer, sdat_noise_pool_stats *st);
+#endif
@@ -1,7 +1,10 @@
+#include "falcon_base_counter.h"
 #include "falcon_base_sampler.h"
 #include "sdat_ref.h"
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 typedef struct { const uint8_t *p; size_t n, pos; } bytes_ctx;
 static int bytes_cb(void *ctx, uint8_t *out, size_t n) {
@@ -35,6 +38,31 @@ static int check_tables(void) {
         if (i && sdat_u72_lt(c[i], c[i-1])) return 7;
     }
     if (sdat_u72_cmp(sum, sda_table_falcon_base.denominator_u72)) return 8;
+    /* SoA copies hold the same thresholds */
+    const sdat_table *tabs[2] = {&original_cdt_table_falcon_base, &sda_table_falcon_base};
+    const sdat_u72_soa *soas[2] = {&original_cdt_soa_falcon_base, &sda_soa_falcon_base};
+    for (int k = 0; k < 2; k++) {
+        const sdat_u72 *t = (const sdat_u72 *)tabs[k]->thresholds;
+        if (soas[k]->count != tabs[k]->threshold_count) return 9;
+        for (size_t i = 0; i < soas[k]->count; i++) if (soas[k]->lo[i] != t[i].lo || soas[k]->hi[i] != t[i].hi) return 9;
+    }
+    return 0;
+}
+
+static int check_ct_compare(void) {
+    const sdat_u72 edge[] = {{0,0},{1,0},{UINT64_MAX,0},{0,1},{UINT64_MAX,254},{0,255},{UINT64_MAX,255},{1ULL << 63,7},{(1ULL << 63) - 1,7}};
+    const size_t ne = sizeof edge / sizeof edge[0];
+    uint64_t z = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < 20000; i++) {
+        sdat_u72 a, b;
+        if (i < ne * ne) { a = edge[i / ne]; b = edge[i % ne]; }
+        else {
+            z ^= z << 13; z ^= z >> 7; z ^= z << 17; a = (sdat_u72){z, (uint8_t)(z >> 5)};
+            z ^= z << 13; z ^= z >> 7; z ^= z << 17; b = (i & 1) ? (sdat_u72){z, a.hi} : (sdat_u72){a.lo ^ (z & 0xff), (uint8_t)z};
+        }
+        if (sdat_u72_lt_ct(a, b) != sdat_u72_lt(a, b) || sdat_u72_ge_ct(a, b) != sdat_u72_ge(a, b)) return 90;
+        if (online_lookup_u72_soa(a, &sda_soa_falcon_base) != online_lookup_u72(a, (const sdat_u72 *)sda_table_falcon_base.thresholds, sda_table_falcon_base.threshold_count)) return 91;
+    }
     return 0;
 }
 
@@ -122,6 +150,166 @@ static int check_batch(void) {
     return 0;
 }
 
+static int check_stream_resume(void) {
+    static uint8_t buf[9 * 3000];
+    for (size_t i = 0; i < sizeof buf; i++) buf[i] = (uint8_t)(i * 29 + 11 + (i >> 9));
+    for (size_t i = 8; i < sizeof buf; i += 45) buf[i] = 0xff; /* every fifth draw rejected by SDA */
+    const size_t cuts[] = {1, 2, 5, 8, 9, 10, 100, 4000};
+    static uint32_t a[2500], b[2500];
+    for (int kind = 0; kind < 2; kind++) {
+        for (size_t ci = 0; ci < sizeof(cuts)/sizeof(cuts[0]); ci++) {
+            const size_t n = 2000;
+            bytes_ctx c = {buf, sizeof buf, 0}; sdat_stats st = {0};
+            size_t k = kind ? falcon_sda_gaussian0_sample_n(bytes_cb, &c, a, n, &st)
+                            : falcon_original_gaussian0_sample_n(bytes_cb, &c, a, n, &st);
+            if (k != n) return 60;
+            falcon_base_stream s;
+            if (falcon_base_stream_init(&s, kind ? FALCON_BASE_SDA : FALCON_BASE_ORIGINAL)) return 61;
+            size_t in = 0, done = 0, want = 1;
+            while (done < n && in < sizeof buf) {
+                size_t m = sizeof buf - in < cuts[ci] ? sizeof buf - in : cuts[ci], used;
+                size_t w = n - done < want ? n - done : want;
+                size_t got = falcon_base_stream_push(&s, buf + in, m, &used, b + done, w);
+                if (used > m || got > w || (got < w && used != m)) return 62;
+                in += used; done += got; want = want % 13 + 1;
+            }
+            if (done != n || memcmp(a, b, n * sizeof a[0])) return 63;
+            if (memcmp(&s.stats, &st, sizeof st) || in != c.pos) return 64;
+            bytes_ctx r = {buf, 0, 0};
+            falcon_base_stream_init(&s, kind ? FALCON_BASE_SDA : FALCON_BASE_ORIGINAL);
+            falcon_base_stream_set_refill(&s, bytes_cb, &r);
+            memset(b, 0, sizeof b); done = 0;
+            for (int round = 0; done < n && round < 10000; round++) {
+                r.n = r.n + cuts[ci] * 9 > sizeof buf ? sizeof buf : r.n + cuts[ci] * 9;
+                done += falcon_base_stream_sample_n(&s, b + done, n - done);
+            }
+            if (done != n || memcmp(a, b, n * sizeof a[0])) return 65;
+        }
+    }
+    return 0;
+}
+
+static int check_avx2_equivalence(void) {
+    size_t lens[] = {0,1,7,8,9,15,16,17,63,257,1000};
+    static uint8_t buf[9 * 2048]; for (size_t i = 0; i < sizeof buf; i++) buf[i] = (uint8_t)(i * 113 + 7);
+    /* plant threshold boundaries and rejections so every lane sees them */
+    const sdat_u72 *ot = (const sdat_u72 *)original_cdt_table_falcon_base.thresholds, *st_ = (const sdat_u72 *)sda_table_falcon_base.thresholds;
+    size_t k = 0;
+    for (size_t i = 0; i < original_cdt_table_falcon_base.threshold_count; i++) { sdat_u72_to_le9(ot[i], buf + 9 * k++); sdat_u72_to_le9(sub1(ot[i]), buf + 9 * k++); }
+    for (size_t i = 0; i < sda_table_falcon_base.threshold_count; i++) { sdat_u72_to_le9(st_[i], buf + 9 * k++); sdat_u72_to_le9(sub1(st_[i]), buf + 9 * k++); }
+    sdat_u72_to_le9(sda_table_falcon_base.denominator_u72, buf + 9 * k++); sdat_u72_to_le9(sub1(sda_table_falcon_base.denominator_u72), buf + 9 * k++);
+    sdat_u72_to_le9((sdat_u72){UINT64_MAX,255}, buf + 9 * k++); sdat_u72_to_le9((sdat_u72){0,0}, buf + 9 * k++);
+    static uint32_t a[1000], b[1000];
+    for (size_t li = 0; li < sizeof(lens)/sizeof(lens[0]); li++) {
+        size_t n = lens[li];
+        for (int kind = 0; kind < 2; kind++) {
+            bytes_ctx c1 = {buf, sizeof buf, 0}, c2 = {buf, sizeof buf, 0}; sdat_stats s1, s2;
+            size_t g1 = kind ? falcon_sda_gaussian0_sample_n(bytes_cb, &c1, a, n, &s1) : falcon_original_gaussian0_sample_n(bytes_cb, &c1, a, n, &s1);
+            size_t g2 = kind ? falcon_sda_gaussian0_sample_n_avx2(bytes_cb, &c2, b, n, &s2) : falcon_original_gaussian0_sample_n_avx2(bytes_cb, &c2, b, n, &s2);
+            if (g1 != n || g2 != n || memcmp(a, b, n * sizeof a[0])) return 70 + kind;
+            if (c1.pos != c2.pos || memcmp(&s1, &s2, sizeof s1)) return 72 + kind;
+            bytes_ctx c3 = {buf, sizeof buf, 0};
+            size_t g3 = kind ? falcon_sda_gaussian0_sample_n_avx2(bytes_cb, &c3, b, n, 0) : falcon_original_gaussian0_sample_n_avx2(bytes_cb, &c3, b, n, 0);
+            if (g3 != n || c3.pos != c1.pos || memcmp(a, b, n * sizeof a[0])) return 74 + kind;
+        }
+    }
+    /* an exhausted source stops at a batch boundary without overrunning */
+    bytes_ctx shortc = {buf, 9 * 12, 0};
+    if (falcon_original_gaussian0_sample_n_avx2(bytes_cb, &shortc, a, 20, 0) != 8 || shortc.pos != 72) return 76;
+    return 0;
+}
+
+static int check_from_buffer(void) {
+    size_t lens[] = {0,1,7,8,9,17,64,300};
+    size_t blens[] = {0,8,9,80,81,9 * 64 + 5,9 * 400};
+    static uint8_t buf[9 * 400]; for (size_t i = 0; i < sizeof buf; i++) buf[i] = (uint8_t)(i * 71 + 5);
+    /* rejections in the middle and at the very end of the buffer */
+    sdat_u72_to_le9((sdat_u72){UINT64_MAX,255}, buf + 9 * 3); sdat_u72_to_le9(sda_table_falcon_base.denominator_u72, buf + 9 * 8);
+    sdat_u72_to_le9((sdat_u72){UINT64_MAX,255}, buf + 9 * 399);
+    static uint32_t a[300], b[300], c[300];
+    for (size_t bi = 0; bi < sizeof(blens)/sizeof(blens[0]); bi++)
+        for (size_t li = 0; li < sizeof(lens)/sizeof(lens[0]); li++)
+            for (int kind = 0; kind < 2; kind++) {
+                size_t n = lens[li], len = blens[bi], u1 = 99, u2 = 99;
+                bytes_ctx cb = {buf, len, 0}; sdat_stats s0, s1, s2;
+                size_t g0 = kind ? falcon_sda_gaussian0_sample_n(bytes_cb, &cb, a, n, &s0) : falcon_original_gaussian0_sample_n(bytes_cb, &cb, a, n, &s0);
+                size_t g1 = kind ? falcon_sda_gaussian0_sample_n_from_buffer(buf, len, &u1, b, n, &s1) : falcon_original_gaussian0_sample_n_from_buffer(buf, len, &u1, b, n, &s1);
+                size_t g2 = kind ? falcon_sda_gaussian0_sample_n_from_buffer_avx2(buf, len, &u2, c, n, &s2) : falcon_original_gaussian0_sample_n_from_buffer_avx2(buf, len, &u2, c, n, &s2);
+                if (g0 != g1 || g1 != g2 || memcmp(a, b, g0 * sizeof a[0]) || memcmp(a, c, g0 * sizeof a[0])) return 80 + kind;
+                if (u1 != u2 || u1 % 9 || memcmp(&s1, &s2, sizeof s1) || s1.random_bytes != u1) return 82 + kind;
+                /* the callback sampler may stop short of a trailing draw it could not read */
+                if (g0 == n && (u1 != cb.pos || memcmp(&s0, &s1, sizeof s0))) return 84 + kind;
+                if (g1 < n && len - u1 >= 9) return 86 + kind;
+            }
+    return 0;
+}
+
+/* Inputs that end right before a PROT_NONE page: the AVX2 gathers must not
+ * read past in + in_len, whatever the length of the tail. */
+static int check_from_buffer_guard_page(void) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uint8_t *map = mmap(0, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) return 90;
+    if (mprotect(map + page, page, PROT_NONE)) { munmap(map, 2 * page); return 91; }
+    for (size_t i = 0; i < page; i++) map[i] = (uint8_t)(i * 29 + 3);
+    uint32_t a[64], b[64];
+    for (size_t len = 0; len <= 9 * 20 + 8; len++)
+        for (int kind = 0; kind < 2; kind++) {
+            const uint8_t *in = map + page - len;
+            size_t u1 = 99, u2 = 99, n = 64;
+            size_t g1 = kind ? falcon_sda_gaussian0_sample_n_from_buffer(in, len, &u1, a, n, 0) : falcon_original_gaussian0_sample_n_from_buffer(in, len, &u1, a, n, 0);
+            size_t g2 = kind ? falcon_sda_gaussian0_sample_n_from_buffer_avx2(in, len, &u2, b, n, 0) : falcon_original_gaussian0_sample_n_from_buffer_avx2(in, len, &u2, b, n, 0);
+            if (g1 != g2 || u1 != u2 || memcmp(a, b, g1 * sizeof a[0])) { munmap(map, 2 * page); return 92 + kind; }
+        }
+    munmap(map, 2 * page);
+    return 0;
+}
+
+static const uint8_t key[32] = {1, 8, 2, 0, 5, 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5,
+                                8, 9, 7, 9, 3, 2, 3, 8, 4, 6, 2, 6, 4, 3, 3, 8};
+
+/* Counter-based base-sampler jobs give the same outputs for any shard split
+ * and thread count, and chunk 0 of stream 0 is the plain seeded sampler. */
+static int check_counter(void) {
+    enum { N = 2 * FALCON_COUNTER_CHUNK + 777 };
+    static uint32_t full[N], part[N], ref[FALCON_COUNTER_CHUNK];
+    static const sdat_prg_kind prgs[3] = {SDAT_PRG_AES128_CTR, SDAT_PRG_CHACHA20, SDAT_PRG_PHILOX4X32};
+    const uint64_t first = 3000;
+    for (int k = 0; k < 3; k++)
+        for (int base = 0; base < 2; base++) {
+            falcon_base_kind bk = base ? FALCON_BASE_SDA : FALCON_BASE_ORIGINAL;
+            size_t kl = sdat_prg_stream_key_bytes(prgs[k]);
+            sdat_stats fs, ps;
+            if (falcon_gaussian0_sample_n_counter(bk, full, first, N, prgs[k], key, kl, 4, &fs)) return 100;
+            for (unsigned shards = 2; shards <= 5; shards++) {
+                size_t done = 0;
+                for (unsigned i = 0; i < shards; i++) {
+                    size_t m = i + 1 == shards ? N - done : N / shards + i * 37u;
+                    if (falcon_gaussian0_sample_n_counter(bk, part + done, first + done, m, prgs[k], key, kl, 4, 0))
+                        return 101;
+                    done += m;
+                }
+                if (memcmp(full, part, sizeof full)) return 101;
+            }
+            for (unsigned th = 1; th <= 4; th++) {
+                memset(part, 0, sizeof part);
+                if (falcon_gaussian0_sample_n_counter_parallel(bk, part, first, N, prgs[k], key, kl, 4, &ps, th) ||
+                    memcmp(full, part, sizeof full) || memcmp(&fs, &ps, sizeof fs))
+                    return 102;
+            }
+            sdat_prg g;
+            sdat_prg_init(&g, prgs[k], key, kl);
+            (base ? falcon_sda_gaussian0_sample_n : falcon_original_gaussian0_sample_n)(sdat_prg_randombytes, &g, ref,
+                                                                                         FALCON_COUNTER_CHUNK, 0);
+            if (falcon_gaussian0_sample_n_counter(bk, part, 0, FALCON_COUNTER_CHUNK, prgs[k], key, kl, 0, 0) ||
+                memcmp(part, ref, sizeof ref))
+                return 103;
+        }
+    if (falcon_gaussian0_sample_n_counter(FALCON_BASE_SDA, full, 0, 8, SDAT_PRG_SHAKE128, key, 32, 0, 0) != -1)
+        return 104;
+    return 0;
+}
+
 int main(void) {
     int r;
     if ((r = check_tables())) return r;
@@ -130,6 +318,12 @@ int main(void) {
     if ((r = check_byte_order_and_rejection())) return r;
     if ((r = check_batch())) return r;
     if ((r = check_no_stats_equivalence())) return r;
+    if ((r = check_stream_resume())) return r;
+    if ((r = check_avx2_equivalence())) return r;
+    if ((r = check_from_buffer())) return r;
+    if ((r = check_from_buffer_guard_page())) return r;
+    if ((r = check_ct_compare())) return r;
+    if ((r = check_counter())) return r;
     puts("falcon base sampler tests passed");
     return 0;
 }
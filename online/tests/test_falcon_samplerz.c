@@ -0,0 +1,219 @@
+#include "falcon_samplerz.h"
+#include "falcon_original_raw_constants.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const uint8_t seed[32] = {1, 8, 2, 0, 5, 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5,
+                                 8, 9, 7, 9, 3, 2, 3, 8, 4, 6, 2, 6, 4, 3, 3, 8};
+
+static int check_expm(void) {
+    static const double ccs[] = {1.0, 0.999999, 0.75, 0.5, 0.0};
+    for (size_t k = 0; k < sizeof ccs / sizeof ccs[0]; k++)
+        for (int i = 0; i < 1000; i++) {
+            double x = 0.6931471805599453 * i / 1000.0;
+            double got = (double)falcon_samplerz_expm_p63(x, ccs[k]) / 9223372036854775808.0;
+            if (fabs(got - ccs[k] * exp(-x)) > 1e-14) return 100;
+        }
+    return 0;
+}
+
+static int check_init(void) {
+    falcon_samplerz_ctx sc;
+    if (falcon_samplerz_init(&sc, (falcon_base_kind)7, FALCON_SAMPLERZ_INLINE, SDAT_PRG_CHACHA20, seed, 32, 1.2) != -3) return 101;
+    if (falcon_samplerz_init(&sc, FALCON_BASE_SDA, (falcon_samplerz_mode)7, SDAT_PRG_CHACHA20, seed, 32, 1.2) != -3) return 101;
+    if (falcon_samplerz_init(&sc, FALCON_BASE_SDA, FALCON_SAMPLERZ_INLINE, SDAT_PRG_CHACHA20, seed, 32, 2.0) != -1) return 102;
+    if (falcon_samplerz_init(&sc, FALCON_BASE_SDA, FALCON_SAMPLERZ_INLINE, SDAT_PRG_CHACHA20, seed, 31, 1.2) != -1) return 102;
+    if (falcon_samplerz_init(0, FALCON_BASE_SDA, FALCON_SAMPLERZ_INLINE, SDAT_PRG_CHACHA20, seed, 32, 1.2) != -1) return 102;
+    return 0;
+}
+
+static int check_berexp(void) {
+    static const double xs[] = {0.0, 0.7, 2.5, 50.0}, cs[] = {0.9, 0.8, 1.0, 1.0};
+    falcon_samplerz_ctx sc;
+    falcon_samplerz_init(&sc, FALCON_BASE_ORIGINAL, FALCON_SAMPLERZ_INLINE, SDAT_PRG_CHACHA20, seed, 32,
+                         FALCON_SAMPLERZ_SIGMA_MIN_512);
+    for (size_t k = 0; k < sizeof xs / sizeof xs[0]; k++) {
+        int hits = 0, n = 200000;
+        for (int i = 0; i < n; i++) hits += falcon_samplerz_berexp(&sc, xs[k], cs[k]);
+        if (fabs((double)hits / n - cs[k] * exp(-xs[k])) > 0.005) return 103;
+    }
+    return 0;
+}
+
+/* Empirical pmf against exp(-(z-mu)^2 / (2 sigma^2)), normalized, for every
+ * base table and mode; determinism per seed. */
+static int check_distribution(void) {
+    static const double mus[] = {-3.3, 0.0, 17.75}, sigmas[] = {1.5, FALCON_SAMPLERZ_SIGMA_MIN_512, 1.8205};
+    enum { N = 200000, W = 16 };
+    for (int base = 0; base < 2; base++)
+        for (int mode = 0; mode < 2; mode++)
+            for (size_t k = 0; k < sizeof mus / sizeof mus[0]; k++) {
+                falcon_samplerz_ctx sc, sc2;
+                falcon_base_kind bk = base ? FALCON_BASE_SDA : FALCON_BASE_ORIGINAL;
+                falcon_samplerz_mode md = mode ? FALCON_SAMPLERZ_BATCHED : FALCON_SAMPLERZ_INLINE;
+                if (falcon_samplerz_init(&sc, bk, md, SDAT_PRG_CHACHA20, seed, 32, FALCON_SAMPLERZ_SIGMA_MIN_512)) return 104;
+                falcon_samplerz_init(&sc2, bk, md, SDAT_PRG_CHACHA20, seed, 32, FALCON_SAMPLERZ_SIGMA_MIN_512);
+                double mu = mus[k], sigma = sigmas[k], isigma = 1.0 / sigma;
+                int c0 = (int)floor(mu);
+                static int hist[2 * W + 1];
+                memset(hist, 0, sizeof hist);
+                for (int i = 0; i < N; i++) {
+                    int z = falcon_samplerz(&sc, mu, isigma);
+                    if (i < 1000 && falcon_samplerz(&sc2, mu, isigma) != z) return 105;
+                    if (z - c0 < -W || z - c0 > W) return 106;
+                    hist[z - c0 + W]++;
+                }
+                double norm = 0.0;
+                for (int d = -W; d <= W; d++) norm += exp(-((c0 + d) - mu) * ((c0 + d) - mu) / (2 * sigma * sigma));
+                for (int d = -W; d <= W; d++) {
+                    double p = exp(-((c0 + d) - mu) * ((c0 + d) - mu) / (2 * sigma * sigma)) / norm;
+                    if (fabs((double)hist[d + W] / N - p) > 0.004) return 107;
+                }
+                const falcon_samplerz_stats *st = &sc.stats;
+                if (st->calls != N || st->iterations < st->calls || st->base_draws < st->iterations) return 108;
+                if (bk == FALCON_BASE_ORIGINAL && st->base_rejections) return 108;
+                if (md == FALCON_SAMPLERZ_INLINE && st->base_draws - st->base_rejections != st->iterations) return 108;
+                falcon_samplerz_wipe(&sc);
+            }
+    return 0;
+}
+
+/* The batched cache holds the buffer sampler's outputs over the first
+ * draw_buf of the stream, including the short batch at its end, which the
+ * AVX2 sampler must take from a padded copy rather than past draw_buf. */
+static int check_batched_tail(void) {
+    static uint8_t bytes[FALCON_SAMPLERZ_BASE_BATCH * FALCON_BASE_RANDOM_BYTES];
+    uint32_t ref[FALCON_SAMPLERZ_BASE_BATCH];
+    for (int base = 0; base < 2; base++) {
+        falcon_samplerz_ctx sc;
+        sdat_prg g;
+        size_t used;
+        falcon_base_kind bk = base ? FALCON_BASE_SDA : FALCON_BASE_ORIGINAL;
+        if (falcon_samplerz_init(&sc, bk, FALCON_SAMPLERZ_BATCHED, SDAT_PRG_CHACHA20, seed, 32, 1.2)) return 115;
+        falcon_samplerz(&sc, 0.5, 1.0 / 1.5);
+        sdat_prg_init(&g, SDAT_PRG_CHACHA20, seed, 32);
+        sdat_prg_generate(&g, bytes, sizeof bytes);
+        size_t n = (base ? falcon_sda_gaussian0_sample_n_from_buffer : falcon_original_gaussian0_sample_n_from_buffer)(
+            bytes, sizeof bytes, &used, ref, FALCON_SAMPLERZ_BASE_BATCH, 0);
+        if (sc.z0_len != n || used != sizeof bytes || memcmp(sc.z0, ref, n * sizeof ref[0])) return 116;
+        falcon_samplerz_wipe(&sc);
+        sdat_prg_wipe(&g);
+    }
+    return 0;
+}
+
+/* Test-local port of prng_get_u64/u8, gaussian0_sampler(), BerExp() and
+ * sampler() from the reference sign.c, over the same seed expander. */
+typedef struct {
+    sdat_prg prg;
+    uint8_t buf[FALCON_SAMPLERZ_PRNG_BYTES];
+    size_t ptr;
+    uint64_t refills;
+} ref_prng;
+
+static void ref_refill(ref_prng *p) {
+    sdat_prg_generate(&p->prg, p->buf, sizeof p->buf);
+    p->ptr = 0;
+    p->refills++;
+}
+
+static uint64_t ref_get_u64(ref_prng *p) {
+    size_t u = p->ptr;
+    if (u >= sizeof p->buf - 9) {
+        ref_refill(p);
+        u = 0;
+    }
+    p->ptr = u + 8;
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p->buf[u + i];
+    return v;
+}
+
+static unsigned ref_get_u8(ref_prng *p) {
+    unsigned v = p->buf[p->ptr++];
+    if (p->ptr == sizeof p->buf) ref_refill(p);
+    return v;
+}
+
+static int ref_gaussian0(ref_prng *p) {
+    uint64_t lo = ref_get_u64(p);
+    uint32_t hi = ref_get_u8(p);
+    uint32_t v0 = (uint32_t)lo & 0xFFFFFF, v1 = (uint32_t)(lo >> 24) & 0xFFFFFF, v2 = (uint32_t)(lo >> 48) | (hi << 16);
+    int z = 0;
+    for (size_t u = 0; u < 3 * FALCON_ORIGINAL_GAUSSIAN0_DIST_TRIPLES; u += 3) {
+        uint32_t cc = (v0 - falcon_original_gaussian0_dist[u + 2]) >> 31;
+        cc = (v1 - falcon_original_gaussian0_dist[u + 1] - cc) >> 31;
+        cc = (v2 - falcon_original_gaussian0_dist[u] - cc) >> 31;
+        z += (int)cc;
+    }
+    return z;
+}
+
+static int ref_berexp(ref_prng *p, double x, double ccs) {
+    uint32_t s = (uint32_t)(int)(x * 1.4426950408889634073599246810);
+    double r = x - (double)s * 0.69314718055994530941723212146;
+    s ^= (s ^ 63u) & -((63u - s) >> 31);
+    uint64_t z = ((falcon_samplerz_expm_p63(r, ccs) << 1) - 1) >> s;
+    uint32_t w;
+    int i = 64;
+    do {
+        i -= 8;
+        w = ref_get_u8(p) - ((uint32_t)(z >> i) & 0xFFu);
+    } while (!w && i > 0);
+    return (int)(w >> 31);
+}
+
+static int ref_sampler(ref_prng *p, double sigma_min, double mu, double isigma) {
+    int s = (int)floor(mu);
+    double r = mu - (double)s, dss = 0.5 * isigma * isigma, ccs = isigma * sigma_min;
+    for (;;) {
+        int z0 = ref_gaussian0(p);
+        int b = (int)ref_get_u8(p) & 1;
+        int z = b + ((b << 1) - 1) * z0;
+        double x = ((double)z - r) * ((double)z - r) * dss - (double)(z0 * z0) * 0.150865048875372721532312163019;
+        if (ref_berexp(p, x, ccs)) return s + z;
+    }
+}
+
+/* INLINE with the Original table against the reference: same outputs and the
+ * same read position in the byte stream after every call. The reference
+ * refills eagerly when a u8 read empties the block, the context lazily, so
+ * positions are compared as bytes consumed. */
+static int check_reference_kat(void) {
+    static const sdat_prg_kind prgs[] = {SDAT_PRG_CHACHA20, SDAT_PRG_SHAKE128};
+    for (size_t k = 0; k < sizeof prgs / sizeof prgs[0]; k++) {
+        falcon_samplerz_ctx sc;
+        ref_prng p;
+        if (falcon_samplerz_init(&sc, FALCON_BASE_ORIGINAL, FALCON_SAMPLERZ_INLINE, prgs[k], seed, 32,
+                                 FALCON_SAMPLERZ_SIGMA_MIN_1024)) return 117;
+        memset(&p, 0, sizeof p);
+        if (sdat_prg_init(&p.prg, prgs[k], seed, 32)) return 117;
+        ref_refill(&p);
+        p.refills = 0;
+        for (int i = 0; i < 100000; i++) {
+            double mu = 0.37 * i - 1000.0 * (i & 7), isigma = 1.0 / (FALCON_SAMPLERZ_SIGMA_MIN_1024 + 0.5 * (i % 11) / 10.0);
+            if (falcon_samplerz(&sc, mu, isigma) != ref_sampler(&p, FALCON_SAMPLERZ_SIGMA_MIN_1024, mu, isigma)) return 118;
+            /* A full round mostly reads 11 bytes; odd BerExp reads move the
+             * draws across every offset, 503 included. */
+            if (i % 3 == 0 && falcon_samplerz_berexp(&sc, 0.1 * (i % 5), 1.0) != ref_berexp(&p, 0.1 * (i % 5), 1.0)) return 118;
+            if (sc.stats.prng_bytes - (sizeof sc.buf - sc.pos) != p.refills * sizeof p.buf + p.ptr) return 119;
+        }
+        if (p.ptr && memcmp(sc.buf, p.buf, sizeof p.buf)) return 119;
+        falcon_samplerz_wipe(&sc);
+        sdat_prg_wipe(&p.prg);
+    }
+    return 0;
+}
+
+int main(void) {
+    int r;
+    if ((r = check_expm())) return r;
+    if ((r = check_init())) return r;
+    if ((r = check_berexp())) return r;
+    if ((r = check_distribution())) return r;
+    if ((r = check_batched_tail())) return r;
+    if ((r = check_reference_kat())) return r;
+    puts("falcon samplerZ tests passed");
+    return 0;
+}
@@ -1,8 +1,12 @@
 #include "frodo_sample_n.h"
 #include "frodo_sample_n_fast.h"
+#include "frodo_kernels_gen.h"
 #include "frodo_sampler.h"
 #include "sdat_avx2.h"
+#include "sdat_cpu.h"
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 static const sdat_table*tabs_o[3]={&original_cdt_table_frodo640,&original_cdt_table_frodo976,&original_cdt_table_frodo1344};
 static const sdat_table*tabs_s[3]={&sda_table_frodo640,&sda_table_frodo976,&sda_table_frodo1344};
@@ -36,9 +40,205 @@ static int test_word_no_stats_equivalence(void){
  return 0;
 }
 
+static int test_word_avx2_equivalence(void){
+ const size_t lens[]={0,1,7,15,16,17,31,32,33,100,1023,4096}; const size_t wcs[]={0,5,16,40,9000}; static uint16_t words[9000],a[4096],b[4096];
+ for(size_t i=0;i<9000;i++)words[i]=(uint16_t)(i*40503u+97u+(i>>3)*7919u);
+ for(int ti=0;ti<3;ti++)for(size_t li=0;li<sizeof(lens)/sizeof(lens[0]);li++)for(size_t wi=0;wi<sizeof(wcs)/sizeof(wcs[0]);wi++){size_t n=lens[li],wc=wcs[wi];sdat_stats s1={0},s2={0};memset(a,0xaa,sizeof a);memset(b,0xaa,sizeof b);
+  int r1=frodo_sda_word_sample_n(a,n,words,wc,tabs_s[ti],0),r2=frodo_sda_word_sample_n_avx2(b,n,words,wc,tabs_s[ti],0);if(r1!=r2)return 270+ti;if(!r1&&memcmp(a,b,sizeof a))return 275+ti;
+  r1=frodo_sda_word_sample_n(a,n,words,wc,tabs_s[ti],&s1);r2=frodo_sda_word_sample_n_avx2(b,n,words,wc,tabs_s[ti],&s2);if(r1!=r2)return 280+ti;if(!r1&&memcmp(a,b,sizeof a))return 285+ti;
+  if(s1.attempts!=s2.attempts||s1.rejections!=s2.rejections||s1.random_bits!=s2.random_bits||s1.random_bytes!=s2.random_bytes)return 290+ti;}
+ return 0;
+}
+
+static int test_packed_avx2_extract(void){
+ static uint8_t buf[20000]; static uint16_t a[8192],b[8192]; const size_t lens[]={0,1,7,8,9,64,1000,8192}; const size_t blens[]={0,3,31,32,33,200,20000}; uint64_t x=99;
+ for(size_t i=0;i<sizeof buf;i++){x=x*6364136223846793005ULL+1442695040888963407ULL;buf[i]=(uint8_t)(x>>56);}
+ for(int ti=0;ti<3;ti++)for(unsigned pre=0;pre<70;pre+=23)for(size_t li=0;li<sizeof(lens)/sizeof(lens[0]);li++)for(size_t bi=0;bi<sizeof(blens)/sizeof(blens[0]);bi++){
+  sdat_bitreader_fast r1,r2;sdat_bitreader_fast_init(&r1,buf,blens[bi]);sdat_bitreader_fast_init(&r2,buf,blens[bi]);uint32_t t;for(unsigned k=0;k<pre;k++){int e1=sdat_take_1(&r1,&t),e2=sdat_take_1(&r2,&t);if(e1!=e2)return 300;}
+  sdat_stats s1={0},s2={0};int rc1=frodo_sda_sample_n_fast(a,lens[li],&r1,tabs_s[ti],&s1),rc2=frodo_sda_sample_n_fast_avx2(b,lens[li],&r2,tabs_s[ti],&s2);if(rc1!=rc2)return 310+ti;
+  if(!rc1&&(memcmp(a,b,lens[li]*2)||r1.bits_consumed!=r2.bits_consumed||s1.attempts!=s2.attempts||s1.rejections!=s2.rejections||s1.random_bits!=s2.random_bits||s1.random_bytes!=s2.random_bytes))return 320+ti;
+  if(!rc1){uint32_t u1,u2;int e1=sdat_take_13(&r1,&u1),e2=sdat_take_13(&r2,&u2);if(e1!=e2||(!e1&&u1!=u2))return 330+ti;}}
+ return 0;
+}
+
 static int test_dispatch_framework(void){
  const frodo_sampler_params*p; uint8_t buf[512]; uint16_t words[512],a[64],b[64]; for(size_t i=0;i<sizeof buf;i++)buf[i]=(uint8_t)(i*17+5); for(size_t i=0;i<512;i++)words[i]=(uint16_t)(i*251u+7u);
  for(int ti=0;ti<3;ti++){p=frodo_get_sampler_params((frodo_param_id)ti); if(!p||!p->original_table||!p->sda_table)return 150+ti; frodo_sampler_stats fs={0}; memcpy(a,words,sizeof a); if(frodo_sample_n_dispatch(FRODO_SAMPLER_ORIGINAL_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_ORIGINAL_WORD,(frodo_param_id)ti,a,64,buf,sizeof buf,words,512,&fs))return 160+ti; memcpy(b,words,sizeof b); if(frodo_original_sample_n(b,64,p->original_table))return 170+ti; if(memcmp(a,b,sizeof a))return 180+ti; if(frodo_sample_n_dispatch(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_PACKED_BIT,(frodo_param_id)ti,a,32,buf,sizeof buf,words,512,&fs))return 190+ti; if(frodo_sample_n_dispatch(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_WORD_ORIENTED,(frodo_param_id)ti,a,32,buf,sizeof buf,words,512,&fs))return 200+ti; if(sdat_avx2_cpu_supported()){ if(frodo_sample_n_dispatch(FRODO_SAMPLER_ORIGINAL_CDT,FRODO_BACKEND_AVX2,FRODO_FRONTEND_ORIGINAL_WORD,(frodo_param_id)ti,a,64,buf,sizeof buf,words,512,&fs))return 210+ti; if(frodo_sample_n_dispatch(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_AVX2,FRODO_FRONTEND_PACKED_BIT,(frodo_param_id)ti,a,32,buf,sizeof buf,words,512,&fs))return 220+ti; if(frodo_sample_n_dispatch(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_AVX2,FRODO_FRONTEND_WORD_ORIENTED,(frodo_param_id)ti,a,32,buf,sizeof buf,words,512,&fs))return 230+ti; }}
  return 0;
 }
-int main(void){int r;if((r=test_orig()))return r;if((r=test_sda_map()))return r;if((r=test_reject()))return r;if((r=test_bitreader()))return r;if((r=test_tail()))return r;if((r=test_fast_extract()))return r;if((r=test_word_sign_exhaustive()))return r;if((r=test_word_accounting_synthetic()))return r;if((r=test_word_no_stats_equivalence()))return r;if((r=test_dispatch_framework()))return r;puts("frodo_sample_n tests passed");return 0;}
+static int test_seed_stream(void){
+ static const size_t lens[]={0,1,15,1000,6000}; static uint8_t src[6000*8+4096]; static uint16_t words[(6000*8+4096)/2],a[6000],b[6000]; static const uint8_t seed[32]={3,1,4,1,5,9,2,6,5,3,5,8,9,7,9,3,2,3,8,4,6,2,6,4,3,3,8,3,2,7,9,5};
+ const frodo_sampler_kind kinds[3]={FRODO_SAMPLER_ORIGINAL_CDT,FRODO_SAMPLER_SDA_CDT,FRODO_SAMPLER_SDA_CDT}; const frodo_frontend fronts[3]={FRODO_FRONTEND_ORIGINAL_WORD,FRODO_FRONTEND_PACKED_BIT,FRODO_FRONTEND_WORD_ORIENTED};
+ static const sdat_prg_kind prgs[4]={SDAT_PRG_SHAKE128,SDAT_PRG_AES128_CTR,SDAT_PRG_CHACHA20,SDAT_PRG_SHAKE128_X4}; static const size_t seed_lens[4]={32,16,32,32};
+ for(int pr=0;pr<4;pr++)for(int pi=0;pi<3;pi++)for(int be=0;be<2;be++)for(int ki=0;ki<3;ki++)for(size_t li=0;li<sizeof(lens)/sizeof(lens[0]);li++){
+  frodo_backend backend=be?FRODO_BACKEND_AVX2:FRODO_BACKEND_REFERENCE; if(!frodo_backend_available(backend))continue; sdat_prg_kind prg=prgs[pr]; size_t n=lens[li],len=n*8+4096;
+  sdat_prg g; sdat_prg_init(&g,prg,seed,seed_lens[pr]); sdat_prg_generate(&g,src,len); memcpy(words,src,len);
+  frodo_sampler_stats s1,s2; memset(a,0xaa,sizeof a); memset(b,0x55,sizeof b);
+  if(frodo_sample_n_dispatch(kinds[ki],backend,fronts[ki],(frodo_param_id)pi,a,n,src,len,words,len/2,&s1))return 350;
+  int rc=frodo_sample_n_from_seed(kinds[ki],backend,fronts[ki],(frodo_param_id)pi,b,n,prg,seed,seed_lens[pr],&s2); if(rc)return 351;
+  if(n&&memcmp(a,b,n*sizeof a[0]))return 352+ki;
+  if(s1.stats.attempts!=s2.stats.attempts||s1.stats.rejections!=s2.stats.rejections||s1.stats.random_bits!=s2.stats.random_bits)return 356;
+  if(fronts[ki]==FRODO_FRONTEND_PACKED_BIT){if(s2.stats.random_bytes!=(s1.reader.bits_consumed+7)/8)return 357;}else if(s1.stats.random_bytes!=s2.stats.random_bytes)return 358;
+  if(s2.reader.ptr)return 359;}
+ uint16_t o[4]; if(frodo_sample_n_from_seed(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_WORD_ORIENTED,FRODO_PARAM_640,o,4,SDAT_PRG_AES128_CTR,seed,7,0)!=-1)return 360;
+ if(frodo_sample_n_from_seed(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_ORIGINAL_WORD,FRODO_PARAM_640,o,4,SDAT_PRG_SHAKE128,seed,32,0)!=-6)return 361;
+ if(frodo_sample_n_from_seed(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_PACKED_BIT,FRODO_PARAM_640,o,4,SDAT_PRG_SHAKE128,0,32,0)!=-1)return 362;
+ return 0;}
+static int test_parallel_dispatch(void){
+ enum{N=60000,WC=N*2}; static uint16_t words[WC],a[N],b[N]; const unsigned thr[]={0,1,2,3,7};
+ for(size_t i=0;i<WC;i++)words[i]=(uint16_t)(i*40503u+97u+(i>>3)*7919u);
+ const frodo_sampler_kind kinds[3]={FRODO_SAMPLER_ORIGINAL_CDT,FRODO_SAMPLER_SDA_CDT,FRODO_SAMPLER_SDA_CDT}; const frodo_frontend fronts[3]={FRODO_FRONTEND_ORIGINAL_WORD,FRODO_FRONTEND_WORD_ORIENTED,FRODO_FRONTEND_PACKED_BIT};
+ for(int shape=0;shape<3;shape++){
+  /* shape 1: a rejected-only prefix forces the remainder past the count window; shape 2: too few words. */
+  size_t n=N,wc=WC; if(shape==1)for(size_t i=0;i<20000;i++)words[i]=0xffffu; if(shape==2)wc=N/2;
+  for(int pi=0;pi<3;pi++)for(int be=0;be<2;be++)for(int ki=0;ki<3;ki++)for(size_t ti=0;ti<sizeof(thr)/sizeof(thr[0]);ti++){
+   frodo_backend backend=be?FRODO_BACKEND_AVX2:FRODO_BACKEND_REFERENCE; if(!frodo_backend_available(backend))continue;
+   frodo_sampler_stats s1,s2; memset(a,0xaa,sizeof a); memset(b,0x55,sizeof b);
+   int r1=frodo_sample_n_dispatch(kinds[ki],backend,fronts[ki],(frodo_param_id)pi,a,n,(const uint8_t*)words,wc*2,words,wc,&s1);
+   int r2=frodo_sample_n_dispatch_parallel(kinds[ki],backend,fronts[ki],(frodo_param_id)pi,b,n,(const uint8_t*)words,wc*2,words,wc,&s2,thr[ti]);
+   if(r1!=r2)return 370+shape;
+   if(!r1&&memcmp(a,b,sizeof a))return 373+ki;
+   if(memcmp(&s1.stats,&s2.stats,sizeof s1.stats))return 376+ki;}}
+ return 0;}
+typedef struct{const uint8_t*src;size_t len,pos,budget;}feed_ctx;
+static int feed_bytes(void*c,uint8_t*o,size_t l){feed_ctx*f=c;if(l>f->budget||f->pos+l>f->len)return -2;memcpy(o,f->src+f->pos,l);f->pos+=l;f->budget-=l;return 0;}
+static int test_stream_resume(void){
+ enum{N=3000,LEN=N*8+4096}; static uint8_t src[LEN]; static uint16_t words[LEN/2],a[N],b[N]; static const size_t cuts[]={1,2,3,7,13,64,1000,5000};
+ for(size_t i=0;i<LEN;i++)src[i]=(uint8_t)((i*2654435761u)>>13^(i>>7)); memcpy(words,src,LEN);
+ const frodo_sampler_kind kinds[3]={FRODO_SAMPLER_ORIGINAL_CDT,FRODO_SAMPLER_SDA_CDT,FRODO_SAMPLER_SDA_CDT}; const frodo_frontend fronts[3]={FRODO_FRONTEND_ORIGINAL_WORD,FRODO_FRONTEND_PACKED_BIT,FRODO_FRONTEND_WORD_ORIENTED};
+ for(int pi=0;pi<3;pi++)for(int be=0;be<2;be++)for(int ki=0;ki<3;ki++)for(size_t ci=0;ci<sizeof(cuts)/sizeof(cuts[0]);ci++){
+  frodo_backend backend=be?FRODO_BACKEND_AVX2:FRODO_BACKEND_REFERENCE; if(!frodo_backend_available(backend))continue;
+  frodo_sampler_stats s1; if(frodo_sample_n_dispatch(kinds[ki],backend,fronts[ki],(frodo_param_id)pi,a,N,src,LEN,words,LEN/2,&s1))return 380;
+  /* push: input in pieces of cuts[ci] bytes, outputs requested in pieces of 1..97 */
+  frodo_stream st; if(frodo_stream_init(&st,kinds[ki],backend,fronts[ki],(frodo_param_id)pi))return 381; memset(b,0x55,sizeof b);
+  size_t in=0,done=0,want=1; while(done<N&&in<LEN){size_t m=LEN-in<cuts[ci]?LEN-in:cuts[ci],used,w=N-done<want?N-done:want; size_t k=frodo_stream_push(&st,src+in,m,&used,b+done,w); if(used>m||k>w)return 382; if(k<w&&used!=m)return 383; in+=used; done+=k; want=want%97+1;}
+  if(done!=N||memcmp(a,b,sizeof a))return 384+ki;
+  if(kinds[ki]==FRODO_SAMPLER_SDA_CDT){if(s1.stats.attempts!=st.stats.attempts||s1.stats.rejections!=st.stats.rejections||s1.stats.random_bits!=st.stats.random_bits)return 387; if(st.stats.random_bytes!=(fronts[ki]==FRODO_FRONTEND_PACKED_BIT?(s1.reader.bits_consumed+7)/8:s1.stats.random_bytes))return 388;}
+  /* refill: the callback fails every cuts[ci]*8 bytes; later calls resume */
+  feed_ctx fc={src,LEN,0,0}; frodo_stream_init(&st,kinds[ki],backend,fronts[ki],(frodo_param_id)pi); frodo_stream_set_refill(&st,feed_bytes,&fc); memset(b,0x55,sizeof b); done=0;
+  for(int rounds=0;done<N&&rounds<100000;rounds++){fc.budget+=cuts[ci]*8+FRODO_STREAM_CHUNK_BYTES/4;done+=frodo_stream_sample_n(&st,b+done,N-done);}
+  if(done!=N||memcmp(a,b,sizeof a))return 389;}
+ frodo_stream st; if(frodo_stream_init(&st,FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_ORIGINAL_WORD,FRODO_PARAM_640)!=-6)return 390;
+ if(frodo_stream_init(&st,FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_WORD_ORIENTED,FRODO_PARAM_640)||frodo_stream_sample_n(&st,a,4)!=0)return 391;
+ return 0;}
+typedef struct{const frodo_sampler_plan*pl;const uint16_t*w;size_t wc;uint16_t*out;size_t n;int rc;}plan_job;
+static void*plan_worker(void*a){plan_job*j=a;for(int it=0;it<50&&!j->rc;it++){if(!frodo_get_sampler_params(j->pl->params->id))j->rc=-100;else j->rc=frodo_sampler_plan_sample_n(j->pl,j->out,j->n,0,0,j->w,j->wc,0);}return 0;}
+static int test_sampler_plan(void){
+ enum{N=2000,WC=N*8+4096}; static uint16_t words[WC],a[N],b[N],c[4][N];
+ for(size_t i=0;i<WC;i++)words[i]=(uint16_t)(i*40503u+97u+(i>>3)*7919u);
+ const frodo_sampler_kind kinds[3]={FRODO_SAMPLER_ORIGINAL_CDT,FRODO_SAMPLER_SDA_CDT,FRODO_SAMPLER_SDA_CDT}; const frodo_frontend fronts[3]={FRODO_FRONTEND_ORIGINAL_WORD,FRODO_FRONTEND_PACKED_BIT,FRODO_FRONTEND_WORD_ORIENTED};
+ for(int pi=0;pi<3;pi++)for(int be=0;be<2;be++)for(int ki=0;ki<3;ki++){
+  frodo_backend backend=be?FRODO_BACKEND_AVX2:FRODO_BACKEND_REFERENCE; if(!frodo_backend_available(backend))continue;
+  frodo_sampler_plan pl; if(frodo_sampler_plan_init(&pl,kinds[ki],backend,fronts[ki],(frodo_param_id)pi))return 400;
+  if(strcmp(pl.label,frodo_implementation_label(kinds[ki],backend,fronts[ki]))||!pl.kernel)return 401;
+  frodo_sampler_stats s1,s2; memset(a,0xaa,sizeof a); memset(b,0x55,sizeof b);
+  int r1=frodo_sample_n_dispatch(kinds[ki],backend,fronts[ki],(frodo_param_id)pi,a,N,(const uint8_t*)words,WC*2,words,WC,&s1);
+  int r2=frodo_sampler_plan_sample_n(&pl,b,N,(const uint8_t*)words,WC*2,words,WC,&s2);
+  if(r1||r2||memcmp(a,b,sizeof a)||memcmp(&s1.stats,&s2.stats,sizeof s1.stats)||s1.reader.bits_consumed!=s2.reader.bits_consumed)return 402;
+  /* expected size is within 2% of what the stream actually used */
+  uint64_t used=ki==1?(s1.reader.bits_consumed+7)/8:ki==2?s1.stats.random_bytes:2u*N, exp=frodo_sampler_plan_expected_bytes(&pl,N);
+  if(exp*100<used*98||exp*100>used*102)return 403;
+  if(fronts[ki]!=FRODO_FRONTEND_WORD_ORIENTED)continue;
+  plan_job jobs[4]; pthread_t tid[4];
+  for(int t=0;t<4;t++){jobs[t]=(plan_job){&pl,words,WC,c[t],N,0};if(pthread_create(&tid[t],0,plan_worker,&jobs[t]))return 404;}
+  for(int t=0;t<4;t++){pthread_join(tid[t],0);if(jobs[t].rc||memcmp(c[t],a,sizeof a))return 405;}}
+ frodo_sampler_plan pl;
+ if(frodo_sampler_plan_init(&pl,FRODO_SAMPLER_ORIGINAL_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_PACKED_BIT,FRODO_PARAM_640)!=-2)return 406;
+ if(frodo_sampler_plan_init(&pl,FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_ORIGINAL_WORD,FRODO_PARAM_640)!=-6)return 407;
+ if(frodo_sampler_plan_init(&pl,FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_WORD_ORIENTED,(frodo_param_id)7)!=-1)return 408;
+ if(frodo_sampler_plan_init(&pl,FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_WORD_ORIENTED,FRODO_PARAM_976)||frodo_sampler_plan_sample_n(&pl,a,4,0,0,0,0,0)!=-5||frodo_sampler_plan_sample_n(&pl,0,4,0,0,words,WC,0)!=-1)return 409;
+ return 0;}
+static int test_cpu_dispatch(void){
+ unsigned f=sdat_cpu_features(), d=sdat_cpu_features_detected(); const char*e=getenv("SDAT_FORCE_BACKEND");
+ if((f&d)!=f||f!=sdat_cpu_features())return 420;
+ if(e&&!strcmp(e,"reference")&&(f||frodo_backend_available(FRODO_BACKEND_AVX2)||frodo_kernels(FRODO_BACKEND_AVX2)||strcmp(sdat_cpu_forced_backend(),"reference")))return 421;
+ if(!!sdat_cpu_has(SDAT_CPU_AVX2)!=frodo_backend_available(FRODO_BACKEND_AVX2))return 422;
+ const frodo_kernel_table*k=frodo_kernels(FRODO_BACKEND_AUTO); frodo_backend best=frodo_resolve_backend(FRODO_BACKEND_AUTO);
+ if(!k||k->backend!=best||k!=frodo_kernels(best)||(best==FRODO_BACKEND_AVX2)!=!!sdat_cpu_has(SDAT_CPU_AVX2))return 423;
+ if(strcmp(frodo_backend_name(FRODO_BACKEND_AUTO),"auto")||strcmp(frodo_implementation_label(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_AUTO,FRODO_FRONTEND_WORD_ORIENTED),frodo_implementation_label(FRODO_SAMPLER_SDA_CDT,best,FRODO_FRONTEND_WORD_ORIENTED)))return 424;
+ enum{N=512,WC=N*8}; static uint16_t words[WC],a[N],b[N]; for(size_t i=0;i<WC;i++)words[i]=(uint16_t)(i*2654435761u>>7);
+ frodo_sampler_plan pl; frodo_sampler_stats s1,s2;
+ if(frodo_sampler_plan_init(&pl,FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_AUTO,FRODO_FRONTEND_WORD_ORIENTED,FRODO_PARAM_1344)||pl.backend!=best||pl.kernels!=k)return 425;
+ if(frodo_sampler_plan_sample_n(&pl,a,N,0,0,words,WC,&s1)||frodo_sample_n_dispatch(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_REFERENCE,FRODO_FRONTEND_WORD_ORIENTED,FRODO_PARAM_1344,b,N,0,0,words,WC,&s2))return 426;
+ if(memcmp(a,b,sizeof a)||memcmp(&s1.stats,&s2.stats,sizeof s1.stats))return 427;
+ return 0;}
+typedef struct{const uint16_t*w;size_t wc;uint16_t*out;size_t n;uint64_t attempts;sdat_avx2_stats mine;int rc;}tel_job;
+static void*tel_worker(void*a){tel_job*j=a;sdat_telemetry_reset_thread();for(int it=0;it<20&&!j->rc;it++){sdat_stats st;j->rc=frodo640_sda_word_sample_n_avx2(j->out,j->n,j->w,j->wc,&st);j->attempts+=st.attempts;}j->mine=sdat_telemetry_thread();return 0;}
+static int test_telemetry(void){
+ enum{N=1000,WC=N*4}; static uint16_t words[WC],out[4][N]; for(size_t i=0;i<WC;i++)words[i]=(uint16_t)(i*40503u+17u);
+ int on=SDAT_TELEMETRY&&sdat_avx2_cpu_supported(); sdat_avx2_stats before,after; sdat_telemetry_aggregate(&before);
+ tel_job jobs[4]; pthread_t tid[4];
+ for(int t=0;t<4;t++){jobs[t]=(tel_job){words,WC,out[t],N,0,{0},0};if(pthread_create(&tid[t],0,tel_worker,&jobs[t]))return 430;}
+ for(int t=0;t<4;t++)pthread_join(tid[t],0);
+ sdat_avx2_stats sum={0};
+ for(int t=0;t<4;t++){const sdat_avx2_stats*m=&jobs[t].mine; if(jobs[t].rc)return 431;
+  if(on?(m->api_calls!=20||m->avx2_vectorized_samples+m->scalar_tail_samples!=jobs[t].attempts||m->avx2_vectorized_samples!=16*m->avx2_vector_batches):(m->api_calls||m->avx2_vectorized_samples))return 432;
+  sdat_avx2_stats_merge(&sum,m);}
+ /* exited threads stay in the aggregate */
+ sdat_telemetry_aggregate(&after);
+ if(after.api_calls-before.api_calls!=sum.api_calls||after.avx2_vectorized_samples-before.avx2_vectorized_samples!=sum.avx2_vectorized_samples||after.scalar_tail_samples-before.scalar_tail_samples!=sum.scalar_tail_samples)return 433;
+ sdat_telemetry_reset_thread(); uint16_t v[37]; for(int i=0;i<37;i++)v[i]=(uint16_t)(i*977u);
+ if(frodo_original_sample_n_avx2(v,37,&original_cdt_table_frodo976))return 434;
+ sdat_avx2_stats me=sdat_telemetry_thread(); if(on&&(me.api_calls!=1||me.avx2_vector_batches!=2||me.avx2_vectorized_samples!=32||me.scalar_tail_samples!=5))return 435;
+ if(!on&&(me.api_calls||me.avx2_vector_batches))return 436;
+ return 0;}
+/* A table that is not one of the built-in objects but has the same content
+ * reaches the generated kernels through the registry, with outputs, stats and
+ * reader positions identical to the hand-written per-parameter kernels. */
+static int test_generated_kernels(void){
+ enum{N=700,WC=N*4,B=N*4}; static uint16_t words[WC],a[N],b[N]; static uint8_t bytes[B]; for(size_t i=0;i<WC;i++)words[i]=(uint16_t)(i*2654435761u>>9); for(size_t i=0;i<B;i++)bytes[i]=(uint8_t)(i*167u+(i>>3));
+ for(int pi=0;pi<3;pi++){
+  sdat_table oc=*tabs_o[pi]; uint16_t othr[16]; memcpy(othr,oc.thresholds,oc.threshold_count*2); oc.thresholds=othr;
+  const frodo_gen_kernels*g=frodo_gen_find(&oc); if(!g||!g->original||!frodo_gen_find_avx2(&oc)||frodo_gen_find_avx2(&oc)-frodo_gen_avx2!=g-frodo_gen_reference)return 450;
+  for(size_t i=0;i<N;i++)a[i]=b[i]=words[i];
+  if(frodo_original_sample_n(a,N,tabs_o[pi])||frodo_original_sample_n(b,N,&oc)||memcmp(a,b,sizeof a))return 451;
+  for(size_t i=0;i<N;i++)b[i]=words[i]; if(frodo_original_sample_n_avx2(b,N,&oc)||memcmp(a,b,sizeof a))return 451;
+  sdat_table sc=*tabs_s[pi]; uint8_t t8[16]; uint16_t t16[16]; if(sc.value_type==SDAT_TYPE_U8){memcpy(t8,sc.thresholds,sc.threshold_count);sc.thresholds=t8;}else{memcpy(t16,sc.thresholds,sc.threshold_count*2);sc.thresholds=t16;}
+  if(!frodo_gen_find(&sc)||frodo_gen_find(&sc)->original)return 452;
+  /* plans and streams dispatch the generated kernels of the built-in tables */
+  if(frodo_kernels(FRODO_BACKEND_REFERENCE)!=&frodo_gen_kernel_table_reference)return 460;
+  for(int be=0;be<2;be++){const frodo_kernel_table*kt=be?&frodo_gen_kernel_table_avx2:&frodo_gen_kernel_table_reference; const frodo_gen_kernels*go=be?frodo_gen_find_avx2(tabs_o[pi]):frodo_gen_find(tabs_o[pi]),*gs=be?frodo_gen_find_avx2(tabs_s[pi]):frodo_gen_find(tabs_s[pi]);
+   if(!go||!gs||kt->original[pi]!=go->original||kt->packed[pi]!=gs->packed||kt->packed_run[pi]!=gs->packed_run||kt->word[pi]!=gs->word||kt->word_run[pi]!=gs->word_run)return 461;}
+  for(int avx=0;avx<2;avx++){sdat_stats s1,s2; sdat_bitreader_fast r1,r2; size_t u1,u2;
+   int(*fast)(uint16_t*,size_t,sdat_bitreader_fast*,const sdat_table*,sdat_stats*)=avx?frodo_sda_sample_n_fast_avx2:frodo_sda_sample_n_fast;
+   size_t(*frun)(uint16_t*,size_t,sdat_bitreader_fast*,const sdat_table*,sdat_stats*)=avx?frodo_sda_sample_n_fast_run_avx2:frodo_sda_sample_n_fast_run;
+   int(*word)(uint16_t*,size_t,const uint16_t*,size_t,const sdat_table*,sdat_stats*)=avx?frodo_sda_word_sample_n_avx2:frodo_sda_word_sample_n;
+   size_t(*wrun)(uint16_t*,size_t,const uint16_t*,size_t,const sdat_table*,size_t*,sdat_stats*)=avx?frodo_sda_word_sample_run_avx2:frodo_sda_word_sample_run;
+   sdat_bitreader_fast_init(&r1,bytes,B); sdat_bitreader_fast_init(&r2,bytes,B);
+   if(fast(a,N,&r1,tabs_s[pi],&s1)||fast(b,N,&r2,&sc,&s2)||memcmp(a,b,sizeof a)||memcmp(&s1,&s2,sizeof s1)||r1.bits_consumed!=r2.bits_consumed)return 453;
+   /* the run forms stop at the end of a short buffer and resume identically */
+   sdat_bitreader_fast_init(&r1,bytes,N); sdat_bitreader_fast_init(&r2,bytes,N); s1=s2=(sdat_stats){0};
+   size_t k1=frun(a,N,&r1,tabs_s[pi],&s1),k2=frun(b,N,&r2,&sc,&s2); if(k1!=k2||k1==N||memcmp(a,b,k1*2)||memcmp(&s1,&s2,sizeof s1)||r1.bits_consumed!=r2.bits_consumed||r1.ptr!=r2.ptr)return 454;
+   if(word(a,N,words,WC,tabs_s[pi],&s1)||word(b,N,words,WC,&sc,&s2)||memcmp(a,b,sizeof a)||memcmp(&s1,&s2,sizeof s1))return 455;
+   if(word(a,N,words,WC,tabs_s[pi],0)||word(b,N,words,WC,&sc,0)||memcmp(a,b,sizeof a))return 455;
+   s1=s2=(sdat_stats){0}; k1=wrun(a,N,words,N/2,tabs_s[pi],&u1,&s1); k2=wrun(b,N,words,N/2,&sc,&u2,&s2);
+   if(k1!=k2||u1!=u2||memcmp(a,b,k1*2)||memcmp(&s1,&s2,sizeof s1))return 456;
+   /* every 16-bit word once: each candidate and sign reaches the compares */
+   static uint16_t all[65536],ea[65536],eb[65536]; for(size_t i=0;i<65536;i++)all[i]=(uint16_t)i;
+   k1=wrun(ea,65536,all,65536,tabs_s[pi],&u1,0); k2=wrun(eb,65536,all,65536,&sc,&u2,0); if(k1!=k2||u1!=65536||memcmp(ea,eb,k1*2))return 456;}
+  /* content, not identity: a changed threshold or q no longer matches */
+  if(sc.value_type==SDAT_TYPE_U8)t8[1]++;else t16[1]++; if(frodo_gen_find(&sc)||frodo_sda_word_sample_n(a,N,words,WC,&sc,0)!=-1)return 457;
+  if(sc.value_type==SDAT_TYPE_U8)t8[1]--;else t16[1]--; sc.denominator_u64++; if(frodo_gen_find(&sc)||frodo_sda_sample_n_fast_run(a,N,&(sdat_bitreader_fast){0},&sc,0))return 458;}
+ if(frodo_gen_find(&sda_table_falcon_base)||frodo_gen_find(0))return 459;
+ return 0;}
+/* Counter-based Frodo jobs give the same outputs for any shard split and thread count. */
+static int test_counter_jobs(void){
+ static uint8_t key[32]; for(int i=0;i<32;i++)key[i]=(uint8_t)(i*29+5);
+ static const sdat_prg_kind ck[3]={SDAT_PRG_AES128_CTR,SDAT_PRG_CHACHA20,SDAT_PRG_PHILOX4X32};
+ enum{N=3*FRODO_COUNTER_CHUNK+1000}; static uint16_t full[N],part[N],ref[FRODO_COUNTER_CHUNK]; const uint64_t first=5000;
+ const frodo_sampler_kind kinds[3]={FRODO_SAMPLER_ORIGINAL_CDT,FRODO_SAMPLER_SDA_CDT,FRODO_SAMPLER_SDA_CDT}; const frodo_frontend fronts[3]={FRODO_FRONTEND_ORIGINAL_WORD,FRODO_FRONTEND_PACKED_BIT,FRODO_FRONTEND_WORD_ORIENTED};
+ for(int k=0;k<3;k++)for(int ki=0;ki<3;ki++){size_t kl=sdat_prg_stream_key_bytes(ck[k]); frodo_sampler_stats fs,ps;
+  if(frodo_sample_n_counter(kinds[ki],FRODO_BACKEND_AUTO,fronts[ki],FRODO_PARAM_640,full,first,N,ck[k],key,kl,9,&fs))return 479;
+  for(unsigned shards=1;shards<=5;shards++){size_t done=0; for(unsigned s2=0;s2<shards;s2++){size_t m=s2+1==shards?N-done:(N/shards)+(s2*977u%301u)-150u; if(m>N-done)m=N-done;
+    if(frodo_sample_n_counter(kinds[ki],FRODO_BACKEND_AUTO,fronts[ki],FRODO_PARAM_640,part+done,first+done,m,ck[k],key,kl,9,0))return 480; done+=m;}
+   if(memcmp(full,part,sizeof full))return 481;}
+  for(unsigned th=1;th<=4;th++){memset(part,0,sizeof part); if(frodo_sample_n_counter_parallel(kinds[ki],FRODO_BACKEND_AUTO,fronts[ki],FRODO_PARAM_640,part,first,N,ck[k],key,kl,9,&ps,th)||memcmp(full,part,sizeof full)||memcmp(&fs.stats,&ps.stats,sizeof fs.stats))return 482;}
+  /* chunk-aligned shards add up to the whole job's stats */
+  sdat_stats sum={0}; frodo_sample_n_counter(kinds[ki],FRODO_BACKEND_AUTO,fronts[ki],FRODO_PARAM_640,full,0,N,ck[k],key,kl,9,&fs);
+  for(size_t b=0;b<N;b+=FRODO_COUNTER_CHUNK){size_t m=N-b<FRODO_COUNTER_CHUNK?N-b:FRODO_COUNTER_CHUNK; frodo_sample_n_counter(kinds[ki],FRODO_BACKEND_AUTO,fronts[ki],FRODO_PARAM_640,part+b,b,m,ck[k],key,kl,9,&ps); sum.attempts+=ps.stats.attempts; sum.rejections+=ps.stats.rejections; sum.random_bits+=ps.stats.random_bits; sum.random_bytes+=ps.stats.random_bytes;}
+  if(memcmp(&sum,&fs.stats,sizeof sum)||memcmp(full,part,sizeof full))return 483;
+  /* chunk 0 of stream 0 is the seeded sampler over the plain key */
+  if(frodo_sample_n_counter(kinds[ki],FRODO_BACKEND_REFERENCE,fronts[ki],FRODO_PARAM_640,part,0,FRODO_COUNTER_CHUNK,ck[k],key,kl,0,0)||frodo_sample_n_from_seed(kinds[ki],FRODO_BACKEND_REFERENCE,fronts[ki],FRODO_PARAM_640,ref,FRODO_COUNTER_CHUNK,ck[k],key,kl,0)||memcmp(part,ref,sizeof ref))return 484;}
+ if(frodo_sample_n_counter(FRODO_SAMPLER_SDA_CDT,FRODO_BACKEND_AUTO,FRODO_FRONTEND_WORD_ORIENTED,FRODO_PARAM_640,full,0,10,SDAT_PRG_SHAKE128,key,32,0,0)!=-1)return 485;
+ return 0;}
+int main(void){int r;if((r=test_orig()))return r;if((r=test_sda_map()))return r;if((r=test_reject()))return r;if((r=test_bitreader()))return r;if((r=test_tail()))return r;if((r=test_fast_extract()))return r;if((r=test_word_sign_exhaustive()))return r;if((r=test_word_accounting_synthetic()))return r;if((r=test_word_no_stats_equivalence()))return r;if((r=test_word_avx2_equivalence()))return r;if((r=test_packed_avx2_extract()))return r;if((r=test_dispatch_framework()))return r;if((r=test_seed_stream()))return r;if((r=test_parallel_dispatch()))return r;if((r=test_stream_resume()))return r;if((r=test_sampler_plan()))return r;if((r=test_cpu_dispatch()))return r;if((r=test_telemetry()))return r;if((r=test_generated_kernels()))return r;if((r=test_counter_jobs()))return r;puts("frodo_sample_n tests passed");return 0;}
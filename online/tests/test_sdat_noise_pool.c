@@ -0,0 +1,178 @@
+#include "sdat_noise_pool.h"
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t seed[32] = {2, 7, 1, 8, 2, 8, 1, 8, 2, 8, 4, 5, 9, 0, 4, 5,
+                                 2, 3, 5, 3, 6, 0, 2, 8, 7, 4, 7, 1, 3, 5, 2, 6};
+
+static sdat_noise_pool_config frodo_config(unsigned consumers, unsigned producers) {
+    sdat_noise_pool_config c = {0};
+    c.source = SDAT_NOISE_FRODO;
+    c.frodo_kind = FRODO_SAMPLER_SDA_CDT;
+    c.backend = FRODO_BACKEND_AUTO;
+    c.frontend = FRODO_FRONTEND_WORD_ORIENTED;
+    c.param = FRODO_PARAM_640;
+    c.consumers = consumers;
+    c.slots = 4;
+    c.low_watermark = 1;
+    c.producers = producers;
+    c.prg = SDAT_PRG_CHACHA20;
+    c.seed = seed;
+    c.seed_len = sizeof seed;
+    return c;
+}
+
+/* The ring PRG as documented: SHAKE128(seed || le32(consumer)). */
+static void ring_prg(sdat_prg *g, sdat_prg_kind kind, unsigned consumer) {
+    uint8_t le[4] = {(uint8_t)consumer, (uint8_t)(consumer >> 8), (uint8_t)(consumer >> 16), (uint8_t)(consumer >> 24)};
+    uint8_t key[32];
+    sdat_shake128_ctx h;
+    sdat_shake128_init(&h);
+    sdat_shake128_absorb(&h, seed, sizeof seed);
+    sdat_shake128_absorb(&h, le, sizeof le);
+    sdat_shake128_squeeze(&h, key, sizeof key);
+    size_t key_len = sdat_prg_stream_key_bytes(kind);
+    sdat_prg_init(g, kind, key, key_len ? key_len : sizeof key);
+}
+
+static int check_config(void) {
+    sdat_noise_pool *p;
+    sdat_noise_pool_config c = frodo_config(2, 1);
+    if (sdat_noise_pool_create(&p, 0) != -1) return 600;
+    c.slots = 6;
+    if (sdat_noise_pool_create(&p, &c) != -1) return 600;
+    c = frodo_config(2, 3);
+    if (sdat_noise_pool_create(&p, &c) != -1) return 601;
+    c = frodo_config(0, 1);
+    if (sdat_noise_pool_create(&p, &c) != -1) return 601;
+    c = frodo_config(2, 1);
+    c.low_watermark = c.slots;
+    if (sdat_noise_pool_create(&p, &c) != -1) return 602;
+    c = frodo_config(2, 1);
+    c.seed = 0;
+    if (sdat_noise_pool_create(&p, &c) != -1) return 602;
+    c = frodo_config(2, 1);
+    c.seed_len = 12; /* ChaCha20 takes 32 or 44 key bytes, but ring keys are derived: any seed length works */
+    if (sdat_noise_pool_create(&p, &c)) return 603;
+    sdat_noise_pool_destroy(p);
+    c = frodo_config(1, 1);
+    c.frontend = FRODO_FRONTEND_ORIGINAL_WORD; /* not a valid pairing with SDA */
+    if (sdat_noise_pool_create(&p, &c) != -3) return 604;
+    return 0;
+}
+
+/* Every consumer's blocks are the consecutive outputs of its own stream,
+ * independent of how many producers there are. */
+static int check_frodo(void) {
+    enum { CONSUMERS = 3, BLOCKS = 11 };
+    size_t n = frodo_get_sampler_params(FRODO_PARAM_640)->native_sample_count;
+    uint16_t *want = malloc(BLOCKS * n * sizeof *want), *got = malloc(n * sizeof *got);
+    frodo_stream *st = malloc(sizeof *st);
+    if (!want || !got || !st) return 610;
+    for (unsigned producers = 1; producers <= CONSUMERS; producers++) {
+        sdat_noise_pool_config c = frodo_config(CONSUMERS, producers);
+        sdat_noise_pool *p;
+        if (sdat_noise_pool_create(&p, &c)) return 611;
+        if (sdat_noise_pool_block_samples(p) != n || sdat_noise_pool_block_bytes(p) != n * 2) return 612;
+        for (unsigned k = 0; k < CONSUMERS; k++) {
+            sdat_prg g;
+            ring_prg(&g, c.prg, k);
+            frodo_stream_init(st, c.frodo_kind, c.backend, c.frontend, c.param);
+            frodo_stream_set_refill(st, sdat_prg_randombytes, &g);
+            if (frodo_stream_sample_n(st, want, BLOCKS * n) != BLOCKS * n) return 613;
+            for (unsigned b = 0; b < BLOCKS; b++) {
+                if (sdat_noise_pool_pop_wait(p, k, got)) return 614;
+                if (memcmp(got, want + b * n, n * sizeof *got)) return 615;
+            }
+        }
+        sdat_noise_pool_destroy(p);
+    }
+    free(st);
+    free(want);
+    free(got);
+    return 0;
+}
+
+/* Falcon rings against falcon_*_gaussian0_sample_n on the same PRG, for both
+ * tables and both backends, with a non-default block size. */
+static int check_falcon(void) {
+    enum { N = 333, BLOCKS = 5 };
+    static uint32_t want[BLOCKS * N], got[N];
+    for (int kind = 0; kind < 2; kind++)
+        for (int be = 0; be < 2; be++) {
+            sdat_noise_pool_config c = frodo_config(2, 1);
+            c.source = SDAT_NOISE_FALCON_BASE;
+            c.falcon_kind = kind ? FALCON_BASE_SDA : FALCON_BASE_ORIGINAL;
+            c.backend = be ? FRODO_BACKEND_AUTO : FRODO_BACKEND_REFERENCE;
+            c.block_samples = N;
+            c.prg = SDAT_PRG_AES128_CTR;
+            sdat_noise_pool *p;
+            if (sdat_noise_pool_create(&p, &c)) return 620;
+            if (sdat_noise_pool_block_bytes(p) != N * 4) return 621;
+            sdat_prg g;
+            ring_prg(&g, c.prg, 1);
+            (kind ? falcon_sda_gaussian0_sample_n : falcon_original_gaussian0_sample_n)(sdat_prg_randombytes, &g, want,
+                                                                                         BLOCKS * N, 0);
+            for (unsigned b = 0; b < BLOCKS; b++) {
+                if (sdat_noise_pool_pop_wait(p, 1, got)) return 622;
+                if (memcmp(got, want + b * N, sizeof got)) return 623;
+            }
+            sdat_noise_pool_destroy(p);
+        }
+    return 0;
+}
+
+/* A released slot is zero until the producer reuses it, counters add up, and
+ * the producer refills rather than leaving a drained ring empty. */
+static int check_release(void) {
+    sdat_noise_pool_config c = frodo_config(1, 1);
+    c.slots = 8;
+    c.low_watermark = 2;
+    c.prg = SDAT_PRG_SHAKE128_X4;
+    sdat_noise_pool *p;
+    if (sdat_noise_pool_create(&p, &c)) return 630;
+    size_t bytes = sdat_noise_pool_block_bytes(p);
+    sdat_noise_pool_stats s;
+    do {
+        sdat_noise_pool_get_stats(p, 0, &s);
+        sched_yield();
+    } while (s.depth < s.capacity);
+    if (s.capacity != 8 || s.produced != 8 || s.consumed || s.min_depth != 8) return 631;
+    const uint8_t *b = sdat_noise_pool_acquire(p, 0);
+    if (!b) return 632;
+    int nonzero = 0;
+    for (size_t i = 0; i < bytes; i++) nonzero |= b[i];
+    if (!nonzero) return 632;
+    /* above the watermark the producer stays asleep, so the slot is not
+     * reused yet and must read back as zero */
+    sdat_noise_pool_release(p, 0);
+    for (size_t i = 0; i < bytes; i++)
+        if (b[i]) {
+            sdat_noise_pool_get_stats(p, 0, &s);
+            if (s.produced == 8) return 633;
+            break;
+        }
+    uint16_t *out = malloc(bytes);
+    if (!out) return 634;
+    for (unsigned i = 0; i < 64; i++)
+        if (sdat_noise_pool_pop_wait(p, 0, out)) return 634;
+    sdat_noise_pool_get_stats(p, 0, &s);
+    if (s.consumed != 65 || s.produced < 65 || s.produced > 65 + 8 || s.depth != s.produced - s.consumed ||
+        s.min_depth > 8 || !s.wakeups)
+        return 635;
+    free(out);
+    sdat_noise_pool_destroy(p);
+    return 0;
+}
+
+int main(void) {
+    int r;
+    if ((r = check_config())) return r;
+    if ((r = check_frodo())) return r;
+    if ((r = check_falcon())) return r;
+    if ((r = check_release())) return r;
+    puts("sdat_noise_pool tests passed");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "sdat_cpu.h"
+#include "sdat_prg.h"
+#include <stdio.h>
+#include <string.h>
+static int hexeq(const uint8_t*b,const char*h){for(size_t i=0;h[2*i];i++){unsigned v;if(sscanf(h+2*i,"%2x",&v)!=1||b[i]!=v)return 0;}return 1;}
+static int test_prg_kat(void){
+ uint8_t o[400],p[400]; sdat_shake128(o,32,(const uint8_t*)"",0); if(!hexeq(o,"7f9c2ba4e88f827d616045507605853ed73b8093f6efbc88eb1a6eacfa66ef26"))return 340;
+ sdat_shake128(o,400,(const uint8_t*)"abc",3); if(!hexeq(o+160,"cc29082f5647584e6aa01b3f5af05780")||!hexeq(o+384,"6ee173e30bd4d08f2bc59c6114bdd745"))return 341;
+ static const uint8_t fk[16]={0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15},fp[16]={0x00,0x11,0x22,0x33,0x44,0x55,0x66,0x77,0x88,0x99,0xaa,0xbb,0xcc,0xdd,0xee,0xff}; uint8_t rk[176]; sdat_aes128_expand_key(rk,fk); sdat_aes128_encrypt_block(rk,fp,o); if(!hexeq(o,"69c4e0d86a7b0430d8cdb78070b4c55a"))return 342;
+ /* SP 800-38A F.5.1: keystream = plaintext ^ ciphertext. */
+ static const uint8_t ck[32]={0x2b,0x7e,0x15,0x16,0x28,0xae,0xd2,0xa6,0xab,0xf7,0x15,0x88,0x09,0xcf,0x4f,0x3c,0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,0xf9,0xfa,0xfb,0xfc,0xfd,0xfe,0xff}; static const uint8_t pt[32]={0x6b,0xc1,0xbe,0xe2,0x2e,0x40,0x9f,0x96,0xe9,0x3d,0x7e,0x11,0x73,0x93,0x17,0x2a,0xae,0x2d,0x8a,0x57,0x1e,0x03,0xac,0x9c,0x9e,0xb7,0x6f,0xac,0x45,0xaf,0x8e,0x51};
+ sdat_prg g; if(sdat_prg_init(&g,SDAT_PRG_AES128_CTR,ck,32))return 343; sdat_prg_generate(&g,o,32); for(int i=0;i<32;i++)o[i]^=pt[i]; if(!hexeq(o,"874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"))return 344;
+ if(sdat_prg_init(&g,SDAT_PRG_AES128_CTR,ck,20)!=-1)return 345;
+ for(int k=0;k<2;k++){sdat_prg_kind kind=k?SDAT_PRG_AES128_CTR:SDAT_PRG_SHAKE128; sdat_prg_init(&g,kind,ck,32); sdat_prg_generate(&g,o,400); sdat_prg_init(&g,kind,ck,32); size_t at=0; for(size_t step=1;at<400;step=step*3+1){size_t m=400-at<step?400-at:step; if(sdat_prg_randombytes(&g,p+at,m))return 346; at+=m;} if(memcmp(o,p,400))return 347+k;}
+ /* RFC 8439 A.1 #1 (zero key, nonce, counter 0) and 2.3.2 (counter 1). */
+ static const uint8_t zk[32]={0}; if(sdat_prg_init(&g,SDAT_PRG_CHACHA20,zk,32))return 437; sdat_prg_generate(&g,o,64); if(!hexeq(o,"76b8e0ada0f13d90405d6ae55386bd28bdd219b8a08ded1aa836efcc8b770dc7da41597c5157488d7724e03fb8d84a376a43b8f41518a11cc387b669b2ee6586"))return 438;
+ uint8_t rk2[44]; for(int i=0;i<32;i++)rk2[i]=(uint8_t)i; static const uint8_t rn[12]={0,0,0,9,0,0,0,0x4a,0,0,0,0}; memcpy(rk2+32,rn,12); sdat_prg_init(&g,SDAT_PRG_CHACHA20,rk2,44); sdat_prg_generate(&g,o,128); if(!hexeq(o+64,"10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4ed2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e"))return 439;
+ if(sdat_prg_init(&g,SDAT_PRG_CHACHA20,ck,16)!=-1)return 440;
+ sdat_prg_init(&g,SDAT_PRG_CHACHA20,rk2,44); sdat_prg_generate(&g,o,400); sdat_prg_init(&g,SDAT_PRG_CHACHA20,rk2,44); {size_t at=0; for(size_t step=1;at<400;step=step*3+1){size_t m=400-at<step?400-at:step; sdat_prg_randombytes(&g,p+at,m); at+=m;}} if(memcmp(o,p,400))return 441;
+ return 0;}
+/* The AES-NI/AVX2 kernels against the portable block functions, across the
+ * counter carries, and SHAKE128x4 against four scalar SHAKE128 lanes. */
+static int test_prg_vector(void){
+ static uint8_t o[4096],p[4096]; uint8_t rk[176],key[16],ctr[16],c2[16];
+ for(int i=0;i<16;i++)key[i]=(uint8_t)(i*29+1); sdat_aes128_expand_key(rk,key);
+ for(int i=0;i<16;i++)ctr[i]=i<8?(uint8_t)i:0xff; ctr[15]=0xfb; memcpy(c2,ctr,16);
+ sdat_aes128_ctr_blocks(rk,ctr,o,37); for(int b=0;b<37;b++){sdat_aes128_encrypt_block(rk,c2,p+16*b); for(int i=15;i>=0;i--)if(++c2[i])break;} if(memcmp(o,p,16*37)||memcmp(ctr,c2,16))return 460;
+ if(sdat_cpu_has(SDAT_CPU_AESNI)){memset(ctr,0xff,16); ctr[15]=0xfe; memcpy(c2,ctr,16); sdat_aes128_ctr_blocks_aesni(rk,ctr,o,9); for(int b=0;b<9;b++){sdat_aes128_encrypt_block(rk,c2,p+16*b); for(int i=15;i>=0;i--)if(++c2[i])break;} if(memcmp(o,p,16*9)||memcmp(ctr,c2,16))return 461;}
+ uint32_t st[16],st2[16]; for(int i=0;i<16;i++)st[i]=0x9e3779b9u*(uint32_t)(i+1); st[12]=0xfffffffcu; memcpy(st2,st,sizeof st);
+ sdat_chacha20_blocks(st,o,19); for(int b=0;b<19;b++){sdat_chacha20_block(st2,p+64*b); st2[13]+=!++st2[12];} if(memcmp(o,p,64*19)||memcmp(st,st2,sizeof st))return 462;
+ static uint64_t k4[25][4]; uint64_t k1[4][25]; for(int j=0;j<25;j++)for(int i=0;i<4;i++)k1[i][j]=k4[j][i]=0x0123456789abcdefULL*(uint64_t)(j*4+i+1);
+ for(int r=0;r<3;r++){sdat_keccak_f1600_x4(k4); for(int i=0;i<4;i++)sdat_keccak_f1600(k1[i]);} for(int j=0;j<25;j++)for(int i=0;i<4;i++)if(k4[j][i]!=k1[i][j])return 463;
+ static uint8_t seed[201],lane[4][1100]; for(int i=0;i<201;i++)seed[i]=(uint8_t)(i*7+3);
+ const size_t sl[3]={0,33,201}; for(int si=0;si<3;si++){
+  for(int i=0;i<4;i++){sdat_shake128_ctx c; sdat_shake128_init(&c); sdat_shake128_absorb(&c,seed,sl[si]); uint8_t b=(uint8_t)i; sdat_shake128_absorb(&c,&b,1); sdat_shake128_squeeze(&c,lane[i],6*SDAT_SHAKE128_RATE);}
+  sdat_prg g; if(sdat_prg_init(&g,SDAT_PRG_SHAKE128_X4,seed,sl[si]))return 464; sdat_prg_generate(&g,o,24*SDAT_SHAKE128_RATE);
+  for(size_t j=0;j<24;j++)if(memcmp(o+SDAT_SHAKE128_RATE*j,lane[j%4]+SDAT_SHAKE128_RATE*(j/4),SDAT_SHAKE128_RATE))return 464;}
+ /* Buffered and bulk paths agree for every kind and request pattern. */
+ for(int k=0;k<4;k++){sdat_prg_kind kind=(sdat_prg_kind)k; sdat_prg g; sdat_prg_init(&g,kind,key,16+16*(k!=SDAT_PRG_AES128_CTR)); sdat_prg_generate(&g,o,sizeof o); sdat_prg_init(&g,kind,key,16+16*(k!=SDAT_PRG_AES128_CTR)); size_t at=0; for(size_t step=1;at<sizeof p;step=step*5%1543+1){size_t m=sizeof p-at<step?sizeof p-at:step; sdat_prg_generate(&g,p+at,m); at+=m;} if(memcmp(o,p,sizeof o))return 465;}
+ const char*aes=sdat_prg_backend_name(SDAT_PRG_AES128_CTR),*cc=sdat_prg_backend_name(SDAT_PRG_CHACHA20);
+ if(strcmp(aes,sdat_cpu_has(SDAT_CPU_AESNI)?"aesni":"portable")||strcmp(cc,sdat_cpu_has(SDAT_CPU_AVX2)?"avx2":"portable")||strcmp(sdat_prg_name(SDAT_PRG_SHAKE128_X4),"shake128x4"))return 466;
+ return 0;}
+/* Counter-based streams: Philox4x32-10 known answers (Random123 kat_vectors), O(1) seek against sequential
+ * generation, and the 64-bit ChaCha20 counter carry. */
+static int test_counter_rng(void){
+ static const uint32_t pk[3][2]={{0,0},{0xffffffffu,0xffffffffu},{0xa4093822u,0x299f31d0u}},pc[3][4]={{0,0,0,0},{0xffffffffu,0xffffffffu,0xffffffffu,0xffffffffu},{0x243f6a88u,0x85a308d3u,0x13198a2eu,0x03707344u}};
+ static const char*px[3]={"d5e827668dc569e14cac57bcd8db009b","6d278f400e3bc841c6c70ba2fd51546d","09fe6cd1ebccfd9420e40150a16e1224"};
+ for(int i=0;i<3;i++){uint8_t o[16]; sdat_philox4x32_block(pk[i],pc[i],o); if(!hexeq(o,px[i]))return 470;}
+ {uint8_t k8[8]={0},o[32]; uint32_t c1[4]={1,0,0,0}; sdat_prg g; if(sdat_prg_init(&g,SDAT_PRG_PHILOX4X32,k8,8))return 471; sdat_prg_generate(&g,o,32); if(!hexeq(o,px[0]))return 471; sdat_philox4x32_block(pk[0],c1,o); if(memcmp(o,o+16,16))return 471;}
+ static uint8_t key[32],seq[3000],at[3000]; for(int i=0;i<32;i++)key[i]=(uint8_t)(i*29+5);
+ static const sdat_prg_kind ck[3]={SDAT_PRG_AES128_CTR,SDAT_PRG_CHACHA20,SDAT_PRG_PHILOX4X32}; static const uint64_t offs[]={0,1,15,16,63,64,100,511,512,513,1000,2047,2999};
+ for(int k=0;k<3;k++){size_t kl=sdat_prg_stream_key_bytes(ck[k]); sdat_prg g,h; if(!kl||sdat_prg_init_stream(&g,ck[k],key,kl+1,0)!=-1)return 472;
+  /* stream 0 is the plain key stream; other streams differ */
+  sdat_prg_init(&g,ck[k],key,kl); sdat_prg_generate(&g,seq,256); sdat_prg_init_stream(&h,ck[k],key,kl,0); sdat_prg_generate(&h,at,256); if(memcmp(seq,at,256))return 473;
+  sdat_prg_init_stream(&h,ck[k],key,kl,1); sdat_prg_generate(&h,at,256); if(!memcmp(seq,at,256))return 473;
+  sdat_prg_init_stream(&g,ck[k],key,kl,0x0123456789abcdefULL); sdat_prg_generate(&g,seq,sizeof seq);
+  for(size_t i=0;i<sizeof offs/sizeof offs[0];i++){size_t o=(size_t)offs[i]; if(sdat_prg_seek(&g,o))return 474; sdat_prg_generate(&g,at,sizeof at-o); if(memcmp(seq+o,at,sizeof at-o))return 475;}
+  sdat_prg_init_chunk(&h,ck[k],key,kl,0x0123456789abcdefULL,3); sdat_prg_generate(&h,at,64); sdat_prg_seek(&g,3*SDAT_PRG_CHUNK_STRIDE); sdat_prg_generate(&g,seq,64); if(memcmp(seq,at,64))return 476;}
+ sdat_prg g; sdat_prg_init(&g,SDAT_PRG_SHAKE128,key,32); if(sdat_prg_seek(&g,0)!=-1)return 477; sdat_prg_init(&g,SDAT_PRG_AES128_CTR,key,32); if(sdat_prg_seek(&g,0)!=-1)return 477; sdat_prg_init(&g,SDAT_PRG_CHACHA20,key,32); if(sdat_prg_seek(&g,0))return 477;
+ /* ChaCha20 streams cross 2^32 blocks with a carry into word 13, in the 8-block and the scalar paths alike */
+ for(uint64_t lead=13;lead<=16;lead+=3){sdat_prg_init_stream(&g,SDAT_PRG_CHACHA20,key,32,7); sdat_prg_seek(&g,(((uint64_t)1<<32)-lead)*64); sdat_prg_generate(&g,seq,40*64);
+  for(uint64_t b=0;b<40;b++){sdat_prg_seek(&g,(((uint64_t)1<<32)-lead+b)*64); sdat_prg_generate(&g,at,64); if(memcmp(seq+64*b,at,64))return 478;}
+  uint32_t st[16]; uint8_t blk[64]; memcpy(st,g.u.chacha.st,sizeof st); st[12]=0; st[13]=1; sdat_chacha20_block(st,blk); if(memcmp(seq+64*lead,blk,64))return 478;}
+ return 0;}
+int main(void){int r;if((r=test_prg_kat()))return r;if((r=test_prg_vector()))return r;if((r=test_counter_rng()))return r;puts("sdat_prg tests passed");return 0;}
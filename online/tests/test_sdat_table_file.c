@@ -0,0 +1,181 @@
+#include "frodo_sample_n_fast.h"
+#include "sdat_table_file.h"
+#include "sdat_tables.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SDA_SOURCE_DIR
+#define SDA_SOURCE_DIR "."
+#endif
+
+static void hex(const uint8_t d[32], char out[65]) {
+    for (int i = 0; i < 32; i++) snprintf(out + 2 * i, 3, "%02x", d[i]);
+}
+
+static int check_sha256(void) {
+    static const struct { const char *msg, *digest; } kat[] = {
+        {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+        {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+        {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+         "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+    };
+    for (size_t i = 0; i < sizeof kat / sizeof kat[0]; i++) {
+        uint8_t d[32];
+        char h[65];
+        sdat_sha256((const uint8_t *)kat[i].msg, strlen(kat[i].msg), d);
+        hex(d, h);
+        if (strcmp(h, kat[i].digest)) return 500;
+    }
+    return 0;
+}
+
+static int values_equal(const sdat_table *a, const void *x, const void *y, size_t n) {
+    if (a->value_type != SDAT_TYPE_U72) return !memcmp(x, y, n * (a->value_type == SDAT_TYPE_U8 ? 1u : 2u));
+    for (size_t i = 0; i < n; i++)
+        if (sdat_u72_cmp(((const sdat_u72 *)x)[i], ((const sdat_u72 *)y)[i])) return 0;
+    return 1;
+}
+
+static int same_table(const sdat_table *a, const sdat_table *b) {
+    const char *sa[] = {a->table_id, a->scheme, a->parameter_set, a->table_family, a->source_kind, a->source_artifact,
+                        a->source_hash, a->threshold_encoding, a->zero_semantics, a->sign_semantics,
+                        a->output_semantics};
+    const char *sb[] = {b->table_id, b->scheme, b->parameter_set, b->table_family, b->source_kind, b->source_artifact,
+                        b->source_hash, b->threshold_encoding, b->zero_semantics, b->sign_semantics,
+                        b->output_semantics};
+    for (size_t i = 0; i < sizeof sa / sizeof sa[0]; i++)
+        if (strcmp(sa[i] ? sa[i] : "", sb[i])) return 0;
+    size_t nthr = a->mass_count > a->threshold_count ? a->mass_count : a->threshold_count;
+    return a->support_min == b->support_min && a->support_max == b->support_max &&
+           a->support_length == b->support_length && a->value_type == b->value_type &&
+           a->denominator_bits == b->denominator_bits && a->random_draw_bits == b->random_draw_bits &&
+           a->mass_count == b->mass_count && a->threshold_count == b->threshold_count &&
+           a->terminal_threshold_stored == b->terminal_threshold_stored &&
+           a->native_table_bytes == b->native_table_bytes && a->packed_bits == b->packed_bits &&
+           !sdat_u72_cmp(a->denominator_u72, b->denominator_u72) && a->denominator_u64 == b->denominator_u64 &&
+           a->available == b->available && a->source_verified == b->source_verified &&
+           a->heuristic_bkz == b->heuristic_bkz && a->exact_svp == b->exact_svp &&
+           a->global_svp_certified == b->global_svp_certified &&
+           (!a->mass_count || values_equal(a, a->pmf, b->pmf, a->mass_count)) &&
+           values_equal(a, a->thresholds, b->thresholds, nthr);
+}
+
+/* The SIMD-ready sections agree with the native thresholds. */
+static int check_forms(const sdat_table_file *f) {
+    const sdat_table *t = &f->table;
+    int original = !strcmp(t->table_family, "original-cdt-table");
+    for (size_t j = 0; j < t->threshold_count; j++) {
+        if (t->value_type == SDAT_TYPE_U72) {
+            sdat_u72 v = ((const sdat_u72 *)t->thresholds)[j];
+            const uint32_t *l = f->limbs24 + 3 * j;
+            if (f->soa.count != t->threshold_count || f->soa.lo[j] != v.lo || f->soa.hi[j] != v.hi) return 0;
+            if (l[0] != (v.lo & 0xFFFFFFu) || l[1] != ((v.lo >> 24) & 0xFFFFFFu) ||
+                l[2] != ((uint32_t)(v.lo >> 48) | ((uint32_t)v.hi << 16)))
+                return 0;
+        } else {
+            uint32_t v = t->value_type == SDAT_TYPE_U8 ? ((const uint8_t *)t->thresholds)[j]
+                                                       : ((const uint16_t *)t->thresholds)[j];
+            uint32_t g = original ? v : v - 1u;
+            if (f->thr_gt16[j] != (uint16_t)g || f->thr_gt32[j] != g) return 0;
+        }
+    }
+    return 1;
+}
+
+static int check_roundtrip(void) {
+    for (uint32_t id = 1; id < SDAT_TABLE_ID_FIRST_DYNAMIC; id++) {
+        const sdat_table *t = online_table_by_id(id);
+        if (!t) continue;
+        if (online_table_id(t->table_family, t->parameter_set) != (sdat_table_id)id ||
+            online_get_table(t->table_family, t->parameter_set) != t)
+            return 510;
+        size_t n = sdat_table_file_encode(t, id, 0, 0);
+        uint8_t *buf = aligned_alloc(SDAT_TABLE_FILE_ALIGN, n);
+        if (!n || !buf || sdat_table_file_encode(t, id, buf, n) != n) return 511;
+        sdat_table_file f;
+        if (sdat_table_file_view(&f, buf, n) || f.id != id || !same_table(t, &f.table) || !check_forms(&f)) return 512;
+        if ((const uint8_t *)f.table.thresholds < buf || (const uint8_t *)f.table.thresholds >= buf + n) return 513;
+        /* corruption is caught before any field is trusted */
+        buf[n - 1] ^= 1u;
+        if (sdat_table_file_view(&f, buf, n) != -4) return 514;
+        buf[n - 1] ^= 1u;
+        if (sdat_table_file_view(&f, buf, n - SDAT_TABLE_FILE_ALIGN) != -2) return 515;
+        buf[0] ^= 1u;
+        if (sdat_table_file_view(&f, buf, n) != -3) return 516;
+        buf[0] ^= 1u;
+        if (sdat_table_file_view(&f, buf + 1, n - 1) != -1) return 517;
+        free(buf);
+    }
+    if (online_table_by_id(SDAT_TABLE_ID_MAX) || online_table_id("sda-table", "frodo512") ||
+        online_get_table(0, "frodo640"))
+        return 518;
+    return 0;
+}
+
+static int hash_listed(const char *rel, const uint8_t digest[32]) {
+    char path[512], line[1024], h[65];
+    snprintf(path, sizeof path, "%s/online/tables/frodo/online_table_hashes.txt", SDA_SOURCE_DIR);
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    hex(digest, h);
+    int ok = 0;
+    while (!ok && fgets(line, sizeof line, f)) {
+        line[strcspn(line, "\r\n")] = 0;
+        ok = strlen(line) > 66 && !strncmp(line, h, 64) && !strncmp(line + 64, "  ", 2) && !strcmp(line + 66, rel);
+    }
+    fclose(f);
+    return ok;
+}
+
+/* The committed files map, match the built-ins and the current encoder, carry
+ * the digests recorded in online_table_hashes.txt, and can be sampled from. */
+static int check_committed(void) {
+    for (uint32_t id = 1; id < SDAT_TABLE_ID_FIRST_DYNAMIC; id++) {
+        const sdat_table *t = online_table_by_id(id);
+        if (!t) continue;
+        char rel[256], path[768];
+        snprintf(rel, sizeof rel, "online/tables/bin/%s.sdtb", t->table_id);
+        snprintf(path, sizeof path, "%s/%s", SDA_SOURCE_DIR, rel);
+        sdat_table_file f;
+        if (sdat_table_file_open(&f, path) || !f.mapped || f.id != id || !same_table(t, &f.table)) return 520;
+        size_t n = sdat_table_file_encode(t, id, 0, 0);
+        uint8_t *buf = malloc(n), digest[32];
+        if (!buf || n != f.len) return 521;
+        sdat_table_file_encode(t, id, buf, n);
+        if (memcmp(buf, f.base, n)) return 521;
+        free(buf);
+        sdat_sha256(f.base, f.len, digest);
+        if (!hash_listed(rel, digest)) return 522;
+        if (online_table_register(SDAT_TABLE_ID_FIRST_DYNAMIC + id, &f.table) ||
+            online_table_by_id(SDAT_TABLE_ID_FIRST_DYNAMIC + id) != &f.table ||
+            online_table_register(SDAT_TABLE_ID_FIRST_DYNAMIC + id, t) != -2 || online_table_register(id, &f.table) != -1)
+            return 523;
+        if (t->value_type != SDAT_TYPE_U72 && !strcmp(t->table_family, "sda-table")) {
+            enum { N = 300, WC = 1200 };
+            uint16_t words[WC], a[N], b[N];
+            sdat_stats s1, s2;
+            for (size_t i = 0; i < WC; i++) words[i] = (uint16_t)(i * 40503u + 7u);
+            if (frodo_sda_word_sample_n(a, N, words, WC, t, &s1) || frodo_sda_word_sample_n(b, N, words, WC, &f.table, &s2) ||
+                memcmp(a, b, sizeof a) || memcmp(&s1, &s2, sizeof s1))
+                return 524;
+        }
+        if (online_table_unregister(SDAT_TABLE_ID_FIRST_DYNAMIC + id, &f.table) ||
+            online_table_by_id(SDAT_TABLE_ID_FIRST_DYNAMIC + id))
+            return 525;
+        sdat_table_file_close(&f);
+    }
+    sdat_table_file f;
+    if (sdat_table_file_open(&f, SDA_SOURCE_DIR "/online/tables/frodo/online_table_manifest.csv") != -3) return 526;
+    if (sdat_table_file_open(&f, SDA_SOURCE_DIR "/online/tables/bin/missing.sdtb") != -1) return 527;
+    return 0;
+}
+
+int main(void) {
+    int r;
+    if ((r = check_sha256())) return r;
+    if ((r = check_roundtrip())) return r;
+    if ((r = check_committed())) return r;
+    puts("sdat_table_file tests passed");
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include "sdat_table_file.h"
+#include "sdat_tables.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Writes every built-in table to <dir>/<table_id>.sdtb and prints sha256sum
+ * lines (paths as given) for online/tables/frodo/online_table_hashes.txt. */
+int main(int argc, char **argv) {
+    const char *dir = argc > 1 ? argv[1] : ".";
+    for (uint32_t id = 1; id < SDAT_TABLE_ID_FIRST_DYNAMIC; id++) {
+        const sdat_table *t = online_table_by_id(id);
+        if (!t) continue;
+        char path[1024];
+        snprintf(path, sizeof path, "%s/%s.sdtb", dir, t->table_id);
+        if (sdat_table_file_write(t, id, path)) {
+            fprintf(stderr, "sdat_table_pack: cannot write %s\n", path);
+            return 1;
+        }
+        size_t n = sdat_table_file_encode(t, id, 0, 0);
+        uint8_t *buf = malloc(n), digest[32];
+        if (!buf) return 1;
+        sdat_table_file_encode(t, id, buf, n);
+        sdat_sha256(buf, n, digest);
+        free(buf);
+        for (int i = 0; i < 32; i++) printf("%02x", digest[i]);
+        printf("  %s\n", path);
+    }
+    return 0;
+}